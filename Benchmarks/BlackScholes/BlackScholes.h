@@ -19,13 +19,22 @@
 // Licensed under the Apache License, v2.0. Please see the LICENSE file included with the HEMI source code.
 
 
+#include "Harness.h"
+
 #include <dax/cont/DeviceAdapter.h>
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/DispatcherMapField.h>
-#include <dax/cont/Timer.h>
 
 #include <dax/math/Exp.h>
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#define MAKE_STRING2(x) #x
+#define MAKE_STRING1(x) MAKE_STRING2(x)
+#define DEVICE_ADAPTER MAKE_STRING1(DAX_DEFAULT_DEVICE_ADAPTER_TAG)
+
 namespace worklet {
 
 // Polynomial approximation of cumulative normal distribution function
@@ -88,40 +97,125 @@ public:
 
 }
 
-double launchBlackScholes(const std::vector<dax::Scalar>& stockPrice,
-                          const std::vector<dax::Scalar>& optionStrike,
-                          const std::vector<dax::Scalar>& optionYears,
-                          std::vector<dax::Scalar>& callResult,
-                          std::vector<dax::Scalar>& putResult
-                          )
-{
-  const dax::Scalar  RISKFREE = 0.02f;
-  const dax::Scalar  VOLATILITY = 0.30f;
+namespace {
 
-  //create Handles for inputs that aren't constant values
-  //this doesn't copy memory on host.
-  dax::cont::ArrayHandle<dax::Scalar> sPriceHandle = dax::cont::make_ArrayHandle(stockPrice);
-  dax::cont::ArrayHandle<dax::Scalar> oStrikeHandle = dax::cont::make_ArrayHandle(optionStrike);
-  dax::cont::ArrayHandle<dax::Scalar> oYearsHandle = dax::cont::make_ArrayHandle(optionYears);
+dax::Scalar RandFloat(dax::Scalar low, dax::Scalar high)
+{
+  dax::Scalar t = (dax::Scalar)rand() / (dax::Scalar)RAND_MAX;
+  return (1.0f - t) * low + t * high;
+}
 
-  dax::cont::ArrayHandle<dax::Scalar> callResultHandle, putResultHandle;
+void initOptions(std::vector<dax::Scalar> &price,
+                 std::vector<dax::Scalar> &strike,
+                 std::vector<dax::Scalar> &years)
+{
+  srand(5347);
+  //Generate options set
+  const std::size_t size = price.size();
+  for (std::size_t i = 0; i < size; i++)
+    {
+    price[i]  = RandFloat(5.0f, 30.0f);
+    strike[i] = RandFloat(1.0f, 100.0f);
+    years[i]  = RandFloat(0.25f, 10.0f);
+    }
+}
 
-  dax::cont::DispatcherMapField< worklet::BlackScholes > dispatcher;
+struct BlackScholesFunctor
+{
+  BlackScholesFunctor(const std::vector<dax::Scalar>& stockPrice,
+                      const std::vector<dax::Scalar>& optionStrike,
+                      const std::vector<dax::Scalar>& optionYears,
+                      std::vector<dax::Scalar>& callResult,
+                      std::vector<dax::Scalar>& putResult)
+    : StockPrice(stockPrice), OptionStrike(optionStrike),
+      OptionYears(optionYears), CallResult(callResult), PutResult(putResult)
+  {  }
+
+  void operator()(dax::benchmark::Trial &trial) const
+  {
+    const dax::Scalar  RISKFREE = 0.02f;
+    const dax::Scalar  VOLATILITY = 0.30f;
+
+    //create Handles for inputs that aren't constant values
+    //this doesn't copy memory on host.
+    dax::cont::ArrayHandle<dax::Scalar> sPriceHandle =
+        dax::cont::make_ArrayHandle(this->StockPrice);
+    dax::cont::ArrayHandle<dax::Scalar> oStrikeHandle =
+        dax::cont::make_ArrayHandle(this->OptionStrike);
+    dax::cont::ArrayHandle<dax::Scalar> oYearsHandle =
+        dax::cont::make_ArrayHandle(this->OptionYears);
+
+    dax::cont::ArrayHandle<dax::Scalar> callResultHandle, putResultHandle;
+
+    trial.BeginStage("black scholes");
+    dax::cont::DispatcherMapField< worklet::BlackScholes >().Invoke(
+          sPriceHandle, oStrikeHandle, oYearsHandle, RISKFREE, VOLATILITY,
+          callResultHandle, putResultHandle );
+
+    callResultHandle.CopyInto(this->CallResult.begin());
+    putResultHandle.CopyInto(this->PutResult.begin());
+    trial.EndStage();
+
+    trial.SetCounter("options", static_cast<double>(this->StockPrice.size()));
+  }
 
-  dax::cont::Timer<> timer;
+  const std::vector<dax::Scalar>& StockPrice;
+  const std::vector<dax::Scalar>& OptionStrike;
+  const std::vector<dax::Scalar>& OptionYears;
+  std::vector<dax::Scalar>& CallResult;
+  std::vector<dax::Scalar>& PutResult;
+};
 
-  //invoke the black scholes worklet 512 averaging the elapsed time
-  for (int i = 0; i < 12; i++)
+int RunBenchmark(int argc, char* argv[])
+{
+  dax::benchmark::Harness harness(
+        "BlackScholes",
+        DEVICE_ADAPTER,
+        &dax::cont::DeviceAdapterAlgorithm<
+          DAX_DEFAULT_DEVICE_ADAPTER_TAG>::Synchronize);
+  harness.AddPipeline(1, "BlackScholes call and put prices");
+  //the size is the number of options
+  harness.SetDefaultSize(4000000);
+  harness.SetEnergyPerCounter("options", "option");
+  if (!harness.ParseArguments(argc, argv))
     {
-    dispatcher.Invoke(  sPriceHandle, oStrikeHandle,
-                        oYearsHandle, RISKFREE, VOLATILITY,
-                        callResultHandle, putResultHandle );
+    return 1;
     }
 
-  callResultHandle.CopyInto(callResult.begin());
-  putResultHandle.CopyInto(putResult.begin());
+  for (std::size_t sizeIndex = 0;
+       sizeIndex < harness.GetSizes().size();
+       ++sizeIndex)
+    {
+    const dax::Id OPT_N = harness.GetSizes()[sizeIndex];
+
+    printf("Initializing data...\n");
+
+    std::vector<dax::Scalar> stockPrice(  OPT_N);
+    std::vector<dax::Scalar> optionStrike( OPT_N);
+    std::vector<dax::Scalar> optionYears( OPT_N);
 
-  const double time = (timer.GetElapsedTime()/12.0);
+    //result vectors
+    std::vector<dax::Scalar> callResult(OPT_N);
+    std::vector<dax::Scalar> putResult(OPT_N);
 
-  return time;
+    initOptions(stockPrice, optionStrike, optionYears);
+
+    BlackScholesFunctor functor(stockPrice, optionStrike, optionYears,
+                                callResult, putResult);
+    const double time = harness.Run(
+          1, dax::benchmark::Parameters().Add("options", OPT_N), functor)
+        .GetMedian();
+
+    //Both call and put is calculated
+    printf("Options count             : %i     \n", static_cast<int>(2 * OPT_N));
+    printf("\tBlackScholes() time    : %f sec\n", time);
+    printf("Effective memory bandwidth: %f GB/s\n",
+          ((double)(5 * OPT_N * sizeof(dax::Scalar)) * 1E-9) / time);
+    printf("Gigaoptions per second    : %f     \n\n",
+          ((double)(2 * OPT_N) * 1E-9) / time);
+    }
+
+  return harness.Finish();
 }
+
+} // Anonymous namespace
@@ -13,24 +13,24 @@
 //  the U.S. Government retains certain rights in this software.
 //
 //=============================================================================
-#include <stdio.h>
-#include <iostream>
+#include "Harness.h"
 
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/ArrayHandleTransform.h>
+#include <dax/cont/DeviceAdapter.h>
 #include <dax/cont/DispatcherMapCell.h>
 #include <dax/cont/DispatcherMapField.h>
-#include <dax/cont/Timer.h>
 #include <dax/cont/UniformGrid.h>
 #include <dax/cont/VectorOperations.h>
 
 #include <dax/worklet/CellGradient.h>
 #include <dax/worklet/Cosine.h>
+#include <dax/worklet/Fused.h>
 #include <dax/worklet/Magnitude.h>
 #include <dax/worklet/Sine.h>
 #include <dax/worklet/Square.h>
 
-#include <vector>
+#include <iostream>
 
 #define MAKE_STRING2(x) #x
 #define MAKE_STRING1(x) MAKE_STRING2(x)
@@ -73,95 +73,71 @@ void PrintScalarValue(dax::Scalar value)
 }
 
 template<class IteratorType>
-void PrintCheckValues(IteratorType begin, IteratorType end)
+void CheckValues(IteratorType begin, IteratorType end)
 {
   typedef typename std::iterator_traits<IteratorType>::value_type VectorType;
 
-  dax::Id index = 0;
   for (IteratorType iter = begin; iter != end; iter++)
     {
     VectorType vector = *iter;
-    if (index < 20)
+    CheckValid isValid;
+    dax::cont::VectorForEach(vector, isValid);
+    if (!isValid)
       {
-      std::cout << index << ":";
+      std::cout << "*** Encountered bad value." << std::endl;
+      std::cout << std::distance(begin,iter) << ":";
       dax::cont::VectorForEach(vector, PrintScalarValue);
       std::cout << std::endl;
+      exit(1);
       }
-    else
-      {
-      CheckValid isValid;
-      dax::cont::VectorForEach(vector, isValid);
-      if (!isValid)
-        {
-        std::cout << "*** Encountered bad value." << std::endl;
-        std::cout << index << ":";
-        dax::cont::VectorForEach(vector, PrintScalarValue);
-        std::cout << std::endl;
-        exit(1);
-        }
-      }
-
-    index++;
     }
 }
 
 template<typename T, class Container, class Device>
-void PrintCheckValues(const dax::cont::ArrayHandle<T,Container,Device> &array)
-{
-  PrintCheckValues(array.GetPortalConstControl().GetIteratorBegin(),
-                   array.GetPortalConstControl().GetIteratorEnd());
-}
-
-void PrintResults(int pipeline, double time)
+void CheckValues(const dax::cont::ArrayHandle<T,Container,Device> &array)
 {
-  std::cout << "Elapsed time: " << time << " seconds." << std::endl;
-  std::cout << "CSV," DEVICE_ADAPTER ","
-            << pipeline << "," << time << std::endl;
+  CheckValues(array.GetPortalConstControl().GetIteratorBegin(),
+              array.GetPortalConstControl().GetIteratorEnd());
 }
 
-void RunPipeline1(const dax::cont::UniformGrid<> &grid)
+void RunPipeline1(dax::benchmark::Trial &trial,
+                  const dax::cont::UniformGrid<> &grid)
 {
-  std::cout << "Running pipeline 1: Magnitude -> Gradient" << std::endl;
-
   dax::cont::ArrayHandle<dax::Scalar> intermediate1;
 
   dax::cont::ArrayHandle<dax::Vector3> results;
 
-  dax::cont::Timer<> timer;
-
+  trial.BeginStage("magnitude");
   dax::cont::DispatcherMapField< dax::worklet::Magnitude >().Invoke(
         grid.GetPointCoordinates(),
         intermediate1);
 
+  trial.BeginStage("gradient");
   dax::cont::DispatcherMapCell< dax::worklet::CellGradient >().Invoke(
         grid,
         grid.GetPointCoordinates(),
         intermediate1,
         results);
+  trial.EndStage();
 
-  double time = timer.GetElapsedTime();
-
-  PrintCheckValues(results);
-  PrintResults(1, time);
+  CheckValues(results);
 }
 
-void RunPipeline2(const dax::cont::UniformGrid<> &grid)
+void RunPipeline2(dax::benchmark::Trial &trial,
+                  const dax::cont::UniformGrid<> &grid)
 {
-  std::cout << "Running pipeline 2: Magnitude->Gradient->Sine->Square->Cosine"
-            << std::endl;
-
   dax::cont::ArrayHandle<dax::Scalar> intermediate1;
   dax::cont::ArrayHandle<dax::Vector3> intermediate2;
   dax::cont::ArrayHandle<dax::Vector3> intermediate3;
 
   dax::cont::ArrayHandle<dax::Vector3> results;
 
-  dax::cont::Timer<> timer;
-
+  trial.BeginStage("magnitude");
   dax::cont::DispatcherMapField<dax::worklet::Magnitude>().Invoke(
         grid.GetPointCoordinates(),
         intermediate1);
 
+  trial.BeginStage("gradient");
   dax::cont::DispatcherMapCell< dax::worklet::CellGradient >().Invoke(
         grid,
         grid.GetPointCoordinates(),
@@ -170,61 +146,54 @@ void RunPipeline2(const dax::cont::UniformGrid<> &grid)
 
   intermediate1.ReleaseResources();
 
-
+  trial.BeginStage("sine");
   dax::cont::DispatcherMapField< dax::worklet::Sine >().Invoke(intermediate2,
                                                                intermediate3);
+  trial.BeginStage("square");
   dax::cont::DispatcherMapField< dax::worklet::Square>().Invoke(intermediate3,
                                                                 intermediate2);
   intermediate3.ReleaseResources();
+  trial.BeginStage("cosine");
   dax::cont::DispatcherMapField< dax::worklet::Cosine>().Invoke(intermediate2,
                                                                 results);
-  double time = timer.GetElapsedTime();
-
-  PrintCheckValues(results);
+  trial.EndStage();
 
-  PrintResults(2, time);
+  CheckValues(results);
 }
 
-void RunPipeline3(const dax::cont::UniformGrid<> &grid)
+void RunPipeline3(dax::benchmark::Trial &trial,
+                  const dax::cont::UniformGrid<> &grid)
 {
-  std::cout << "Running pipeline 3: Magnitude -> Sine -> Square -> Cosine"
-            << std::endl;
-
   dax::cont::ArrayHandle<dax::Scalar> intermediate1;
   dax::cont::ArrayHandle<dax::Scalar> intermediate2;
 
   dax::cont::ArrayHandle<dax::Scalar> results;
 
-  dax::cont::Timer<> timer;
-
+  trial.BeginStage("magnitude");
   dax::cont::DispatcherMapField<dax::worklet::Magnitude>().Invoke(
         grid.GetPointCoordinates(),
         intermediate1);
 
+  trial.BeginStage("sine");
   dax::cont::DispatcherMapField< dax::worklet::Sine >().Invoke(intermediate1,
                                                                intermediate2);
+  trial.BeginStage("square");
   dax::cont::DispatcherMapField< dax::worklet::Square>().Invoke(intermediate2,
                                                                 intermediate1);
   intermediate2.ReleaseResources();
+  trial.BeginStage("cosine");
   dax::cont::DispatcherMapField< dax::worklet::Cosine>().Invoke(intermediate1,
                                                                 results);
+  trial.EndStage();
 
-  double time = timer.GetElapsedTime();
-
-  PrintCheckValues(results);
-
-  PrintResults(3, time);
+  CheckValues(results);
 }
 
-void RunPipeline4(const dax::cont::UniformGrid<> &grid)
+void RunPipeline4(dax::benchmark::Trial &trial,
+                  const dax::cont::UniformGrid<> &grid)
 {
-  std::cout << "Running Fused Pipeline 4: Magnitude -> Sine -> Square -> Cosine"
-            << std::endl;
-
   dax::cont::ArrayHandle<dax::Scalar> results;
 
-  dax::cont::Timer<> timer;
-
   //fuse the first three worklets into the transform handle instead of
   //explicitly calling each of them, only the cosine worklet will be called
   typedef dax::cont::ArrayHandleTransform< dax::Scalar,
@@ -239,6 +208,7 @@ void RunPipeline4(const dax::cont::UniformGrid<> &grid)
           SineFusedHandle,
           dax::worklet::Square > SquareFusedHandle;
 
+  trial.BeginStage("fused cosine");
   MagnitudeHandle mag(grid.GetPointCoordinates());
 
   SineFusedHandle sine(mag);
@@ -246,14 +216,114 @@ void RunPipeline4(const dax::cont::UniformGrid<> &grid)
 
   dax::cont::DispatcherMapField< dax::worklet::Cosine>().Invoke(fused,
                                                                 results);
+  trial.EndStage();
+
+  CheckValues(results);
+}
+
+void RunPipeline5(dax::benchmark::Trial &trial,
+                  const dax::cont::UniformGrid<> &grid)
+{
+  dax::cont::ArrayHandle<dax::Vector3> intermediate1;
+
+  dax::cont::ArrayHandle<dax::Vector3> results;
+
+  //the gradient reads the magnitude straight from the point coordinates
+  //instead of from a stored point field
+  typedef dax::cont::ArrayHandleTransform< dax::Scalar,
+          dax::cont::UniformGrid<>::PointCoordinatesType,
+          ::worklets::MagWrapper > MagnitudeHandle;
 
-  double time = timer.GetElapsedTime();
+  //sine, square and cosine run as one worklet over the gradient, so the
+  //only array written between the inputs and the results is the gradient
+  typedef dax::worklet::Fused<
+      dax::worklet::Fused<dax::worklet::Sine, dax::worklet::Square>,
+      dax::worklet::Cosine> SineSquareCosine;
 
-  PrintCheckValues(results);
+  trial.BeginStage("fused gradient");
+  MagnitudeHandle mag(grid.GetPointCoordinates());
+  dax::cont::DispatcherMapCell< dax::worklet::CellGradient >().Invoke(
+        grid,
+        grid.GetPointCoordinates(),
+        mag,
+        intermediate1);
 
+  trial.BeginStage("fused sine square cosine");
+  dax::cont::DispatcherMapField< SineSquareCosine >().Invoke(intermediate1,
+                                                             results);
+  trial.EndStage();
 
-  PrintResults(4, time);
+  CheckValues(results);
 }
 
-} // Anonymous namespace
+struct PipelineFunctor
+{
+  PipelineFunctor(int pipeline, const dax::cont::UniformGrid<> &grid)
+    : Pipeline(pipeline), Grid(grid) {  }
+
+  void operator()(dax::benchmark::Trial &trial) const
+  {
+    switch (this->Pipeline)
+      {
+      case 1: RunPipeline1(trial, this->Grid); break;
+      case 2: RunPipeline2(trial, this->Grid); break;
+      case 3: RunPipeline3(trial, this->Grid); break;
+      case 4: RunPipeline4(trial, this->Grid); break;
+      case 5: RunPipeline5(trial, this->Grid); break;
+      }
+  }
+
+  int Pipeline;
+  const dax::cont::UniformGrid<> &Grid;
+};
 
+dax::cont::UniformGrid<> CreateInputStructure(dax::Id dim)
+{
+  dax::cont::UniformGrid<> grid;
+  grid.SetOrigin(dax::make_Vector3(0.0, 0.0, 0.0));
+  grid.SetSpacing(dax::make_Vector3(1.0, 1.0, 1.0));
+  grid.SetExtent(dax::make_Id3(0, 0, 0), dax::make_Id3(dim-1, dim-1, dim-1));
+  return grid;
+}
+
+int RunBenchmark(int argc, char* argv[])
+{
+  dax::benchmark::Harness harness(
+        "FY11Timing",
+        DEVICE_ADAPTER,
+        &dax::cont::DeviceAdapterAlgorithm<
+          DAX_DEFAULT_DEVICE_ADAPTER_TAG>::Synchronize);
+  harness.AddPipeline(1, "Magnitude -> Gradient");
+  harness.AddPipeline(2, "Magnitude -> Gradient -> Sine -> Square -> Cosine");
+  harness.AddPipeline(3, "Magnitude -> Sine -> Square -> Cosine");
+  harness.AddPipeline(4, "Fused Magnitude -> Sine -> Square -> Cosine");
+  harness.AddPipeline(5,
+      "Fused Magnitude -> Gradient -> Fused Sine -> Square -> Cosine");
+  harness.SetDefaultSize(128);
+  if (!harness.ParseArguments(argc, argv))
+    {
+    return 1;
+    }
+
+  for (std::size_t sizeIndex = 0;
+       sizeIndex < harness.GetSizes().size();
+       ++sizeIndex)
+    {
+    const dax::Id size = harness.GetSizes()[sizeIndex];
+    dax::cont::UniformGrid<> grid = CreateInputStructure(size);
+    for (std::size_t pipelineIndex = 0;
+         pipelineIndex < harness.GetPipelines().size();
+         ++pipelineIndex)
+      {
+      const int pipeline = harness.GetPipelines()[pipelineIndex];
+      PipelineFunctor functor(pipeline, grid);
+      harness.Run(pipeline,
+                  dax::benchmark::Parameters().Add("size", size),
+                  functor);
+      }
+    }
+
+  return harness.Finish();
+}
+
+} // Anonymous namespace
@@ -0,0 +1,236 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#include "EnergyMeter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+/// Returns the sorted names of the entries of a directory, or nothing if the
+/// directory cannot be listed.
+std::vector<std::string> ListDirectory(const std::string &directory)
+{
+  std::vector<std::string> names;
+#ifndef _WIN32
+  DIR *dir = opendir(directory.c_str());
+  if (dir == NULL) { return names; }
+  for (dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir))
+    {
+    const std::string name(entry->d_name);
+    if (name != "." && name != "..") { names.push_back(name); }
+    }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+#else
+  (void)directory;
+#endif
+  return names;
+}
+
+bool IsRegularFile(const std::string &path)
+{
+#ifndef _WIN32
+  struct stat info;
+  return (stat(path.c_str(), &info) == 0) && S_ISREG(info.st_mode);
+#else
+  (void)path;
+  return false;
+#endif
+}
+
+/// Reads the first word of a file, such as the name of a powercap zone.
+bool ReadWord(const std::string &path, std::string &word)
+{
+  std::ifstream file(path.c_str());
+  return static_cast<bool>(file >> word);
+}
+
+bool ReadNumber(const std::string &path, double &value)
+{
+  std::ifstream file(path.c_str());
+  return static_cast<bool>(file >> value);
+}
+
+/// Powercap zones are directories such as intel-rapl:0 and their subzones
+/// intel-rapl:0:0, which also appear as links at the top level.
+int CountZoneLevels(const std::string &name)
+{
+  if (name.find("rapl:") == std::string::npos) { return 0; }
+  return static_cast<int>(std::count(name.begin(), name.end(), ':'));
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+dax::benchmark::EnergyMeter *
+dax::benchmark::EnergyMeter::New(const std::string &specification)
+{
+  const std::string::size_type colon = specification.find(':');
+  const std::string kind = specification.substr(0, colon);
+  const std::string directory =
+      (colon == std::string::npos) ? "" : specification.substr(colon + 1);
+
+  EnergyMeter *meter = NULL;
+  if (kind == "powercap")
+    {
+    meter = directory.empty() ? new PowercapEnergyMeter
+                              : new PowercapEnergyMeter(directory);
+    }
+  else if (kind == "mock" && !directory.empty())
+    {
+    meter = new MockEnergyMeter(directory);
+    }
+  else
+    {
+    std::cerr << "Unknown energy meter \"" << specification
+              << "\", expected powercap, powercap:<directory> or "
+              << "mock:<directory>" << std::endl;
+    return NULL;
+    }
+
+  std::vector<double> joules;
+  if (meter->GetDomainNames().empty() || !meter->Read(joules))
+    {
+    std::cerr << "Could not read any energy counters of " << meter->GetName()
+              << std::endl;
+    delete meter;
+    return NULL;
+    }
+  return meter;
+}
+
+//-----------------------------------------------------------------------------
+dax::benchmark::PowercapEnergyMeter::PowercapEnergyMeter(
+    const std::string &directory)
+  : Directory(directory)
+{
+  const std::vector<std::string> zones = ListDirectory(directory);
+  for (std::size_t zone = 0; zone < zones.size(); ++zone)
+    {
+    if (CountZoneLevels(zones[zone]) != 1) { continue; }
+    const std::string zonePath = directory + "/" + zones[zone];
+    std::string packageName;
+    if (!ReadWord(zonePath + "/name", packageName) ||
+        packageName.compare(0, 7, "package") != 0)
+      {
+      continue;
+      }
+
+    std::vector<std::string> paths(1, zonePath);
+    std::vector<std::string> names(1, packageName);
+    const std::vector<std::string> subzones = ListDirectory(zonePath);
+    for (std::size_t subzone = 0; subzone < subzones.size(); ++subzone)
+      {
+      if (CountZoneLevels(subzones[subzone]) != 2) { continue; }
+      const std::string subzonePath = zonePath + "/" + subzones[subzone];
+      std::string subzoneName;
+      if (ReadWord(subzonePath + "/name", subzoneName) &&
+          subzoneName == "dram")
+        {
+        paths.push_back(subzonePath);
+        names.push_back(packageName + "/" + subzoneName);
+        }
+      }
+
+    for (std::size_t index = 0; index < paths.size(); ++index)
+      {
+      double range;
+      if (!ReadNumber(paths[index] + "/max_energy_range_uj", range))
+        {
+        range = 0;
+        }
+      this->DomainNames.push_back(names[index]);
+      this->CounterFiles.push_back(paths[index] + "/energy_uj");
+      this->Ranges.push_back(range);
+      }
+    }
+
+  this->LastReadings.resize(this->CounterFiles.size(), -1);
+  this->Accumulated.resize(this->CounterFiles.size(), 0);
+}
+
+//-----------------------------------------------------------------------------
+std::string dax::benchmark::PowercapEnergyMeter::GetName() const
+{
+  return "powercap:" + this->Directory;
+}
+
+//-----------------------------------------------------------------------------
+bool dax::benchmark::PowercapEnergyMeter::Read(std::vector<double> &joules)
+{
+  for (std::size_t index = 0; index < this->CounterFiles.size(); ++index)
+    {
+    double microjoules;
+    if (!ReadNumber(this->CounterFiles[index], microjoules)) { return false; }
+    if (this->LastReadings[index] >= 0)
+      {
+      double delta = microjoules - this->LastReadings[index];
+      if (delta < 0) { delta += this->Ranges[index]; }
+      this->Accumulated[index] += 1e-6*delta;
+      }
+    this->LastReadings[index] = microjoules;
+    }
+  joules = this->Accumulated;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+dax::benchmark::MockEnergyMeter::MockEnergyMeter(const std::string &directory)
+  : Directory(directory), NextReading(0)
+{
+  const std::vector<std::string> files = ListDirectory(directory);
+  for (std::size_t index = 0; index < files.size(); ++index)
+    {
+    const std::string path = directory + "/" + files[index];
+    if (!IsRegularFile(path)) { continue; }
+
+    std::vector<double> readings;
+    std::ifstream file(path.c_str());
+    double value;
+    while (file >> value) { readings.push_back(value); }
+    if (readings.empty()) { continue; }
+
+    this->DomainNames.push_back(files[index]);
+    this->Readings.push_back(readings);
+    }
+}
+
+//-----------------------------------------------------------------------------
+std::string dax::benchmark::MockEnergyMeter::GetName() const
+{
+  return "mock:" + this->Directory;
+}
+
+//-----------------------------------------------------------------------------
+bool dax::benchmark::MockEnergyMeter::Read(std::vector<double> &joules)
+{
+  joules.resize(this->Readings.size());
+  for (std::size_t index = 0; index < this->Readings.size(); ++index)
+    {
+    const std::vector<double> &readings = this->Readings[index];
+    joules[index] = readings[std::min(this->NextReading, readings.size() - 1)];
+    }
+  ++this->NextReading;
+  return true;
+}
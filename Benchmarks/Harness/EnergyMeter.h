@@ -0,0 +1,105 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_benchmark_EnergyMeter_h
+#define __dax_benchmark_EnergyMeter_h
+
+#include <string>
+#include <vector>
+
+namespace dax { namespace benchmark {
+
+/// \brief Reads cumulative energy counters of the machine.
+///
+/// A meter reports one counter per domain, such as a processor package or
+/// its DRAM. The domains must not overlap so that their sum is the energy of
+/// the machine. Counters are read at the boundaries of benchmark stages and
+/// the energy of a stage is the difference of two readings.
+///
+class EnergyMeter
+{
+public:
+  virtual ~EnergyMeter() {  }
+
+  /// Returns a description of the meter for reports.
+  virtual std::string GetName() const = 0;
+
+  const std::vector<std::string> &GetDomainNames() const
+    { return this->DomainNames; }
+
+  /// Fills \p joules with the cumulative energy of each domain, measured from
+  /// an arbitrary origin. Returns false if a counter could not be read.
+  virtual bool Read(std::vector<double> &joules) = 0;
+
+  /// Creates the meter described by \p specification, which is either
+  /// "powercap", "powercap:<directory>" or "mock:<directory>". Returns NULL,
+  /// after printing why, if the meter cannot be created or has no domains.
+  static EnergyMeter *New(const std::string &specification);
+
+protected:
+  std::vector<std::string> DomainNames;
+};
+
+/// \brief Reads the package and DRAM energy of the Linux powercap interface.
+///
+/// Every intel-rapl zone named package-N and its dram subzone become a
+/// domain (core and uncore subzones are part of the package energy and are
+/// skipped). The energy_uj counters wrap at max_energy_range_uj, which
+/// takes minutes even at full load, so a wrap between two readings is
+/// corrected. Reading the counters usually requires root, or read access
+/// granted to energy_uj.
+///
+class PowercapEnergyMeter : public EnergyMeter
+{
+public:
+  explicit PowercapEnergyMeter(
+      const std::string &directory = "/sys/class/powercap");
+
+  virtual std::string GetName() const;
+  virtual bool Read(std::vector<double> &joules);
+
+private:
+  std::string Directory;
+  std::vector<std::string> CounterFiles;
+  std::vector<double> Ranges;
+  std::vector<double> LastReadings;
+  std::vector<double> Accumulated;
+};
+
+/// \brief Replays energy readings stored in the files of a directory.
+///
+/// Every regular file of the directory is a domain named after the file and
+/// holds a list of cumulative readings in joules separated by white space.
+/// Each Read advances to the next reading of every domain and repeats the
+/// last one when the list runs out. This stands in for real counters on
+/// machines without them and makes energy reports reproducible in tests.
+///
+class MockEnergyMeter : public EnergyMeter
+{
+public:
+  explicit MockEnergyMeter(const std::string &directory);
+
+  virtual std::string GetName() const;
+  virtual bool Read(std::vector<double> &joules);
+
+private:
+  std::string Directory;
+  std::vector<std::vector<double> > Readings;
+  std::size_t NextReading;
+};
+
+}}
+
+#endif //__dax_benchmark_EnergyMeter_h
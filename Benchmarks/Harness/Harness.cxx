@@ -0,0 +1,827 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#include "Harness.h"
+
+#include <dax/testing/OptionParser.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <sys/timeb.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace {
+
+double CurrentTime()
+{
+#ifdef _WIN32
+  timeb currentTime;
+  ::ftime(&currentTime);
+  return currentTime.time + 0.001*currentTime.millitm;
+#else
+  timeval currentTime;
+  gettimeofday(&currentTime, NULL);
+  return currentTime.tv_sec + 0.000001*currentTime.tv_usec;
+#endif
+}
+
+std::string EscapeJSON(const std::string &text)
+{
+  std::string result;
+  for (std::string::const_iterator c = text.begin(); c != text.end(); ++c)
+    {
+    switch (*c)
+      {
+      case '"':  result += "\\\""; break;
+      case '\\': result += "\\\\"; break;
+      case '\n': result += "\\n"; break;
+      case '\t': result += "\\t"; break;
+      default:   result += *c; break;
+      }
+    }
+  return result;
+}
+
+std::string FormatNumber(double value)
+{
+  std::stringstream stream;
+  stream << std::setprecision(9) << value;
+  return stream.str();
+}
+
+/// Parses a comma separated list such as "64,128,256".
+template<typename T>
+bool ParseList(const std::string &text, std::vector<T> &values)
+{
+  std::vector<T> parsed;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ','))
+    {
+    std::stringstream itemStream(item);
+    T value;
+    itemStream >> value;
+    if (!itemStream || !(itemStream >> std::ws).eof())
+      {
+      std::cerr << "Could not parse \"" << item << "\" in \"" << text << "\""
+                << std::endl;
+      return false;
+      }
+    parsed.push_back(value);
+    }
+  if (parsed.empty()) { return false; }
+  values = parsed;
+  return true;
+}
+
+/// Appends the values of \p stages to the samples of the stage of the same
+/// name, adding stages not seen before.
+void AddStageSamples(const dax::benchmark::Trial::ValueList &stages,
+                     std::vector<std::string> &names,
+                     std::vector<std::vector<double> > &samples)
+{
+  for (std::size_t stage = 0; stage < stages.size(); ++stage)
+    {
+    const std::size_t index =
+        std::find(names.begin(), names.end(), stages[stage].first)
+        - names.begin();
+    if (index == names.size())
+      {
+      names.push_back(stages[stage].first);
+      samples.push_back(std::vector<double>());
+      }
+    samples[index].push_back(stages[stage].second);
+    }
+}
+
+enum optionIndex { UNKNOWN, HELP, PIPELINE, SIZE, ISOVALUE, FILENAME,
+                   SLABDEPTH, WARMUP, TRIALS, JSON, OUTPUT, ENERGY,
+                   MEMORYBUDGET };
+const dax::testing::option::Descriptor usage[] =
+{
+  {UNKNOWN,   0,"" , ""    ,      dax::testing::option::Arg::None, "USAGE: benchmark [options]\n\n"
+                                                                    "Options:" },
+  {HELP,      0,"h" , "help",      dax::testing::option::Arg::None, "  --help, -h  \tPrint usage and exit." },
+  {PIPELINE,  0,"", "pipeline",  dax::testing::option::Arg::Optional, "  --pipeline  \t Comma separated pipelines to run, or \"all\"." },
+  {SIZE,      0,"", "size",      dax::testing::option::Arg::Optional, "  --size  \t Comma separated problem sizes to sweep." },
+  {ISOVALUE,  0,"", "isovalue",  dax::testing::option::Arg::Optional, "  --isovalue \t Comma separated isovalues to sweep." },
+  {FILENAME,  0,"", "filename",  dax::testing::option::Arg::Optional, "  --filename \t Input file to use instead of a generated grid." },
+  {SLABDEPTH, 0,"", "slab-depth", dax::testing::option::Arg::Optional, "  --slab-depth \t Process the input file out of core, this many cell layers at a time." },
+  {WARMUP,    0,"", "warmup",    dax::testing::option::Arg::Optional, "  --warmup \t Untimed runs before the trials (default 1)." },
+  {TRIALS,    0,"", "trials",    dax::testing::option::Arg::Optional, "  --trials \t Timed runs of each configuration (default 5)." },
+  {JSON,      0,"", "json",      dax::testing::option::Arg::Optional, "  --json \t Write all results to this JSON file (- for stdout)." },
+  {OUTPUT,    0,"", "output",    dax::testing::option::Arg::Optional, "  --output \t Write the output mesh of the last trial to this file." },
+  {ENERGY,    0,"", "energy",    dax::testing::option::Arg::Optional, "  --energy \t Measure the energy of each stage with powercap, powercap:<directory> or mock:<directory>." },
+  {MEMORYBUDGET, 0,"", "memory-budget", dax::testing::option::Arg::Optional, "  --memory-budget \t Budget of each memory space in MB. Execution arrays over it are released or spilled to the control environment." },
+  {UNKNOWN,   0,"",  "",          dax::testing::option::Arg::None, "\nExamples:\n"
+                                                                   " benchmark --size=128 --pipeline=1\n"
+                                                                   " benchmark --size=64,128,256 --pipeline=all --trials=10 --json=results.json\n"},
+  {0,0,0,0,0,0}
+};
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+dax::benchmark::Parameters &
+dax::benchmark::Parameters::Add(const std::string &name, double value)
+{
+  Entry entry;
+  entry.Name = name;
+  entry.Value = FormatNumber(value);
+  entry.IsNumber = true;
+  this->Entries.push_back(entry);
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+dax::benchmark::Parameters &
+dax::benchmark::Parameters::Add(const std::string &name,
+                                const std::string &value)
+{
+  Entry entry;
+  entry.Name = name;
+  entry.Value = value;
+  entry.IsNumber = false;
+  this->Entries.push_back(entry);
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+std::string dax::benchmark::Parameters::ToString() const
+{
+  std::string result;
+  for (std::size_t index = 0; index < this->Entries.size(); ++index)
+    {
+    if (index > 0) { result += " "; }
+    result += this->Entries[index].Name + "=" + this->Entries[index].Value;
+    }
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Parameters::WriteJSON(std::ostream &stream) const
+{
+  stream << "{";
+  for (std::size_t index = 0; index < this->Entries.size(); ++index)
+    {
+    const Entry &entry = this->Entries[index];
+    stream << ((index > 0) ? ", " : "") << "\"" << EscapeJSON(entry.Name)
+           << "\": ";
+    if (entry.IsNumber)
+      {
+      stream << entry.Value;
+      }
+    else
+      {
+      stream << "\"" << EscapeJSON(entry.Value) << "\"";
+      }
+    }
+  stream << "}";
+}
+
+//-----------------------------------------------------------------------------
+dax::benchmark::Statistics::Statistics()
+{
+}
+
+//-----------------------------------------------------------------------------
+dax::benchmark::Statistics::Statistics(const std::vector<double> &samples)
+  : Samples(samples), Sorted(samples)
+{
+  std::sort(this->Sorted.begin(), this->Sorted.end());
+}
+
+//-----------------------------------------------------------------------------
+double dax::benchmark::Statistics::GetPercentile(double fraction) const
+{
+  if (this->Sorted.empty()) { return 0; }
+  const double position = fraction*(this->Sorted.size() - 1);
+  const std::size_t below = static_cast<std::size_t>(position);
+  if (below + 1 >= this->Sorted.size()) { return this->Sorted.back(); }
+  const double weight = position - below;
+  return (1 - weight)*this->Sorted[below] + weight*this->Sorted[below + 1];
+}
+
+//-----------------------------------------------------------------------------
+double dax::benchmark::Statistics::GetMinimum() const
+{
+  return this->Sorted.empty() ? 0 : this->Sorted.front();
+}
+
+//-----------------------------------------------------------------------------
+double dax::benchmark::Statistics::GetMaximum() const
+{
+  return this->Sorted.empty() ? 0 : this->Sorted.back();
+}
+
+//-----------------------------------------------------------------------------
+double dax::benchmark::Statistics::GetMean() const
+{
+  if (this->Samples.empty()) { return 0; }
+  double sum = 0;
+  for (std::size_t index = 0; index < this->Samples.size(); ++index)
+    {
+    sum += this->Samples[index];
+    }
+  return sum/this->Samples.size();
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Statistics::WriteJSON(std::ostream &stream) const
+{
+  stream << "{\"median\": " << FormatNumber(this->GetMedian())
+         << ", \"p10\": " << FormatNumber(this->GetPercentile(0.1))
+         << ", \"p90\": " << FormatNumber(this->GetPercentile(0.9))
+         << ", \"min\": " << FormatNumber(this->GetMinimum())
+         << ", \"max\": " << FormatNumber(this->GetMaximum())
+         << ", \"mean\": " << FormatNumber(this->GetMean())
+         << ", \"samples\": [";
+  for (std::size_t index = 0; index < this->Samples.size(); ++index)
+    {
+    stream << ((index > 0) ? ", " : "") << FormatNumber(this->Samples[index]);
+    }
+  stream << "]}";
+}
+
+//-----------------------------------------------------------------------------
+dax::benchmark::Trial::Trial(SynchronizeFunction synchronize,
+                             EnergyMeter *meter)
+  : SynchronizeDevice(synchronize), Meter(meter), StageStart(0)
+{
+  if (this->Meter)
+    {
+    this->DomainEnergies.resize(this->Meter->GetDomainNames().size(), 0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Trial::BeginStage(const std::string &name)
+{
+  this->EndStage();
+  this->CurrentStage = name;
+  dax::cont::MemoryRegistry::GetInstance().BeginStage(name);
+  // The device is idle here, either because the previous stage ended or
+  // because this is the first stage, so the reading starts clean.
+  if (this->Meter)
+    {
+    this->Synchronize();
+    this->ReadEnergy(this->StageStartEnergies);
+    }
+  this->StageStart = CurrentTime();
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Trial::EndStage()
+{
+  if (this->CurrentStage.empty()) { return; }
+  this->Synchronize();
+  this->StageTimes.push_back(
+        std::make_pair(this->CurrentStage, CurrentTime() - this->StageStart));
+
+  // Only the stage just ended is needed, so do not let the registry collect
+  // the stages of every trial.
+  dax::cont::MemoryRegistry &registry =
+      dax::cont::MemoryRegistry::GetInstance();
+  registry.EndStage();
+  if (!registry.GetStages().empty())
+    {
+    this->StageMemory.push_back(
+          std::make_pair(this->CurrentStage,
+                         static_cast<double>(
+                           registry.GetStages().back().GetTotalPeakBytes())
+                         /(1024*1024)));
+    }
+  registry.ClearStages();
+
+  std::vector<double> joules;
+  if (this->ReadEnergy(joules))
+    {
+    double stageEnergy = 0;
+    for (std::size_t domain = 0; domain < joules.size(); ++domain)
+      {
+      const double delta = joules[domain] - this->StageStartEnergies[domain];
+      this->DomainEnergies[domain] += delta;
+      stageEnergy += delta;
+      }
+    this->StageEnergies.push_back(
+          std::make_pair(this->CurrentStage, stageEnergy));
+    }
+  this->CurrentStage.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool dax::benchmark::Trial::ReadEnergy(std::vector<double> &joules)
+{
+  if (!this->Meter) { return false; }
+  if (!this->Meter->Read(joules) ||
+      joules.size() != this->DomainEnergies.size())
+    {
+    // Do not report energies that miss a stage.
+    std::cerr << "Could not read " << this->Meter->GetName() << std::endl;
+    this->Meter = NULL;
+    this->StageEnergies.clear();
+    this->DomainEnergies.clear();
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Trial::SetCounter(const std::string &name, double value)
+{
+  this->Counters.push_back(std::make_pair(name, value));
+}
+
+//-----------------------------------------------------------------------------
+double dax::benchmark::Trial::GetTotalTime() const
+{
+  double total = 0;
+  for (std::size_t index = 0; index < this->StageTimes.size(); ++index)
+    {
+    total += this->StageTimes[index].second;
+    }
+  return total;
+}
+
+//-----------------------------------------------------------------------------
+double dax::benchmark::Trial::GetTotalEnergy() const
+{
+  double total = 0;
+  for (std::size_t index = 0; index < this->StageEnergies.size(); ++index)
+    {
+    total += this->StageEnergies[index].second;
+    }
+  return total;
+}
+
+//-----------------------------------------------------------------------------
+double dax::benchmark::Trial::GetCounter(const std::string &name) const
+{
+  for (std::size_t index = 0; index < this->Counters.size(); ++index)
+    {
+    if (this->Counters[index].first == name)
+      {
+      return this->Counters[index].second;
+      }
+    }
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Trial::Synchronize() const
+{
+  if (this->SynchronizeDevice) { this->SynchronizeDevice(); }
+}
+
+//-----------------------------------------------------------------------------
+dax::benchmark::Harness::Harness(const std::string &benchmarkName,
+                                 const std::string &deviceAdapterName,
+                                 SynchronizeFunction synchronize)
+  : BenchmarkName(benchmarkName),
+    DeviceAdapterName(deviceAdapterName),
+    SynchronizeDevice(synchronize),
+    DefaultSize(128),
+    DefaultIsovalue(3.0f),
+    SlabDepth(0),
+    MemoryBudget(0),
+    NumberOfWarmups(1),
+    NumberOfTrials(5)
+{
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Harness::AddPipeline(int pipeline,
+                                          const std::string &description)
+{
+  this->PipelineDescriptions.push_back(std::make_pair(pipeline, description));
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Harness::PrintUsage() const
+{
+  dax::testing::option::printUsage(std::cout, usage);
+  if (!this->PipelineDescriptions.empty())
+    {
+    std::cout << "\nPipelines of " << this->BenchmarkName << ":\n";
+    for (std::size_t index = 0;
+         index < this->PipelineDescriptions.size();
+         ++index)
+      {
+      std::cout << "  " << this->PipelineDescriptions[index].first << "  "
+                << this->PipelineDescriptions[index].second << "\n";
+      }
+    }
+  std::cout << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+bool dax::benchmark::Harness::ParseArguments(int argc, char *argv[])
+{
+  argc-=(argc>0);
+  argv+=(argc>0); // skip program name argv[0] if present
+
+  dax::testing::option::Stats  stats(usage, argc, argv);
+  std::vector<dax::testing::option::Option> options(stats.options_max);
+  std::vector<dax::testing::option::Option> buffer(stats.options_max);
+  dax::testing::option::Parser parse(usage, argc, argv,
+                                     &options[0], &buffer[0]);
+
+  if (parse.error() || options[HELP] || options[UNKNOWN])
+    {
+    this->PrintUsage();
+    return false;
+    }
+
+  this->Pipelines.clear();
+  if (!this->PipelineDescriptions.empty())
+    {
+    this->Pipelines.push_back(this->PipelineDescriptions[0].first);
+    }
+  this->Sizes = std::vector<dax::Id>(1, this->DefaultSize);
+  this->Isovalues = std::vector<dax::Scalar>(1, this->DefaultIsovalue);
+
+  bool valid = true;
+  if ( options[PIPELINE] )
+    {
+    const std::string sarg(options[PIPELINE].last()->arg);
+    if (sarg == "all")
+      {
+      this->Pipelines.clear();
+      for (std::size_t index = 0;
+           index < this->PipelineDescriptions.size();
+           ++index)
+        {
+        this->Pipelines.push_back(this->PipelineDescriptions[index].first);
+        }
+      }
+    else
+      {
+      valid &= ParseList(sarg, this->Pipelines);
+      for (std::size_t index = 0; valid && index < this->Pipelines.size();
+           ++index)
+        {
+        bool known = this->PipelineDescriptions.empty();
+        for (std::size_t description = 0;
+             description < this->PipelineDescriptions.size();
+             ++description)
+          {
+          known |= (this->PipelineDescriptions[description].first
+                    == this->Pipelines[index]);
+          }
+        if (!known)
+          {
+          std::cerr << "Unknown pipeline " << this->Pipelines[index]
+                    << std::endl;
+          valid = false;
+          }
+        }
+      }
+    }
+
+  if ( options[SIZE] )
+    {
+    valid &= ParseList(options[SIZE].last()->arg, this->Sizes);
+    }
+
+  if ( options[ISOVALUE] )
+    {
+    valid &= ParseList(options[ISOVALUE].last()->arg, this->Isovalues);
+    }
+
+  if ( options[FILENAME] )
+    {
+    this->FileName = options[FILENAME].last()->arg;
+    }
+
+  if ( options[SLABDEPTH] )
+    {
+    std::stringstream argstream(options[SLABDEPTH].last()->arg);
+    argstream >> this->SlabDepth;
+    }
+
+  if ( options[MEMORYBUDGET] )
+    {
+    std::stringstream argstream(options[MEMORYBUDGET].last()->arg);
+    double megabytes = 0;
+    argstream >> megabytes;
+    valid &= (megabytes >= 0);
+    this->MemoryBudget =
+        static_cast<dax::internal::Int64Type>(megabytes*1024*1024);
+    dax::cont::MemoryRegistry::GetInstance().SetDefaultBudget(
+          (this->MemoryBudget > 0) ? this->MemoryBudget : 0);
+    }
+
+  if ( options[WARMUP] )
+    {
+    std::stringstream argstream(options[WARMUP].last()->arg);
+    argstream >> this->NumberOfWarmups;
+    }
+
+  if ( options[TRIALS] )
+    {
+    std::stringstream argstream(options[TRIALS].last()->arg);
+    argstream >> this->NumberOfTrials;
+    valid &= (this->NumberOfTrials > 0);
+    }
+
+  if ( options[JSON] )
+    {
+    this->JSONFileName = options[JSON].last()->arg;
+    }
+
+  if ( options[OUTPUT] )
+    {
+    this->OutputFileName = options[OUTPUT].last()->arg;
+    }
+
+  if ( options[ENERGY] )
+    {
+    const char *specification = options[ENERGY].last()->arg;
+    this->Meter.reset(
+          EnergyMeter::New(specification ? specification : "powercap"));
+    valid &= (this->Meter.get() != NULL);
+    }
+
+  if (!valid)
+    {
+    this->PrintUsage();
+    }
+  return valid;
+}
+
+//-----------------------------------------------------------------------------
+void dax::benchmark::Harness::SetMemoryCounters(Trial &trial)
+{
+  const dax::cont::ScratchArenaStatistics scratch =
+      dax::cont::ScratchArena::GetInstance().GetStatistics();
+  trial.SetCounter("scratch peak MB",
+                   static_cast<double>(scratch.HighWaterMark)/(1024*1024));
+  trial.SetCounter("scratch requests",
+                   static_cast<double>(scratch.NumberOfRequests));
+  trial.SetCounter("scratch reuses",
+                   static_cast<double>(scratch.NumberOfReuses));
+
+  const std::vector<dax::cont::MemorySpaceUsage> usage =
+      dax::cont::MemoryRegistry::GetInstance().GetUsage();
+  for (std::size_t index = 0; index < usage.size(); ++index)
+    {
+    const std::string &name = usage[index].Name;
+    trial.SetCounter(name + " peak MB",
+                     static_cast<double>(usage[index].PeakBytes)/(1024*1024));
+    if (usage[index].Budget > 0)
+      {
+      trial.SetCounter(name + " released MB",
+                       static_cast<double>(usage[index].BytesReleased)
+                       /(1024*1024));
+      trial.SetCounter(name + " spilled MB",
+                       static_cast<double>(usage[index].BytesSpilled)
+                       /(1024*1024));
+      trial.SetCounter(name + " overruns",
+                       static_cast<double>(usage[index].NumberOfOverruns));
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+dax::benchmark::Statistics
+dax::benchmark::Harness::Report(int pipeline,
+                                const Parameters &parameters,
+                                const std::vector<Trial> &trials)
+{
+  // Gather the samples of each stage in the order the stages first ran.
+  std::vector<std::string> stageNames;
+  std::vector<std::vector<double> > stageSamples;
+  std::vector<std::vector<double> > stageEnergySamples;
+  std::vector<std::vector<double> > stageMemorySamples;
+  std::vector<double> totalSamples;
+  for (std::size_t trial = 0; trial < trials.size(); ++trial)
+    {
+    AddStageSamples(trials[trial].GetStageTimes(), stageNames, stageSamples);
+    totalSamples.push_back(trials[trial].GetTotalTime());
+    }
+  stageMemorySamples.resize(stageNames.size());
+  for (std::size_t trial = 0; trial < trials.size(); ++trial)
+    {
+    std::vector<std::string> names = stageNames;
+    AddStageSamples(trials[trial].GetStageMemory(), names, stageMemorySamples);
+    }
+  const Statistics total(totalSamples);
+  const Trial::ValueList counters =
+      trials.empty() ? Trial::ValueList() : trials.back().GetCounters();
+
+  // Trials whose energy meter failed have no energies and are left out.
+  const std::vector<std::string> domainNames = this->Meter
+      ? this->Meter->GetDomainNames() : std::vector<std::string>();
+  std::vector<std::vector<double> > domainSamples(domainNames.size());
+  std::vector<double> energySamples;
+  std::vector<double> energyPerUnitSamples;
+  stageEnergySamples.resize(stageNames.size());
+  for (std::size_t trial = 0; trial < trials.size(); ++trial)
+    {
+    if (trials[trial].GetStageEnergies().empty()) { continue; }
+    std::vector<std::string> names = stageNames;
+    AddStageSamples(trials[trial].GetStageEnergies(),
+                    names,
+                    stageEnergySamples);
+    for (std::size_t domain = 0; domain < domainNames.size(); ++domain)
+      {
+      domainSamples[domain].push_back(
+            trials[trial].GetDomainEnergies()[domain]);
+      }
+    energySamples.push_back(trials[trial].GetTotalEnergy());
+    const double units = trials[trial].GetCounter(this->EnergyCounterName);
+    if (!this->EnergyUnitName.empty() && units > 0)
+      {
+      energyPerUnitSamples.push_back(trials[trial].GetTotalEnergy()/units);
+      }
+    }
+  const bool hasEnergy = !energySamples.empty();
+  const Statistics energy(energySamples);
+  const Statistics energyPerUnit(energyPerUnitSamples);
+
+  std::cout << this->BenchmarkName << " pipeline " << pipeline << " "
+            << parameters.ToString() << ": " << trials.size()
+            << " trials after " << this->NumberOfWarmups << " warmup"
+            << std::endl;
+  std::cout << "  " << std::left << std::setw(24) << "stage" << std::right
+            << std::setw(12) << "median" << std::setw(12) << "p10"
+            << std::setw(12) << "p90" << std::setw(12) << "min"
+            << std::setw(12) << "max" << std::setw(12) << "peak MB";
+  if (hasEnergy) { std::cout << std::setw(12) << "joules"; }
+  std::cout << std::endl;
+  for (std::size_t stage = 0; stage <= stageNames.size(); ++stage)
+    {
+    const bool isTotal = (stage == stageNames.size());
+    const Statistics statistics =
+        isTotal ? total : Statistics(stageSamples[stage]);
+    std::cout << "  " << std::left << std::setw(24)
+              << (isTotal ? std::string("total") : stageNames[stage])
+              << std::right << std::setw(12) << statistics.GetMedian()
+              << std::setw(12) << statistics.GetPercentile(0.1)
+              << std::setw(12) << statistics.GetPercentile(0.9)
+              << std::setw(12) << statistics.GetMinimum()
+              << std::setw(12) << statistics.GetMaximum();
+    if (isTotal)
+      {
+      // The peak of the whole run is the largest peak of its stages.
+      double peak = 0;
+      for (std::size_t index = 0; index < stageNames.size(); ++index)
+        {
+        peak = std::max(peak,
+                        Statistics(stageMemorySamples[index]).GetMaximum());
+        }
+      std::cout << std::setw(12) << peak;
+      }
+    else
+      {
+      std::cout << std::setw(12)
+                << Statistics(stageMemorySamples[stage]).GetMaximum();
+      }
+    if (hasEnergy)
+      {
+      std::cout << std::setw(12) << (isTotal ? energy.GetMedian() :
+        Statistics(stageEnergySamples[stage]).GetMedian());
+      }
+    std::cout << std::endl;
+    }
+  for (std::size_t counter = 0; counter < counters.size(); ++counter)
+    {
+    std::cout << "  " << counters[counter].first << ": "
+              << FormatNumber(counters[counter].second) << std::endl;
+    }
+  if (hasEnergy)
+    {
+    std::cout << "  joules by domain:";
+    for (std::size_t domain = 0; domain < domainNames.size(); ++domain)
+      {
+      std::cout << " " << domainNames[domain] << "="
+                << Statistics(domainSamples[domain]).GetMedian();
+      }
+    std::cout << std::endl;
+    if (!energyPerUnitSamples.empty())
+      {
+      std::cout << "  joules per " << this->EnergyUnitName << ": "
+                << energyPerUnit.GetMedian() << std::endl;
+      }
+    }
+  std::cout << "CSV," << this->DeviceAdapterName << "," << pipeline << ","
+            << total.GetMedian() << std::endl;
+
+  std::stringstream json;
+  json << "    {\"pipeline\": " << pipeline << ",\n"
+       << "     \"parameters\": ";
+  parameters.WriteJSON(json);
+  json << ",\n     \"counters\": {";
+  for (std::size_t counter = 0; counter < counters.size(); ++counter)
+    {
+    json << ((counter > 0) ? ", " : "") << "\""
+         << EscapeJSON(counters[counter].first) << "\": "
+         << FormatNumber(counters[counter].second);
+    }
+  json << "},\n     \"stages\": [";
+  for (std::size_t stage = 0; stage < stageNames.size(); ++stage)
+    {
+    json << ((stage > 0) ? "," : "") << "\n       {\"name\": \""
+         << EscapeJSON(stageNames[stage]) << "\", \"seconds\": ";
+    Statistics(stageSamples[stage]).WriteJSON(json);
+    json << ", \"peak_mb\": ";
+    Statistics(stageMemorySamples[stage]).WriteJSON(json);
+    if (hasEnergy)
+      {
+      json << ", \"joules\": ";
+      Statistics(stageEnergySamples[stage]).WriteJSON(json);
+      }
+    json << "}";
+    }
+  json << "],\n     \"total\": ";
+  total.WriteJSON(json);
+  if (hasEnergy)
+    {
+    json << ",\n     \"joules\": ";
+    energy.WriteJSON(json);
+    json << ",\n     \"domain_joules\": {";
+    for (std::size_t domain = 0; domain < domainNames.size(); ++domain)
+      {
+      json << ((domain > 0) ? ", " : "") << "\""
+           << EscapeJSON(domainNames[domain]) << "\": ";
+      Statistics(domainSamples[domain]).WriteJSON(json);
+      }
+    json << "}";
+    if (!energyPerUnitSamples.empty())
+      {
+      json << ",\n     \"joules_per_unit\": {\"unit\": \""
+           << EscapeJSON(this->EnergyUnitName) << "\", \"joules\": ";
+      energyPerUnit.WriteJSON(json);
+      json << "}";
+      }
+    }
+  json << "}";
+  this->Results.push_back(json.str());
+
+  return total;
+}
+
+//-----------------------------------------------------------------------------
+int dax::benchmark::Harness::Finish()
+{
+  if (this->JSONFileName.empty()) { return 0; }
+
+  std::stringstream json;
+  json << "{\"benchmark\": \"" << EscapeJSON(this->BenchmarkName) << "\",\n"
+       << " \"device_adapter\": \"" << EscapeJSON(this->DeviceAdapterName)
+       << "\",\n"
+       << " \"warmup\": " << this->NumberOfWarmups << ",\n"
+       << " \"trials\": " << this->NumberOfTrials << ",\n";
+  if (this->MemoryBudget > 0)
+    {
+    json << " \"memory_budget_mb\": "
+         << FormatNumber(static_cast<double>(this->MemoryBudget)/(1024*1024))
+         << ",\n";
+    }
+  if (this->Meter)
+    {
+    json << " \"energy_meter\": \"" << EscapeJSON(this->Meter->GetName())
+         << "\",\n";
+    }
+  json << " \"results\": [";
+  for (std::size_t index = 0; index < this->Results.size(); ++index)
+    {
+    json << ((index > 0) ? "," : "") << "\n" << this->Results[index];
+    }
+  json << "\n  ]\n}\n";
+
+  if (this->JSONFileName == "-")
+    {
+    std::cout << json.str();
+    return 0;
+    }
+  std::ofstream file(this->JSONFileName.c_str());
+  file << json.str();
+  if (!file)
+    {
+    std::cerr << "Could not write " << this->JSONFileName << std::endl;
+    return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,284 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_benchmark_Harness_h
+#define __dax_benchmark_Harness_h
+
+#include "EnergyMeter.h"
+
+#include <dax/Types.h>
+#include <dax/cont/MemoryRegistry.h>
+#include <dax/cont/ScratchArena.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dax { namespace benchmark {
+
+/// A function that blocks until the device has finished all of its work.
+/// Every benchmark passes the Synchronize of its device adapter so that stage
+/// times include all of the work of the stage.
+typedef void (*SynchronizeFunction)();
+
+/// \brief The named parameters of one benchmark configuration.
+///
+/// Parameters are reported in the order they are added.
+///
+class Parameters
+{
+public:
+  Parameters &Add(const std::string &name, double value);
+  Parameters &Add(const std::string &name, const std::string &value);
+
+  /// Returns the parameters as "name=value name=value".
+  std::string ToString() const;
+
+  void WriteJSON(std::ostream &stream) const;
+
+private:
+  struct Entry
+  {
+    std::string Name;
+    std::string Value;
+    bool IsNumber;
+  };
+  std::vector<Entry> Entries;
+};
+
+/// \brief Summary statistics of the samples of one stage.
+///
+class Statistics
+{
+public:
+  Statistics();
+  explicit Statistics(const std::vector<double> &samples);
+
+  /// Returns the value below which \p fraction of the samples fall,
+  /// interpolating linearly between samples.
+  double GetPercentile(double fraction) const;
+
+  double GetMedian() const { return this->GetPercentile(0.5); }
+  double GetMinimum() const;
+  double GetMaximum() const;
+  double GetMean() const;
+
+  const std::vector<double> &GetSamples() const { return this->Samples; }
+
+  void WriteJSON(std::ostream &stream) const;
+
+private:
+  std::vector<double> Samples;
+  std::vector<double> Sorted;
+};
+
+/// \brief Times the stages of one run of a benchmark.
+///
+/// A benchmark calls BeginStage before each step it wants reported. Starting
+/// a stage ends the previous one, and both synchronize the device first.
+/// Work done outside of a stage, such as checking results, is not timed.
+/// When given an energy meter, the trial also reads it after synchronizing at
+/// the beginning and end of each stage. Each stage is also a stage of the
+/// dax::cont::MemoryRegistry, which records its peak memory.
+///
+class Trial
+{
+public:
+  explicit Trial(SynchronizeFunction synchronize, EnergyMeter *meter = NULL);
+
+  void BeginStage(const std::string &name);
+  void EndStage();
+
+  /// Records a value describing the output of the run, such as the number
+  /// of cells generated.
+  void SetCounter(const std::string &name, double value);
+
+  typedef std::vector<std::pair<std::string, double> > ValueList;
+
+  const ValueList &GetStageTimes() const { return this->StageTimes; }
+
+  /// The peak MB of each stage, summed over the memory spaces.
+  const ValueList &GetStageMemory() const { return this->StageMemory; }
+  const ValueList &GetCounters() const { return this->Counters; }
+
+  /// The joules of each stage summed over the domains of the energy meter.
+  /// Empty without a meter or if a reading failed.
+  const ValueList &GetStageEnergies() const { return this->StageEnergies; }
+
+  /// The joules of all stages in each domain of the energy meter.
+  const std::vector<double> &GetDomainEnergies() const
+    { return this->DomainEnergies; }
+
+  /// The sum of the times of all stages.
+  double GetTotalTime() const;
+
+  /// The sum of the energies of all stages.
+  double GetTotalEnergy() const;
+
+  /// Returns the value of a counter, or 0 if it was not set.
+  double GetCounter(const std::string &name) const;
+
+private:
+  void Synchronize() const;
+  bool ReadEnergy(std::vector<double> &joules);
+
+  SynchronizeFunction SynchronizeDevice;
+  EnergyMeter *Meter;
+  ValueList StageTimes;
+  ValueList StageMemory;
+  ValueList StageEnergies;
+  ValueList Counters;
+  std::vector<double> DomainEnergies;
+  std::vector<double> StageStartEnergies;
+  std::string CurrentStage;
+  double StageStart;
+};
+
+/// \brief Runs benchmark configurations and reports their timings.
+///
+/// The harness parses the options common to all benchmarks (the pipelines,
+/// problem sizes and isovalues to sweep, the number of warmup and timed
+/// trials, input and output files and JSON output). Each configuration is
+/// run warmup times untimed and then trials times. The median, percentiles
+/// and extremes of every stage and of the total are printed, along with the
+/// legacy "CSV,<adapter>,<pipeline>,<median>" line, and collected for the
+/// JSON report written by Finish.
+///
+/// With --energy the harness also reads an EnergyMeter around every stage
+/// and reports the joules of each stage, of each domain and per unit of the
+/// output named by SetEnergyPerCounter, so that device adapters and thread
+/// counts can be compared by the energy they need for the same result. The
+/// counters of real meters update about every millisecond, which limits the
+/// accuracy for short stages.
+///
+/// Every stage reports its peak memory. With --memory-budget every memory
+/// space gets that budget, and the counters tell how much the budget made
+/// the dax::cont::MemoryRegistry release or spill.
+///
+class Harness
+{
+public:
+  Harness(const std::string &benchmarkName,
+          const std::string &deviceAdapterName,
+          SynchronizeFunction synchronize);
+
+  /// Describes a pipeline for --help. The first pipeline added is the
+  /// default.
+  void AddPipeline(int pipeline, const std::string &description);
+
+  void SetDefaultSize(dax::Id size) { this->DefaultSize = size; }
+  void SetDefaultIsovalue(dax::Scalar value) { this->DefaultIsovalue = value; }
+
+  /// Reports the energy per unit of the counter \p counterName, such as
+  /// "joules per triangle" for the counter "cells out" and the unit
+  /// "triangle".
+  void SetEnergyPerCounter(const std::string &counterName,
+                           const std::string &unitName)
+  {
+    this->EnergyCounterName = counterName;
+    this->EnergyUnitName = unitName;
+  }
+
+  /// Returns false, after printing the usage, if the program should exit.
+  bool ParseArguments(int argc, char *argv[]);
+
+  const std::vector<int> &GetPipelines() const { return this->Pipelines; }
+  const std::vector<dax::Id> &GetSizes() const { return this->Sizes; }
+  const std::vector<dax::Scalar> &GetIsovalues() const
+    { return this->Isovalues; }
+  const std::string &GetFileName() const { return this->FileName; }
+  const std::string &GetOutputFileName() const { return this->OutputFileName; }
+  dax::Id GetSlabDepth() const { return this->SlabDepth; }
+  int GetNumberOfWarmups() const { return this->NumberOfWarmups; }
+  int GetNumberOfTrials() const { return this->NumberOfTrials; }
+  dax::internal::Int64Type GetMemoryBudget() const
+    { return this->MemoryBudget; }
+
+  /// The meter selected by --energy, or NULL.
+  EnergyMeter *GetEnergyMeter() const { return this->Meter.get(); }
+
+  /// Runs \p functor, which is called with a Trial, for one configuration
+  /// and reports it. Returns the statistics of the total time.
+  ///
+  /// The runs share a dax::cont::ScratchArenaScope, as the time steps of a
+  /// simulation loop would, so the timed trials reuse the temporaries the
+  /// warmups allocated. Each trial reports the scratch memory it used and
+  /// the peak of every memory space.
+  template<class Functor>
+  Statistics Run(int pipeline, const Parameters &parameters, Functor &functor)
+  {
+    dax::cont::ScratchArenaScope scratchScope;
+    for (int warmup = 0; warmup < this->NumberOfWarmups; ++warmup)
+      {
+      Trial trial(this->SynchronizeDevice, this->Meter.get());
+      functor(trial);
+      trial.EndStage();
+      }
+
+    std::vector<Trial> trials;
+    for (int index = 0; index < this->NumberOfTrials; ++index)
+      {
+      dax::cont::ScratchArena::GetInstance().ResetHighWaterMark();
+      dax::cont::MemoryRegistry::GetInstance().ResetPeaks();
+      Trial trial(this->SynchronizeDevice, this->Meter.get());
+      functor(trial);
+      trial.EndStage();
+      SetMemoryCounters(trial);
+      trials.push_back(trial);
+      }
+    return this->Report(pipeline, parameters, trials);
+  }
+
+  /// Writes the JSON report if one was requested. Returns the exit code for
+  /// main.
+  int Finish();
+
+private:
+  static void SetMemoryCounters(Trial &trial);
+  Statistics Report(int pipeline,
+                    const Parameters &parameters,
+                    const std::vector<Trial> &trials);
+  void PrintUsage() const;
+
+  std::string BenchmarkName;
+  std::string DeviceAdapterName;
+  SynchronizeFunction SynchronizeDevice;
+  std::vector<std::pair<int, std::string> > PipelineDescriptions;
+  dax::Id DefaultSize;
+  dax::Scalar DefaultIsovalue;
+
+  std::vector<int> Pipelines;
+  std::vector<dax::Id> Sizes;
+  std::vector<dax::Scalar> Isovalues;
+  std::string FileName;
+  std::string OutputFileName;
+  std::string JSONFileName;
+  boost::shared_ptr<EnergyMeter> Meter;
+  std::string EnergyCounterName;
+  std::string EnergyUnitName;
+  dax::Id SlabDepth;
+  dax::internal::Int64Type MemoryBudget;
+  int NumberOfWarmups;
+  int NumberOfTrials;
+
+  std::vector<std::string> Results;
+};
+
+}}
+
+#endif //__dax_benchmark_Harness_h
@@ -14,112 +14,329 @@
 //
 //=============================================================================
 
-#include "ArgumentsParser.h"
+#include "Harness.h"
 
 #include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleTransform.h>
+#include <dax/cont/ClassifyUniformGrid.h>
+#include <dax/cont/DeviceAdapter.h>
 #include <dax/cont/DispatcherGenerateInterpolatedCells.h>
 #include <dax/cont/DispatcherMapCell.h>
-#include <dax/cont/DispatcherMapField.h> 
-#include <dax/cont/Timer.h>
+#include <dax/cont/DispatcherMapField.h>
+#include <dax/cont/MinMaxBrickIndex.h>
 #include <dax/cont/UniformGrid.h>
 #include <dax/cont/UnstructuredGrid.h>
-#include <dax/cont/VectorOperations.h>
+
+#include <dax/io/MarchingCubesOutOfCore.h>
+#include <dax/io/ReaderVolume.h>
+#include <dax/io/WriterUnstructuredGrid.h>
 
 #include <dax/worklet/Magnitude.h>
 #include <dax/worklet/MarchingCubes.h>
 
+#include <cassert>
 #include <iostream>
-#include <vector>
-#include <fstream>
+#include <string>
 
 #define MAKE_STRING2(x) #x
 #define MAKE_STRING1(x) MAKE_STRING2(x)
 #define DEVICE_ADAPTER MAKE_STRING1(DAX_DEFAULT_DEVICE_ADAPTER_TAG)
 
 
-namespace 
+namespace
 {
-dax::Scalar ISOVALUE = 400;
-dax::Scalar GRID_SIZE = 400;
 
-//typedef dax::cont::ArrayHandle<dax::Scalar> ArrayHandleScalar;
+enum PipelineMode
+  {
+  MARCHING_CUBES = 1,
+  MARCHING_CUBES_REMOVE_DUPLICATES = 2,
+  MARCHING_CUBES_WELD_DUPLICATES = 3,
+  MARCHING_CUBES_CACHED_CASES = 4,
+  MARCHING_CUBES_BRICK_INDEX = 5,
+  MARCHING_CUBES_ROW_CLASSIFY = 6
+  };
 
-void PrintResults(int pipeline, double time)
-{
-  std::cout << "Elapsed time: " << time << " seconds." << std::endl;
-  std::cout << "CSV," DEVICE_ADAPTER ","
-            << pipeline << "," << time << std::endl;
-}
+typedef dax::cont::UnstructuredGrid<dax::CellTagTriangle> OutputGridType;
 
-void ReadData(std::vector<dax::Scalar> &buffer)
+void WriteOutput(const OutputGridType &outGrid, const std::string &fileName)
 {
-    assert(sizeof(float) == sizeof(dax::Scalar));
-    
-    FILE *f = fopen("/home/slabasan/Dropbox/DaxDatasets/counts.400.400.400", "rb");
-    assert(f != NULL);
-
-    buffer.resize(GRID_SIZE*GRID_SIZE*GRID_SIZE);
-    fread(&buffer.front(), sizeof(float), GRID_SIZE*GRID_SIZE*GRID_SIZE, f);
-    assert(ferror(f) == 0);
-
-    //SL: Confirming validity of data read in from file
-    //printf("grid size: %lf\n", GRID_SIZE);
-    //std::cout << "buffer: " << buffer.at(0) << std::endl;
-    //std::cout << "buffer: " << buffer.at(1) << std::endl;
-    //std::cout << "buffer: " << buffer.at(2) << std::endl;
-    //std::cout << "buffer: " << buffer.at(3) << std::endl;
-    //std::cout << "buffer: " << buffer.at(4) << std::endl;
-    //std::cout << "buffer: " << buffer.at(5) << std::endl;
-
-    fclose(f);
+  if (!fileName.empty())
+    {
+    dax::io::WriterUnstructuredGrid().Write(outGrid, fileName);
+    }
 }
 
-void RunDAXPipeline(const dax::cont::UniformGrid<> &grid, int pipeline, std::vector<dax::Scalar> &buffer)
+/// Contours a point field with one of the in core pipelines.
+template<class FieldHandleType>
+struct MarchingCubesFunctor
 {
-  std::cout << "Running pipeline " << pipeline << ": Magnitude -> MarchingCubes" << std::endl;
- 
-  dax::cont::UnstructuredGrid<dax::CellTagTriangle> outGrid;
+  MarchingCubesFunctor(const dax::cont::UniformGrid<> &grid,
+                       int pipeline,
+                       const FieldHandleType &inArray,
+                       dax::Scalar isovalue,
+                       const std::string &outputFileName)
+    : Grid(grid),
+      Pipeline(pipeline),
+      InArray(inArray),
+      Isovalue(isovalue),
+      OutputFileName(outputFileName)
+  {
+    assert(grid.GetNumberOfPoints() == inArray.GetNumberOfValues());
+  }
+
+  void operator()(dax::benchmark::Trial &trial) const
+  {
+    OutputGridType outGrid;
+
+    if (this->Pipeline == MARCHING_CUBES_CACHED_CASES ||
+        this->Pipeline == MARCHING_CUBES_BRICK_INDEX ||
+        this->Pipeline == MARCHING_CUBES_ROW_CLASSIFY)
+      {
+      //classify every cell once, keeping its case for the generate step
+      typedef dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType>
+          CaseHandleType;
+      typedef dax::cont::ArrayHandleTransform<dax::Id, CaseHandleType,
+          dax::worklet::MarchingCubesCaseFaceCount> CaseCountHandleType;
+      typedef dax::cont::DispatcherGenerateInterpolatedCells<
+          dax::worklet::MarchingCubesGenerateFromCases,
+          CaseCountHandleType > CaseDispatcherIC;
 
-  dax::cont::ArrayHandle<dax::Scalar> inArray = dax::cont::make_ArrayHandle(buffer);
-  std::cout << "size of input data: " << inArray.GetNumberOfValues() << std::endl;
-  assert(grid.GetNumberOfPoints() == inArray.GetNumberOfValues());
+      CaseHandleType cases;
+      if (this->Pipeline == MARCHING_CUBES_BRICK_INDEX)
+        {
+        //the index only depends on the field, so it can be reused to contour
+        //other isovalues
+        trial.BeginStage("brick index");
+        dax::cont::MinMaxBrickIndex<> brickIndex(this->Grid, this->InArray);
 
-  //dax::cont::ArrayHandle<dax::Scalar> intermediate1;
-  //dax::cont::DispatcherMapField< dax::worklet::Magnitude > magDispatcher;
-  //magDispatcher.Invoke( grid.GetPointCoordinates(), inArray);
+        trial.BeginStage("classify");
+        dax::cont::MarchingCubesClassifyBricks(brickIndex, this->InArray,
+                                               this->Isovalue, cases);
+        }
+      else if (this->Pipeline == MARCHING_CUBES_ROW_CLASSIFY)
+        {
+        trial.BeginStage("classify");
+        dax::worklet::MarchingCubesClassifyRows(this->Grid, this->InArray,
+                                                this->Isovalue, cases);
+        }
+      else
+        {
+        trial.BeginStage("classify");
+        dax::cont::DispatcherMapCell<dax::worklet::MarchingCubesClassify >(
+              dax::worklet::MarchingCubesClassify(this->Isovalue))
+            .Invoke(this->Grid, this->InArray, cases);
+        }
 
-  dax::cont::Timer<> timer;
+      trial.BeginStage("generate");
+      CaseCountHandleType count(cases);
+      CaseDispatcherIC caseDispatcher(
+            count, dax::worklet::MarchingCubesGenerateFromCases(this->Isovalue));
+      caseDispatcher.SetRemoveDuplicatePoints(true);
+      caseDispatcher.Invoke(
+            this->Grid, outGrid, cases,
+            dax::worklet::make_MarchingCubesPointValues(this->InArray));
+      }
+    else
+      {
+      //dispatch marching cubes worklet generate step
+      typedef dax::cont::DispatcherGenerateInterpolatedCells<
+          dax::worklet::MarchingCubesGenerate > DispatcherIC;
+      typedef typename DispatcherIC::CountHandleType  CountHandleType;
 
-  //dispatch marching cubes worklet generate step
-  typedef dax::cont::DispatcherGenerateInterpolatedCells< dax::worklet::MarchingCubesGenerate > DispatcherIC;
-  typedef DispatcherIC::CountHandleType  CountHandleType;
+      //run the first step
+      trial.BeginStage("classify");
+      CountHandleType count; //array handle for the first step count
+      dax::cont::DispatcherMapCell<dax::worklet::MarchingCubesCount >(
+            dax::worklet::MarchingCubesCount(this->Isovalue))
+          .Invoke(this->Grid, this->InArray, count);
 
-  dax::worklet::MarchingCubesCount classifyWorklet(ISOVALUE);
-  dax::worklet::MarchingCubesGenerate generateWorklet(ISOVALUE);
+      //construct the topology generation worklet
+      trial.BeginStage("generate");
+      DispatcherIC icDispatcher(
+            count, dax::worklet::MarchingCubesGenerate(this->Isovalue));
+      icDispatcher.SetRemoveDuplicatePoints(
+            this->Pipeline == MARCHING_CUBES_REMOVE_DUPLICATES ||
+            this->Pipeline == MARCHING_CUBES_WELD_DUPLICATES);
+      if (this->Pipeline == MARCHING_CUBES_WELD_DUPLICATES)
+        {
+        icDispatcher.SetDuplicatePointStrategy(
+              dax::cont::DUPLICATE_POINTS_HASH);
+        }
 
-  //run the first step
-  CountHandleType count; //array handle for the first step count
-  dax::cont::DispatcherMapCell<dax::worklet::MarchingCubesCount > cellDispatcher( classifyWorklet );
-  cellDispatcher.Invoke(grid, inArray, count);
+      //run the second step
+      icDispatcher.Invoke(this->Grid, outGrid, this->InArray);
+      }
+    trial.EndStage();
 
-  //construct the topology generation worklet
-  DispatcherIC icDispatcher(count, generateWorklet );
-  icDispatcher.SetRemoveDuplicatePoints(
-                pipeline == dax::testing::ArgumentsParser::MARCHING_CUBES_REMOVE_DUPLICATES);
+    trial.SetCounter("points out", outGrid.GetNumberOfPoints());
+    trial.SetCounter("cells out", outGrid.GetNumberOfCells());
+    WriteOutput(outGrid, this->OutputFileName);
+  }
 
-  //run the second step
-  icDispatcher.Invoke(grid, outGrid, inArray);
+  const dax::cont::UniformGrid<> &Grid;
+  int Pipeline;
+  FieldHandleType InArray;
+  dax::Scalar Isovalue;
+  std::string OutputFileName;
+};
 
-  double time = timer.GetElapsedTime();
+/// Contours a BOV or raw volume one z slab at a time. Duplicate points are
+/// always merged, including across slab seams.
+struct MarchingCubesOutOfCoreFunctor
+{
+  MarchingCubesOutOfCoreFunctor(const dax::io::ReaderVolume &reader,
+                                dax::Id slabDepth,
+                                dax::Scalar isovalue,
+                                const std::string &outputFileName)
+    : Reader(reader),
+      SlabDepth(slabDepth),
+      Isovalue(isovalue),
+      OutputFileName(outputFileName)
+  {  }
+
+  void operator()(dax::benchmark::Trial &trial) const
+  {
+    trial.BeginStage("contour slabs");
+    dax::io::MarchingCubesOutOfCore<> outOfCore(this->Reader, this->Isovalue);
+    outOfCore.SetSlabDepth(this->SlabDepth);
+    OutputGridType outGrid;
+    outOfCore.Run(outGrid);
+    trial.EndStage();
+
+    trial.SetCounter("slabs", outOfCore.GetNumberOfSlabs());
+    trial.SetCounter("points out", outGrid.GetNumberOfPoints());
+    trial.SetCounter("cells out", outGrid.GetNumberOfCells());
+    WriteOutput(outGrid, this->OutputFileName);
+  }
 
-  std::cout << "isovalue: " << ISOVALUE << std::endl;
-  std::cout << "number of coordinates in: " << grid.GetNumberOfPoints() << std::endl;
-  std::cout << "number of coordinates out: " << outGrid.GetNumberOfPoints() << std::endl;
-  std::cout << "number of cells out: " << outGrid.GetNumberOfCells() << std::endl;
-  PrintResults(pipeline, time);
+  const dax::io::ReaderVolume &Reader;
+  dax::Id SlabDepth;
+  dax::Scalar Isovalue;
+  std::string OutputFileName;
+};
+
+/// Runs every requested pipeline and isovalue on one point field.
+template<class FieldHandleType>
+void RunDAXPipelines(dax::benchmark::Harness &harness,
+                     const dax::cont::UniformGrid<> &grid,
+                     const FieldHandleType &inArray,
+                     dax::benchmark::Parameters parameters)
+{
+  std::cout << "size of input data: " << inArray.GetNumberOfValues()
+            << std::endl;
+  for (std::size_t pipelineIndex = 0;
+       pipelineIndex < harness.GetPipelines().size();
+       ++pipelineIndex)
+    {
+    const int pipeline = harness.GetPipelines()[pipelineIndex];
+    for (std::size_t isoIndex = 0;
+         isoIndex < harness.GetIsovalues().size();
+         ++isoIndex)
+      {
+      const dax::Scalar isovalue = harness.GetIsovalues()[isoIndex];
+      MarchingCubesFunctor<FieldHandleType> functor(
+            grid, pipeline, inArray, isovalue, harness.GetOutputFileName());
+      harness.Run(pipeline,
+                  dax::benchmark::Parameters(parameters)
+                  .Add("isovalue", isovalue),
+                  functor);
+      }
+    }
+}
 
+dax::cont::UniformGrid<> CreateInputStructure(dax::Id dim)
+{
+  dax::cont::UniformGrid<> grid;
+  grid.SetOrigin(dax::make_Vector3(0.0, 0.0, 0.0));
+  grid.SetSpacing(dax::make_Vector3(1.0, 1.0, 1.0));
+  grid.SetExtent(dax::make_Id3(0, 0, 0), dax::make_Id3(dim-1, dim-1, dim-1));
+  return grid;
 }
 
+/// Contours the magnitude of the point coordinates of generated grids, or the
+/// point field of a BOV or raw volume. A file is memory mapped, so the volume
+/// is paged in as the classify step reads it.
+int RunBenchmark(int argc, char* argv[])
+{
+  dax::benchmark::Harness harness(
+        "MarchingCubes",
+        DEVICE_ADAPTER,
+        &dax::cont::DeviceAdapterAlgorithm<
+          DAX_DEFAULT_DEVICE_ADAPTER_TAG>::Synchronize);
+  harness.AddPipeline(MARCHING_CUBES, "MarchingCubes");
+  harness.AddPipeline(MARCHING_CUBES_REMOVE_DUPLICATES,
+                      "MarchingCubes, merging duplicate points by sorting");
+  harness.AddPipeline(MARCHING_CUBES_WELD_DUPLICATES,
+                      "MarchingCubes, welding duplicate points by hashing");
+  harness.AddPipeline(MARCHING_CUBES_CACHED_CASES,
+                      "MarchingCubes from cached cell cases");
+  harness.AddPipeline(MARCHING_CUBES_BRICK_INDEX,
+                      "MarchingCubes from cases classified by a brick index");
+  harness.AddPipeline(MARCHING_CUBES_ROW_CLASSIFY,
+                      "MarchingCubes from cases classified a row at a time");
+  harness.SetDefaultSize(128);
+  harness.SetDefaultIsovalue(3.0f);
+  harness.SetEnergyPerCounter("cells out", "triangle");
+  if (!harness.ParseArguments(argc, argv))
+    {
+    return 1;
+    }
 
-} // Anonymous namespace
+  const std::string &fileName = harness.GetFileName();
+  if (!fileName.empty() && harness.GetSlabDepth() > 0)
+    {
+    std::cout << "Running out of core MarchingCubes on " << fileName
+              << " with slab depth " << harness.GetSlabDepth() << std::endl;
+    dax::io::ReaderVolume reader(fileName);
+    for (std::size_t isoIndex = 0;
+         isoIndex < harness.GetIsovalues().size();
+         ++isoIndex)
+      {
+      const dax::Scalar isovalue = harness.GetIsovalues()[isoIndex];
+      MarchingCubesOutOfCoreFunctor functor(reader,
+                                            harness.GetSlabDepth(),
+                                            isovalue,
+                                            harness.GetOutputFileName());
+      harness.Run(MARCHING_CUBES_REMOVE_DUPLICATES,
+                  dax::benchmark::Parameters()
+                  .Add("file", fileName)
+                  .Add("slab depth", harness.GetSlabDepth())
+                  .Add("isovalue", isovalue),
+                  functor);
+      }
+    }
+  else if (!fileName.empty())
+    {
+    //grid extent, spacing and data layout come from the file's header
+    std::cout << "Mapping " << fileName << "..." << std::endl;
+    dax::io::ReaderVolume reader(fileName);
+    dax::cont::UniformGrid<> grid = reader.GetUniformGrid();
+    const dax::Id3 dims = reader.GetDimensions();
+    std::cout << "volume dimensions: " << dims[0] << " x " << dims[1]
+              << " x " << dims[2] << std::endl;
+
+    RunDAXPipelines(harness, grid, reader.GetPointField<dax::Scalar>(),
+                    dax::benchmark::Parameters().Add("file", fileName));
+    }
+  else
+    {
+    for (std::size_t sizeIndex = 0;
+         sizeIndex < harness.GetSizes().size();
+         ++sizeIndex)
+      {
+      const dax::Id size = harness.GetSizes()[sizeIndex];
+      dax::cont::UniformGrid<> grid = CreateInputStructure(size);
 
+      dax::cont::ArrayHandle<dax::Scalar> magnitude;
+      dax::cont::DispatcherMapField< dax::worklet::Magnitude >().Invoke(
+            grid.GetPointCoordinates(), magnitude);
+
+      RunDAXPipelines(harness, grid, magnitude,
+                      dax::benchmark::Parameters().Add("size", size));
+      }
+    }
+
+  return harness.Finish();
+}
+
+} // Anonymous namespace
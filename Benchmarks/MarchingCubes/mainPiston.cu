@@ -22,7 +22,7 @@
 #endif
 
 #include "PistonPipeline.h"
-#include "ArgumentsParser.h"
+#include "Harness.h"
 
 dax::cont::UniformGrid<> CreateInputStructure(dax::Id dim)
 {
@@ -35,19 +35,21 @@ dax::cont::UniformGrid<> CreateInputStructure(dax::Id dim)
 
 int main(int argc, char* argv[])
   {
-  dax::testing::ArgumentsParser parser;
-  if (!parser.parseArguments(argc, argv))
+  //only the problem size is used, the comparison pipeline is timed by the
+  //pipeline itself
+  dax::benchmark::Harness harness("MarchingCubesPiston", "Piston", NULL);
+  harness.AddPipeline(1, "Piston MarchingCubes");
+  if (!harness.ParseArguments(argc, argv))
     {
     return 1;
     }
 
-  //init grid vars from parser
-  const dax::Id MAX_SIZE = parser.problemSize();
+  //init grid vars from the harness options
+  const dax::Id MAX_SIZE = harness.GetSizes()[0];
 
   dax::cont::UniformGrid<> dgrid = CreateInputStructure(MAX_SIZE);
 
-  int pipeline = parser.pipeline();
-  std::cout << "Pipeline #" << pipeline << std::endl;
+  std::cout << "Pipeline #" << harness.GetPipelines()[0] << std::endl;
 
   RunPISTONPipeline(dgrid);
 
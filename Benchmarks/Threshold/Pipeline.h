@@ -14,27 +14,27 @@
 //
 //=============================================================================
 
-#include <stdio.h>
-#include <iostream>
+#include "Harness.h"
 
 #include <dax/CellTag.h>
 #include <dax/CellTraits.h>
 
 #include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapter.h>
 #include <dax/cont/DispatcherMapField.h>
 #include <dax/cont/DispatcherMapCell.h>
 #include <dax/cont/DispatcherGenerateTopology.h>
-#include <dax/cont/Timer.h>
 #include <dax/cont/UniformGrid.h>
 #include <dax/cont/UnstructuredGrid.h>
 #include <dax/cont/VectorOperations.h>
 
+#include <dax/io/WriterUnstructuredGrid.h>
+
 #include <dax/worklet/Magnitude.h>
 #include <dax/worklet/Threshold.h>
 
-#include <vector>
 #include <iostream>
-#include <fstream>
+#include <string>
 
 #define MAKE_STRING2(x) #x
 #define MAKE_STRING1(x) MAKE_STRING2(x)
@@ -94,121 +94,94 @@ void CheckValues(const dax::cont::ArrayHandle<T,Container,Device> &array)
               array.GetPortalConstControl().GetIteratorEnd());
 }
 
-void PrintResults(int pipeline, double time)
+/// Thresholds the magnitude of the point coordinates of a grid.
+struct ThresholdFunctor
 {
-  std::cout << "Elapsed time: " << time << " seconds." << std::endl;
-  std::cout << "CSV," DEVICE_ADAPTER ","
-            << pipeline << "," << time << std::endl;
-}
+  ThresholdFunctor(const dax::cont::UniformGrid<> &grid,
+                   const dax::cont::ArrayHandle<dax::Scalar> &inArray,
+                   const std::string &outputFileName)
+    : Grid(grid), InArray(inArray), OutputFileName(outputFileName)
+  {  }
 
-template<typename T, typename Stream>
-void PrintContentsToStream(dax::cont::UnstructuredGrid<T>& grid, Stream &stream)
+  void operator()(dax::benchmark::Trial &trial) const
   {
-  const dax::Id num_points(grid.GetNumberOfPoints());
-  const dax::Id num_cells(grid.GetNumberOfCells());
-
-  //dump header
-  stream << "# vtk DataFile Version 3.0"  << std::endl;
-  stream << "vtk output" << std::endl;
-  stream << "ASCII"  << std::endl;
-  stream << "DATASET UNSTRUCTURED_GRID" << std::endl;
-  stream << "POINTS " << num_points << " float" << std::endl;
-
-  std::vector<dax::Vector3> contPoints(num_points);
-  grid.GetPointCoordinates().CopyInto(contPoints.begin());
-
-  for(dax::Id i=0; i < num_points; ++i)
-    {
-    dax::Vector3 coord = contPoints[i];
-    stream << coord[0] << " " << coord[1] << " " << coord[2] << " ";
-    if(i%3==2)
+    dax::cont::UnstructuredGrid<dax::CellTagHexahedron> grid2;
+    dax::cont::ArrayHandle<dax::Scalar> resultHandle;
+
+    typedef dax::worklet::ThresholdTopology ThresholdTopologyType;
+    typedef dax::worklet::ThresholdCount<dax::Scalar> ThresholdCountType;
+
+    trial.BeginStage("classify");
+    dax::cont::ArrayHandle<dax::Id> count;
+    dax::cont::DispatcherMapCell< ThresholdCountType > clasifyDispatcher
+          ( ThresholdCountType(THRESHOLD_MIN,THRESHOLD_MAX) );
+    clasifyDispatcher.Invoke(this->Grid, this->InArray, count);
+
+    trial.BeginStage("generate topology");
+    dax::cont::DispatcherGenerateTopology< ThresholdTopologyType >
+          topoDispatcher(count);
+    topoDispatcher.Invoke(this->Grid,grid2);
+
+    trial.BeginStage("compact point field");
+    topoDispatcher.CompactPointField(this->InArray,resultHandle);
+    trial.EndStage();
+
+    trial.SetCounter("points out", grid2.GetNumberOfPoints());
+    trial.SetCounter("cells out", grid2.GetNumberOfCells());
+    if (!this->OutputFileName.empty())
       {
-      stream << std::endl; //pump new line after each 3rd vector
+      dax::io::WriterUnstructuredGrid().Write(grid2, this->OutputFileName);
       }
-    }
-  if(num_points%3!=0)
-    {
-    stream << std::endl;
-    }
-
-  //print cells
-  enum {NUM_VERTS = dax::CellTraits<T>::NUM_VERTICES};
-  stream << "CELLS " << num_cells << " " << num_cells  * (NUM_VERTS+1) << std::endl;
 
-  std::vector<dax::Id> contTopo(num_cells*NUM_VERTS);
-  grid.GetCellConnections().CopyInto(contTopo.begin());
-
-  dax::Id index=0;
-  for(dax::Id i=0; i < num_cells; ++i,index+=NUM_VERTS)
-    {
-    stream << NUM_VERTS << " ";
-    stream << contTopo[index+0] << " ";
-    stream << contTopo[index+1] << " ";
-    stream << contTopo[index+2] << " ";
-    stream << contTopo[index+3] << " ";
-    stream << contTopo[index+4] << " ";
-    stream << contTopo[index+5] << " ";
-    stream << contTopo[index+6] << " ";
-    stream << contTopo[index+7] << std::endl;
-    }
-  stream << std::endl;
-  stream << "CELL_TYPES " << num_cells << std::endl;
-  for(dax::Id i=0; i < num_cells; ++i)
-    {
-    stream << "12" << std::endl; //11 is voxel && 12 is hexa
-    }
+    CheckValues(resultHandle);
   }
 
-void RunDAXPipeline(const dax::cont::UniformGrid<> &grid)
-{
-  std::cout << "Running pipeline 1: Magnitude -> Threshold" << std::endl;
-
-  dax::cont::UnstructuredGrid<dax::CellTagHexahedron> grid2;
-
-  dax::cont::ArrayHandle<dax::Scalar> intermediate1;
-  dax::cont::ArrayHandle<dax::Scalar> resultHandle;
-
-  dax::cont::DispatcherMapField<dax::worklet::Magnitude>().Invoke(
-        grid.GetPointCoordinates(),
-        intermediate1);
-
-  dax::cont::Timer<> timer;
-
-  typedef dax::worklet::ThresholdTopology ThresholdTopologyType;
-  typedef dax::worklet::ThresholdCount<dax::Scalar> ThresholdCountType;
-
-  dax::cont::ArrayHandle<dax::Id> count;
-  dax::cont::DispatcherMapCell< ThresholdCountType > clasifyDispatcher
-        ( ThresholdCountType(THRESHOLD_MIN,THRESHOLD_MAX) );
-
-  clasifyDispatcher.Invoke(grid, intermediate1, count);
+  const dax::cont::UniformGrid<> &Grid;
+  dax::cont::ArrayHandle<dax::Scalar> InArray;
+  std::string OutputFileName;
+};
 
-  dax::cont::DispatcherGenerateTopology< ThresholdTopologyType >
-        topoDispatcher(count);
-  //topoDispatcher.SetRemoveDuplicatePoints(false);
-  topoDispatcher.Invoke(grid,grid2);
-  topoDispatcher.CompactPointField(intermediate1,resultHandle);
+dax::cont::UniformGrid<> CreateInputStructure(dax::Id dim)
+{
+  dax::cont::UniformGrid<> grid;
+  grid.SetOrigin(dax::make_Vector3(0.0, 0.0, 0.0));
+  grid.SetSpacing(dax::make_Vector3(1.0, 1.0, 1.0));
+  grid.SetExtent(dax::make_Id3(0, 0, 0), dax::make_Id3(dim-1, dim-1, dim-1));
+  return grid;
+}
 
+int RunBenchmark(int argc, char* argv[])
+{
+  dax::benchmark::Harness harness(
+        "Threshold",
+        DEVICE_ADAPTER,
+        &dax::cont::DeviceAdapterAlgorithm<
+          DAX_DEFAULT_DEVICE_ADAPTER_TAG>::Synchronize);
+  harness.AddPipeline(1, "Magnitude -> Threshold");
+  harness.SetDefaultSize(128);
+  harness.SetEnergyPerCounter("cells out", "cell");
+  if (!harness.ParseArguments(argc, argv))
+    {
+    return 1;
+    }
 
-  double time = timer.GetElapsedTime();
-  std::cout << "original GetNumberOfCells: " << grid.GetNumberOfCells() << std::endl;
-  std::cout << "threshold GetNumberOfCells: " << grid2.GetNumberOfCells() << std::endl;
+  for (std::size_t sizeIndex = 0;
+       sizeIndex < harness.GetSizes().size();
+       ++sizeIndex)
+    {
+    const dax::Id size = harness.GetSizes()[sizeIndex];
+    dax::cont::UniformGrid<> grid = CreateInputStructure(size);
 
-  std::cout << "original GetNumberOfPoints: " << grid.GetNumberOfPoints() << std::endl;
-  std::cout << "threshold GetNumberOfPoints: " << grid2.GetNumberOfPoints() << std::endl;
-  PrintResults(1, time);
+    dax::cont::ArrayHandle<dax::Scalar> intermediate1;
+    dax::cont::DispatcherMapField<dax::worklet::Magnitude>().Invoke(
+          grid.GetPointCoordinates(),
+          intermediate1);
 
-  if(time < 0) //rough dump to file, currently disabled
-    {
-    std::ofstream file;
-    file.open ("daxResult.vtk");
-    PrintContentsToStream(grid2,file);
-    file.close();
+    ThresholdFunctor functor(grid, intermediate1, harness.GetOutputFileName());
+    harness.Run(1, dax::benchmark::Parameters().Add("size", size), functor);
     }
 
-  CheckValues(resultHandle);
+  return harness.Finish();
 }
 
-
 } // Anonymous namespace
-
@@ -18,7 +18,7 @@
 #include <vtkImageData.h>
 #include <vtkNew.h>
 
-#include "ArgumentsParser.h"
+#include "Harness.h"
 #include "VTKPipeline.h"
 
 //create a dax and vtk image structure of the same size
@@ -37,20 +37,22 @@ dax::cont::UniformGrid<> CreateStructures(vtkImageData *grid, dax::Id dim)
 
 int main(int argc, char* argv[])
   {
-  dax::testing::ArgumentsParser parser;
-  if (!parser.parseArguments(argc, argv))
+  //only the problem size is used, the comparison pipeline is timed by the
+  //pipeline itself
+  dax::benchmark::Harness harness("ThresholdVTK", "VTK", NULL);
+  harness.AddPipeline(1, "VTK Threshold");
+  if (!harness.ParseArguments(argc, argv))
     {
     return 1;
     }
 
-  //init grid vars from parser
-  const dax::Id MAX_SIZE = parser.problemSize();
+  //init grid vars from the harness options
+  const dax::Id MAX_SIZE = harness.GetSizes()[0];
 
   vtkNew<vtkImageData> grid;
   dax::cont::UniformGrid<> dgrid = CreateStructures(grid.GetPointer(),MAX_SIZE);
 
-  int pipeline = parser.pipeline();
-  std::cout << "Pipeline #" << pipeline << std::endl;
+  std::cout << "Pipeline #" << harness.GetPipelines()[0] << std::endl;
 
   RunVTKPipeline(dgrid, grid.GetPointer());
 
@@ -0,0 +1,222 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#include "Harness.h"
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/DispatcherMapCell.h>
+#include <dax/cont/DispatcherMapField.h>
+#include <dax/cont/UniformGrid.h>
+#include <dax/cont/internal/ScheduleTiles.h>
+
+#include <dax/worklet/CellGradient.h>
+#include <dax/worklet/Magnitude.h>
+#include <dax/worklet/MarchingCubes.h>
+#include <dax/worklet/PointDataToCellData.h>
+#include <dax/worklet/Threshold.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#define MAKE_STRING2(x) #x
+#define MAKE_STRING1(x) MAKE_STRING2(x)
+#define DEVICE_ADAPTER MAKE_STRING1(DAX_DEFAULT_DEVICE_ADAPTER_TAG)
+
+namespace
+{
+
+enum PipelineType
+{
+  MARCHING_CUBES_COUNT = 1,
+  CELL_GRADIENT = 2,
+  POINT_DATA_TO_CELL_DATA = 3,
+  THRESHOLD_COUNT = 4
+};
+
+typedef dax::cont::internal::ScheduleTilingSettings<
+    DAX_DEFAULT_DEVICE_ADAPTER_TAG> TilingSettings;
+
+/// The tilings compared by the benchmark: one row per tile, which is the
+/// plain k/j/i loop split into rows, the default of the device adapter, and a
+/// few brick shapes in both orders.
+std::vector<dax::cont::internal::ScheduleTiling> GetTilings()
+{
+  using dax::cont::internal::ScheduleTiling;
+  const dax::cont::internal::ScheduleTileOrder rowMajor =
+      dax::cont::internal::SCHEDULE_TILE_ORDER_ROW_MAJOR;
+  const dax::cont::internal::ScheduleTileOrder morton =
+      dax::cont::internal::SCHEDULE_TILE_ORDER_MORTON;
+
+  TilingSettings::Reset();
+  std::vector<ScheduleTiling> tilings;
+  tilings.push_back(ScheduleTiling(dax::make_Id3(0, 1, 1), rowMajor));
+  tilings.push_back(TilingSettings::Get());
+  tilings.push_back(ScheduleTiling(dax::make_Id3(0, 16, 16), rowMajor));
+  tilings.push_back(ScheduleTiling(dax::make_Id3(0, 8, 8), rowMajor));
+  tilings.push_back(ScheduleTiling(dax::make_Id3(64, 8, 8), rowMajor));
+  tilings.push_back(ScheduleTiling(dax::make_Id3(64, 8, 8), morton));
+  tilings.push_back(ScheduleTiling(dax::make_Id3(32, 32, 32), rowMajor));
+  tilings.push_back(ScheduleTiling(dax::make_Id3(32, 32, 32), morton));
+  return tilings;
+}
+
+std::string TileShapeString(const dax::cont::internal::ScheduleTiling &tiling)
+{
+  std::stringstream stream;
+  for (int component = 0; component < 3; ++component)
+    {
+    stream << ((component > 0) ? "x" : "");
+    if (tiling.TileShape[component] > 0)
+      {
+      stream << tiling.TileShape[component];
+      }
+    else
+      {
+      stream << "all";
+      }
+    }
+  return stream.str();
+}
+
+typedef dax::worklet::ThresholdCount<dax::Scalar> ThresholdCountType;
+
+/// Runs one cell worklet over the whole grid. The output array is kept
+/// between trials, so only the first (warmup) run allocates it.
+struct CellWorkletFunctor
+{
+  CellWorkletFunctor(const dax::cont::UniformGrid<> &grid,
+                     const dax::cont::ArrayHandle<dax::Scalar> &field,
+                     int pipeline)
+    : Grid(grid), Field(field), Pipeline(pipeline)
+  {  }
+
+  void operator()(dax::benchmark::Trial &trial)
+  {
+    switch (this->Pipeline)
+      {
+      case MARCHING_CUBES_COUNT:
+        trial.BeginStage("MarchingCubesCount");
+        dax::cont::DispatcherMapCell<dax::worklet::MarchingCubesCount>(
+              dax::worklet::MarchingCubesCount(0.5f))
+            .Invoke(this->Grid, this->Field, this->CaseCounts);
+        break;
+      case CELL_GRADIENT:
+        trial.BeginStage("CellGradient");
+        dax::cont::DispatcherMapCell<dax::worklet::CellGradient>()
+            .Invoke(this->Grid, this->Grid.GetPointCoordinates(),
+                    this->Field, this->Gradients);
+        break;
+      case POINT_DATA_TO_CELL_DATA:
+        trial.BeginStage("PointDataToCellData");
+        dax::cont::DispatcherMapCell<dax::worklet::PointDataToCellData>()
+            .Invoke(this->Grid, this->Field, this->CellValues);
+        break;
+      case THRESHOLD_COUNT:
+        trial.BeginStage("ThresholdCount");
+        dax::cont::DispatcherMapCell<ThresholdCountType>(
+              ThresholdCountType(0.25f, 0.75f))
+            .Invoke(this->Grid, this->Field, this->CellCounts);
+        break;
+      }
+    trial.EndStage();
+    trial.SetCounter("cells", this->Grid.GetNumberOfCells());
+  }
+
+  const dax::cont::UniformGrid<> &Grid;
+  const dax::cont::ArrayHandle<dax::Scalar> &Field;
+  int Pipeline;
+  dax::cont::ArrayHandle<dax::Id> CaseCounts;
+  dax::cont::ArrayHandle<dax::Vector3> Gradients;
+  dax::cont::ArrayHandle<dax::Scalar> CellValues;
+  dax::cont::ArrayHandle<dax::Id> CellCounts;
+};
+
+/// Compares the tilings of the 3D schedule of the device adapter on cell
+/// worklets that gather the eight points of each voxel. The point field is
+/// the distance from the center of the grid, scaled to [0,1].
+int RunBenchmark(int argc, char* argv[])
+{
+  dax::benchmark::Harness harness(
+        "TiledSchedule",
+        DEVICE_ADAPTER,
+        &dax::cont::DeviceAdapterAlgorithm<
+          DAX_DEFAULT_DEVICE_ADAPTER_TAG>::Synchronize);
+  harness.AddPipeline(MARCHING_CUBES_COUNT, "MarchingCubesCount");
+  harness.AddPipeline(CELL_GRADIENT, "CellGradient");
+  harness.AddPipeline(POINT_DATA_TO_CELL_DATA, "PointDataToCellData");
+  harness.AddPipeline(THRESHOLD_COUNT, "ThresholdCount");
+  harness.SetDefaultSize(512);
+  if (!harness.ParseArguments(argc, argv))
+    {
+    return 1;
+    }
+
+  const std::vector<dax::cont::internal::ScheduleTiling> tilings =
+      GetTilings();
+
+  for (std::size_t sizeIndex = 0;
+       sizeIndex < harness.GetSizes().size();
+       ++sizeIndex)
+    {
+    const dax::Id size = harness.GetSizes()[sizeIndex];
+    const dax::Scalar spacing = 1.0f/size;
+    dax::cont::UniformGrid<> grid;
+    grid.SetOrigin(dax::make_Vector3(-0.5f, -0.5f, -0.5f));
+    grid.SetSpacing(dax::make_Vector3(spacing, spacing, spacing));
+    grid.SetExtent(dax::make_Id3(0, 0, 0), dax::make_Id3(size, size, size));
+
+    dax::cont::ArrayHandle<dax::Scalar> field;
+    dax::cont::DispatcherMapField<dax::worklet::Magnitude>()
+        .Invoke(grid.GetPointCoordinates(), field);
+
+    for (std::size_t pipelineIndex = 0;
+         pipelineIndex < harness.GetPipelines().size();
+         ++pipelineIndex)
+      {
+      const int pipeline = harness.GetPipelines()[pipelineIndex];
+      CellWorkletFunctor functor(grid, field, pipeline);
+      for (std::size_t tilingIndex = 0;
+           tilingIndex < tilings.size();
+           ++tilingIndex)
+        {
+        const dax::cont::internal::ScheduleTiling &tiling =
+            tilings[tilingIndex];
+        TilingSettings::Set(tiling);
+        const dax::benchmark::Statistics total = harness.Run(
+              pipeline,
+              dax::benchmark::Parameters()
+              .Add("size", size)
+              .Add("tile", TileShapeString(tiling))
+              .Add("order",
+                   (tiling.Order ==
+                    dax::cont::internal::SCHEDULE_TILE_ORDER_MORTON)
+                   ? "morton" : "row-major")
+              .Add("default", (tilingIndex == 1) ? "yes" : "no"),
+              functor);
+        std::cout << "  Mcells/s: "
+                  << grid.GetNumberOfCells()/(1e6*total.GetMedian())
+                  << std::endl;
+        }
+      }
+    }
+  TilingSettings::Reset();
+
+  return harness.Finish();
+}
+
+} // anonymous namespace
@@ -8,40 +8,22 @@
 //  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
 //  PURPOSE.  See the above copyright notice for more information.
 //
-//  Copyright 2012 Sandia Corporation.
+//  Copyright 2013 Sandia Corporation.
 //  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
 //  the U.S. Government retains certain rights in this software.
 //
 //=============================================================================
-#ifndef __argumentsParser_h
-#define __argumentsParser_h
 
-namespace dax { namespace testing {
+#define BOOST_SP_DISABLE_THREADS
 
-class ArgumentsParser
-{
-public:
-  ArgumentsParser();
-  virtual ~ArgumentsParser();
-
-  bool parseArguments(int argc, char* argv[]);
-
-  unsigned int problemSize() const
-    { return this->ProblemSize; }
-
-  enum PipelineMode
-    {
-    MARCHING_CUBES = 1,
-    MARCHING_CUBES_REMOVE_DUPLICATES = 2
-
-    };
-  PipelineMode pipeline() const
-    { return this->Pipeline; }
+//included after defining the device adapter
+#ifndef DAX_DEVICE_ADAPTER
+  #define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_CUDA
+#endif
 
-private:
-  unsigned int ProblemSize;
-  PipelineMode Pipeline;
-};
+#include "Pipeline.h"
 
-}}
-#endif
+int main(int argc, char* argv[])
+{
+  return RunBenchmark(argc, argv);
+}
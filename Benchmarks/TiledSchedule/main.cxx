@@ -8,38 +8,15 @@
 //  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
 //  PURPOSE.  See the above copyright notice for more information.
 //
-//  Copyright 2012 Sandia Corporation.
+//  Copyright 2013 Sandia Corporation.
 //  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
 //  the U.S. Government retains certain rights in this software.
 //
 //=============================================================================
 
-namespace dax { namespace testing {
+#include "Pipeline.h"
 
-class ArgumentsParser
+int main(int argc, char* argv[])
 {
-public:
-  ArgumentsParser();
-  virtual ~ArgumentsParser();
-
-  bool parseArguments(int argc, char* argv[]);
-
-  unsigned int problemSize() const
-    { return this->ProblemSize; }
-
-  enum PipelineMode
-    {
-    CELL_GRADIENT = 1,
-    CELL_GRADIENT_SINE_SQUARE_COS = 2,
-    SINE_SQUARE_COS = 3,
-    TANGLE_SINE_SQUARE_COS = 4
-    };
-  PipelineMode pipeline() const
-    { return this->Pipeline; }
-
-private:
-  unsigned int ProblemSize;
-  PipelineMode Pipeline;
-};
-
-}}
+  return RunBenchmark(argc, argv);
+}
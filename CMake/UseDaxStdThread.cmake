@@ -0,0 +1,90 @@
+##=============================================================================
+##
+##  Copyright (c) Kitware, Inc.
+##  All rights reserved.
+##  See LICENSE.txt for details.
+##
+##  This software is distributed WITHOUT ANY WARRANTY; without even
+##  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+##  PURPOSE.  See the above copyright notice for more information.
+##
+##  Copyright 2013 Sandia Corporation.
+##  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+##  the U.S. Government retains certain rights in this software.
+##
+##=============================================================================
+
+if (Dax_StdThread_initialize_complete)
+  return()
+endif (Dax_StdThread_initialize_complete)
+
+set(Dax_StdThread_FOUND ${Dax_ENABLE_STDTHREAD})
+if (NOT Dax_StdThread_FOUND)
+  message(STATUS "This build of Dax does not include StdThread.")
+endif (NOT Dax_StdThread_FOUND)
+
+# Find the Boost library.
+if (Dax_StdThread_FOUND)
+  if(NOT Boost_FOUND)
+    find_package(BoostHeaders ${Dax_REQUIRED_BOOST_VERSION})
+  endif()
+
+  if (NOT Boost_FOUND)
+    message(STATUS "Boost not found")
+    set(Dax_StdThread_FOUND)
+  endif (NOT Boost_FOUND)
+endif (Dax_StdThread_FOUND)
+
+# std::thread needs C++11 and the platform thread library. Compilers that
+# default to an older standard need the C++11 flag, which is only given to
+# the targets that use the StdThread device adapter (see
+# dax_use_stdthread) so that the rest of Dax keeps its own standard.
+set(Dax_StdThread_COMPILE_FLAGS)
+set(Dax_StdThread_LIBRARIES)
+if (Dax_StdThread_FOUND)
+  find_package(Threads)
+
+  include(CheckCXXSourceCompiles)
+  set(_dax_std_thread_source
+    "#include <thread>\nint main() { std::thread t([]{}); t.join(); return 0; }")
+  set(CMAKE_REQUIRED_LIBRARIES ${CMAKE_THREAD_LIBS_INIT})
+  check_cxx_source_compiles("${_dax_std_thread_source}"
+    Dax_StdThread_COMPILES)
+  if (NOT Dax_StdThread_COMPILES AND CXX11_COMPILER_FLAGS)
+    set(CMAKE_REQUIRED_FLAGS ${CXX11_COMPILER_FLAGS})
+    check_cxx_source_compiles("${_dax_std_thread_source}"
+      Dax_StdThread_COMPILES_WITH_CXX11_FLAGS)
+    unset(CMAKE_REQUIRED_FLAGS)
+    if (Dax_StdThread_COMPILES_WITH_CXX11_FLAGS)
+      set(Dax_StdThread_COMPILE_FLAGS ${CXX11_COMPILER_FLAGS})
+      set(Dax_StdThread_COMPILES TRUE)
+    endif (Dax_StdThread_COMPILES_WITH_CXX11_FLAGS)
+  endif (NOT Dax_StdThread_COMPILES AND CXX11_COMPILER_FLAGS)
+  unset(CMAKE_REQUIRED_LIBRARIES)
+
+  if (NOT Dax_StdThread_COMPILES)
+    message(STATUS "std::thread not available")
+    set(Dax_StdThread_FOUND)
+  endif (NOT Dax_StdThread_COMPILES)
+  set(Dax_StdThread_LIBRARIES ${CMAKE_THREAD_LIBS_INIT})
+endif (Dax_StdThread_FOUND)
+
+# Adds the compile flags and libraries that std::thread needs to a target
+# built with the StdThread device adapter.
+function(dax_use_stdthread target)
+  if (Dax_StdThread_COMPILE_FLAGS)
+    set_property(TARGET ${target}
+      APPEND_STRING PROPERTY COMPILE_FLAGS " ${Dax_StdThread_COMPILE_FLAGS}")
+  endif (Dax_StdThread_COMPILE_FLAGS)
+  target_link_libraries(${target} ${Dax_StdThread_LIBRARIES})
+endfunction(dax_use_stdthread)
+
+# Set up all these dependent packages (if they were all found).
+if (Dax_StdThread_FOUND)
+  include_directories(
+    ${Boost_INCLUDE_DIRS}
+    ${Dax_INCLUDE_DIRS}
+    )
+
+  set(Dax_StdThread_initialize_complete TRUE)
+endif (Dax_StdThread_FOUND)
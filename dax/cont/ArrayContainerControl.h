@@ -19,6 +19,7 @@
 #define DAX_ARRAY_CONTAINER_CONTROL_ERROR      -1
 #define DAX_ARRAY_CONTAINER_CONTROL_UNDEFINED   0
 #define DAX_ARRAY_CONTAINER_CONTROL_BASIC       1
+#define DAX_ARRAY_CONTAINER_CONTROL_ALIGNED     2
 
 #ifndef DAX_ARRAY_CONTAINER_CONTROL
 #define DAX_ARRAY_CONTAINER_CONTROL DAX_ARRAY_CONTAINER_CONTROL_BASIC
@@ -35,8 +36,9 @@ namespace cont {
 /// Rather, this documentation is provided to describe how array containers are
 /// specified. Loading the dax/cont/ArrayContainerControl.h header will set a
 /// default array container. You can specify the default array container by
-/// first setting the DAX_ARRAY_CONTAINER_CONTROL macro.  Currently it can only
-/// be set to DAX_ARRAY_CONTAINER_CONTROL_BASIC.
+/// first setting the DAX_ARRAY_CONTAINER_CONTROL macro.  Currently it can
+/// be set to DAX_ARRAY_CONTAINER_CONTROL_BASIC or
+/// DAX_ARRAY_CONTAINER_CONTROL_ALIGNED.
 ///
 /// User code external to Dax is free to make its own ArrayContainerControlTag.
 /// This is a good way to get Dax to read data directly in and out of arrays
@@ -147,6 +149,12 @@ public:
 #define DAX_DEFAULT_ARRAY_CONTAINER_CONTROL_TAG \
   ::dax::cont::ArrayContainerControlTagBasic
 
+#elif DAX_ARRAY_CONTAINER_CONTROL == DAX_ARRAY_CONTAINER_CONTROL_ALIGNED
+
+#include <dax/cont/ArrayContainerControlAligned.h>
+#define DAX_DEFAULT_ARRAY_CONTAINER_CONTROL_TAG \
+  ::dax::cont::ArrayContainerControlTagAligned
+
 #elif DAX_ARRAY_CONTAINER_CONTROL == DAX_ARRAY_CONTAINER_CONTROL_ERROR
 
 #include <dax/cont/internal/ArrayContainerControlError.h>
@@ -0,0 +1,291 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax__cont__ArrayContainerControlAligned_h
+#define __dax__cont__ArrayContainerControlAligned_h
+
+#include <dax/Types.h>
+#include <dax/cont/ArrayContainerControl.h>
+#include <dax/cont/Assert.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/ErrorControlOutOfMemory.h>
+#include <dax/cont/MemoryRegistry.h>
+#include <dax/cont/internal/ArrayPortalFromIterators.h>
+
+#include <stdlib.h>
+#include <sys/mman.h>
+
+namespace dax {
+namespace cont {
+
+/// A tag for an ArrayContainerControl that aligns its array, can ask the
+/// operating system for huge pages, and lets the threads of a device adapter
+/// first touch the pages of a new array.
+///
+struct ArrayContainerControlTagAligned {  };
+
+/// \brief How arrays of ArrayContainerControlTagAligned are allocated.
+///
+struct ArrayContainerControlAlignment
+{
+  /// The alignment in bytes of every array. It must be a power of two and a
+  /// multiple of the size of a pointer. The default, 64, is a cache line.
+  ///
+  dax::Id Alignment;
+
+  /// Arrays of at least this many bytes are aligned to HugePageSize, padded to
+  /// a whole number of huge pages and advised to be backed by transparent
+  /// huge pages. Zero, the default, never asks for huge pages.
+  ///
+  dax::Id HugePageThreshold;
+
+  /// The size of a huge page in bytes, 2 MB by default.
+  ///
+  dax::Id HugePageSize;
+
+  /// When true, the default, the ArrayManagerExecution of multithreaded device
+  /// adapters touches the pages of a newly allocated output array from the
+  /// threads of the device. Operating systems that place pages on the memory
+  /// of the first thread touching them then put each page near the thread
+  /// that later works on it rather than near the control thread.
+  ///
+  bool FirstTouch;
+
+  DAX_CONT_EXPORT ArrayContainerControlAlignment()
+    : Alignment(64),
+      HugePageThreshold(0),
+      HugePageSize(2*1024*1024),
+      FirstTouch(true) {  }
+};
+
+/// \brief The alignment used by new ArrayContainerControlTagAligned arrays.
+///
+/// Changing the settings does not affect arrays already allocated.
+///
+class ArrayContainerControlAlignedSettings
+{
+public:
+  DAX_CONT_EXPORT static ArrayContainerControlAlignment Get()
+  {
+    return GetReference();
+  }
+
+  DAX_CONT_EXPORT static void Set(const ArrayContainerControlAlignment &value)
+  {
+    if ((value.Alignment < dax::Id(sizeof(void*)))
+        || ((value.Alignment & (value.Alignment - 1)) != 0))
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Array alignment must be a power of two no smaller than a pointer.");
+      }
+    if ((value.HugePageThreshold > 0)
+        && ((value.HugePageSize < value.Alignment)
+            || ((value.HugePageSize & (value.HugePageSize - 1)) != 0)))
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Huge page size must be a power of two no smaller than the "
+            "array alignment.");
+      }
+    GetReference() = value;
+  }
+
+  DAX_CONT_EXPORT static void Reset()
+  {
+    GetReference() = ArrayContainerControlAlignment();
+  }
+
+private:
+  DAX_CONT_EXPORT static ArrayContainerControlAlignment &GetReference()
+  {
+    static ArrayContainerControlAlignment alignment;
+    return alignment;
+  }
+};
+
+namespace internal {
+
+/// An implementation of an ArrayContainerControl object that aligns its
+/// array as given by ArrayContainerControlAlignedSettings.
+///
+/// Like the basic container, this container does \em not construct the
+/// values within the array, so it should only hold basic types and the Dax
+/// Tuple classes.
+///
+template <typename ValueT>
+class ArrayContainerControl<ValueT, dax::cont::ArrayContainerControlTagAligned>
+{
+public:
+  typedef ValueT ValueType;
+  typedef dax::cont::internal::ArrayPortalFromIterators<ValueType*> PortalType;
+  typedef dax::cont::internal::ArrayPortalFromIterators<const ValueType*> PortalConstType;
+
+public:
+
+  ArrayContainerControl()
+    : Array(NULL), NumberOfValues(0), AllocatedSize(0),
+      FirstTouchPending(false) { }
+
+  ~ArrayContainerControl()
+  {
+    this->ReleaseResources();
+  }
+
+  void ReleaseResources()
+  {
+    // Unlike the basic container, check the array rather than the number of
+    // values, which Shrink and Allocate may have set to zero.
+    if (this->Array != NULL)
+      {
+      free(this->Array);
+      ReportFree(this->AllocatedSize);
+      this->Array = NULL;
+      this->NumberOfValues = 0;
+      this->AllocatedSize = 0;
+      this->FirstTouchPending = false;
+      }
+  }
+
+  void Allocate(dax::Id numberOfValues)
+  {
+    if (numberOfValues <= this->AllocatedSize)
+      {
+      this->NumberOfValues = numberOfValues;
+      return;
+      }
+
+    this->ReleaseResources();
+    if (numberOfValues <= 0)
+      {
+      // ReleaseResources should have already set AllocatedSize to 0.
+      DAX_ASSERT_CONT(this->AllocatedSize == 0);
+      return;
+      }
+
+    const ArrayContainerControlAlignment settings =
+        ArrayContainerControlAlignedSettings::Get();
+    const size_t requestedBytes =
+        static_cast<size_t>(numberOfValues) * sizeof(ValueType);
+    const bool hugePages = (settings.HugePageThreshold > 0) &&
+        (requestedBytes >= static_cast<size_t>(settings.HugePageThreshold));
+    const size_t alignment = static_cast<size_t>(
+          hugePages ? settings.HugePageSize : settings.Alignment);
+    const size_t allocatedBytes =
+        ((requestedBytes + alignment - 1) / alignment) * alignment;
+
+    void *memory = NULL;
+    if (posix_memalign(&memory, alignment, allocatedBytes) != 0)
+      {
+      throw dax::cont::ErrorControlOutOfMemory(
+            "Could not allocate aligned control array.");
+      }
+#ifdef MADV_HUGEPAGE
+    if (hugePages)
+      {
+      // Only advice: the array works the same if the system has no huge
+      // pages to give.
+      madvise(memory, allocatedBytes, MADV_HUGEPAGE);
+      }
+#endif
+
+    this->Array = static_cast<ValueType*>(memory);
+    this->AllocatedSize  = static_cast<dax::Id>(
+          allocatedBytes / sizeof(ValueType));
+    this->NumberOfValues = numberOfValues;
+    this->FirstTouchPending = settings.FirstTouch;
+    dax::cont::MemoryRegistry::GetInstance().Allocate(
+          dax::cont::MemoryRegistry::GetControlSpaceName(),
+          static_cast<dax::internal::Int64Type>(allocatedBytes));
+  }
+
+  dax::Id GetNumberOfValues() const
+  {
+    return this->NumberOfValues;
+  }
+
+  void Shrink(dax::Id numberOfValues)
+  {
+    if (numberOfValues > this->GetNumberOfValues())
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Shrink method cannot be used to grow array.");
+      }
+
+    this->NumberOfValues = numberOfValues;
+  }
+
+  PortalType GetPortal()
+  {
+    return PortalType(this->Array, this->Array + this->NumberOfValues);
+  }
+
+  PortalConstType GetPortalConst() const
+  {
+    return PortalConstType(this->Array, this->Array + this->NumberOfValues);
+  }
+
+  /// True when the array was allocated since the last call to
+  /// SetFirstTouched and the settings asked for a parallel first touch.
+  ///
+  bool GetFirstTouchPending() const
+  {
+    return this->FirstTouchPending;
+  }
+
+  void SetFirstTouched()
+  {
+    this->FirstTouchPending = false;
+  }
+
+  /// \brief Take the reference away from this object.
+  ///
+  /// Same as the basic container, except that the returned array must be
+  /// released with \c free.
+  ///
+  ValueType *StealArray()
+  {
+    ValueType *saveArray =  this->Array;
+    ReportFree(this->AllocatedSize);
+    this->Array = NULL;
+    this->NumberOfValues = 0;
+    this->AllocatedSize = 0;
+    this->FirstTouchPending = false;
+    return saveArray;
+  }
+
+private:
+  // Not implemented.
+  ArrayContainerControl(const ArrayContainerControl<ValueType, ArrayContainerControlTagAligned> &src);
+  void operator=(const ArrayContainerControl<ValueType, ArrayContainerControlTagAligned> &src);
+
+  static void ReportFree(dax::Id numberOfValues)
+  {
+    dax::cont::MemoryRegistry::GetInstance().Free(
+          dax::cont::MemoryRegistry::GetControlSpaceName(),
+          static_cast<dax::internal::Int64Type>(numberOfValues)
+          * static_cast<dax::internal::Int64Type>(sizeof(ValueType)));
+  }
+
+  ValueType *Array;
+  dax::Id NumberOfValues;
+  dax::Id AllocatedSize;
+  bool FirstTouchPending;
+};
+
+} // namespace internal
+
+}
+} // namespace dax::cont
+
+#endif //__dax__cont__ArrayContainerControlAligned_h
@@ -21,6 +21,7 @@
 #include <dax/cont/Assert.h>
 #include <dax/cont/ErrorControlBadValue.h>
 #include <dax/cont/ErrorControlOutOfMemory.h>
+#include <dax/cont/MemoryRegistry.h>
 #include <dax/cont/internal/ArrayPortalFromIterators.h>
 
 namespace dax {
@@ -73,6 +74,7 @@ public:
       DAX_ASSERT_CONT(this->Array != NULL);
       AllocatorType allocator;
       allocator.deallocate(this->Array, this->AllocatedSize);
+      ReportFree(this->AllocatedSize);
       this->Array = NULL;
       this->NumberOfValues = 0;
       this->AllocatedSize = 0;
@@ -100,6 +102,10 @@ public:
         this->Array = allocator.allocate(numberOfValues);
         this->AllocatedSize  = numberOfValues;
         this->NumberOfValues = numberOfValues;
+        dax::cont::MemoryRegistry::GetInstance().Allocate(
+              dax::cont::MemoryRegistry::GetControlSpaceName(),
+              static_cast<dax::internal::Int64Type>(numberOfValues)
+              * static_cast<dax::internal::Int64Type>(sizeof(ValueType)));
         }
       else
         {
@@ -156,6 +162,8 @@ public:
   ValueType *StealArray()
   {
     ValueType *saveArray =  this->Array;
+    // The caller owns the memory from now on, so it is no longer counted.
+    ReportFree(this->AllocatedSize);
     this->Array = NULL;
     this->NumberOfValues = 0;
     this->AllocatedSize = 0;
@@ -167,6 +175,14 @@ private:
   ArrayContainerControl(const ArrayContainerControl<ValueType, ArrayContainerControlTagBasic> &src);
   void operator=(const ArrayContainerControl<ValueType, ArrayContainerControlTagBasic> &src);
 
+  static void ReportFree(dax::Id numberOfValues)
+  {
+    dax::cont::MemoryRegistry::GetInstance().Free(
+          dax::cont::MemoryRegistry::GetControlSpaceName(),
+          static_cast<dax::internal::Int64Type>(numberOfValues)
+          * static_cast<dax::internal::Int64Type>(sizeof(ValueType)));
+  }
+
   ValueType *Array;
   dax::Id NumberOfValues;
   dax::Id AllocatedSize;
@@ -0,0 +1,157 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax__cont__ArrayContainerControlScratch_h
+#define __dax__cont__ArrayContainerControlScratch_h
+
+#include <dax/Types.h>
+#include <dax/cont/ArrayContainerControl.h>
+#include <dax/cont/Assert.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/ScratchArena.h>
+#include <dax/cont/internal/ArrayPortalFromIterators.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace dax {
+namespace cont {
+
+/// A tag for an ArrayContainerControl that draws its array from the
+/// ScratchArena. Dispatchers and device adapter algorithms use it for their
+/// temporary arrays.
+///
+struct ArrayContainerControlTagScratch {  };
+
+namespace internal {
+
+/// An implementation of an ArrayContainerControl object that allocates its
+/// array from dax::cont::ScratchArena. Releasing the array gives it back to
+/// the arena, which keeps it for the next temporary while a
+/// ScratchArenaScope exists.
+///
+/// Like the basic container, this container does \em not construct the
+/// values within the array, so it should only hold basic types and the Dax
+/// Tuple classes.
+///
+template <typename ValueT>
+class ArrayContainerControl<ValueT, dax::cont::ArrayContainerControlTagScratch>
+{
+public:
+  typedef ValueT ValueType;
+  typedef dax::cont::internal::ArrayPortalFromIterators<ValueType*> PortalType;
+  typedef dax::cont::internal::ArrayPortalFromIterators<const ValueType*> PortalConstType;
+
+public:
+
+  ArrayContainerControl()
+    : Array(NULL), NumberOfValues(0), AllocatedSize(0), BlockBytes(0) { }
+
+  ~ArrayContainerControl()
+  {
+    this->ReleaseResources();
+  }
+
+  void ReleaseResources()
+  {
+    if (this->Array != NULL)
+      {
+      dax::cont::ScratchArena::GetInstance().Free(this->Array,
+                                                  this->BlockBytes);
+      this->Array = NULL;
+      this->NumberOfValues = 0;
+      this->AllocatedSize = 0;
+      this->BlockBytes = 0;
+      }
+  }
+
+  void Allocate(dax::Id numberOfValues)
+  {
+    if (numberOfValues <= this->AllocatedSize)
+      {
+      this->NumberOfValues = numberOfValues;
+      return;
+      }
+
+    this->ReleaseResources();
+    if (numberOfValues <= 0)
+      {
+      // ReleaseResources should have already set AllocatedSize to 0.
+      DAX_ASSERT_CONT(this->AllocatedSize == 0);
+      return;
+      }
+
+    // The arena throws ErrorControlOutOfMemory and leaves this container
+    // empty if it cannot allocate.
+    dax::internal::Int64Type blockBytes;
+    void *block = dax::cont::ScratchArena::GetInstance().Allocate(
+          static_cast<dax::internal::Int64Type>(numberOfValues)
+          * static_cast<dax::internal::Int64Type>(sizeof(ValueType)),
+          blockBytes);
+
+    this->Array = static_cast<ValueType*>(block);
+    this->BlockBytes = blockBytes;
+    // The block may hold more values than a dax::Id can count.
+    this->AllocatedSize = static_cast<dax::Id>(
+          std::min(blockBytes
+                   / static_cast<dax::internal::Int64Type>(sizeof(ValueType)),
+                   static_cast<dax::internal::Int64Type>(
+                     std::numeric_limits<dax::Id>::max())));
+    this->NumberOfValues = numberOfValues;
+  }
+
+  dax::Id GetNumberOfValues() const
+  {
+    return this->NumberOfValues;
+  }
+
+  void Shrink(dax::Id numberOfValues)
+  {
+    if (numberOfValues > this->GetNumberOfValues())
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Shrink method cannot be used to grow array.");
+      }
+
+    this->NumberOfValues = numberOfValues;
+  }
+
+  PortalType GetPortal()
+  {
+    return PortalType(this->Array, this->Array + this->NumberOfValues);
+  }
+
+  PortalConstType GetPortalConst() const
+  {
+    return PortalConstType(this->Array, this->Array + this->NumberOfValues);
+  }
+
+private:
+  // Not implemented.
+  ArrayContainerControl(const ArrayContainerControl<ValueType, ArrayContainerControlTagScratch> &src);
+  void operator=(const ArrayContainerControl<ValueType, ArrayContainerControlTagScratch> &src);
+
+  ValueType *Array;
+  dax::Id NumberOfValues;
+  dax::Id AllocatedSize;
+  dax::internal::Int64Type BlockBytes;
+};
+
+} // namespace internal
+
+}
+} // namespace dax::cont
+
+#endif //__dax__cont__ArrayContainerControlScratch_h
@@ -21,6 +21,8 @@
 #include <dax/cont/ArrayContainerControl.h>
 #include <dax/cont/Assert.h>
 #include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/MemoryRegistry.h>
+#include <dax/cont/Tracing.h>
 #include <dax/cont/internal/ArrayTransfer.h>
 #include <dax/cont/internal/DeviceAdapterTag.h>
 
@@ -176,6 +178,8 @@ public:
     BOOST_CONCEPT_ASSERT((boost::ForwardIterator<IteratorType>));
     if (this->Internals->ExecutionArrayValid)
       {
+      DAX_TRACE_SCOPE("transfer", "CopyInto", this->GetNumberOfValues(),
+                      dax::cont::internal::GetTraceBytes(*this));
       this->Internals->ExecutionArray.CopyInto(dest);
       }
     else
@@ -236,6 +240,7 @@ public:
       this->Internals->ExecutionArray.ReleaseResources();
       this->Internals->ExecutionArrayValid = false;
       }
+    this->Internals->UnpinExecutionArray();
   }
 
   /// Releases all resources in both the control and execution environments.
@@ -270,12 +275,18 @@ public:
     else if (this->Internals->UserPortalValid)
       {
       DAX_ASSERT_CONT(!this->Internals->ControlArrayValid);
+      DAX_TRACE_SCOPE("transfer", "PrepareForInput",
+                      this->GetNumberOfValues(),
+                      dax::cont::internal::GetTraceBytes(*this));
       this->Internals->ExecutionArray.LoadDataForInput(
             this->Internals->UserPortal);
       this->Internals->ExecutionArrayValid = true;
       }
     else if (this->Internals->ControlArrayValid)
       {
+      DAX_TRACE_SCOPE("transfer", "PrepareForInput",
+                      this->GetNumberOfValues(),
+                      dax::cont::internal::GetTraceBytes(*this));
       this->Internals->ExecutionArray.LoadDataForInput(
             this->Internals->ControlArray.GetPortalConst());
       this->Internals->ExecutionArrayValid = true;
@@ -285,6 +296,7 @@ public:
       throw dax::cont::ErrorControlBadValue(
             "ArrayHandle has no data when PrepareForInput called.");
       }
+    this->Internals->TouchExecutionArray();
     return this->Internals->ExecutionArray.GetPortalConstExecution();
   }
 
@@ -304,6 +316,10 @@ public:
     this->Internals->UserPortalValid = false;
     this->Internals->ControlArrayValid = false;
 
+    // Bytes counts the memory allocated, nothing is copied.
+    DAX_TRACE_SCOPE("transfer", "PrepareForOutput", numberOfValues,
+                    static_cast<dax::internal::Int64Type>(numberOfValues)
+                    * static_cast<dax::internal::Int64Type>(sizeof(T)));
     this->Internals->ExecutionArray.AllocateArrayForOutput(
           this->Internals->ControlArray, numberOfValues);
 
@@ -317,6 +333,7 @@ public:
     // returned from this method, so you would have to work to invalidate this
     // assumption anyway.)
     this->Internals->ExecutionArrayValid = true;
+    this->Internals->TouchExecutionArray();
 
     return this->Internals->ExecutionArray.GetPortalExecution();
   }
@@ -347,6 +364,9 @@ public:
       }
     else if (this->Internals->ControlArrayValid)
       {
+      DAX_TRACE_SCOPE("transfer", "PrepareForInPlace",
+                      this->GetNumberOfValues(),
+                      dax::cont::internal::GetTraceBytes(*this));
       this->Internals->ExecutionArray.LoadDataForInPlace(
             this->Internals->ControlArray.GetPortal());
       this->Internals->ExecutionArrayValid = true;
@@ -361,6 +381,7 @@ public:
     // the execution data is overwritten. Don't actually release the control
     // array. It may be shared as the execution array.
     this->Internals->ControlArrayValid = false;
+    this->Internals->TouchExecutionArray();
 
     return this->Internals->ExecutionArray.GetPortalExecution();
   }
@@ -383,7 +404,13 @@ protected:
   }
 
 private:
-  struct InternalStruct {
+  typedef dax::cont::internal::ArrayManagerExecutionMemorySpace<
+      DeviceAdapterTag> MemorySpaceType;
+
+  // The MemoryRegistry may drop the execution array of a device with separate
+  // memory when that memory is over its budget, so the state of the array is
+  // also an ExecutionArrayCache.
+  struct InternalStruct : public dax::cont::internal::ExecutionArrayCache {
     PortalConstControl UserPortal;
     bool UserPortalValid;
 
@@ -392,6 +419,37 @@ private:
 
     ArrayTransferType ExecutionArray;
     bool ExecutionArrayValid;
+
+    InternalStruct()
+      : dax::cont::internal::ExecutionArrayCache(
+          MemorySpaceType::GetName(), MemorySpaceType::IS_SEPARATE) {  }
+
+    virtual bool HasExecutionArray() const
+    {
+      return this->ExecutionArrayValid;
+    }
+
+    virtual bool HasControlArray() const
+    {
+      return this->UserPortalValid || this->ControlArrayValid;
+    }
+
+    virtual void ReleaseExecutionArray()
+    {
+      if (!this->ExecutionArrayValid) { return; }
+      if (!this->HasControlArray())
+        {
+        DAX_TRACE_SCOPE("transfer", "SpillExecutionArray",
+                        this->ExecutionArray.GetNumberOfValues(),
+                        static_cast<dax::internal::Int64Type>(
+                          this->ExecutionArray.GetNumberOfValues())
+                        * static_cast<dax::internal::Int64Type>(sizeof(T)));
+        this->ExecutionArray.RetrieveOutputData(this->ControlArray);
+        this->ControlArrayValid = true;
+        }
+      this->ExecutionArray.ReleaseResources();
+      this->ExecutionArrayValid = false;
+    }
   };
 
   /// Synchronizes the control array with the execution array. If either the
@@ -409,6 +467,11 @@ private:
       // an external point of view.
       InternalStruct *internals
           = const_cast<InternalStruct*>(this->Internals.get());
+      DAX_TRACE_SCOPE("transfer", "SyncControlArray",
+                      internals->ExecutionArray.GetNumberOfValues(),
+                      static_cast<dax::internal::Int64Type>(
+                        internals->ExecutionArray.GetNumberOfValues())
+                      * static_cast<dax::internal::Int64Type>(sizeof(T)));
       internals->ExecutionArray.RetrieveOutputData(internals->ControlArray);
       internals->ControlArrayValid = true;
       }
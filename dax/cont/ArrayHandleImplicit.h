@@ -18,6 +18,7 @@
 
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/ArrayContainerControlImplicit.h>
+#include <dax/cont/ArrayPortal.h>
 #include <dax/cont/internal/IteratorFromArrayPortal.h>
 
 namespace dax {
@@ -81,6 +82,11 @@ private:
 
 /// A convenience class that provides a typedef to the appropriate tag for
 /// a implicit array container.
+template<typename ValueType, typename FunctorType>
+struct ArrayPortalComputesValues<
+    dax::cont::internal::ArrayPortalImplicit<ValueType, FunctorType> >
+    : boost::true_type {  };
+
 template<typename ValueType, typename FunctorType>
 struct ArrayHandleImplicitTraits
 {
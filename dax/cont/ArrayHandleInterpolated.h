@@ -0,0 +1,103 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_ArrayHandleInterpolated_h
+#define __dax_cont_ArrayHandleInterpolated_h
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/internal/ArrayContainerControlInterpolated.h>
+
+namespace dax {
+namespace cont {
+
+/// ArrayHandleInterpolated is a specialization of ArrayHandle.
+/// It takes the interpolation edges and ratios of the points made by
+/// dax::cont::DispatcherGenerateInterpolatedCells along with a point field of
+/// the input grid, and makes a new handle whose value at each index is the
+/// field interpolated along that point's edge. Nothing is interpolated until
+/// a value is read, and only the values read are computed.
+///
+template <class FieldHandleType,
+          class EdgeHandleType,
+          class RatioHandleType,
+          class DeviceAdapterTag = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+class ArrayHandleInterpolated
+    : public dax::cont::ArrayHandle <
+          typename FieldHandleType::ValueType,
+          typename internal::ArrayHandleInterpolatedTraits<
+                                          typename FieldHandleType::ValueType,
+                                          EdgeHandleType,
+                                          RatioHandleType,
+                                          FieldHandleType>::Tag,
+          DeviceAdapterTag >
+{
+private:
+  typedef typename FieldHandleType::ValueType ValueType;
+  typedef typename internal::ArrayHandleInterpolatedTraits<ValueType,
+                                EdgeHandleType,
+                                RatioHandleType,
+                                FieldHandleType> ArrayTraits;
+
+  typedef typename ArrayTraits::Tag Tag;
+
+ public:
+  typedef dax::cont::ArrayHandle < ValueType,
+                                   Tag,
+                                   DeviceAdapterTag > Superclass;
+
+  ArrayHandleInterpolated()
+    : Superclass( )
+  {
+  }
+
+  ArrayHandleInterpolated(const EdgeHandleType& edges,
+                          const RatioHandleType& ratios,
+                          const FieldHandleType& field)
+    : Superclass( typename Superclass::PortalConstControl(edges,
+                                                          ratios,
+                                                          field) )
+  {
+  }
+
+};
+
+/// make_ArrayHandleInterpolated is convenience function to generate an
+/// ArrayHandleInterpolated. It takes in the interpolation edges and ratios
+/// of the output points and the point field to interpolate.
+
+template <typename FieldHandleType,
+          typename EdgeHandleType,
+          typename RatioHandleType>
+DAX_CONT_EXPORT
+dax::cont::ArrayHandleInterpolated<FieldHandleType,
+                                   EdgeHandleType,
+                                   RatioHandleType,
+                                   typename FieldHandleType::DeviceAdapterTag>
+make_ArrayHandleInterpolated(EdgeHandleType edges,
+                             RatioHandleType ratios,
+                             FieldHandleType field)
+{
+  return ArrayHandleInterpolated<FieldHandleType,
+                                 EdgeHandleType,
+                                 RatioHandleType,
+                                 typename FieldHandleType::DeviceAdapterTag>(
+        edges, ratios, field);
+}
+
+
+}
+} // namespace dax::cont
+
+#endif //__dax_cont_ArrayHandleInterpolated_h
@@ -18,6 +18,8 @@
 
 #include <dax/Types.h>
 
+#include <boost/type_traits/integral_constant.hpp>
+
 namespace dax {
 namespace cont {
 
@@ -97,6 +99,19 @@ public:
 
 #endif // DAX_DOXYGEN_ONLY
 
+namespace internal {
+
+/// Whether \c Get of an ArrayPortal computes each value rather than loading
+/// it, as the implicit arrays do. Code in the execution environment may keep
+/// the values of such portals around to avoid computing them again, which
+/// does not pay when they are simply loaded from memory. False unless a
+/// portal specializes it.
+///
+template<typename PortalType>
+struct ArrayPortalComputesValues : boost::false_type {  };
+
+} // namespace internal
+
 }
 } // namespace dax::cont
 
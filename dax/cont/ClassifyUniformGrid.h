@@ -0,0 +1,77 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_ClassifyUniformGrid_h
+#define __dax_cont_ClassifyUniformGrid_h
+
+#include <dax/Types.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/MinMaxBrickIndex.h>
+
+#include <dax/worklet/MarchingCubes.h>
+
+namespace dax {
+namespace cont {
+
+/// Computes the same cases as dax::worklet::MarchingCubesClassify for a uniform grid, one
+/// brick of \p brickIndex at a time. The cells of bricks that the isovalue
+/// does not cut get case 0, or 255 when the whole brick is above the
+/// isovalue, without loading any point value, so only the bricks near the
+/// isosurface are read. \p brickIndex must have been built for \p field on
+/// the same grid, and can be reused for any number of isovalues.
+template<class DeviceAdapterTag, class FieldContainer, class CaseContainer>
+DAX_CONT_EXPORT void MarchingCubesClassifyBricks(
+    dax::cont::MinMaxBrickIndex<DeviceAdapterTag> &brickIndex,
+    const dax::cont::ArrayHandle<dax::Scalar,FieldContainer,DeviceAdapterTag>
+        &field,
+    dax::Scalar isoValue,
+    dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType,
+                           CaseContainer,DeviceAdapterTag> &cases)
+{
+  typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
+  typedef dax::cont::ArrayHandle<dax::Scalar,FieldContainer,DeviceAdapterTag>
+      FieldHandleType;
+  typedef dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType,
+                                 CaseContainer,DeviceAdapterTag>
+      CaseHandleType;
+  typedef typename dax::cont::MinMaxBrickIndex<DeviceAdapterTag>::
+      BrickMaskArrayType::PortalConstExecution MaskPortalType;
+  typedef dax::worklet::internal::marchingcubes::ClassifyBrick<
+      typename FieldHandleType::PortalConstExecution,
+      MaskPortalType,
+      typename CaseHandleType::PortalExecution> ClassifyType;
+
+  const dax::Id3 &cellDims = brickIndex.GetCellDimensions();
+  const dax::Id numCells = cellDims[0] * cellDims[1] * cellDims[2];
+  if (field.GetNumberOfValues() !=
+      (cellDims[0] + 1) * (cellDims[1] + 1) * (cellDims[2] + 1))
+    {
+    throw dax::cont::ErrorControlBadValue(
+          "The field does not match the grid of the brick index.");
+    }
+
+  ClassifyType classify(field.PrepareForInput(),
+                        brickIndex.PrepareForIsoValue(isoValue),
+                        cases.PrepareForOutput(numCells),
+                        isoValue);
+  Algorithm::Schedule(classify, brickIndex.GetNumberOfBricks());
+}
+
+}
+} // namespace dax::cont
+
+#endif //__dax_cont_ClassifyUniformGrid_h
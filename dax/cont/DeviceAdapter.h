@@ -50,6 +50,10 @@ namespace cont {
 /// threads using the Intel Threading Building Blocks (TBB) libraries. Must
 /// have the TBB headers available and the resulting code must be linked with
 /// the TBB libraries.
+/// \li \c DAX_DEVICE_ADAPTER_STDTHREAD Dispatches and runs algorithms on a
+/// work-stealing pool of C++11 std::thread workers. Needs only the standard
+/// library, but the resulting code must be linked with the platform thread
+/// library.
 ///
 /// See the ArrayManagerExecution.h and DeviceAdapterAlgorithm.h files for
 /// documentation on all the functions and classes that must be
@@ -18,56 +18,83 @@
 
 #include <dax/Types.h>
 
+#include <dax/cont/ArrayContainerControlScratch.h>
+#include <dax/cont/ArrayHandleInterpolated.h>
+#include <dax/cont/ErrorControlBadValue.h>
 #include <dax/cont/dispatcher/DispatcherBase.h>
 #include <dax/cont/internal/DeviceAdapterTag.h>
+#include <dax/cont/internal/InterpolatedCellsContainer.h>
 #include <dax/exec/WorkletInterpolatedCell.h>
 #include <dax/internal/ParameterPack.h>
 
 #include <dax/math/Compare.h>
 #include <dax/cont/dispatcher/AddVisitIndexArg.h>
+#include <dax/exec/internal/InterpolationEdge.h>
 #include <dax/exec/internal/kernel/GenerateWorklets.h>
 
 namespace dax { namespace cont {
 
+/// Selects how \c DispatcherGenerateInterpolatedCells merges output points
+/// that were interpolated from the same input edge.
+enum DuplicatePointStrategy {
+  /// Sort the interpolation edges, remove duplicates, and find every
+  /// point with a binary search. The points are ordered by their edges.
+  DUPLICATE_POINTS_SORT,
+  /// Weld the points with a hash table keyed on their edge, in linear
+  /// time. The points keep the order in which they were first generated.
+  DUPLICATE_POINTS_HASH
+};
 
+/// \c IndexType_ is the integer type of the intermediate arrays that map
+/// output cells back to input cells, as in DispatcherGenerateTopology.
+///
 template <
   class WorkletType_,
   class CountHandleType_ = dax::cont::ArrayHandle< dax::Id >,
-  class DeviceAdapterTag_ = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+  class DeviceAdapterTag_ = DAX_DEFAULT_DEVICE_ADAPTER_TAG,
+  class IndexType_ = dax::Id>
 class DispatcherGenerateInterpolatedCells :
   public dax::cont::dispatcher::DispatcherBase<
-          DispatcherGenerateInterpolatedCells< WorkletType_, CountHandleType_, DeviceAdapterTag_ >,
+          DispatcherGenerateInterpolatedCells< WorkletType_, CountHandleType_,
+                                               DeviceAdapterTag_, IndexType_ >,
           dax::exec::WorkletInterpolatedCell,
           WorkletType_,
           DeviceAdapterTag_ >
 {
 
-  typedef dax::cont::dispatcher::DispatcherBase< DispatcherGenerateInterpolatedCells< WorkletType_, CountHandleType_,  DeviceAdapterTag_>,
+  typedef dax::cont::dispatcher::DispatcherBase< DispatcherGenerateInterpolatedCells< WorkletType_, CountHandleType_,  DeviceAdapterTag_, IndexType_>,
                                                  dax::exec::WorkletInterpolatedCell,
                                                  WorkletType_,
                                                  DeviceAdapterTag_> Superclass;
-  friend class dax::cont::dispatcher::DispatcherBase< DispatcherGenerateInterpolatedCells< WorkletType_, CountHandleType_, DeviceAdapterTag_>,
+  friend class dax::cont::dispatcher::DispatcherBase< DispatcherGenerateInterpolatedCells< WorkletType_, CountHandleType_, DeviceAdapterTag_, IndexType_>,
                                                  dax::exec::WorkletInterpolatedCell,
                                                  WorkletType_,
                                                  DeviceAdapterTag_>;
 
-  typedef dax::cont::ArrayHandle< dax::Vector3,
+public:
+  typedef dax::cont::ArrayHandle< dax::exec::internal::InterpolationEdgeType,
+                  dax::cont::ArrayContainerControlTagBasic,
+                  DeviceAdapterTag_ >  InterpolationEdgesType;
+  typedef dax::cont::ArrayHandle< dax::Scalar,
                   dax::cont::ArrayContainerControlTagBasic,
-                  DeviceAdapterTag_ >  InterpolationWeightsType;
+                  DeviceAdapterTag_ >  InterpolationRatiosType;
 
-public:
   typedef WorkletType_ WorkletType;
   typedef CountHandleType_ CountHandleType;
   typedef DeviceAdapterTag_ DeviceAdapterTag;
+  typedef IndexType_ IndexType;
 
 
   DAX_CONT_EXPORT
   DispatcherGenerateInterpolatedCells(const CountHandleType &count):
     Superclass( WorkletType() ),
     RemoveDuplicatePoints(true),
+    DuplicateStrategy(DUPLICATE_POINTS_SORT),
+    MaterializePointCoordinates(true),
     ReleaseCount(true),
     Count(count),
-    InterpolationWeights()
+    InterpolationEdges(),
+    InterpolationRatios()
     { }
 
   DAX_CONT_EXPORT
@@ -75,9 +102,12 @@ public:
                             const WorkletType& work):
     Superclass( work ),
     RemoveDuplicatePoints(true),
+    DuplicateStrategy(DUPLICATE_POINTS_SORT),
+    MaterializePointCoordinates(true),
     ReleaseCount(true),
     Count(count),
-    InterpolationWeights()
+    InterpolationEdges(),
+    InterpolationRatios()
     { }
 
 
@@ -103,6 +133,81 @@ public:
   bool GetRemoveDuplicatePoints() const
     { return RemoveDuplicatePoints; }
 
+  /// How duplicate points are merged when RemoveDuplicatePoints is on.
+  DAX_CONT_EXPORT
+  void SetDuplicatePointStrategy(DuplicatePointStrategy strategy)
+    { DuplicateStrategy = strategy; }
+
+  DAX_CONT_EXPORT
+  DuplicatePointStrategy GetDuplicatePointStrategy() const
+    { return DuplicateStrategy; }
+
+  /// When on, the default, Invoke computes the point coordinates of the
+  /// output grid. When off, the output grid is left without coordinates,
+  /// which saves storing them when they are only needed for some of the
+  /// points, and GetInterpolatedPointField gives them on demand from the
+  /// coordinates of the input grid.
+  ///
+  /// The number of points of an UnstructuredGrid is the number of its
+  /// coordinates, so without coordinates the output grid reports no points
+  /// even though its cell connections refer to them. Such a grid can be used
+  /// for its topology, but not where its points are counted, such as the
+  /// domain of a point worklet. Use GetNumberOfPoints of the dispatcher for
+  /// the number of points instead.
+  DAX_CONT_EXPORT
+  void SetMaterializePointCoordinates(bool b)
+    { MaterializePointCoordinates = b; }
+
+  DAX_CONT_EXPORT
+  bool GetMaterializePointCoordinates() const
+    { return MaterializePointCoordinates; }
+
+
+  /// After Invoke, the number of points of the output grid, whether or not
+  /// their coordinates were materialized.
+  DAX_CONT_EXPORT
+  dax::Id GetNumberOfPoints() const
+    { return InterpolationEdges.GetNumberOfValues(); }
+
+  /// After Invoke, holds the edge (see dax::exec::internal::
+  /// MakeInterpolationEdge) of each point of the output grid, in the same
+  /// order as the output point coordinates. The point ids index the input
+  /// grid.
+  DAX_CONT_EXPORT
+  InterpolationEdgesType GetInterpolationEdges() const
+    { return InterpolationEdges; }
+
+  /// After Invoke, holds the ratio along its edge of each point of the
+  /// output grid.
+  DAX_CONT_EXPORT
+  InterpolationRatiosType GetInterpolationRatios() const
+    { return InterpolationRatios; }
+
+  /// The type of the array GetInterpolatedPointField returns for a field
+  /// of type \c FieldHandleType.
+  template<typename FieldHandleType>
+  struct InterpolatedPointFieldType
+  {
+    typedef dax::cont::ArrayHandleInterpolated<FieldHandleType,
+                                               InterpolationEdgesType,
+                                               InterpolationRatiosType,
+                                               DeviceAdapterTag> type;
+  };
+
+  /// After Invoke, an implicit array of \p input, a point field of the
+  /// input grid, interpolated to the points of the output grid. Each value
+  /// is interpolated from the interpolation edges and ratios when it is
+  /// read, so unlike CompactPointField nothing is computed or stored up
+  /// front. The array keeps using the edges and ratios of this Invoke even
+  /// after the dispatcher is invoked again.
+  template<typename FieldHandleType>
+  DAX_CONT_EXPORT
+  typename InterpolatedPointFieldType<FieldHandleType>::type
+  GetInterpolatedPointField(const FieldHandleType &input) const
+    {
+    return typename InterpolatedPointFieldType<FieldHandleType>::type(
+          this->InterpolationEdges, this->InterpolationRatios, input);
+    }
 
   template<typename T, typename Container1,
            typename Container2, typename DeviceAdapter>
@@ -115,26 +220,32 @@ public:
                                         Algorithm;
     typedef typename dax::cont::ArrayHandle<T,Container1,DeviceAdapter>::
                                         PortalConstExecution InPortalType;
-    typedef typename InterpolationWeightsType::
-                                        PortalConstExecution InterpPortalType;
+    typedef typename InterpolationEdgesType::
+                                        PortalConstExecution EdgePortalType;
+    typedef typename InterpolationRatiosType::
+                                        PortalConstExecution RatioPortalType;
     typedef typename dax::cont::ArrayHandle<T,Container2,DeviceAdapter>::
                                         PortalExecution OutPortalType;
 
-    const dax::Id size = this->InterpolationWeights.GetNumberOfValues();
-    dax::exec::internal::kernel::InterpolateFieldToField<InterpPortalType,
+    const dax::Id size = this->InterpolationEdges.GetNumberOfValues();
+    dax::exec::internal::kernel::InterpolateFieldToField<EdgePortalType,
+                                                         RatioPortalType,
                                                          InPortalType,
                                                          OutPortalType>
-        interpolate( InterpolationWeights.PrepareForInput(),
+        interpolate( InterpolationEdges.PrepareForInput(),
+                     InterpolationRatios.PrepareForInput(),
                      input.PrepareForInput(),
                      output.PrepareForOutput(size));
 
     Algorithm::Schedule(interpolate, size);
 
-    //after each time we interpolate we unload the interpolation weights
+    //after each time we interpolate we unload the interpolation edges
     //from the execution env so that we don't hold reserve exec memory
     //longer than needed
-    this->InterpolationWeights.GetPortalControl(); //copy to cont
-    this->InterpolationWeights.ReleaseResourcesExecution();
+    this->InterpolationEdges.GetPortalControl(); //copy to cont
+    this->InterpolationEdges.ReleaseResourcesExecution();
+    this->InterpolationRatios.GetPortalControl();
+    this->InterpolationRatios.ReleaseResourcesExecution();
 
     return true;
     }
@@ -165,8 +276,24 @@ private:
   {
     typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>
         Algorithm;
-    typedef dax::cont::ArrayHandle<dax::Id, ArrayContainerControlTagBasic,
+    typedef dax::cont::ArrayHandle<dax::Id, ArrayContainerControlTagScratch,
         DeviceAdapterTag> IdArrayHandleType;
+    typedef dax::cont::ArrayHandle<IndexType, ArrayContainerControlTagScratch,
+        DeviceAdapterTag> IndexArrayHandleType;
+
+    //the interpolation edges pack the ids of the input points, so refuse
+    //grids whose ids would not fit rather than merge the wrong points
+    if(!dax::exec::internal::InterpolationEdgeCanHold(
+         inputGrid.GetNumberOfPoints()))
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Input grid has too many points for interpolation edges.");
+      }
+
+    //start from new edge and ratio arrays, so that the interpolated point
+    //fields handed out after the last Invoke keep their values
+    this->InterpolationEdges = InterpolationEdgesType();
+    this->InterpolationRatios = InterpolationRatiosType();
 
     //do an inclusive scan of the cell count / cell mask to get the number
     //of cells in the output
@@ -188,9 +315,11 @@ private:
 
     //now do the uppper bounds of the cell indices so that we figure out
     //which original topology indexs match the new indices.
-    IdArrayHandleType validCellRange;
+    IndexArrayHandleType validCellRange;
     Algorithm::UpperBounds(scannedNewCellCounts,
-                   dax::cont::make_ArrayHandleCounting(dax::Id(0),numNewCells),
+                   dax::cont::make_ArrayHandleCounting(dax::Id(0),
+                                                       numNewCells,
+                                                       DeviceAdapterTag()),
                    validCellRange);
 
     // We are done with scannedNewCellCounts.
@@ -206,7 +335,7 @@ private:
     //The AddVisitIndexArg does all this, plus creates a derived worklet
     //from the users worklet with the visit index added to the signature.
     typedef dax::cont::dispatcher::AddVisitIndexArg<WorkletType,
-      Algorithm,IdArrayHandleType> AddVisitIndexFunctor;
+      Algorithm,IndexArrayHandleType> AddVisitIndexFunctor;
     typedef typename AddVisitIndexFunctor::VisitIndexArgType IndexArgType;
     typedef typename AddVisitIndexFunctor::DerivedWorkletType DerivedWorkletType;
 
@@ -214,26 +343,28 @@ private:
     AddVisitIndexFunctor createVisitIndex;
     createVisitIndex(validCellRange,visitIndex);
 
-    //make fake indicies so that the worklet can write out the interpolated
-    //cell points information as geometry
+    //every generated cell starts out with its own points, numbered in
+    //order, until duplicate points are merged
     outputGrid.GetCellConnections().PrepareForOutput(
        numNewCells * dax::CellTraits<typename OutputGrid::CellTag>::NUM_VERTICES);
     dax::cont::DispatcherMapField< dax::exec::internal::kernel::Index >()
                                       .Invoke(outputGrid.GetCellConnections());
 
-    //Next step is to set the dispatcher to fill the output geometry
-    //with the interpolated cell values. We use the outputGrid,
-    //since a vec3 is what the interpolated cell values and the outputGrids
-    //coordinate space are
-
     //we get our magic here. we need to wrap some parameters and pass
-    //them to the real dispatcher
+    //them to the real dispatcher. The output grid is replaced with the
+    //interpolation edges and ratios, which the worklet fills in for every
+    //point of the generated cells.
     DerivedWorkletType derivedWorklet(worklet);
 
     this->BasicInvoke( derivedWorklet,
           arguments.template Replace<1>(
             dax::cont::make_Permutation(validCellRange,inputGrid,
                                         inputGrid.GetNumberOfCells()))
+          .template Replace<2>(
+            dax::cont::internal::make_InterpolatedCells(
+              outputGrid,
+              this->InterpolationEdges,
+              this->InterpolationRatios))
           .Append(visitIndex));
 
     //now that the interpolated grid is filled we now have to properly
@@ -255,42 +386,146 @@ private:
     typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>
         Algorithm;
 
-    //we have stored the interpolation weights inside the output grid coordinates
-    //which in the future needs to be changed. So store a copy of them
-    //into our own array handle
-    Algorithm::Copy(outputGrid.GetPointCoordinates(),
-                    this->InterpolationWeights);
+    typedef typename InterpolationRatiosType::PortalExecution RatioPortalType;
+
+    //the worklet stored the edge and ratio of each point of the generated
+    //cells, in the same order as the cell connections
+    const dax::Id numPoints = this->InterpolationEdges.GetNumberOfValues();
+    DAX_TRACE_SCOPE("dispatcher", "ResolveCoordinates", numPoints, 0);
 
-    if(removeDuplicates)
+    if(removeDuplicates &&
+       this->GetDuplicatePointStrategy() == DUPLICATE_POINTS_HASH)
+      {
+      this->WeldDuplicatePoints(outputGrid);
+      }
+    else if(removeDuplicates)
       {
       // the sort and unique will get us the subset of new points
-      // the lower bounds on the subset and the original coords, will produce
+      // the lower bounds on the subset and the original edges, will produce
       // the resulting topology array
-
-      dax::math::SortLess comparisonFunctor;
-
-      Algorithm::Sort(this->InterpolationWeights, comparisonFunctor );
-      Algorithm::Unique(this->InterpolationWeights);
-      Algorithm::LowerBounds(this->InterpolationWeights,
-                             outputGrid.GetPointCoordinates(),
-                             outputGrid.GetCellConnections(),
-                             comparisonFunctor );
-
-      //reduce and resize outputGrid
-      Algorithm::Copy(this->InterpolationWeights,
-                      outputGrid.GetPointCoordinates());
+      InterpolationEdgesType uniqueEdges;
+      Algorithm::Copy(this->InterpolationEdges, uniqueEdges);
+      Algorithm::Sort(uniqueEdges);
+      Algorithm::Unique(uniqueEdges);
+      Algorithm::LowerBounds(uniqueEdges,
+                             this->InterpolationEdges,
+                             outputGrid.GetCellConnections());
+
+      //move each ratio to the point its edge was merged into
+      typedef typename OutputGrid::CellConnectionsType::PortalConstExecution
+          ConnectionPortalType;
+      typedef typename InterpolationRatiosType::PortalConstExecution
+          RatioConstPortalType;
+      InterpolationRatiosType uniqueRatios;
+      dax::exec::internal::kernel::ScatterInterpolationRatios<
+          ConnectionPortalType, RatioConstPortalType, RatioPortalType>
+          scatter(outputGrid.GetCellConnections().PrepareForInput(),
+                  this->InterpolationRatios.PrepareForInput(),
+                  uniqueRatios.PrepareForOutput(
+                    uniqueEdges.GetNumberOfValues()));
+      Algorithm::Schedule(scatter, numPoints);
+
+      this->InterpolationEdges = uniqueEdges;
+      this->InterpolationRatios = uniqueRatios;
       }
 
-    this->CompactPointField(inputGrid.GetPointCoordinates(),
-                            outputGrid.GetPointCoordinates());
+    if(this->GetMaterializePointCoordinates())
+      {
+      this->CompactPointField(inputGrid.GetPointCoordinates(),
+                              outputGrid.GetPointCoordinates());
+      }
+    else
+      {
+      outputGrid.GetPointCoordinates().ReleaseResources();
+      }
   }
 
 
+  //merge duplicate points with a hash table keyed on the edge each point
+  //was interpolated from. Each point's first occurrence is kept, so the
+  //resulting topology does not depend on the device adapter.
+  template <typename OutputGrid>
+  DAX_CONT_EXPORT void WeldDuplicatePoints(OutputGrid& outputGrid)
+  {
+    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>
+        Algorithm;
+    typedef dax::exec::internal::kernel::detail::EdgeHashKeyType KeyType;
+    typedef dax::cont::ArrayHandle<KeyType, ArrayContainerControlTagScratch,
+        DeviceAdapterTag> KeyArrayHandleType;
+    typedef dax::cont::ArrayHandle<dax::Id, ArrayContainerControlTagScratch,
+        DeviceAdapterTag> IdArrayHandleType;
+    typedef typename IdArrayHandleType::PortalExecution IdPortalType;
+    typedef typename IdArrayHandleType::PortalConstExecution IdConstPortalType;
+    typedef typename InterpolationEdgesType::PortalConstExecution
+        EdgePortalType;
+    typedef typename OutputGrid::CellConnectionsType::PortalExecution
+        ConnectionPortalType;
+
+    const dax::Id numPoints = this->InterpolationEdges.GetNumberOfValues();
+    DAX_TRACE_SCOPE("dispatcher", "WeldDuplicatePoints", numPoints, 0);
+
+    //a power of two at least twice the number of points keeps the probe
+    //sequences short
+    dax::Id capacity = 2;
+    while (capacity < 2*numPoints) { capacity *= 2; }
+
+    KeyArrayHandleType hashKeys;
+    IdArrayHandleType hashOwners;
+    KeyType *keys = &(*hashKeys.PrepareForOutput(capacity).GetIteratorBegin());
+    dax::Id *owners =
+        &(*hashOwners.PrepareForOutput(capacity).GetIteratorBegin());
+
+    Algorithm::Schedule(
+          dax::exec::internal::kernel::EdgeHashClear(keys, owners, numPoints),
+          capacity);
+
+    IdArrayHandleType slots;
+    dax::exec::internal::kernel::EdgeHashInsert<EdgePortalType, IdPortalType>
+        insert(this->InterpolationEdges.PrepareForInput(),
+               slots.PrepareForOutput(numPoints),
+               keys, owners, capacity - 1);
+    Algorithm::Schedule(insert, numPoints);
+    hashKeys.ReleaseResources();
+
+    IdArrayHandleType ownerFlags;
+    dax::exec::internal::kernel::EdgeHashMarkOwners<IdConstPortalType,
+                                                    IdPortalType>
+        markOwners(slots.PrepareForInput(), owners,
+                   ownerFlags.PrepareForOutput(numPoints));
+    Algorithm::Schedule(markOwners, numPoints);
+
+    //the unique points in order of first occurrence
+    InterpolationEdgesType uniqueEdges;
+    InterpolationRatiosType uniqueRatios;
+    Algorithm::StreamCompact(this->InterpolationEdges, ownerFlags, uniqueEdges);
+    Algorithm::StreamCompact(this->InterpolationRatios, ownerFlags,
+                             uniqueRatios);
+    this->InterpolationEdges = uniqueEdges;
+    this->InterpolationRatios = uniqueRatios;
+
+    //number the unique points, then point every connection at the number
+    //of the first occurrence of its edge
+    IdArrayHandleType newIds;
+    Algorithm::ScanExclusive(ownerFlags, newIds);
+    ownerFlags.ReleaseResources();
+
+    const dax::Id numConnections =
+        outputGrid.GetCellConnections().GetNumberOfValues();
+    dax::exec::internal::kernel::EdgeHashResolveConnections<
+        IdConstPortalType, IdConstPortalType, ConnectionPortalType>
+        resolve(slots.PrepareForInput(), owners, newIds.PrepareForInput(),
+                outputGrid.GetCellConnections().PrepareForInPlace());
+    Algorithm::Schedule(resolve, numConnections);
+  }
+
   bool RemoveDuplicatePoints;
+  DuplicatePointStrategy DuplicateStrategy;
+  bool MaterializePointCoordinates;
   bool ReleaseCount;
   CountHandleType Count;
 
-  InterpolationWeightsType InterpolationWeights;
+  InterpolationEdgesType InterpolationEdges;
+  InterpolationRatiosType InterpolationRatios;
 
 };
 
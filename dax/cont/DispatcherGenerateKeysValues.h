@@ -17,6 +17,7 @@
 #define __dax_cont_DispatcherGenerateKeysValues_h
 
 #include <dax/Types.h>
+#include <dax/cont/ArrayContainerControlScratch.h>
 #include <dax/cont/dispatcher/DispatcherBase.h>
 #include <dax/cont/internal/DeviceAdapterTag.h>
 #include <dax/exec/WorkletGenerateKeysValues.h>
@@ -104,7 +105,7 @@ DAX_CONT_EXPORT void InvokeGenerateKeysValues(
     const ParameterPackType &arguments)
   {
   typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
-  typedef dax::cont::ArrayHandle<dax::Id, ArrayContainerControlTagBasic,
+  typedef dax::cont::ArrayHandle<dax::Id, ArrayContainerControlTagScratch,
       DeviceAdapterTag> IdArrayHandleType;
 
   //do an inclusive scan of the cell count / cell mask to get the number
@@ -129,7 +130,9 @@ DAX_CONT_EXPORT void InvokeGenerateKeysValues(
   //now do the lower bounds of the cell indices so that we figure out
   IdArrayHandleType outputIndexRanges;
   Algorithm::UpperBounds(scannedOutputCounts,
-                 dax::cont::make_ArrayHandleCounting(dax::Id(0),numNewValues),
+                 dax::cont::make_ArrayHandleCounting(dax::Id(0),
+                                                     numNewValues,
+                                                     DeviceAdapterTag()),
                  outputIndexRanges);
 
   // We are done with scannedOutputCounts.
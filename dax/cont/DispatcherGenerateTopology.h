@@ -18,6 +18,7 @@
 
 #include <dax/Types.h>
 
+#include <dax/cont/ArrayContainerControlScratch.h>
 #include <dax/cont/dispatcher/DispatcherBase.h>
 #include <dax/cont/internal/DeviceAdapterTag.h>
 #include <dax/exec/WorkletGenerateTopology.h>
@@ -29,23 +30,30 @@
 namespace dax { namespace cont {
 
 
+/// \c IndexType_ is the integer type of the intermediate arrays that map
+/// output cells back to input cells. It can be narrower than dax::Id (for
+/// example dax::internal::Int32Type in a 64-bit id build) when the number of
+/// output cells fits, which halves the memory traffic of those arrays.
+///
 template <
   class WorkletType_,
   class CountHandleType_ = dax::cont::ArrayHandle< dax::Id >,
-  class DeviceAdapterTag_ = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+  class DeviceAdapterTag_ = DAX_DEFAULT_DEVICE_ADAPTER_TAG,
+  class IndexType_ = dax::Id>
 class DispatcherGenerateTopology :
   public dax::cont::dispatcher::DispatcherBase<
-          DispatcherGenerateTopology< WorkletType_, CountHandleType_, DeviceAdapterTag_ >,
+          DispatcherGenerateTopology< WorkletType_, CountHandleType_,
+                                      DeviceAdapterTag_, IndexType_ >,
           dax::exec::WorkletGenerateTopology,
           WorkletType_,
           DeviceAdapterTag_ >
 {
 
-  typedef dax::cont::dispatcher::DispatcherBase< DispatcherGenerateTopology< WorkletType_, CountHandleType_,  DeviceAdapterTag_>,
+  typedef dax::cont::dispatcher::DispatcherBase< DispatcherGenerateTopology< WorkletType_, CountHandleType_,  DeviceAdapterTag_, IndexType_>,
                                                  dax::exec::WorkletGenerateTopology,
                                                  WorkletType_,
                                                  DeviceAdapterTag_> Superclass;
-  friend class dax::cont::dispatcher::DispatcherBase< DispatcherGenerateTopology< WorkletType_, CountHandleType_, DeviceAdapterTag_>,
+  friend class dax::cont::dispatcher::DispatcherBase< DispatcherGenerateTopology< WorkletType_, CountHandleType_, DeviceAdapterTag_, IndexType_>,
                                                  dax::exec::WorkletGenerateTopology,
                                                  WorkletType_,
                                                  DeviceAdapterTag_>;
@@ -54,9 +62,10 @@ public:
   typedef WorkletType_ WorkletType;
   typedef CountHandleType_ CountHandleType;
   typedef DeviceAdapterTag_ DeviceAdapterTag;
+  typedef IndexType_ IndexType;
 
   typedef dax::cont::ArrayHandle< dax::Id,
-            dax::cont::ArrayContainerControlTagBasic,
+            dax::cont::ArrayContainerControlTagScratch,
             DeviceAdapterTag> PointMaskType;
 
   DAX_CONT_EXPORT
@@ -136,8 +145,10 @@ private:
   {
     typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>
         Algorithm;
-    typedef dax::cont::ArrayHandle<dax::Id, ArrayContainerControlTagBasic,
+    typedef dax::cont::ArrayHandle<dax::Id, ArrayContainerControlTagScratch,
         DeviceAdapterTag> IdArrayHandleType;
+    typedef dax::cont::ArrayHandle<IndexType, ArrayContainerControlTagScratch,
+        DeviceAdapterTag> IndexArrayHandleType;
 
     //do an inclusive scan of the cell count / cell mask to get the number
     //of cells in the output
@@ -159,9 +170,11 @@ private:
 
     //now do the lower bounds of the cell indices so that we figure out
     //which original topology indexs match the new indices.
-    IdArrayHandleType validCellRange;
+    IndexArrayHandleType validCellRange;
     Algorithm::UpperBounds(scannedNewCellCounts,
-                   dax::cont::make_ArrayHandleCounting(dax::Id(0),numNewCells),
+                   dax::cont::make_ArrayHandleCounting(dax::Id(0),
+                                                       numNewCells,
+                                                       DeviceAdapterTag()),
                    validCellRange);
 
     // We are done with scannedNewCellCounts.
@@ -177,7 +190,7 @@ private:
     //The AddVisitIndexArg does all this, plus creates a derived worklet
     //from the users worklet with the visit index added to the signature.
     typedef dax::cont::dispatcher::AddVisitIndexArg<WorkletType,
-      Algorithm,IdArrayHandleType> AddVisitIndexFunctor;
+      Algorithm,IndexArrayHandleType> AddVisitIndexFunctor;
     typedef typename AddVisitIndexFunctor::VisitIndexArgType IndexArgType;
     typedef typename AddVisitIndexFunctor::DerivedWorkletType DerivedWorkletType;
 
@@ -232,6 +245,8 @@ private:
   {
     // Here we are assuming OutGridType is an UnstructuredGrid so that we
     // can set point and connectivity information.
+    DAX_TRACE_SCOPE("dispatcher", "ResolveDuplicatePoints",
+                    inGrid.GetNumberOfPoints(), 0);
 
     typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
 
@@ -246,9 +261,11 @@ private:
     // Make usedPointIds become a sorted array of used point indices.
     // If entry i in usedPointIndices is j, then point index i in the
     // output corresponds to point index j in the input.
-    typedef dax::cont::ArrayHandle<dax::Id, ArrayContainerControlTagBasic,
-        DeviceAdapterTag> IdArrayHandleType;
-    IdArrayHandleType usedPointIndices;
+    typedef dax::cont::ArrayHandle<
+        typename OutGridType::CellConnectionsType::ValueType,
+        ArrayContainerControlTagScratch,
+        DeviceAdapterTag> ConnectionArrayHandleType;
+    ConnectionArrayHandleType usedPointIndices;
     Algorithm::Copy(outGrid.GetCellConnections(), usedPointIndices);
     Algorithm::Sort(usedPointIndices);
     Algorithm::Unique(usedPointIndices);
@@ -0,0 +1,71 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_DispatcherMapPointNeighborhood_h
+#define __dax_cont_DispatcherMapPointNeighborhood_h
+
+#include <dax/Types.h>
+#include <dax/cont/dispatcher/DispatcherBase.h>
+#include <dax/cont/internal/DeviceAdapterTag.h>
+#include <dax/exec/WorkletMapPointNeighborhood.h>
+#include <dax/internal/ParameterPack.h>
+
+namespace dax { namespace cont {
+
+/// Dispatches a dax::exec::WorkletMapPointNeighborhood once for every point
+/// of a uniform grid.
+///
+template <
+  class WorkletType_,
+  class DeviceAdapterTag_ = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+class DispatcherMapPointNeighborhood :
+  public dax::cont::dispatcher::DispatcherBase<
+          DispatcherMapPointNeighborhood< WorkletType_, DeviceAdapterTag_ >,
+          dax::exec::WorkletMapPointNeighborhood,
+          WorkletType_,
+          DeviceAdapterTag_ >
+{
+
+  typedef dax::cont::dispatcher::DispatcherBase< DispatcherMapPointNeighborhood< WorkletType_, DeviceAdapterTag_>,
+                                                 dax::exec::WorkletMapPointNeighborhood,
+                                                 WorkletType_,
+                                                 DeviceAdapterTag_> Superclass;
+  friend class dax::cont::dispatcher::DispatcherBase< DispatcherMapPointNeighborhood< WorkletType_, DeviceAdapterTag_>,
+                                                 dax::exec::WorkletMapPointNeighborhood,
+                                                 WorkletType_,
+                                                 DeviceAdapterTag_>;
+
+public:
+  typedef WorkletType_ WorkletType;
+  typedef DeviceAdapterTag_ DeviceAdapterTag;
+
+  DAX_CONT_EXPORT DispatcherMapPointNeighborhood() : Superclass(WorkletType())
+    { }
+  DAX_CONT_EXPORT DispatcherMapPointNeighborhood(WorkletType worklet) : Superclass(worklet)
+    { }
+
+private:
+  template<typename ParameterPackType>
+  DAX_CONT_EXPORT void DoInvoke(WorkletType worklet,
+                                ParameterPackType arguments) const
+  {
+    this->BasicInvoke(worklet, arguments);
+  }
+
+};
+
+} }
+
+#endif //__dax_cont_DispatcherMapPointNeighborhood_h
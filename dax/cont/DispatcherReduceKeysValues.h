@@ -17,6 +17,8 @@
 #define __dax_cont_DispatcherReduceKeysValues_h
 
 #include <dax/Types.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/ReductionMap.h>
 #include <dax/cont/dispatcher/DispatcherBase.h>
 #include <dax/cont/internal/DeviceAdapterTag.h>
 #include <dax/exec/WorkletReduceKeysValues.h>
@@ -24,7 +26,6 @@
 
 #include <dax/cont/dispatcher/AddReduceKeysArgs.h>
 
-#include <dax/exec/internal/kernel/GenerateWorklets.h>
 
 
 namespace dax { namespace cont {
@@ -56,21 +57,16 @@ public:
   typedef KeysHandleType_ KeysHandleType;
   typedef DeviceAdapterTag_ DeviceAdapterTag;
 
-  typedef dax::cont::ArrayHandle<dax::Id,
-                                 dax::cont::ArrayContainerControlTagBasic,
-                                 DeviceAdapterTag> ReductionMapType;
+  typedef dax::cont::ReductionMap<DeviceAdapterTag> ReductionMapType;
 
   DAX_CONT_EXPORT
   DispatcherReduceKeysValues(const KeysHandleType &keys):
     Superclass(WorkletType()),
     Keys(keys),
-    ReductionKeys(),
-    ReductionMapValid(false),
+    KeyRange(0),
     ReleaseKeys(true),
     ReleaseReductionMap(true),
-    ReductionCounts(),
-    ReductionIndices(),
-    ReductionOffsets()
+    ReductionMap()
     { }
 
   DAX_CONT_EXPORT
@@ -78,35 +74,78 @@ public:
                              const WorkletType& work):
     Superclass(work),
     Keys(keys),
-    ReductionKeys(),
-    ReductionMapValid(false),
+    KeyRange(0),
     ReleaseKeys(true),
     ReleaseReductionMap(true),
-    ReductionCounts(),
-    ReductionIndices(),
-    ReductionOffsets()
+    ReductionMap()
+    { }
+
+  /// Reduces with a map that was built beforehand, so it is not rebuilt
+  /// from keys on every invoke. The map is shared and not released after
+  /// the invoke.
+  DAX_CONT_EXPORT
+  DispatcherReduceKeysValues(const ReductionMapType &reductionMap):
+    Superclass(WorkletType()),
+    Keys(),
+    KeyRange(0),
+    ReleaseKeys(false),
+    ReleaseReductionMap(false),
+    ReductionMap(reductionMap)
+    { }
+
+  DAX_CONT_EXPORT
+  DispatcherReduceKeysValues(const ReductionMapType &reductionMap,
+                             const WorkletType& work):
+    Superclass(work),
+    Keys(),
+    KeyRange(0),
+    ReleaseKeys(false),
+    ReleaseReductionMap(false),
+    ReductionMap(reductionMap)
     { }
 
   DAX_CONT_EXPORT void SetReleaseKeys(bool flag){ this->ReleaseKeys = flag; }
   DAX_CONT_EXPORT bool GetReleaseKeys() const { return ReleaseKeys; }
 
   DAX_CONT_EXPORT KeysHandleType GetKeys() const { return this->Keys; }
+
   DAX_CONT_EXPORT void DoReleaseKeys()
     { this->Keys.ReleaseResourcesExecution(); }
 
+  /// Declares that every key lies in [0, \p numberOfKeys), as the point ids
+  /// generated by CellDataToPointData do. The reduction map is then built
+  /// with a counting sort in linear time rather than with a comparison sort.
+  /// Only integer keys have a range. Pass 0 (the default) to sort the keys.
+  DAX_CONT_EXPORT void SetKeyRange(dax::Id numberOfKeys)
+  {
+    if (numberOfKeys < 0)
+      {
+      throw dax::cont::ErrorControlBadValue("Key range must not be negative.");
+      }
+    this->KeyRange = numberOfKeys;
+    this->ReductionMap.ReleaseResources();
+  }
+  DAX_CONT_EXPORT dax::Id GetKeyRange() const { return this->KeyRange; }
+
   DAX_CONT_EXPORT void SetReleaseReductionMap(bool flag)
     { this->ReleaseReductionMap = flag; }
   DAX_CONT_EXPORT bool GetReleaseReductionMap() const
     { return ReleaseReductionMap; }
 
- DAX_CONT_EXPORT
-  void DoReleaseReductionMap() {
-    this->ReductionCounts.ReleaseResourcesExecution();
-    this->ReductionOffsets.ReleaseResourcesExecution();
-    this->ReductionIndices.ReleaseResourcesExecution();
-    this->ReductionMapValid = false;
+  /// Returns the reduction map, building it from the keys if needed. The
+  /// returned map shares its arrays with this dispatcher and can be handed
+  /// to other dispatchers reducing the same keys.
+  DAX_CONT_EXPORT ReductionMapType GetReductionMap()
+  {
+    this->BuildReductionMap();
+    return this->ReductionMap;
   }
 
+  /// Drops this dispatcher's reference to the reduction map. Other holders
+  /// of the map keep it.
+  DAX_CONT_EXPORT void DoReleaseReductionMap()
+    { this->ReductionMap.ReleaseResources(); }
+
 
 private:
 
@@ -135,9 +174,9 @@ private:
     //them to the real dispatcher
     DerivedWorkletType derivedWorklet(worklet);
     this->BasicInvoke(derivedWorklet,
-                      arguments.Append(this->ReductionCounts)
-                      .Append(this->ReductionOffsets)
-                      .Append(this->ReductionIndices)
+                      arguments.Append(this->ReductionMap.GetCounts())
+                      .Append(this->ReductionMap.GetOffsets())
+                      .Append(this->ReductionMap.GetIndices())
                       );
 
     if(this->GetReleaseReductionMap())
@@ -148,67 +187,23 @@ private:
 
   /// Builds a map from output indices to input indices that describes how
   /// many values are to be reduced for an entry and at what indices those
-  /// values are.  See GetReductionCounts, GetReductionOffsets, and
-  /// GetReductionIndices.
+  /// values are.  See dax::cont::ReductionMap.
   DAX_CONT_EXPORT void BuildReductionMap()
   {
-    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>
-        Algorithms;
-
-    if (this->ReductionMapValid) { return; } // Nothing to do.
-
-    // Make a copy of the keys.  (Our first step is sort, which is in place.)
-    dax::cont::ArrayHandle<
-        typename KeysHandleType::ValueType,
-        dax::cont::ArrayContainerControlTagBasic,
-        DeviceAdapterTag> sortedKeys;
-    Algorithms::Copy(this->Keys, sortedKeys);
-
-    // Initialize the indices using a counting array. After they are sorted as
-    // values, they will point to the original index. Using a counting array
-    // handle to initialize. You could also use a simple functor and a
-    // schedule, but this is fewer lines and is probably about the same
-    // runtime.
-    dax::cont::ArrayHandleCounting<dax::Id, DeviceAdapterTag>
-        countingArray(0, this->Keys.GetNumberOfValues());
-    Algorithms::Copy(countingArray, this->ReductionIndices);
-
-    Algorithms::SortByKey(sortedKeys, this->ReductionIndices);
-
-    // Unique keys represents the output entries.
-    Algorithms::Copy(sortedKeys, this->ReductionKeys);
-    Algorithms::Unique(this->ReductionKeys);
-
-    // Find the index of each unique key in the sorted list to get the offsets
-    // into the ReductionIndices array.
-    Algorithms::LowerBounds(sortedKeys, this->ReductionKeys, this->ReductionOffsets);
-
-    //Find the number of values corresponding to each unique key.
-    dax::Id numUniqueKeys = this->ReductionKeys.GetNumberOfValues();
-
-    typedef dax::exec::internal::kernel::Offset2CountFunctor<
-                        ReductionMapType> OffsetFunctorType;
-    OffsetFunctorType offset2Count( this->ReductionOffsets.PrepareForInput(),
-                        this->ReductionCounts.PrepareForOutput(numUniqueKeys),
-                        numUniqueKeys-1,
-                        this->ReductionIndices.GetNumberOfValues());
-    Algorithms::Schedule(offset2Count, numUniqueKeys);
-
-    this->ReductionMapValid = true;
+    if (this->ReductionMap.IsValid()) { return; } // Nothing to do.
+    DAX_TRACE_SCOPE("dispatcher", "BuildReductionMap",
+                    this->Keys.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(this->Keys));
+    this->ReductionMap.Build(this->Keys, this->KeyRange);
   }
 
-
-
   KeysHandleType Keys;
-  KeysHandleType ReductionKeys;
+  dax::Id KeyRange;
 
-  bool ReductionMapValid;
   bool ReleaseKeys;
   bool ReleaseReductionMap;
 
-  ReductionMapType ReductionCounts;
-  ReductionMapType ReductionIndices;
-  ReductionMapType ReductionOffsets;
+  ReductionMapType ReductionMap;
 
 };
 
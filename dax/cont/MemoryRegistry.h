@@ -0,0 +1,670 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax__cont__MemoryRegistry_h
+#define __dax__cont__MemoryRegistry_h
+
+#include <dax/Types.h>
+#include <dax/cont/ErrorControlBadValue.h>
+
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dax {
+namespace cont {
+
+namespace internal {
+class ExecutionArrayCache;
+class MemoryBudgetScope;
+}
+
+/// \brief The memory held in one memory space.
+///
+/// Byte counts are 64 bit even when dax::Id is 32 bit, so that arrays over
+/// 2 GiB are accounted for correctly.
+///
+struct MemorySpaceUsage
+{
+  std::string Name;
+  /// Bytes allocated right now.
+  dax::internal::Int64Type Bytes;
+  /// The largest Bytes since the registry was created or ResetPeaks was
+  /// called.
+  dax::internal::Int64Type PeakBytes;
+  /// The budget of the space, or 0 if it has none.
+  dax::internal::Int64Type Budget;
+  /// Bytes freed by dropping execution arrays that were copies of control
+  /// arrays.
+  dax::internal::Int64Type BytesReleased;
+  /// Bytes freed by copying execution arrays back to the control environment
+  /// before dropping them.
+  dax::internal::Int64Type BytesSpilled;
+  /// The number of times the space stayed over its budget after everything
+  /// that could be freed was freed.
+  dax::Id NumberOfOverruns;
+
+  DAX_CONT_EXPORT MemorySpaceUsage()
+    : Bytes(0), PeakBytes(0), Budget(0), BytesReleased(0), BytesSpilled(0),
+      NumberOfOverruns(0) {  }
+};
+
+/// \brief The peak memory of each memory space during one stage.
+///
+struct MemoryStageUsage
+{
+  typedef std::vector<std::pair<std::string, dax::internal::Int64Type> >
+      PeakListType;
+
+  std::string Name;
+  /// The peak bytes of every space used during the stage, in the order of
+  /// the space names.
+  PeakListType PeakBytes;
+
+  /// The sum of the peaks of all spaces.
+  DAX_CONT_EXPORT dax::internal::Int64Type GetTotalPeakBytes() const
+  {
+    dax::internal::Int64Type total = 0;
+    for (std::size_t index = 0; index < this->PeakBytes.size(); ++index)
+      {
+      total += this->PeakBytes[index].second;
+      }
+    return total;
+  }
+};
+
+/// \brief Accounts for the memory held by arrays, per memory space.
+///
+/// The array containers that allocate memory (basic, aligned and the scratch
+/// arena) report their allocations in the "control" space. Device adapters
+/// whose execution arrays live in a separate memory report them in the space
+/// named by ArrayManagerExecutionMemorySpace. Device adapters that share
+/// memory with the control environment allocate nothing of their own, so
+/// their arrays are counted once, in the control space. Memory that Dax does
+/// not allocate, such as user arrays given to make_ArrayHandle, is not
+/// counted.
+///
+/// Each space can be given a budget. When the control space goes over its
+/// budget, the registry trims the caches it knows of (the blocks cached by
+/// the ScratchArena). When a device space goes over its budget, the registry
+/// drops execution arrays of that space, least recently used first. It first
+/// drops those whose data is also in the control environment, then spills
+/// the others by copying them back to the control environment. Arrays that
+/// were dropped are moved to the device again when next used. Execution
+/// arrays are only dropped at safe points, when no worklet can hold a portal
+/// to them: at the start of an outermost dispatcher Invoke and at the start
+/// of a stage. Portals handed out outside of any Invoke may still be held by
+/// the caller across these points (make_MarchingCubesPointValues does this),
+/// so such arrays are pinned and not dropped at the safe points until their
+/// execution resources are released.
+///
+/// Stages name the steps of a pipeline. The registry records the peak memory
+/// of every space during each stage, which tells how much memory a batch job
+/// needs.
+///
+/// There is one registry per process, returned by GetInstance. It is used
+/// from the control environment, which is expected to be driven by one
+/// thread.
+///
+class MemoryRegistry
+{
+public:
+  typedef void (*CacheTrimFunction)();
+
+  DAX_CONT_EXPORT static MemoryRegistry &GetInstance()
+  {
+    // Never destroyed, so that static arrays can still report their release
+    // at exit.
+    static MemoryRegistry *instance = new MemoryRegistry;
+    return *instance;
+  }
+
+  DAX_CONT_EXPORT static const char *GetControlSpaceName()
+  {
+    return "control";
+  }
+
+  /// Records that \p numberOfBytes were allocated in \p space.
+  ///
+  DAX_CONT_EXPORT void Allocate(const std::string &space,
+                                dax::internal::Int64Type numberOfBytes)
+  {
+    SpaceRecord &record = this->GetSpace(space);
+    record.Usage.Bytes += numberOfBytes;
+    if (record.Usage.Bytes > record.Usage.PeakBytes)
+      {
+      record.Usage.PeakBytes = record.Usage.Bytes;
+      }
+    if (this->StageOpen && (record.Usage.Bytes > record.StagePeakBytes))
+      {
+      record.StagePeakBytes = record.Usage.Bytes;
+      }
+
+    // Cached blocks are not in use, so they can be trimmed at any time.
+    if ((space == GetControlSpaceName()) && this->IsOverBudget(record))
+      {
+      this->TrimCaches();
+      }
+  }
+
+  /// Records that \p numberOfBytes were freed in \p space.
+  ///
+  DAX_CONT_EXPORT void Free(const std::string &space,
+                            dax::internal::Int64Type numberOfBytes)
+  {
+    this->GetSpace(space).Usage.Bytes -= numberOfBytes;
+  }
+
+  DAX_CONT_EXPORT dax::internal::Int64Type GetBytes(
+      const std::string &space) const
+  {
+    SpaceMapType::const_iterator record = this->Spaces.find(space);
+    return (record != this->Spaces.end()) ? record->second.Usage.Bytes : 0;
+  }
+
+  DAX_CONT_EXPORT dax::internal::Int64Type GetPeakBytes(
+      const std::string &space) const
+  {
+    SpaceMapType::const_iterator record = this->Spaces.find(space);
+    return (record != this->Spaces.end())
+        ? record->second.Usage.PeakBytes : 0;
+  }
+
+  /// Sets the budget of \p space in bytes. Zero removes the budget.
+  ///
+  DAX_CONT_EXPORT void SetBudget(const std::string &space,
+                                 dax::internal::Int64Type numberOfBytes)
+  {
+    if (numberOfBytes < 0)
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Memory budget must not be negative.");
+      }
+    this->GetSpace(space).Usage.Budget = numberOfBytes;
+  }
+
+  /// Sets the budget of every space that has none of its own. Zero removes
+  /// the default budget.
+  ///
+  DAX_CONT_EXPORT void SetDefaultBudget(dax::internal::Int64Type numberOfBytes)
+  {
+    if (numberOfBytes < 0)
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Memory budget must not be negative.");
+      }
+    this->DefaultBudget = numberOfBytes;
+  }
+
+  /// The budget that applies to \p space, or 0 if there is none.
+  ///
+  DAX_CONT_EXPORT dax::internal::Int64Type GetBudget(
+      const std::string &space) const
+  {
+    SpaceMapType::const_iterator record = this->Spaces.find(space);
+    return (record != this->Spaces.end())
+        ? this->GetBudget(record->second) : this->DefaultBudget;
+  }
+
+  /// The usage of every space that was ever used, by name.
+  ///
+  DAX_CONT_EXPORT std::vector<MemorySpaceUsage> GetUsage() const
+  {
+    std::vector<MemorySpaceUsage> usage;
+    for (SpaceMapType::const_iterator record = this->Spaces.begin();
+         record != this->Spaces.end();
+         ++record)
+      {
+      usage.push_back(record->second.Usage);
+      usage.back().Budget = this->GetBudget(record->second);
+      }
+    return usage;
+  }
+
+  /// Restarts the peaks from the current usage and zeroes the counters of
+  /// released and spilled bytes and of overruns.
+  ///
+  DAX_CONT_EXPORT void ResetPeaks()
+  {
+    for (SpaceMapType::iterator record = this->Spaces.begin();
+         record != this->Spaces.end();
+         ++record)
+      {
+      MemorySpaceUsage &usage = record->second.Usage;
+      usage.PeakBytes = usage.Bytes;
+      usage.BytesReleased = 0;
+      usage.BytesSpilled = 0;
+      usage.NumberOfOverruns = 0;
+      }
+  }
+
+  /// Brings every space under its budget as far as possible. Execution arrays
+  /// may be dropped, pinned ones included, so this must only be called when
+  /// no portal to an execution array is in use.
+  ///
+  DAX_CONT_EXPORT void EnforceBudgets()
+  {
+    this->EnforceBudgets(false);
+  }
+
+  /// Registers a function that frees memory cached for later use, such as
+  /// the blocks kept by the ScratchArena. The functions are called when the
+  /// control space goes over its budget.
+  ///
+  DAX_CONT_EXPORT void AddCacheTrimFunction(CacheTrimFunction function)
+  {
+    this->TrimFunctions.push_back(function);
+  }
+
+  /// Starts recording the peak memory of a stage. Starting a stage ends the
+  /// previous one. Budgets are enforced first, keeping pinned arrays.
+  ///
+  DAX_CONT_EXPORT void BeginStage(const std::string &name)
+  {
+    this->EndStage();
+    this->EnforceBudgets(true);
+    for (SpaceMapType::iterator record = this->Spaces.begin();
+         record != this->Spaces.end();
+         ++record)
+      {
+      record->second.StagePeakBytes = record->second.Usage.Bytes;
+      }
+    this->StageName = name;
+    this->StageOpen = true;
+  }
+
+  /// Ends the current stage, if any, and records its peaks.
+  ///
+  DAX_CONT_EXPORT void EndStage()
+  {
+    if (!this->StageOpen) { return; }
+    MemoryStageUsage stage;
+    stage.Name = this->StageName;
+    for (SpaceMapType::const_iterator record = this->Spaces.begin();
+         record != this->Spaces.end();
+         ++record)
+      {
+      stage.PeakBytes.push_back(
+            std::make_pair(record->first, record->second.StagePeakBytes));
+      }
+    this->Stages.push_back(stage);
+    this->StageOpen = false;
+  }
+
+  /// The stages ended since the registry was created or ClearStages was
+  /// called, in the order they ran.
+  ///
+  DAX_CONT_EXPORT const std::vector<MemoryStageUsage> &GetStages() const
+  {
+    return this->Stages;
+  }
+
+  DAX_CONT_EXPORT void ClearStages()
+  {
+    this->Stages.clear();
+  }
+
+  /// Prints the usage, peak and budget of every space followed by the peaks
+  /// of every recorded stage, in MB.
+  ///
+  DAX_CONT_EXPORT void WriteReport(std::ostream &stream) const
+  {
+    const std::vector<MemorySpaceUsage> usage = this->GetUsage();
+    stream << std::left << std::setw(16) << "space" << std::right
+           << std::setw(12) << "MB" << std::setw(12) << "peak MB"
+           << std::setw(12) << "budget MB" << std::setw(12) << "released"
+           << std::setw(12) << "spilled" << std::setw(10) << "overruns"
+           << "\n";
+    for (std::size_t index = 0; index < usage.size(); ++index)
+      {
+      stream << std::left << std::setw(16) << usage[index].Name << std::right
+             << std::setw(12) << ToMB(usage[index].Bytes)
+             << std::setw(12) << ToMB(usage[index].PeakBytes)
+             << std::setw(12) << ToMB(usage[index].Budget)
+             << std::setw(12) << ToMB(usage[index].BytesReleased)
+             << std::setw(12) << ToMB(usage[index].BytesSpilled)
+             << std::setw(10) << usage[index].NumberOfOverruns << "\n";
+      }
+    for (std::size_t index = 0; index < this->Stages.size(); ++index)
+      {
+      const MemoryStageUsage &stage = this->Stages[index];
+      stream << "stage " << stage.Name << ":";
+      for (std::size_t space = 0; space < stage.PeakBytes.size(); ++space)
+        {
+        stream << " " << stage.PeakBytes[space].first << "="
+               << ToMB(stage.PeakBytes[space].second);
+        }
+      stream << " MB\n";
+      }
+  }
+
+private:
+  friend class dax::cont::internal::ExecutionArrayCache;
+  friend class dax::cont::internal::MemoryBudgetScope;
+
+  struct SpaceRecord
+  {
+    MemorySpaceUsage Usage;
+    dax::internal::Int64Type StagePeakBytes;
+
+    SpaceRecord() : StagePeakBytes(0) {  }
+  };
+  typedef std::map<std::string, SpaceRecord> SpaceMapType;
+
+  DAX_CONT_EXPORT MemoryRegistry()
+    : DefaultBudget(0), StageOpen(false), InvokeDepth(0), MostRecent(NULL),
+      LeastRecent(NULL)
+  {  }
+
+  // Not implemented.
+  MemoryRegistry(const MemoryRegistry &);
+  void operator=(const MemoryRegistry &);
+
+  DAX_CONT_EXPORT SpaceRecord &GetSpace(const std::string &space)
+  {
+    SpaceMapType::iterator record = this->Spaces.find(space);
+    if (record == this->Spaces.end())
+      {
+      record = this->Spaces.insert(
+            std::make_pair(space, SpaceRecord())).first;
+      record->second.Usage.Name = space;
+      }
+    return record->second;
+  }
+
+  DAX_CONT_EXPORT dax::internal::Int64Type GetBudget(
+      const SpaceRecord &record) const
+  {
+    return (record.Usage.Budget > 0) ? record.Usage.Budget
+                                     : this->DefaultBudget;
+  }
+
+  DAX_CONT_EXPORT bool IsOverBudget(const SpaceRecord &record) const
+  {
+    const dax::internal::Int64Type budget = this->GetBudget(record);
+    return (budget > 0) && (record.Usage.Bytes > budget);
+  }
+
+  // Brings every space under its budget. Pinned arrays are kept when
+  // keepPinned is true, which is how the safe points call it.
+  DAX_CONT_EXPORT void EnforceBudgets(bool keepPinned)
+  {
+    for (SpaceMapType::iterator record = this->Spaces.begin();
+         record != this->Spaces.end();
+         ++record)
+      {
+      if (!this->IsOverBudget(record->second)) { continue; }
+
+      if (record->first == GetControlSpaceName())
+        {
+        this->TrimCaches();
+        }
+      else
+        {
+        // First drop copies, which costs nothing to undo but a transfer,
+        // then spill arrays that only live in the execution environment.
+        this->ReleaseExecutionArrays(
+              record->first, record->second, false, keepPinned);
+        this->ReleaseExecutionArrays(
+              record->first, record->second, true, keepPinned);
+        }
+
+      if (this->IsOverBudget(record->second))
+        {
+        record->second.Usage.NumberOfOverruns++;
+        }
+      }
+  }
+
+  DAX_CONT_EXPORT void TrimCaches()
+  {
+    for (std::size_t index = 0; index < this->TrimFunctions.size(); ++index)
+      {
+      this->TrimFunctions[index]();
+      }
+  }
+
+  // Declared here, defined after ExecutionArrayCache.
+  DAX_CONT_EXPORT void ReleaseExecutionArrays(const std::string &space,
+                                              SpaceRecord &record,
+                                              bool spill,
+                                              bool keepPinned);
+  DAX_CONT_EXPORT void Link(dax::cont::internal::ExecutionArrayCache *cache);
+  DAX_CONT_EXPORT void Unlink(dax::cont::internal::ExecutionArrayCache *cache);
+
+  static double ToMB(dax::internal::Int64Type numberOfBytes)
+  {
+    return static_cast<double>(numberOfBytes)/(1024*1024);
+  }
+
+  SpaceMapType Spaces;
+  dax::internal::Int64Type DefaultBudget;
+  std::vector<CacheTrimFunction> TrimFunctions;
+
+  std::vector<MemoryStageUsage> Stages;
+  std::string StageName;
+  bool StageOpen;
+
+  // The number of dispatcher Invokes running. Portals handed out when it is
+  // 0 belong to the caller, so their arrays are pinned.
+  int InvokeDepth;
+
+  // The execution arrays of separate memory spaces, most recently used
+  // first.
+  dax::cont::internal::ExecutionArrayCache *MostRecent;
+  dax::cont::internal::ExecutionArrayCache *LeastRecent;
+};
+
+namespace internal {
+
+/// \brief The state of an array whose execution copy the MemoryRegistry may
+/// drop.
+///
+/// ArrayHandle derives its internal state from this class. Only arrays of
+/// device adapters with separate execution memory are registered, and they
+/// are kept in the order they were last used.
+///
+class ExecutionArrayCache
+{
+public:
+  DAX_CONT_EXPORT ExecutionArrayCache(const char *spaceName, bool separate)
+    : SpaceName(spaceName), Registered(separate), Pinned(false),
+      Previous(NULL), Next(NULL)
+  {
+    if (this->Registered)
+      {
+      dax::cont::MemoryRegistry::GetInstance().Link(this);
+      }
+  }
+
+  DAX_CONT_EXPORT virtual ~ExecutionArrayCache()
+  {
+    if (this->Registered)
+      {
+      dax::cont::MemoryRegistry::GetInstance().Unlink(this);
+      }
+  }
+
+  /// Marks the execution array as the most recently used. Called whenever a
+  /// portal to it is handed out. When that happens outside of any dispatcher
+  /// Invoke, the caller may keep the portal, so the array is pinned.
+  ///
+  DAX_CONT_EXPORT void TouchExecutionArray()
+  {
+    if (!this->Registered) { return; }
+    dax::cont::MemoryRegistry &registry =
+        dax::cont::MemoryRegistry::GetInstance();
+    if (registry.InvokeDepth == 0)
+      {
+      this->Pinned = true;
+      }
+    if (this->Previous != NULL)
+      {
+      registry.Unlink(this);
+      registry.Link(this);
+      }
+  }
+
+  /// Called when the execution array is released, after which no portal to
+  /// it may be used.
+  ///
+  DAX_CONT_EXPORT void UnpinExecutionArray()
+  {
+    this->Pinned = false;
+  }
+
+  DAX_CONT_EXPORT const char *GetMemorySpaceName() const
+  {
+    return this->SpaceName;
+  }
+
+  DAX_CONT_EXPORT virtual bool HasExecutionArray() const = 0;
+  DAX_CONT_EXPORT virtual bool HasControlArray() const = 0;
+
+  /// Drops the execution array, first copying it to the control environment
+  /// if that has no copy.
+  ///
+  DAX_CONT_EXPORT virtual void ReleaseExecutionArray() = 0;
+
+private:
+  friend class dax::cont::MemoryRegistry;
+
+  // Not implemented.
+  ExecutionArrayCache(const ExecutionArrayCache &);
+  void operator=(const ExecutionArrayCache &);
+
+  const char *SpaceName;
+  bool Registered;
+  bool Pinned;
+  ExecutionArrayCache *Previous;
+  ExecutionArrayCache *Next;
+};
+
+} // namespace internal
+
+DAX_CONT_EXPORT void MemoryRegistry::Link(
+    dax::cont::internal::ExecutionArrayCache *cache)
+{
+  cache->Previous = NULL;
+  cache->Next = this->MostRecent;
+  if (this->MostRecent != NULL)
+    {
+    this->MostRecent->Previous = cache;
+    }
+  else
+    {
+    this->LeastRecent = cache;
+    }
+  this->MostRecent = cache;
+}
+
+DAX_CONT_EXPORT void MemoryRegistry::Unlink(
+    dax::cont::internal::ExecutionArrayCache *cache)
+{
+  if (cache->Previous != NULL)
+    {
+    cache->Previous->Next = cache->Next;
+    }
+  else
+    {
+    this->MostRecent = cache->Next;
+    }
+  if (cache->Next != NULL)
+    {
+    cache->Next->Previous = cache->Previous;
+    }
+  else
+    {
+    this->LeastRecent = cache->Previous;
+    }
+  cache->Previous = NULL;
+  cache->Next = NULL;
+}
+
+DAX_CONT_EXPORT void MemoryRegistry::ReleaseExecutionArrays(
+    const std::string &space, SpaceRecord &record, bool spill, bool keepPinned)
+{
+  dax::cont::internal::ExecutionArrayCache *cache = this->LeastRecent;
+  while ((cache != NULL) && this->IsOverBudget(record))
+    {
+    // Releasing does not reorder the list, but take the next one first
+    // anyway.
+    dax::cont::internal::ExecutionArrayCache *next = cache->Previous;
+    if ((space == cache->GetMemorySpaceName())
+        && cache->HasExecutionArray()
+        && (cache->HasControlArray() != spill)
+        && !(keepPinned && cache->Pinned))
+      {
+      const dax::internal::Int64Type bytesBefore = record.Usage.Bytes;
+      cache->ReleaseExecutionArray();
+      cache->Pinned = false;
+      const dax::internal::Int64Type bytesFreed =
+          bytesBefore - record.Usage.Bytes;
+      if (spill)
+        {
+        record.Usage.BytesSpilled += bytesFreed;
+        }
+      else
+        {
+        record.Usage.BytesReleased += bytesFreed;
+        }
+      }
+    cache = next;
+    }
+}
+
+namespace internal {
+
+/// \brief Marks a safe point for the MemoryRegistry.
+///
+/// Dispatchers declare one for the duration of Invoke. The outermost one
+/// enforces the memory budgets before the dispatcher moves its arguments to
+/// the execution environment. Arrays pinned by portals handed out before the
+/// Invoke are kept.
+///
+class MemoryBudgetScope
+{
+public:
+  DAX_CONT_EXPORT MemoryBudgetScope()
+  {
+    dax::cont::MemoryRegistry &registry =
+        dax::cont::MemoryRegistry::GetInstance();
+    if (registry.InvokeDepth == 0)
+      {
+      registry.EnforceBudgets(true);
+      }
+    registry.InvokeDepth++;
+  }
+
+  DAX_CONT_EXPORT ~MemoryBudgetScope()
+  {
+    dax::cont::MemoryRegistry::GetInstance().InvokeDepth--;
+  }
+
+private:
+  // Not implemented.
+  MemoryBudgetScope(const MemoryBudgetScope &);
+  void operator=(const MemoryBudgetScope &);
+};
+
+} // namespace internal
+
+}
+} // namespace dax::cont
+
+#endif //__dax__cont__MemoryRegistry_h
@@ -0,0 +1,201 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#ifndef __dax_cont_MinMaxBrickIndex_h
+#define __dax_cont_MinMaxBrickIndex_h
+
+#include <dax/Extent.h>
+#include <dax/Types.h>
+#include <dax/cont/ArrayContainerControlBasic.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/UniformGrid.h>
+#include <dax/exec/BrickMask.h>
+#include <dax/exec/internal/kernel/MinMaxBrickWorklets.h>
+
+namespace dax {
+namespace cont {
+
+/// \brief Min/max acceleration structure over a point field of a uniform grid.
+///
+/// MinMaxBrickIndex splits the cells of a uniform grid into bricks of
+/// brickSize cells along each axis and saves the range of the point field
+/// over every brick. Building the index reads the whole field once. After
+/// that, PrepareForIsoValue only has to test the handful of brick ranges to
+/// find the bricks that can contain an isovalue, so the same index can be
+/// used to contour the field at many isovalues. The returned
+/// dax::exec::BrickMask is given to functors such as the one scheduled by
+/// dax::cont::MarchingCubesClassifyBricks, which skip the cells of
+/// inactive bricks without loading their point values.
+///
+/// The index does not keep the field. Build it again when the field changes.
+///
+template<class DeviceAdapterTag = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+class MinMaxBrickIndex
+{
+public:
+  typedef dax::cont::ArrayHandle<dax::Vector2,
+                                 dax::cont::ArrayContainerControlTagBasic,
+                                 DeviceAdapterTag> BrickRangesType;
+  typedef dax::cont::ArrayHandle<unsigned char,
+                                 dax::cont::ArrayContainerControlTagBasic,
+                                 DeviceAdapterTag> BrickMaskArrayType;
+  typedef dax::exec::BrickMask<
+      typename BrickMaskArrayType::PortalConstExecution> BrickMaskExecution;
+
+  DAX_CONT_EXPORT MinMaxBrickIndex()
+    : CellDimensions(0),
+      BrickDimensions(0),
+      BrickSize(0),
+      MaskIsoValue(0),
+      MaskValid(false)
+  {  }
+
+  template<class Container>
+  DAX_CONT_EXPORT MinMaxBrickIndex(
+      const dax::cont::UniformGrid<DeviceAdapterTag> &grid,
+      const dax::cont::ArrayHandle<dax::Scalar,Container,DeviceAdapterTag>
+          &field,
+      dax::Id brickSize = 8)
+    : MaskIsoValue(0),
+      MaskValid(false)
+  {
+    this->Build(grid, field, brickSize);
+  }
+
+  /// Computes the range of \p field over every brick of \p grid. \p field
+  /// must hold one value per point of the grid.
+  ///
+  template<class Container>
+  DAX_CONT_EXPORT void Build(
+      const dax::cont::UniformGrid<DeviceAdapterTag> &grid,
+      const dax::cont::ArrayHandle<dax::Scalar,Container,DeviceAdapterTag>
+          &field,
+      dax::Id brickSize = 8)
+  {
+    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
+    typedef typename dax::cont::ArrayHandle<
+        dax::Scalar,Container,DeviceAdapterTag>::PortalConstExecution
+        FieldPortalType;
+    typedef typename BrickRangesType::PortalExecution RangePortalType;
+
+    if (brickSize < 1)
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "The brick size of a MinMaxBrickIndex must be at least 1.");
+      }
+    if (field.GetNumberOfValues() != grid.GetNumberOfPoints())
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "The field of a MinMaxBrickIndex must have a value for every "
+            "point of the grid.");
+      }
+
+    const dax::Id3 pointDimensions = dax::extentDimensions(grid.GetExtent());
+    this->CellDimensions = dax::extentCellDimensions(grid.GetExtent());
+    this->BrickSize = brickSize;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      this->BrickDimensions[axis] =
+          (this->CellDimensions[axis] + brickSize - 1) / brickSize;
+      }
+    this->MaskValid = false;
+
+    const dax::Id numBricks = this->GetNumberOfBricks();
+    dax::exec::internal::kernel::ComputeBrickRanges<FieldPortalType,
+                                                    RangePortalType>
+        computeRanges(field.PrepareForInput(),
+                      this->Ranges.PrepareForOutput(numBricks),
+                      pointDimensions,
+                      this->BrickDimensions,
+                      brickSize);
+    Algorithm::Schedule(computeRanges, numBricks);
+  }
+
+  /// Finds the dax::exec::BrickState of every brick for \p isoValue and
+  /// returns the mask for the execution environment. The states of the last
+  /// isovalue are kept, so asking again for the same isovalue does no work.
+  ///
+  DAX_CONT_EXPORT BrickMaskExecution PrepareForIsoValue(dax::Scalar isoValue)
+  {
+    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
+    typedef typename BrickRangesType::PortalConstExecution RangePortalType;
+    typedef typename BrickMaskArrayType::PortalExecution MaskPortalType;
+
+    if (!this->MaskValid || this->MaskIsoValue != isoValue)
+      {
+      const dax::Id numBricks = this->GetNumberOfBricks();
+      dax::exec::internal::kernel::MarkActiveBricks<RangePortalType,
+                                                    MaskPortalType>
+          markActive(this->Ranges.PrepareForInput(),
+                     this->Mask.PrepareForOutput(numBricks),
+                     isoValue);
+      Algorithm::Schedule(markActive, numBricks);
+      this->MaskIsoValue = isoValue;
+      this->MaskValid = true;
+      }
+
+    return BrickMaskExecution(this->Mask.PrepareForInput(),
+                              this->CellDimensions,
+                              this->BrickDimensions,
+                              this->BrickSize);
+  }
+
+  /// The number of cells of the grid along each axis.
+  ///
+  DAX_CONT_EXPORT const dax::Id3 &GetCellDimensions() const
+    { return this->CellDimensions; }
+
+  /// The number of bricks along each axis.
+  ///
+  DAX_CONT_EXPORT const dax::Id3 &GetBrickDimensions() const
+    { return this->BrickDimensions; }
+
+  DAX_CONT_EXPORT dax::Id GetNumberOfBricks() const
+  {
+    return this->BrickDimensions[0] * this->BrickDimensions[1]
+        * this->BrickDimensions[2];
+  }
+
+  DAX_CONT_EXPORT dax::Id GetBrickSize() const { return this->BrickSize; }
+
+  /// The (min, max) of the field over each brick. Bricks are ordered with the
+  /// x axis varying fastest.
+  ///
+  DAX_CONT_EXPORT const BrickRangesType &GetBrickRanges() const
+    { return this->Ranges; }
+
+  /// The dax::exec::BrickState of each brick, set by the last call to
+  /// PrepareForIsoValue.
+  ///
+  DAX_CONT_EXPORT const BrickMaskArrayType &GetBrickMask() const
+    { return this->Mask; }
+
+private:
+  dax::Id3 CellDimensions;
+  dax::Id3 BrickDimensions;
+  dax::Id BrickSize;
+  BrickRangesType Ranges;
+  BrickMaskArrayType Mask;
+  dax::Scalar MaskIsoValue;
+  bool MaskValid;
+};
+
+}
+} // namespace dax::cont
+
+#endif //__dax_cont_MinMaxBrickIndex_h
@@ -0,0 +1,420 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_ReductionMap_h
+#define __dax_cont_ReductionMap_h
+
+#include <dax/Types.h>
+#include <dax/cont/ArrayContainerControlBasic.h>
+#include <dax/cont/ArrayContainerControlScratch.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleConstant.h>
+#include <dax/cont/ArrayHandleCounting.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/internal/DeviceAdapterTagSerial.h>
+#include <dax/exec/internal/kernel/GenerateWorklets.h>
+
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace dax {
+namespace cont {
+
+/// \brief Groups the indices of an array of keys by key.
+///
+/// A ReductionMap holds, for each distinct key in ascending order, how many
+/// values share the key (the counts), where the group of that key starts
+/// (the offsets) and the input indices of the group (the indices). This is
+/// the structure DispatcherReduceKeysValues needs to run a reduce worklet.
+///
+/// The map depends only on the keys, not on the values being reduced, so a
+/// map built once can be given to any number of reduce dispatchers whatever
+/// their worklet or value types. This makes it worthwhile to keep a map
+/// resident for a fixed topology, for example across the fields and time
+/// steps reduced by CellDataToPointData. Copies of a ReductionMap share the
+/// same arrays. Build always allocates new arrays, so rebuilding one copy
+/// leaves the others untouched. The arrays are drawn from the ScratchArena,
+/// so maps that are rebuilt every time step reuse the same memory.
+///
+/// A map can also be written to and read back from a binary stream with
+/// Write and Read.
+///
+template<class DeviceAdapterTag = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+class ReductionMap
+{
+public:
+  typedef DeviceAdapterTag DeviceAdapter;
+  typedef dax::cont::ArrayHandle<dax::Id,
+                                 dax::cont::ArrayContainerControlTagScratch,
+                                 DeviceAdapterTag> IdArrayHandleType;
+
+  DAX_CONT_EXPORT ReductionMap() : Valid(false) {  }
+
+  /// Builds the map for \p keys. See Build.
+  template<class KeysHandleType>
+  DAX_CONT_EXPORT ReductionMap(const KeysHandleType &keys,
+                               dax::Id keyRange = 0)
+    : Valid(false)
+  {
+    this->Build(keys, keyRange);
+  }
+
+  /// Builds the map for \p keys.
+  ///
+  /// When \p keyRange is positive, every key must lie in [0, keyRange), as
+  /// the point ids generated by CellDataToPointData do. The map is then
+  /// built with a counting sort in linear time rather than with a comparison
+  /// sort. Only integer keys have a range. Otherwise keys that are already
+  /// grouped in ascending order are used in place, and only keys that are
+  /// out of order get copied and sorted.
+  template<class KeysHandleType>
+  DAX_CONT_EXPORT void Build(const KeysHandleType &keys, dax::Id keyRange = 0)
+  {
+    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
+
+    if (keyRange < 0)
+      {
+      throw dax::cont::ErrorControlBadValue("Key range must not be negative.");
+      }
+
+    // Never write into arrays another copy of this map may still use.
+    this->Counts = IdArrayHandleType();
+    this->Offsets = IdArrayHandleType();
+    this->Indices = IdArrayHandleType();
+    this->Valid = false;
+
+    if (keys.GetNumberOfValues() == 0)
+      {
+      // Allocate empty arrays. There is nothing to read from the keys.
+      this->Counts.PrepareForOutput(0);
+      this->Offsets.PrepareForOutput(0);
+      this->Indices.PrepareForOutput(0);
+      }
+    else if (keyRange > 0)
+      {
+      this->BuildBounded(
+            keys,
+            keyRange,
+            typename boost::is_integral<
+              typename KeysHandleType::ValueType>::type());
+      }
+    else if (KeysAreSorted(keys))
+      {
+      // Identity indices; the keys are grouped already.
+      dax::cont::ArrayHandleCounting<dax::Id, DeviceAdapterTag>
+          countingArray(0, keys.GetNumberOfValues());
+      Algorithm::Copy(countingArray, this->Indices);
+      this->BuildOffsetsFromSortedKeys(keys);
+      }
+    else
+      {
+      // Make a copy of the keys.  (Sort is in place.)
+      dax::cont::ArrayHandle<
+          typename KeysHandleType::ValueType,
+          dax::cont::ArrayContainerControlTagScratch,
+          DeviceAdapterTag> sortedKeys;
+      Algorithm::Copy(keys, sortedKeys);
+
+      // Initialize the indices using a counting array. After they are sorted
+      // as values, they will point to the original index.
+      dax::cont::ArrayHandleCounting<dax::Id, DeviceAdapterTag>
+          countingArray(0, keys.GetNumberOfValues());
+      Algorithm::Copy(countingArray, this->Indices);
+
+      Algorithm::SortByKey(sortedKeys, this->Indices);
+      this->BuildOffsetsFromSortedKeys(sortedKeys);
+      }
+
+    this->Valid = true;
+  }
+
+  /// True once Build or Read has filled the map.
+  DAX_CONT_EXPORT bool IsValid() const { return this->Valid; }
+
+  /// The number of distinct keys, which is the number of reduced outputs.
+  DAX_CONT_EXPORT dax::Id GetNumberOfKeys() const
+    { return this->Counts.GetNumberOfValues(); }
+
+  /// The number of keys the map was built from, which is the number of
+  /// values a reduce worklet consumes.
+  DAX_CONT_EXPORT dax::Id GetNumberOfValues() const
+    { return this->Indices.GetNumberOfValues(); }
+
+  DAX_CONT_EXPORT const IdArrayHandleType &GetCounts() const
+    { return this->Counts; }
+  DAX_CONT_EXPORT const IdArrayHandleType &GetOffsets() const
+    { return this->Offsets; }
+  DAX_CONT_EXPORT const IdArrayHandleType &GetIndices() const
+    { return this->Indices; }
+
+  /// The number of bytes the arrays of the map hold. The execution
+  /// environment holds at most as many again while the map is in use.
+  DAX_CONT_EXPORT dax::Id GetNumberOfBytes() const
+  {
+    return static_cast<dax::Id>(sizeof(dax::Id)) *
+        (this->Counts.GetNumberOfValues()
+         + this->Offsets.GetNumberOfValues()
+         + this->Indices.GetNumberOfValues());
+  }
+
+  /// Frees the execution copies of the arrays. The map stays valid and is
+  /// moved back to the execution environment the next time it is used.
+  DAX_CONT_EXPORT void ReleaseResourcesExecution()
+  {
+    this->Counts.ReleaseResourcesExecution();
+    this->Offsets.ReleaseResourcesExecution();
+    this->Indices.ReleaseResourcesExecution();
+  }
+
+  /// Drops this copy's reference to the arrays and invalidates it.
+  DAX_CONT_EXPORT void ReleaseResources()
+  {
+    this->Counts = IdArrayHandleType();
+    this->Offsets = IdArrayHandleType();
+    this->Indices = IdArrayHandleType();
+    this->Valid = false;
+  }
+
+  /// Writes the map to a binary stream. The data is in native byte order
+  /// and can be read back on a machine with the same dax::Id size.
+  DAX_CONT_EXPORT void Write(std::ostream &stream) const
+  {
+    if (!this->Valid)
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Cannot write a reduction map that has not been built.");
+      }
+
+    stream.write(MagicString(), MAGIC_LENGTH);
+    const dax::Id header[3] = { static_cast<dax::Id>(sizeof(dax::Id)),
+                                this->GetNumberOfKeys(),
+                                this->GetNumberOfValues() };
+    stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+    WriteArray(stream, this->Counts);
+    WriteArray(stream, this->Offsets);
+    WriteArray(stream, this->Indices);
+
+    if (!stream)
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Failed to write reduction map to stream.");
+      }
+  }
+
+  /// Replaces the map with one written by Write.
+  DAX_CONT_EXPORT void Read(std::istream &stream)
+  {
+    char magic[MAGIC_LENGTH];
+    dax::Id header[3];
+    stream.read(magic, MAGIC_LENGTH);
+    stream.read(reinterpret_cast<char *>(header), sizeof(header));
+    if (!stream || std::memcmp(magic, MagicString(), MAGIC_LENGTH) != 0)
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Stream does not hold a reduction map.");
+      }
+    if (header[0] != static_cast<dax::Id>(sizeof(dax::Id)))
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Reduction map was written with a different dax::Id size.");
+      }
+    if (header[1] < 0 || header[2] < header[1])
+      {
+      throw dax::cont::ErrorControlBadValue("Reduction map header is corrupt.");
+      }
+
+    IdArrayHandleType counts;
+    IdArrayHandleType offsets;
+    IdArrayHandleType indices;
+    ReadArray(stream, header[1], counts);
+    ReadArray(stream, header[1], offsets);
+    ReadArray(stream, header[2], indices);
+
+    this->Counts = counts;
+    this->Offsets = offsets;
+    this->Indices = indices;
+    this->Valid = true;
+  }
+
+private:
+  enum { MAGIC_LENGTH = 8 };
+  DAX_CONT_EXPORT static const char *MagicString() { return "DAXRMAP1"; }
+
+  DAX_CONT_EXPORT
+  static void WriteArray(std::ostream &stream, const IdArrayHandleType &array)
+  {
+    std::vector<dax::Id> buffer(array.GetNumberOfValues());
+    if (buffer.empty()) { return; }
+    array.CopyInto(buffer.begin());
+    stream.write(reinterpret_cast<const char *>(&buffer[0]),
+                 static_cast<std::streamsize>(buffer.size()*sizeof(dax::Id)));
+  }
+
+  DAX_CONT_EXPORT
+  static void ReadArray(std::istream &stream,
+                        dax::Id numberOfValues,
+                        IdArrayHandleType &array)
+  {
+    std::vector<dax::Id> buffer(numberOfValues);
+    if (!buffer.empty())
+      {
+      stream.read(reinterpret_cast<char *>(&buffer[0]),
+                  static_cast<std::streamsize>(buffer.size()*sizeof(dax::Id)));
+      }
+    if (!stream)
+      {
+      throw dax::cont::ErrorControlBadValue("Reduction map data is truncated.");
+      }
+    // The buffer goes out of scope, so copy into an array we own.
+    dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>::Copy(
+          dax::cont::make_ArrayHandle(buffer,
+                                      dax::cont::ArrayContainerControlTagBasic(),
+                                      DeviceAdapterTag()),
+          array);
+  }
+
+  /// Returns true when the keys are in ascending order, which a single pass
+  /// can check far faster than a sort of already sorted keys runs.
+  template<class KeysHandleType>
+  DAX_CONT_EXPORT static bool KeysAreSorted(const KeysHandleType &keys)
+  {
+    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
+    typedef typename KeysHandleType::PortalConstExecution KeysPortalType;
+
+    const dax::Id numKeys = keys.GetNumberOfValues();
+    if (numKeys < 2) { return true; }
+
+    IdArrayHandleType unsortedFlag;
+    Algorithm::Copy(
+          dax::cont::make_ArrayHandleConstant(dax::Id(0), 1, DeviceAdapterTag()),
+          unsortedFlag);
+    dax::Id *unsorted =
+        &(*unsortedFlag.PrepareForInPlace().GetIteratorBegin());
+
+    dax::exec::internal::kernel::CheckKeysSortedFunctor<KeysPortalType>
+        checkSorted(keys.PrepareForInput(), unsorted);
+    Algorithm::Schedule(checkSorted, numKeys - 1);
+
+    return unsortedFlag.GetPortalConstControl().Get(0) == 0;
+  }
+
+  /// Fills the offsets and counts from keys that are grouped in order. The
+  /// first key of each group marks an offset, which replaces the unique and
+  /// lower bounds search over the whole key array.
+  template<class SortedKeysHandleType>
+  DAX_CONT_EXPORT
+  void BuildOffsetsFromSortedKeys(const SortedKeysHandleType &sortedKeys)
+  {
+    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
+
+    const dax::Id numKeys = sortedKeys.GetNumberOfValues();
+
+    IdArrayHandleType groupStarts;
+    dax::exec::internal::kernel::MarkKeyGroupStartsFunctor<
+        typename SortedKeysHandleType::PortalConstExecution,
+        typename IdArrayHandleType::PortalExecution>
+      markStarts(sortedKeys.PrepareForInput(),
+                 groupStarts.PrepareForOutput(numKeys));
+    Algorithm::Schedule(markStarts, numKeys);
+
+    Algorithm::StreamCompact(groupStarts, this->Offsets);
+    groupStarts.ReleaseResources();
+
+    //Find the number of values corresponding to each unique key.
+    dax::Id numUniqueKeys = this->Offsets.GetNumberOfValues();
+
+    typedef dax::exec::internal::kernel::Offset2CountFunctor<
+                        IdArrayHandleType> OffsetFunctorType;
+    OffsetFunctorType offset2Count( this->Offsets.PrepareForInput(),
+                        this->Counts.PrepareForOutput(numUniqueKeys),
+                        numUniqueKeys-1,
+                        numKeys);
+    Algorithm::Schedule(offset2Count, numUniqueKeys);
+  }
+
+  /// Counting sort of keys in [0, keyRange): histogram the keys, scan the
+  /// histogram into offsets, then scatter each index into its key's slot.
+  /// Keys absent from the input produce no output entry.
+  template<class KeysHandleType>
+  DAX_CONT_EXPORT void BuildBounded(const KeysHandleType &keys,
+                                    dax::Id keyRange,
+                                    boost::true_type)
+  {
+    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
+    typedef typename KeysHandleType::PortalConstExecution KeysPortalType;
+
+    const dax::Id numValues = keys.GetNumberOfValues();
+
+    IdArrayHandleType keyCounts;
+    Algorithm::Copy(
+          dax::cont::make_ArrayHandleConstant(dax::Id(0),
+                                              keyRange,
+                                              DeviceAdapterTag()),
+          keyCounts);
+    dax::Id *counts = &(*keyCounts.PrepareForInPlace().GetIteratorBegin());
+
+    dax::exec::internal::kernel::CountKeysInRangeFunctor<KeysPortalType>
+        countKeys(keys.PrepareForInput(), counts, keyRange);
+    Algorithm::Schedule(countKeys, numValues);
+
+    IdArrayHandleType keyOffsets;
+    Algorithm::ScanExclusive(keyCounts, keyOffsets);
+
+    IdArrayHandleType keyCursors;
+    Algorithm::Copy(keyOffsets, keyCursors);
+    dax::Id *cursors = &(*keyCursors.PrepareForInPlace().GetIteratorBegin());
+
+    dax::exec::internal::kernel::ScatterKeysInRangeFunctor<
+        KeysPortalType,
+        typename IdArrayHandleType::PortalExecution,
+        !boost::is_same<DeviceAdapterTag,
+                        dax::cont::DeviceAdapterTagSerial>::value>
+      scatterKeys(keys.PrepareForInput(),
+                  cursors,
+                  this->Indices.PrepareForOutput(numValues));
+    Algorithm::Schedule(scatterKeys, numValues);
+    keyCursors.ReleaseResources();
+
+    // Drop the keys that never occur.
+    Algorithm::StreamCompact(keyOffsets, keyCounts, this->Offsets);
+    Algorithm::StreamCompact(keyCounts, keyCounts, this->Counts);
+  }
+
+  template<class KeysHandleType>
+  DAX_CONT_EXPORT void BuildBounded(const KeysHandleType &,
+                                    dax::Id,
+                                    boost::false_type)
+  {
+    throw dax::cont::ErrorControlBadValue(
+          "A key range can only be used with integer keys.");
+  }
+
+  IdArrayHandleType Counts;
+  IdArrayHandleType Offsets;
+  IdArrayHandleType Indices;
+  bool Valid;
+};
+
+}
+} // namespace dax::cont
+
+#endif //__dax_cont_ReductionMap_h
@@ -0,0 +1,301 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax__cont__ScratchArena_h
+#define __dax__cont__ScratchArena_h
+
+#include <dax/Types.h>
+#include <dax/cont/Assert.h>
+#include <dax/cont/ErrorControlOutOfMemory.h>
+#include <dax/cont/MemoryRegistry.h>
+
+#include <map>
+#include <stdlib.h>
+#include <vector>
+
+namespace dax {
+namespace cont {
+
+/// \brief Usage counters of the ScratchArena.
+///
+/// All sizes are in bytes of whole blocks, so they include the rounding of
+/// each request up to its size class. Like the MemoryRegistry, byte counts
+/// are 64 bit even when dax::Id is 32 bit.
+///
+struct ScratchArenaStatistics
+{
+  /// Bytes held by arrays and buffers right now.
+  dax::internal::Int64Type BytesInUse;
+
+  /// Bytes of free blocks kept for reuse.
+  dax::internal::Int64Type BytesCached;
+
+  /// The largest BytesInUse since the arena was created or
+  /// ResetHighWaterMark was called.
+  dax::internal::Int64Type HighWaterMark;
+
+  /// The largest BytesInUse plus BytesCached over the same period, which is
+  /// the most memory the arena held from the system at once.
+  dax::internal::Int64Type PeakBytesReserved;
+
+  /// The number of blocks handed out.
+  dax::Id NumberOfRequests;
+
+  /// The number of blocks handed out from the cache rather than allocated.
+  dax::Id NumberOfReuses;
+
+  DAX_CONT_EXPORT ScratchArenaStatistics()
+    : BytesInUse(0),
+      BytesCached(0),
+      HighWaterMark(0),
+      PeakBytesReserved(0),
+      NumberOfRequests(0),
+      NumberOfReuses(0) {  }
+};
+
+/// \brief A pool of memory blocks for temporary arrays.
+///
+/// Dispatchers and device adapter algorithms allocate their temporary arrays
+/// (scans, index ranges, stencils, sort buffers, reduction maps) from the
+/// arena through ArrayContainerControlTagScratch and
+/// dax::cont::internal::ScratchBuffer. Every request is rounded up to a size
+/// class: the classes are spaced four to a power of two, so a block wastes
+/// less than a quarter of its size.
+///
+/// While a ScratchArenaScope exists, freed blocks are kept in the arena and
+/// handed to the next request of the same size class, so a loop that runs
+/// the same pipeline every time step stops allocating after its first step.
+/// When the outermost scope ends, the cached blocks are returned to the
+/// system. Outside any scope the arena frees blocks as soon as they are
+/// released, like the basic container.
+///
+/// The blocks the arena holds, cached or not, are counted in the control
+/// space of the MemoryRegistry, which trims the cache when that space goes
+/// over its budget.
+///
+/// There is one arena per process, returned by GetInstance. It is used from
+/// the control environment, which is expected to be driven by one thread.
+///
+class ScratchArena
+{
+public:
+  DAX_CONT_EXPORT static ScratchArena &GetInstance()
+  {
+    static ScratchArena instance;
+    return instance;
+  }
+
+  DAX_CONT_EXPORT ~ScratchArena()
+  {
+    this->Trim();
+  }
+
+  /// Returns a block of at least \p numberOfBytes bytes, aligned to a cache
+  /// line, and sets \p blockBytes to its actual size, which must be passed
+  /// back to Free.
+  ///
+  DAX_CONT_EXPORT void *Allocate(dax::internal::Int64Type numberOfBytes,
+                                 dax::internal::Int64Type &blockBytes)
+  {
+    DAX_ASSERT_CONT(numberOfBytes > 0);
+    blockBytes = GetSizeClass(numberOfBytes);
+
+    void *block = NULL;
+    bool reused = false;
+    FreeBlockMap::iterator freeBlocks = this->FreeBlocks.find(blockBytes);
+    if ((freeBlocks != this->FreeBlocks.end()) && !freeBlocks->second.empty())
+      {
+      block = freeBlocks->second.back();
+      freeBlocks->second.pop_back();
+      this->Statistics.BytesCached -= blockBytes;
+      this->Statistics.NumberOfReuses++;
+      reused = true;
+      }
+    else if (posix_memalign(&block,
+                            CACHE_LINE_SIZE,
+                            static_cast<size_t>(blockBytes)) != 0)
+      {
+      throw dax::cont::ErrorControlOutOfMemory(
+            "Could not allocate scratch array.");
+      }
+
+    this->Statistics.NumberOfRequests++;
+    this->Statistics.BytesInUse += blockBytes;
+    if (this->Statistics.BytesInUse > this->Statistics.HighWaterMark)
+      {
+      this->Statistics.HighWaterMark = this->Statistics.BytesInUse;
+      }
+    this->UpdatePeakReserved();
+    if (!reused)
+      {
+      // Last, because going over the budget may trim this arena.
+      dax::cont::MemoryRegistry::GetInstance().Allocate(
+            dax::cont::MemoryRegistry::GetControlSpaceName(), blockBytes);
+      }
+    return block;
+  }
+
+  /// Gives back a block returned by Allocate. Inside a ScratchArenaScope the
+  /// block is cached for reuse; otherwise it is freed.
+  ///
+  DAX_CONT_EXPORT void Free(void *block, dax::internal::Int64Type blockBytes)
+  {
+    if (block == NULL) { return; }
+    DAX_ASSERT_CONT(blockBytes == GetSizeClass(blockBytes));
+    this->Statistics.BytesInUse -= blockBytes;
+    if (this->ScopeDepth > 0)
+      {
+      this->FreeBlocks[blockBytes].push_back(block);
+      this->Statistics.BytesCached += blockBytes;
+      }
+    else
+      {
+      free(block);
+      ReportFree(blockBytes);
+      }
+  }
+
+  /// Returns every cached block to the system. Blocks in use are not
+  /// affected.
+  ///
+  DAX_CONT_EXPORT void Trim()
+  {
+    for (FreeBlockMap::iterator freeBlocks = this->FreeBlocks.begin();
+         freeBlocks != this->FreeBlocks.end();
+         ++freeBlocks)
+      {
+      for (std::size_t index = 0; index < freeBlocks->second.size(); ++index)
+        {
+        free(freeBlocks->second[index]);
+        ReportFree(freeBlocks->first);
+        }
+      }
+    this->FreeBlocks.clear();
+    this->Statistics.BytesCached = 0;
+  }
+
+  DAX_CONT_EXPORT ScratchArenaStatistics GetStatistics() const
+  {
+    return this->Statistics;
+  }
+
+  /// Restarts the high-water marks from the current usage and zeroes the
+  /// request counters, for example to measure a single time step.
+  ///
+  DAX_CONT_EXPORT void ResetHighWaterMark()
+  {
+    this->Statistics.HighWaterMark = this->Statistics.BytesInUse;
+    this->Statistics.PeakBytesReserved =
+        this->Statistics.BytesInUse + this->Statistics.BytesCached;
+    this->Statistics.NumberOfRequests = 0;
+    this->Statistics.NumberOfReuses = 0;
+  }
+
+  /// True while a ScratchArenaScope exists.
+  ///
+  DAX_CONT_EXPORT bool GetCaching() const { return this->ScopeDepth > 0; }
+
+  /// The size of the block Allocate returns for \p numberOfBytes.
+  ///
+  DAX_CONT_EXPORT static dax::internal::Int64Type GetSizeClass(
+      dax::internal::Int64Type numberOfBytes)
+  {
+    if (numberOfBytes <= MINIMUM_BLOCK_SIZE) { return MINIMUM_BLOCK_SIZE; }
+    dax::internal::Int64Type powerOfTwo = MINIMUM_BLOCK_SIZE;
+    while (powerOfTwo <= numberOfBytes / 2) { powerOfTwo *= 2; }
+    const dax::internal::Int64Type step = powerOfTwo / 4;
+    return ((numberOfBytes + step - 1) / step) * step;
+  }
+
+private:
+  friend class ScratchArenaScope;
+
+  enum {
+    CACHE_LINE_SIZE = 64,
+    MINIMUM_BLOCK_SIZE = 256
+  };
+
+  typedef std::map<dax::internal::Int64Type, std::vector<void *> >
+      FreeBlockMap;
+
+  DAX_CONT_EXPORT ScratchArena() : ScopeDepth(0)
+  {
+    dax::cont::MemoryRegistry::GetInstance().AddCacheTrimFunction(&TrimInstance);
+  }
+
+  DAX_CONT_EXPORT static void TrimInstance()
+  {
+    GetInstance().Trim();
+  }
+
+  DAX_CONT_EXPORT static void ReportFree(dax::internal::Int64Type blockBytes)
+  {
+    dax::cont::MemoryRegistry::GetInstance().Free(
+          dax::cont::MemoryRegistry::GetControlSpaceName(), blockBytes);
+  }
+
+  // Not implemented.
+  ScratchArena(const ScratchArena &);
+  void operator=(const ScratchArena &);
+
+  DAX_CONT_EXPORT void UpdatePeakReserved()
+  {
+    const dax::internal::Int64Type reserved =
+        this->Statistics.BytesInUse + this->Statistics.BytesCached;
+    if (reserved > this->Statistics.PeakBytesReserved)
+      {
+      this->Statistics.PeakBytesReserved = reserved;
+      }
+  }
+
+  FreeBlockMap FreeBlocks;
+  ScratchArenaStatistics Statistics;
+  int ScopeDepth;
+};
+
+/// \brief Keeps the blocks freed to the ScratchArena for reuse while it
+/// exists.
+///
+/// Declare one around a loop of pipeline executions. Scopes may be nested;
+/// the cache is trimmed when the outermost one ends.
+///
+class ScratchArenaScope
+{
+public:
+  DAX_CONT_EXPORT ScratchArenaScope()
+  {
+    ScratchArena::GetInstance().ScopeDepth++;
+  }
+
+  DAX_CONT_EXPORT ~ScratchArenaScope()
+  {
+    ScratchArena &arena = ScratchArena::GetInstance();
+    arena.ScopeDepth--;
+    if (arena.ScopeDepth == 0)
+      {
+      arena.Trim();
+      }
+  }
+
+private:
+  // Not implemented.
+  ScratchArenaScope(const ScratchArenaScope &);
+  void operator=(const ScratchArenaScope &);
+};
+
+}
+} // namespace dax::cont
+
+#endif //__dax__cont__ScratchArena_h
@@ -0,0 +1,398 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_Tracing_h
+#define __dax_cont_Tracing_h
+
+#include <dax/Types.h>
+
+#include <dax/cont/ErrorControlBadValue.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+#ifdef _WIN32
+#include <sys/timeb.h>
+#else
+#include <sys/time.h>
+#endif
+
+/// \def DAX_TRACE_SCOPE(category, name, count, bytes)
+///
+/// Records the time from this statement to the end of the enclosing block in
+/// the dax::cont::TraceCollector, along with the number of values processed
+/// and the number of bytes moved. Dax places these in dispatchers, device
+/// adapter algorithms and array transfers. Tracing is compiled in only when
+/// DAX_ENABLE_TRACING is defined (see the CMake option of the same name);
+/// otherwise the macro expands to nothing and its arguments are never
+/// evaluated. Only one scope may be declared per block.
+///
+/// \def DAX_TRACE_SCOPE_SET_COUNT(count, bytes)
+///
+/// Changes the count and bytes of the scope declared in the same block, for
+/// when they are not known until part way through.
+///
+#ifdef DAX_ENABLE_TRACING
+#define DAX_TRACE_SCOPE(category, name, count, bytes) \
+  ::dax::cont::TraceScope daxTraceScope(category, name, count, bytes)
+#define DAX_TRACE_SCOPE_SET_COUNT(count, bytes) \
+  daxTraceScope.SetCount(count, bytes)
+#else
+#define DAX_TRACE_SCOPE(category, name, count, bytes)
+#define DAX_TRACE_SCOPE_SET_COUNT(count, bytes)
+#endif
+
+namespace dax {
+namespace cont {
+
+/// \brief One call recorded by the TraceCollector.
+///
+struct TraceEvent
+{
+  std::string Category;
+  std::string Name;
+  /// Seconds from the creation or last reset of the collector to the start
+  /// of the call.
+  double StartTime;
+  /// Seconds spent in the call, including the events nested in it.
+  double Duration;
+  /// Seconds spent in the call but not in the events nested in it.
+  double SelfDuration;
+  dax::Id Count;
+  dax::internal::Int64Type Bytes;
+  /// The number of events the call was nested in.
+  int Depth;
+};
+
+/// \brief Collects the events of the DAX_TRACE_SCOPE instrumentation.
+///
+/// There is one collector per process, returned by GetInstance. Events are
+/// recorded from the control environment, which is expected to be driven by
+/// one thread. When a call returns before the device has finished its work
+/// (for example a CUDA kernel launch), its duration only covers the launch
+/// and the wait is attributed to the next call that synchronizes.
+///
+/// If the DAX_TRACE_FILE environment variable names a file, the Chrome trace
+/// is written to it when the process exits.
+///
+class TraceCollector
+{
+public:
+  DAX_CONT_EXPORT static TraceCollector &GetInstance()
+  {
+    static TraceCollector instance;
+    return instance;
+  }
+
+  /// Recording can be paused to skip uninteresting parts of a program. It is
+  /// enabled by default.
+  DAX_CONT_EXPORT void SetEnabled(bool enabled) { this->Enabled = enabled; }
+  DAX_CONT_EXPORT bool GetEnabled() const { return this->Enabled; }
+
+  /// Drops all recorded events and restarts the clock.
+  DAX_CONT_EXPORT void Reset()
+  {
+    this->Events.clear();
+    this->ChildDurations.clear();
+    this->Origin = GetCurrentTime();
+  }
+
+  /// Events are ordered by the time they end, so nested events come before
+  /// the event they are nested in.
+  DAX_CONT_EXPORT const std::vector<TraceEvent> &GetEvents() const
+  {
+    return this->Events;
+  }
+
+  /// Writes the events in the Chrome trace event format, which can be loaded
+  /// in chrome://tracing or Perfetto.
+  DAX_CONT_EXPORT void WriteChromeTrace(std::ostream &stream) const
+  {
+    stream << "{\"traceEvents\": [";
+    for (std::size_t index = 0; index < this->Events.size(); ++index)
+      {
+      const TraceEvent &event = this->Events[index];
+      stream << (index == 0 ? "\n" : ",\n")
+             << " {\"name\": \"" << EscapeJSON(event.Name)
+             << "\", \"cat\": \"" << EscapeJSON(event.Category)
+             << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0"
+             << std::setprecision(15)
+             << ", \"ts\": " << event.StartTime * 1.0e6
+             << ", \"dur\": " << event.Duration * 1.0e6
+             << ", \"args\": {\"count\": " << event.Count
+             << ", \"bytes\": " << event.Bytes
+             << ", \"self_us\": " << event.SelfDuration * 1.0e6
+             << "}}";
+      }
+    stream << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+  }
+
+  DAX_CONT_EXPORT void WriteChromeTrace(const std::string &fileName) const
+  {
+    std::ofstream stream(fileName.c_str());
+    if (!stream)
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Could not open trace file " + fileName);
+      }
+    this->WriteChromeTrace(stream);
+  }
+
+  /// Prints one line per distinct category and name with the number of
+  /// calls, the total and self time, the values processed, the bytes moved
+  /// and the resulting bandwidth, hottest (by self time) first.
+  DAX_CONT_EXPORT void WriteSummary(std::ostream &stream) const
+  {
+    typedef std::pair<std::string, std::string> KeyType;
+    std::map<KeyType, SummaryEntry> entries;
+    for (std::size_t index = 0; index < this->Events.size(); ++index)
+      {
+      const TraceEvent &event = this->Events[index];
+      SummaryEntry &entry =
+          entries[KeyType(event.Category, event.Name)];
+      entry.Calls++;
+      entry.Duration += event.Duration;
+      entry.SelfDuration += event.SelfDuration;
+      entry.Count += event.Count;
+      entry.Bytes += event.Bytes;
+      }
+
+    std::vector<std::pair<double, KeyType> > order;
+    for (std::map<KeyType, SummaryEntry>::const_iterator iter =
+           entries.begin(); iter != entries.end(); ++iter)
+      {
+      order.push_back(std::make_pair(-iter->second.SelfDuration, iter->first));
+      }
+    std::sort(order.begin(), order.end());
+
+    stream << std::setw(12) << "self (s)" << std::setw(12) << "total (s)"
+           << std::setw(8) << "calls" << std::setw(14) << "values"
+           << std::setw(10) << "GB/s" << "  category: name\n";
+    for (std::size_t index = 0; index < order.size(); ++index)
+      {
+      const KeyType &key = order[index].second;
+      const SummaryEntry &entry = entries[key];
+      const double bandwidth = entry.Duration > 0
+          ? entry.Bytes / entry.Duration * 1.0e-9 : 0.0;
+      stream << std::setw(12) << entry.SelfDuration
+             << std::setw(12) << entry.Duration
+             << std::setw(8) << entry.Calls
+             << std::setw(14) << entry.Count
+             << std::setw(10) << bandwidth
+             << "  " << key.first << ": " << key.second << "\n";
+      }
+  }
+
+  /// Wall clock time in seconds. Unlike dax::cont::Timer this does not
+  /// synchronize the device.
+  DAX_CONT_EXPORT static double GetCurrentTime()
+  {
+#ifdef _WIN32
+    timeb currentTime;
+    ::ftime(&currentTime);
+    return currentTime.time + 1.0e-3*currentTime.millitm;
+#else
+    timeval currentTime;
+    gettimeofday(&currentTime, NULL);
+    return currentTime.tv_sec + 1.0e-6*currentTime.tv_usec;
+#endif
+  }
+
+  DAX_CONT_EXPORT ~TraceCollector()
+  {
+    const char *fileName = std::getenv("DAX_TRACE_FILE");
+    if (fileName != NULL && *fileName != '\0')
+      {
+      std::ofstream stream(fileName);
+      this->WriteChromeTrace(stream);
+      }
+  }
+
+private:
+  friend class TraceScope;
+
+  struct SummaryEntry
+  {
+    SummaryEntry() : Calls(0), Duration(0), SelfDuration(0), Count(0),
+      Bytes(0) {  }
+    dax::Id Calls;
+    double Duration;
+    double SelfDuration;
+    dax::internal::Int64Type Count;
+    dax::internal::Int64Type Bytes;
+  };
+
+  DAX_CONT_EXPORT TraceCollector() : Enabled(true)
+  {
+    this->Origin = GetCurrentTime();
+  }
+
+  DAX_CONT_EXPORT TraceCollector(const TraceCollector &); // Not implemented.
+  DAX_CONT_EXPORT void operator=(const TraceCollector &); // Not implemented.
+
+  DAX_CONT_EXPORT double Begin()
+  {
+    this->ChildDurations.push_back(0.0);
+    return GetCurrentTime();
+  }
+
+  DAX_CONT_EXPORT void End(const char *category,
+                           const std::string &name,
+                           double startTime,
+                           dax::Id count,
+                           dax::internal::Int64Type bytes)
+  {
+    const double duration = GetCurrentTime() - startTime;
+    // A Reset inside of a scope drops the scopes that were open.
+    if (this->ChildDurations.empty()) { return; }
+    const double childDuration = this->ChildDurations.back();
+    this->ChildDurations.pop_back();
+    if (!this->ChildDurations.empty())
+      {
+      this->ChildDurations.back() += duration;
+      }
+
+    TraceEvent event;
+    event.Category = category;
+    event.Name = name;
+    event.StartTime = startTime - this->Origin;
+    event.Duration = duration;
+    event.SelfDuration = std::max(duration - childDuration, 0.0);
+    event.Count = count;
+    event.Bytes = bytes;
+    event.Depth = static_cast<int>(this->ChildDurations.size());
+    this->Events.push_back(event);
+  }
+
+  DAX_CONT_EXPORT static std::string EscapeJSON(const std::string &value)
+  {
+    std::string result;
+    for (std::size_t index = 0; index < value.size(); ++index)
+      {
+      if (value[index] == '"' || value[index] == '\\') { result += '\\'; }
+      result += value[index];
+      }
+    return result;
+  }
+
+  bool Enabled;
+  double Origin;
+  std::vector<TraceEvent> Events;
+  std::vector<double> ChildDurations;
+};
+
+/// \brief Records the lifetime of a block in the TraceCollector.
+///
+/// Use the DAX_TRACE_SCOPE macro rather than this class directly so that
+/// tracing compiles away when it is disabled.
+///
+class TraceScope
+{
+public:
+  DAX_CONT_EXPORT TraceScope(const char *category,
+                             const std::string &name,
+                             dax::Id count,
+                             dax::internal::Int64Type bytes)
+    : Category(category), Name(name), Count(count), Bytes(bytes),
+      Active(TraceCollector::GetInstance().GetEnabled()), StartTime(0)
+  {
+    if (this->Active)
+      {
+      this->StartTime = TraceCollector::GetInstance().Begin();
+      }
+  }
+
+  DAX_CONT_EXPORT void SetCount(dax::Id count, dax::internal::Int64Type bytes)
+  {
+    this->Count = count;
+    this->Bytes = bytes;
+  }
+
+  DAX_CONT_EXPORT ~TraceScope()
+  {
+    if (this->Active)
+      {
+      TraceCollector::GetInstance().End(this->Category, this->Name,
+                                        this->StartTime,
+                                        this->Count, this->Bytes);
+      }
+  }
+
+private:
+  DAX_CONT_EXPORT TraceScope(const TraceScope &); // Not implemented.
+  DAX_CONT_EXPORT void operator=(const TraceScope &); // Not implemented.
+
+  const char *Category;
+  std::string Name;
+  dax::Id Count;
+  dax::internal::Int64Type Bytes;
+  bool Active;
+  double StartTime;
+};
+
+namespace internal {
+
+/// Returns a readable name of \c T for trace events.
+///
+template<typename T>
+DAX_CONT_EXPORT const std::string &GetTraceTypeName()
+{
+  static std::string name;
+  if (name.empty())
+    {
+    name = typeid(T).name();
+#if defined(__GNUC__)
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name.c_str(), NULL, NULL, &status);
+    if (status == 0 && demangled != NULL)
+      {
+      name = demangled;
+      }
+    std::free(demangled);
+#endif
+    }
+  return name;
+}
+
+/// The number of bytes in the values of an array handle or anything else
+/// with a ValueType and a GetNumberOfValues.
+///
+template<class ArrayHandleType>
+DAX_CONT_EXPORT
+dax::internal::Int64Type GetTraceBytes(const ArrayHandleType &array)
+{
+  return static_cast<dax::internal::Int64Type>(array.GetNumberOfValues())
+      * static_cast<dax::internal::Int64Type>(
+        sizeof(typename ArrayHandleType::ValueType));
+}
+
+} // namespace internal
+
+}
+} // namespace dax::cont
+
+#endif //__dax_cont_Tracing_h
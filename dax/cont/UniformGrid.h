@@ -87,6 +87,14 @@ private:
 
 } // namespace detail
 
+namespace internal {
+// Every coordinate is computed from its point index.
+template<>
+struct ArrayPortalComputesValues<
+    dax::cont::detail::ArrayPortalFromUniformGridPointCoordinates>
+    : boost::true_type {  };
+}
+
 /// This class defines the topology of a uniform grid. A uniform grid is axis
 /// aligned and has uniform spacing between grid points in every dimension. The
 /// grid can be shifted and scaled in space by defining and origin and spacing.
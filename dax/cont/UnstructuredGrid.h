@@ -29,19 +29,27 @@ namespace cont {
 /// This class defines the topology of an unstructured grid. An unstructured
 /// grid can only contain cells of a single type.
 ///
+/// The point indices in the cell connections are stored as \c
+/// ConnectionIdT, which is dax::Id unless given. A build with 64-bit
+/// dax::Id can store the connections of a grid with fewer than 2^31 points
+/// as dax::internal::Int32Type, which halves the memory and bandwidth they
+/// take. Indices are still computed as dax::Id.
+///
 template <
     typename CellT,
     class CellConnectionsContainerControlTag = DAX_DEFAULT_ARRAY_CONTAINER_CONTROL_TAG,
     class PointsArrayContainerControlTag = DAX_DEFAULT_ARRAY_CONTAINER_CONTROL_TAG,
-    class DeviceAdapterTag = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+    class DeviceAdapterTag = DAX_DEFAULT_DEVICE_ADAPTER_TAG,
+    typename ConnectionIdT = dax::Id>
 class UnstructuredGrid
 {
 public:
   typedef CellT CellTag;
   typedef dax::cont::internal::UnstructuredGridOfCell<CellTag> GridTypeTag;
+  typedef ConnectionIdT ConnectionIdType;
 
   typedef dax::cont::ArrayHandle<
-      dax::Id, CellConnectionsContainerControlTag, DeviceAdapterTag>
+      ConnectionIdType, CellConnectionsContainerControlTag, DeviceAdapterTag>
       CellConnectionsType;
   typedef dax::cont::ArrayHandle<
       dax::Vector3, PointsArrayContainerControlTag, DeviceAdapterTag>
@@ -0,0 +1,103 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_arg_GeometryInterpolatedCells_h
+#define __dax_cont_arg_GeometryInterpolatedCells_h
+
+#include <dax/Types.h>
+#include <dax/CellTraits.h>
+#include <dax/internal/Tags.h>
+#include <dax/cont/arg/ConceptMap.h>
+#include <dax/cont/arg/Geometry.h>
+#include <dax/cont/internal/InterpolatedCellsContainer.h>
+#include <dax/cont/sig/Tag.h>
+
+#include <dax/exec/arg/GeometryInterpolatedCell.h>
+
+namespace dax { namespace cont { namespace arg {
+
+/// \headerfile GeometryInterpolatedCells.h dax/cont/arg/GeometryInterpolatedCells.h
+/// \brief Map the output of an interpolated cell generation to an execution
+/// side parameter that writes the edge and ratio of every cell point
+template <typename Tags,
+          typename GridType,
+          typename EdgeHandleType,
+          typename RatioHandleType>
+class ConceptMap<Geometry(Tags),
+                 dax::cont::internal::InterpolatedCellsContainer<
+                   GridType, EdgeHandleType, RatioHandleType> >
+{
+  typedef dax::cont::internal::InterpolatedCellsContainer<
+      GridType, EdgeHandleType, RatioHandleType> InputType;
+
+  typedef typename EdgeHandleType::PortalExecution EdgePortalType;
+  typedef typename RatioHandleType::PortalExecution RatioPortalType;
+
+  InputType Input;
+  EdgeHandleType Edges;
+  RatioHandleType Ratios;
+  EdgePortalType EdgePortal;
+  RatioPortalType RatioPortal;
+
+public:
+  //All Topology binding classes must export the cell tag and grid tag
+  //This allows us to do better scheduling based on cell / grid types
+  typedef typename GridType::CellTag CellTypeTag;
+  typedef typename GridType::GridTypeTag GridTypeTag;
+
+  typedef InputType ContArg;
+  typedef dax::exec::arg::GeometryInterpolatedCell<Tags,
+                                                   CellTypeTag,
+                                                   EdgePortalType,
+                                                   RatioPortalType> ExecArg;
+  typedef dax::cont::sig::Cell DomainTag;
+
+  ConceptMap(InputType input):
+    Input(input),
+    Edges(input.Edges()),
+    Ratios(input.Ratios())
+    {}
+
+  ExecArg GetExecArg() const {
+    return ExecArg(this->EdgePortal,this->RatioPortal);
+  }
+
+  DAX_CONT_EXPORT const ContArg& GetContArg() const { return this->Input; }
+
+  //we need to pass the number of cells to allocate, every cell gets an
+  //edge and ratio for each of its points
+  void ToExecution(dax::Id size)
+    {
+    const dax::Id numPoints =
+        size * dax::CellTraits<CellTypeTag>::NUM_VERTICES;
+    this->EdgePortal = this->Edges.PrepareForOutput(numPoints);
+    this->RatioPortal = this->Ratios.PrepareForOutput(numPoints);
+    }
+
+  dax::Id GetDomainLength(sig::Point) const
+    {
+    return this->Edges.GetNumberOfValues();
+    }
+
+  dax::Id GetDomainLength(sig::Cell) const
+    {
+    return (this->Edges.GetNumberOfValues()
+            / dax::CellTraits<CellTypeTag>::NUM_VERTICES);
+    }
+};
+
+}}} // namespace dax::cont::arg
+
+#endif //__dax_cont_arg_GeometryInterpolatedCells_h
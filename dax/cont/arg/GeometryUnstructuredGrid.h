@@ -34,14 +34,16 @@ template <typename Tags,
           typename Cell,
           typename CellContainerTag,
           typename PointContainerTag,
-          typename DeviceTag
+          typename DeviceTag,
+          typename ConnectionIdType
           >
 class ConceptMap<Geometry(Tags), dax::cont::UnstructuredGrid< Cell,
                                  CellContainerTag,PointContainerTag,
-                                 DeviceTag > >
+                                 DeviceTag,ConnectionIdType > >
 {
   typedef dax::cont::UnstructuredGrid< Cell,
-          CellContainerTag, PointContainerTag, DeviceTag > GridType;
+          CellContainerTag, PointContainerTag, DeviceTag,
+          ConnectionIdType > GridType;
 
   //use mpl::if_ to determine the type for ExecArg
   typedef typename boost::mpl::if_<
@@ -117,14 +119,16 @@ template <typename Tags,
           typename Cell,
           typename CellContainerTag,
           typename PointContainerTag,
-          typename DeviceTag
+          typename DeviceTag,
+          typename ConnectionIdType
           >
 class ConceptMap<Geometry(Tags), const dax::cont::UnstructuredGrid< Cell,
                                  CellContainerTag,PointContainerTag,
-                                 DeviceTag > >
+                                 DeviceTag,ConnectionIdType > >
 {
   typedef dax::cont::UnstructuredGrid< Cell,
-          CellContainerTag, PointContainerTag, DeviceTag > GridType;
+          CellContainerTag, PointContainerTag, DeviceTag,
+          ConnectionIdType > GridType;
 
   //use mpl::if_ to determine the type for ExecArg
   typedef typename GridType::TopologyStructConstExecution TopologyType;
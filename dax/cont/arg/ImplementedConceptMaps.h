@@ -20,6 +20,7 @@
 
 //Add all concept maps to this header so that dispatchers can find them.
 #include <dax/cont/arg/ConceptMap.h>
+#include <dax/cont/arg/ExecutionObject.h>
 #include <dax/cont/arg/FieldArrayHandle.h>
 #include <dax/cont/arg/FieldArrayHandleConstant.h>
 #include <dax/cont/arg/FieldArrayHandleCounting.h>
@@ -28,6 +29,7 @@
 #include <dax/cont/arg/FieldArrayHandleTransform.h>
 #include <dax/cont/arg/FieldConstant.h>
 #include <dax/cont/arg/FieldMap.h>
+#include <dax/cont/arg/GeometryInterpolatedCells.h>
 #include <dax/cont/arg/GeometryUniformGrid.h>
 #include <dax/cont/arg/GeometryUnstructuredGrid.h>
 #include <dax/cont/arg/TopologyUniformGrid.h>
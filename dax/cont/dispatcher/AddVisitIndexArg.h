@@ -19,6 +19,7 @@
 #include <dax/Types.h>
 
 #include <dax/cont/DispatcherMapField.h>
+#include <dax/cont/Tracing.h>
 
 #include <dax/cont/arg/Field.h>
 #include <dax/cont/sig/Arg.h>
@@ -51,6 +52,8 @@ struct MakeVisitIndexControlType
     //the current input cell, we take the lower bounds of the
     //input cell id array. The resulting number subtracted from the WorkId
     //gives us the number of times we have visited that cell
+    DAX_TRACE_SCOPE("dispatcher", "BuildVisitIndex",
+                    inputCellIds.GetNumberOfValues(), 0);
     visitIndices.PrepareForOutput(inputCellIds.GetNumberOfValues());
     Algorithm::LowerBounds(inputCellIds, inputCellIds, visitIndices);
 
@@ -19,6 +19,8 @@
 
 #include <dax/Types.h>
 #include <dax/cont/arg/ConceptMap.h>
+#include <dax/cont/arg/Topology.h>
+#include <dax/cont/sig/Tag.h>
 
 #include <boost/mpl/if.hpp>
 #include <boost/type_traits/is_same.hpp>
@@ -26,6 +28,19 @@
 
 namespace dax { namespace cont { namespace dispatcher {
 
+namespace internal {
+//a concept provides the length of the domain named by its domain tag
+template <class Concept, class DomainTag, class DomainType>
+struct ConceptHasDomain : boost::is_same<DomainTag,DomainType> {};
+
+//topologies are in the cell domain, but they also know the number of points
+//so they provide the length for worklets that visit points
+template <>
+struct ConceptHasDomain<dax::cont::arg::Topology,
+                        dax::cont::sig::Cell,
+                        dax::cont::sig::Point> : boost::true_type {};
+}
+
 template <class DomainType>
 class CollectCount
 {
@@ -45,7 +60,8 @@ public:
     typedef dax::cont::arg::ConceptMap<C,A> ConceptType;
     typedef dax::cont::arg::ConceptMapTraits<ConceptType> Traits;
     typedef typename Traits::DomainTag DomainTag;
-    typedef typename boost::is_same<DomainTag,DomainType>::type HasDomain;
+    typedef typename internal::ConceptHasDomain<
+        typename Traits::Concept,DomainTag,DomainType>::type HasDomain;
 
     this->getCount<ConceptType,HasDomain>(c);
     }
@@ -23,6 +23,10 @@
 #include <dax/cont/internal/GridTags.h>
 
 #include <dax/exec/WorkletMapCell.h>
+#include <dax/exec/WorkletMapPointNeighborhood.h>
+
+#include <boost/mpl/assert.hpp>
+#include <boost/type_traits/is_same.hpp>
 
 namespace dax { namespace cont { namespace dispatcher {
 
@@ -146,5 +150,47 @@ public:
 
 };
 
+//worklet map point neighborhood visits every point of a uniform grid, so it
+//is always scheduled over the point dimensions of the grid
+template<typename Invocation>
+class DetermineIndicesAndGridType<dax::exec::WorkletMapPointNeighborhood,
+                                  Invocation>
+{
+  typedef typename dax::cont::internal::FindBinding<
+                                  Invocation,
+                                  dax::cont::arg::Topology>::type TopoIndex;
+  typedef typename dax::cont::internal::Bindings<Invocation>::type BindingsType;
+  typedef typename BindingsType::template GetType<
+                                  TopoIndex::value>::type TopoControlBinding;
+  typedef typename TopoControlBinding::ContArg TopoContArgType;
+  typedef typename TopoControlBinding::GridTypeTag GridTypeTag;
+
+  //if you get a compile error here, the neighborhood of a point is only
+  //implicit for uniform grids
+  BOOST_MPL_ASSERT((boost::is_same<GridTypeTag,
+                                   dax::cont::internal::UniformGridTag>));
+
+  const TopoContArgType& Topology;
+  const dax::Id NumInstances;
+
+public:
+  DetermineIndicesAndGridType(const BindingsType& bindings,
+                              dax::Id numInstances):
+    Topology( internal::get_topology<TopoContArgType, TopoIndex::value >(bindings) ),
+    NumInstances(numInstances)
+    {
+    }
+
+  dax::Id3 gridCount() const
+  {
+    return dax::extentDimensions(this->Topology.GetExtent());
+  }
+
+  bool isValidForGridScheduling() const
+    {
+    return this->NumInstances == this->Topology.GetNumberOfPoints();
+    }
+};
+
 } } } //namespace dax::cont::dispatcher
 #endif
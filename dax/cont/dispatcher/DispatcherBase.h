@@ -27,6 +27,8 @@
 # include <dax/internal/ParameterPackCxx03.h>
 #endif // !DAX_USE_VARIADIC_TEMPLATE
 
+#include <dax/cont/MemoryRegistry.h>
+#include <dax/cont/Tracing.h>
 #include <dax/cont/arg/ImplementedConceptMaps.h>
 #include <dax/cont/internal/Bindings.h>
 
@@ -65,6 +67,11 @@ public:
     // (Check the type for WorkletType. It should match WorkletBaseType.)
     BOOST_MPL_ASSERT((Worklet_Should_Match_DispatcherType));
 
+    DAX_TRACE_SCOPE("dispatcher",
+        dax::cont::internal::GetTraceTypeName<DerivedDispatcher>(), 0, 0);
+    // Execution arrays may be dropped to meet the memory budgets only
+    // before the arguments are moved to the execution environment.
+    dax::cont::internal::MemoryBudgetScope memoryBudgetScope;
     static_cast<DerivedDispatcher*>(this)->DoInvoke(
       this->Worklet, dax::internal::make_ParameterPack(arguments...));
     }
@@ -93,6 +100,11 @@ protected:
   // from the worklet that the dispatcher is templated on.
   BOOST_MPL_ASSERT((DerivedWorklet_Should_Match));
 
+  // The scope covers moving the arguments to the execution environment and
+  // scheduling the worklet, which are also traced on their own.
+  DAX_TRACE_SCOPE("worklet",
+                  dax::cont::internal::GetTraceTypeName<WorkletType>(), 0, 0);
+
   typedef dax::cont::dispatcher::VerifyUserArgLength<DerivedWorkletType,
               ParameterPackType::NUM_PARAMETERS> WorkletUserArgs;
   //if you are getting this error you are passing less arguments than requested
@@ -116,6 +128,7 @@ protected:
   dax::Id count=1;
   bindings.ForEachCont(
         dax::cont::dispatcher::CollectCount<DomainType>(count));
+  DAX_TRACE_SCOPE_SET_COUNT(count, 0);
 
   // Visit each bound argument to set up its representation in the
   // execution environment.
@@ -165,6 +178,11 @@ private:
     // (Check the type for WorkletType. It should match WorkletBaseType.)
     BOOST_MPL_ASSERT((Worklet_Should_Match_DispatcherType));
 
+    DAX_TRACE_SCOPE("dispatcher",
+        dax::cont::internal::GetTraceTypeName<DerivedDispatcher>(), 0, 0);
+    // Execution arrays may be dropped to meet the memory budgets only
+    // before the arguments are moved to the execution environment.
+    dax::cont::internal::MemoryBudgetScope memoryBudgetScope;
     static_cast<DerivedDispatcher*>(this)->DoInvoke(
       this->Worklet,
       dax::internal::make_ParameterPack( _dax_pp_args___(arguments) ) );
@@ -0,0 +1,99 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_internal_ArrayContainerControlFirstTouch_h
+#define __dax_cont_internal_ArrayContainerControlFirstTouch_h
+
+#include <dax/Types.h>
+#include <dax/cont/ArrayContainerControl.h>
+#include <dax/cont/ArrayContainerControlAligned.h>
+#include <dax/exec/internal/ErrorMessageBuffer.h>
+
+#include <unistd.h>
+
+namespace dax {
+namespace cont {
+
+// Declared in dax/cont/internal/DeviceAdapterAlgorithm.h, which includes the
+// ArrayManagerExecution classes that use this header.
+template<class DeviceAdapterTag> struct DeviceAdapterAlgorithm;
+
+namespace internal {
+
+namespace detail {
+
+class ArrayFirstTouchKernel
+{
+public:
+  DAX_CONT_EXPORT ArrayFirstTouchKernel(char *begin, dax::Id pageSize)
+    : Begin(begin), PageSize(pageSize) {  }
+
+  DAX_EXEC_EXPORT void operator()(dax::Id page) const
+  {
+    // One write is enough to place the whole page.
+    static_cast<volatile char *>(this->Begin)[page*this->PageSize] = 0;
+  }
+
+  DAX_CONT_EXPORT
+  void SetErrorMessageBuffer(const dax::exec::internal::ErrorMessageBuffer &)
+  {  }
+
+private:
+  char *Begin;
+  dax::Id PageSize;
+};
+
+} // namespace detail
+
+/// Containers other than ArrayContainerControlTagAligned leave the pages of
+/// their arrays to whichever thread writes them first.
+///
+template<class DeviceAdapterTag, typename T, class ArrayContainerControlTag>
+DAX_CONT_EXPORT void ArrayContainerControlFirstTouch(
+    ArrayContainerControl<T, ArrayContainerControlTag> &)
+{  }
+
+/// Touches every page of a newly allocated aligned array with a schedule of
+/// the given device adapter. The threads get contiguous blocks of pages like
+/// they get contiguous blocks of values in a schedule over the array, so most
+/// pages land on the memory of the thread that will fill them.
+///
+template<class DeviceAdapterTag, typename T>
+DAX_CONT_EXPORT void ArrayContainerControlFirstTouch(
+    ArrayContainerControl<T, dax::cont::ArrayContainerControlTagAligned>
+      &container)
+{
+  if (!container.GetFirstTouchPending()) { return; }
+  container.SetFirstTouched();
+
+  const dax::Id pageSize = static_cast<dax::Id>(sysconf(_SC_PAGESIZE));
+  const dax::Id numberOfBytes =
+      container.GetNumberOfValues() * static_cast<dax::Id>(sizeof(T));
+  const dax::Id numberOfPages = (numberOfBytes + pageSize - 1) / pageSize;
+  if (numberOfPages <= 1) { return; }
+
+  dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>::Schedule(
+        detail::ArrayFirstTouchKernel(
+          reinterpret_cast<char *>(
+            container.GetPortal().GetIteratorBegin()),
+          pageSize),
+        numberOfPages);
+}
+
+}
+}
+} // namespace dax::cont::internal
+
+#endif //__dax_cont_internal_ArrayContainerControlFirstTouch_h
@@ -0,0 +1,374 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_internal_ArrayContainerControlInterpolated_h
+#define __dax_cont_internal_ArrayContainerControlInterpolated_h
+
+#include <dax/cont/ArrayContainerControl.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/ErrorControlInternal.h>
+#include <dax/cont/internal/ArrayTransfer.h>
+#include <dax/cont/internal/IteratorFromArrayPortal.h>
+#include <dax/exec/internal/InterpolationEdge.h>
+#include <dax/math/VectorAnalysis.h>
+
+#include <algorithm>
+
+namespace dax {
+namespace cont {
+namespace internal {
+
+/// \brief An implicit array portal that interpolates a point field.
+///
+/// Value \c index lies at the ratio \c Ratios.Get(index) along the edge
+/// \c Edges.Get(index) (see dax::exec::internal::MakeInterpolationEdge), so
+/// it is interpolated between the two values of \c Field at the ends of the
+/// edge every time it is read.
+///
+template <class ValueType_,
+          class EdgePortalType_,
+          class RatioPortalType_,
+          class FieldPortalType_>
+class ArrayPortalInterpolated
+{
+public:
+  typedef ValueType_ ValueType;
+  typedef EdgePortalType_ EdgePortalType;
+  typedef RatioPortalType_ RatioPortalType;
+  typedef FieldPortalType_ FieldPortalType;
+
+  DAX_CONT_EXPORT
+  ArrayPortalInterpolated() :
+  Edges(),
+  Ratios(),
+  Field()
+  {  }
+
+  DAX_CONT_EXPORT
+  ArrayPortalInterpolated(const EdgePortalType &edges,
+                          const RatioPortalType &ratios,
+                          const FieldPortalType &field) :
+  Edges(edges),
+  Ratios(ratios),
+  Field(field)
+  {  }
+
+  /// Copy constructor for any other ArrayPortalInterpolated with portal
+  /// types that can be copied to these portal types. This allows us to do
+  /// any type casting that the portals do (like the non-const to const cast).
+  ///
+  template<class OtherV, class OtherE, class OtherR, class OtherF>
+  DAX_CONT_EXPORT
+  ArrayPortalInterpolated(
+      const ArrayPortalInterpolated<OtherV,OtherE,OtherR,OtherF> &src)
+    : Edges(src.GetEdges()),
+      Ratios(src.GetRatios()),
+      Field(src.GetField())
+  {  }
+
+  DAX_EXEC_EXPORT
+  dax::Id GetNumberOfValues() const {
+    return this->Edges.GetNumberOfValues();
+  }
+
+  DAX_EXEC_EXPORT
+  ValueType Get(dax::Id index) const {
+    const dax::exec::internal::InterpolationEdgeType edge =
+        this->Edges.Get(index);
+    return dax::math::Lerp(
+          this->Field.Get(dax::exec::internal::InterpolationEdgeFirst(edge)),
+          this->Field.Get(dax::exec::internal::InterpolationEdgeSecond(edge)),
+          this->Ratios.Get(index));
+  }
+
+  typedef dax::cont::internal::IteratorFromArrayPortal<
+      ArrayPortalInterpolated<ValueType, EdgePortalType,
+                              RatioPortalType, FieldPortalType> > IteratorType;
+
+  DAX_EXEC_EXPORT
+  IteratorType GetIteratorBegin() const
+  {
+    return IteratorType(*this);
+  }
+
+  DAX_EXEC_EXPORT
+  IteratorType GetIteratorEnd() const
+  {
+    return IteratorType(*this, this->GetNumberOfValues());
+  }
+
+  DAX_CONT_EXPORT
+  const EdgePortalType &GetEdges() const { return this->Edges; }
+  DAX_CONT_EXPORT
+  const RatioPortalType &GetRatios() const { return this->Ratios; }
+  DAX_CONT_EXPORT
+  const FieldPortalType &GetField() const { return this->Field; }
+
+private:
+  EdgePortalType Edges;
+  RatioPortalType Ratios;
+  FieldPortalType Field;
+};
+
+//simple container for the three array handles so we can get them inside
+//the array transfer class
+template<class EdgeHandleType, class RatioHandleType, class FieldHandleType>
+struct ArrayPortalConstInterpolated
+{
+  DAX_CONT_EXPORT
+  ArrayPortalConstInterpolated():
+  Edges(),
+  Ratios(),
+  Field()
+  { }
+
+  DAX_CONT_EXPORT
+  ArrayPortalConstInterpolated(const EdgeHandleType &edges,
+                               const RatioHandleType &ratios,
+                               const FieldHandleType &field):
+  Edges(edges),
+  Ratios(ratios),
+  Field(field)
+  { }
+
+  DAX_CONT_EXPORT
+  dax::Id GetNumberOfValues() const {
+    return this->Edges.GetNumberOfValues();
+  }
+
+  EdgeHandleType Edges;
+  RatioHandleType Ratios;
+  FieldHandleType Field;
+};
+
+
+template<class ValueType,
+         class EdgeHandleType,
+         class RatioHandleType,
+         class FieldHandleType>
+struct ArrayContainerControlTagInterpolated { };
+
+/// A convenience class that provides a typedef to the appropriate tag for
+/// an interpolated array container.
+template<typename ValueType,
+         typename EdgeHandleType,
+         typename RatioHandleType,
+         typename FieldHandleType>
+struct ArrayHandleInterpolatedTraits
+{
+  typedef dax::cont::internal::ArrayContainerControlTagInterpolated<
+                                                ValueType,
+                                                EdgeHandleType,
+                                                RatioHandleType,
+                                                FieldHandleType > Tag;
+  typedef dax::cont::internal::ArrayContainerControl<
+          ValueType, Tag > ContainerType;
+
+};
+
+
+template<typename T,
+         class EdgeHandleType,
+         class RatioHandleType,
+         class FieldHandleType>
+class ArrayContainerControl<
+    T,
+    ArrayContainerControlTagInterpolated<T,
+                                         EdgeHandleType,
+                                         RatioHandleType,
+                                         FieldHandleType> >
+{
+public:
+
+  typedef T ValueType;
+  typedef ArrayPortalConstInterpolated<EdgeHandleType,
+                                       RatioHandleType,
+                                       FieldHandleType> PortalType;
+  typedef PortalType PortalConstType;
+
+public:
+  DAX_CONT_EXPORT
+  ArrayContainerControl() {
+  }
+
+
+  DAX_CONT_EXPORT
+  PortalType GetPortal() {
+    throw dax::cont::ErrorControlBadValue(
+          "Interpolated arrays are read-only.");
+  }
+
+  DAX_CONT_EXPORT
+  PortalConstType GetPortalConst() const {
+    throw dax::cont::ErrorControlBadValue(
+          "Interpolated container does not store array portal.  "
+          "Perhaps you did not set the ArrayPortal when "
+          "constructing the ArrayHandle.");
+  }
+
+  DAX_CONT_EXPORT
+  dax::Id GetNumberOfValues() const {
+    throw dax::cont::ErrorControlBadValue(
+          "Interpolated container does not store array portal.  "
+          "Perhaps you did not set the ArrayPortal when "
+          "constructing the ArrayHandle.");
+  }
+
+  DAX_CONT_EXPORT
+  void Allocate(dax::Id daxNotUsed(numberOfValues)) {
+    throw dax::cont::ErrorControlInternal(
+      "The allocate method for the interpolated control array container "
+      "should never have been called. The allocate is generally only called "
+      "by the execution array manager, and the array transfer for the "
+      "interpolated container should prevent the execution array manager "
+      "from being directly used.");
+  }
+
+  DAX_CONT_EXPORT
+  void Shrink(dax::Id daxNotUsed(numberOfValues)) {
+    throw dax::cont::ErrorControlBadValue(
+          "Interpolated arrays are read-only.");
+  }
+
+  DAX_CONT_EXPORT
+  void ReleaseResources() {
+    throw dax::cont::ErrorControlBadValue(
+          "Interpolated arrays are read-only.");
+  }
+};
+
+
+template<typename T,
+         class EdgeHandleType,
+         class RatioHandleType,
+         class FieldHandleType,
+         class DeviceAdapterTag>
+class ArrayTransfer<
+    T,
+    ArrayContainerControlTagInterpolated<T,
+                                         EdgeHandleType,
+                                         RatioHandleType,
+                                         FieldHandleType>,
+    DeviceAdapterTag>
+{
+private:
+  typedef ArrayContainerControlTagInterpolated<T,
+                                               EdgeHandleType,
+                                               RatioHandleType,
+                                               FieldHandleType>
+      ArrayContainerControlTag;
+  typedef dax::cont::internal::ArrayContainerControl<T,ArrayContainerControlTag>
+      ContainerType;
+
+public:
+  typedef T ValueType;
+
+  typedef typename ContainerType::PortalType PortalControl;
+  typedef typename ContainerType::PortalConstType PortalConstControl;
+
+  typedef ArrayPortalInterpolated< ValueType,
+                  typename EdgeHandleType::PortalConstExecution,
+                  typename RatioHandleType::PortalConstExecution,
+                  typename FieldHandleType::PortalConstExecution>
+      PortalExecution;
+  typedef PortalExecution PortalConstExecution;
+
+
+  DAX_CONT_EXPORT
+  ArrayTransfer() :
+    PortalValid(false),
+    NumberOfValues(0),
+    Portal()
+  {
+  }
+
+  DAX_CONT_EXPORT dax::Id GetNumberOfValues() const {
+    DAX_ASSERT_CONT(this->PortalValid);
+    return this->NumberOfValues;
+  }
+
+  DAX_CONT_EXPORT void LoadDataForInput(PortalConstControl portal)
+  {
+    if (portal.Ratios.GetNumberOfValues() != portal.GetNumberOfValues())
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Interpolated arrays need one ratio per edge.");
+      }
+    this->NumberOfValues = portal.GetNumberOfValues();
+    this->Portal = PortalConstExecution(portal.Edges.PrepareForInput(),
+                                        portal.Ratios.PrepareForInput(),
+                                        portal.Field.PrepareForInput());
+    this->PortalValid = true;
+  }
+
+  DAX_CONT_EXPORT void LoadDataForInPlace(PortalControl daxNotUsed(portal))
+  {
+    throw dax::cont::ErrorControlBadValue(
+          "Implicit arrays cannot be used for output or in place.");
+  }
+
+  DAX_CONT_EXPORT void AllocateArrayForOutput(
+      ContainerType &daxNotUsed(controlArray),
+      dax::Id daxNotUsed(numberOfValues))
+  {
+    throw dax::cont::ErrorControlBadValue(
+          "Implicit arrays cannot be used for output.");
+  }
+  DAX_CONT_EXPORT void RetrieveOutputData(
+      ContainerType &daxNotUsed(controlArray)) const
+  {
+    throw dax::cont::ErrorControlBadValue(
+          "Implicit arrays cannot be used for output.");
+  }
+
+  template <class IteratorTypeControl>
+  DAX_CONT_EXPORT void CopyInto(IteratorTypeControl dest) const
+  {
+    DAX_ASSERT_CONT(this->PortalValid);
+    std::copy(this->Portal.GetIteratorBegin(),
+              this->Portal.GetIteratorEnd(),
+              dest);
+  }
+
+  DAX_CONT_EXPORT void Shrink(dax::Id daxNotUsed(numberOfValues))
+  {
+    throw dax::cont::ErrorControlBadValue("Implicit arrays cannot be resized.");
+  }
+
+  DAX_CONT_EXPORT PortalExecution GetPortalExecution()
+  {
+    throw dax::cont::ErrorControlBadValue(
+          "Implicit arrays are read-only.  (Get the const portal.)");
+  }
+  DAX_CONT_EXPORT PortalConstExecution GetPortalConstExecution() const
+  {
+    DAX_ASSERT_CONT(this->PortalValid);
+    return this->Portal;
+  }
+
+  DAX_CONT_EXPORT void ReleaseResources() {  }
+
+private:
+  bool PortalValid;
+  dax::Id NumberOfValues;
+  PortalConstExecution Portal;
+
+};
+
+}
+}
+} // namespace dax::cont::internal
+
+#endif //__dax_cont_internal_ArrayContainerControlInterpolated_h
@@ -145,6 +145,21 @@ public:
 ;
 #endif // DAX_DOXYGEN_ONLY
 
+/// \brief Names the memory in which the ArrayManagerExecution of a device
+/// adapter allocates its arrays.
+///
+/// The dax::cont::MemoryRegistry accounts for execution arrays by this name.
+/// This default is for device adapters whose execution arrays share the
+/// memory of the control arrays. Device adapters with a memory of their own
+/// specialize it with \c IS_SEPARATE true and the name of that memory.
+///
+template<class DeviceAdapterTag>
+struct ArrayManagerExecutionMemorySpace
+{
+  static const bool IS_SEPARATE = false;
+  DAX_CONT_EXPORT static const char *GetName() { return "control"; }
+};
+
 }
 }
 } // namespace dax::cont::internal
@@ -163,6 +178,8 @@ public:
 #include <dax/openmp/cont/internal/ArrayManagerExecutionOpenMP.h>
 #elif DAX_DEVICE_ADAPTER == DAX_DEVICE_ADAPTER_TBB
 #include <dax/tbb/cont/internal/ArrayManagerExecutionTBB.h>
+#elif DAX_DEVICE_ADAPTER == DAX_DEVICE_ADAPTER_STDTHREAD
+#include <dax/stdthread/cont/internal/ArrayManagerExecutionStdThread.h>
 #endif
 
 #endif //__dax_cont_internal_ArrayManagerExecution_h
@@ -55,16 +55,17 @@ struct DeviceAdapterAlgorithm
   ///
   /// LowerBounds is a vectorized search. From each value in \c values it finds
   /// the first place the item can be inserted in the ordered \c input array and
-  /// stores the index in \c output.
+  /// stores the index in \c output. The output may hold any integer type,
+  /// such as a 32-bit index array in a build with 64-bit dax::Id.
   ///
   /// \par Requirements:
   /// \arg \c input must already be sorted
   ///
-  template<typename T, class CIn, class CVal, class COut>
+  template<typename T, typename IndexType, class CIn, class CVal, class COut>
   DAX_CONT_EXPORT static void LowerBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>& values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& output);
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>& output);
 
   /// \brief Output is the first index in input for each item in values that wouldn't alter the ordering of input
   ///
@@ -76,24 +77,25 @@ struct DeviceAdapterAlgorithm
   /// \par Requirements:
   /// \arg \c input must already be sorted
   ///
-  template<typename T, class CIn, class CVal, class COut, class Compare>
+  template<typename T, typename IndexType,
+           class CIn, class CVal, class COut, class Compare>
   DAX_CONT_EXPORT static void LowerBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>& values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& output,
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>& output,
       Compare comp);
 
   /// \brief A special version of LowerBounds that does an in place operation.
   ///
   /// This version of lower bounds performs an in place operation where each
   /// value in the \c values_output array is replaced by the index in \c input
-  /// where it occurs. Because this is an in place operation, the type of the
-  /// arrays is limited to dax::Id.
+  /// where it occurs. Because this is an in place operation, the arrays must
+  /// hold an integer index type, such as dax::Id.
   ///
-  template<class CIn, class COut>
+  template<typename T, class CIn, class COut>
   DAX_CONT_EXPORT static void LowerBounds(
-      const dax::cont::ArrayHandle<dax::Id,CIn,DeviceAdapterTag>& input,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& values_output);
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& values_output);
 
   /// \brief Compute an inclusive prefix sum operation on the input ArrayHandle.
   ///
@@ -285,16 +287,17 @@ struct DeviceAdapterAlgorithm
   ///
   /// UpperBounds is a vectorized search. From each value in \c values it finds
   /// the last place the item can be inserted in the ordered \c input array and
-  /// stores the index in \c output.
+  /// stores the index in \c output. The output may hold any integer type,
+  /// such as a 32-bit index array in a build with 64-bit dax::Id.
   ///
   /// \par Requirements:
   /// \arg \c input must already be sorted
   ///
-  template<typename T, class CIn, class CVal, class COut>
+  template<typename T, typename IndexType, class CIn, class CVal, class COut>
   DAX_CONT_EXPORT static void UpperBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag___>& input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag___>& values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag___>& output);
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag___>& output);
 
   /// \brief Output is the last index in input for each item in values that wouldn't alter the ordering of input
   ///
@@ -306,24 +309,25 @@ struct DeviceAdapterAlgorithm
   /// \par Requirements:
   /// \arg \c input must already be sorted
   ///
-  template<typename T, class CIn, class CVal, class COut, class Compare>
+  template<typename T, typename IndexType,
+           class CIn, class CVal, class COut, class Compare>
   DAX_CONT_EXPORT static void UpperBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>& values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& output,
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>& output,
       Compare comp);
 
   /// \brief A special version of UpperBounds that does an in place operation.
   ///
   /// This version of lower bounds performs an in place operation where each
   /// value in the \c values_output array is replaced by the last index in
-  /// \c input where it occurs. Because this is an in place operation, the type
-  /// of the arrays is limited to dax::Id.
+  /// \c input where it occurs. Because this is an in place operation, the
+  /// arrays must hold an integer index type, such as dax::Id.
   ///
-  template<class CIn, class COut>
+  template<typename T, class CIn, class COut>
   DAX_CONT_EXPORT static void UpperBounds(
-      const dax::cont::ArrayHandle<dax::Id,CIn,DeviceAdapterTag___>& input,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag___>& values_output);
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag___>& input,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag___>& values_output);
 };
 #else // DAX_DOXYGEN_ONLY
     ;
@@ -418,6 +422,8 @@ public:
 #include <dax/openmp/cont/internal/DeviceAdapterAlgorithmOpenMP.h>
 #elif DAX_DEVICE_ADAPTER == DAX_DEVICE_ADAPTER_TBB
 #include <dax/tbb/cont/internal/DeviceAdapterAlgorithmTBB.h>
+#elif DAX_DEVICE_ADAPTER == DAX_DEVICE_ADAPTER_STDTHREAD
+#include <dax/stdthread/cont/internal/DeviceAdapterAlgorithmStdThread.h>
 #endif
 
 #endif //__dax_cont_DeviceAdapterAlgorithm_h
@@ -20,6 +20,8 @@
 #include <dax/cont/ArrayHandleConstant.h>
 #include <dax/cont/ArrayHandleCounting.h>
 #include <dax/cont/ArrayContainerControlBasic.h>
+#include <dax/cont/ArrayContainerControlScratch.h>
+#include <dax/cont/Tracing.h>
 #include <dax/cont/internal/ArrayHandleZip.h>
 
 #include <dax/Functional.h>
@@ -99,7 +101,7 @@ private:
   {
     typedef dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> InputArrayType;
     typedef dax::cont::ArrayHandle<
-        T,dax::cont::ArrayContainerControlTagBasic,DeviceAdapterTag>
+        T,dax::cont::ArrayContainerControlTagScratch,DeviceAdapterTag>
         OutputArrayType;
 
     OutputArrayType output;
@@ -155,6 +157,8 @@ public:
       const dax::cont::ArrayHandle<T, CIn, DeviceAdapterTag> &input,
       dax::cont::ArrayHandle<T, COut, DeviceAdapterTag> &output)
   {
+    DAX_TRACE_SCOPE("algorithm", "Copy", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     dax::Id arraySize = input.GetNumberOfValues();
 
     CopyKernel<
@@ -253,18 +257,22 @@ private:
 
 
 public:
-  template<typename T, class CIn, class CVal, class COut>
+  template<typename T, typename IndexType, class CIn, class CVal, class COut>
   DAX_CONT_EXPORT static void LowerBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag> &values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &output)
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag> &output)
   {
+    DAX_TRACE_SCOPE("algorithm", "LowerBounds", values.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(values)
+                    + values.GetNumberOfValues()*sizeof(IndexType));
     dax::Id arraySize = values.GetNumberOfValues();
 
     LowerBoundsKernel<
         typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>::PortalConstExecution,
         typename dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>::PortalConstExecution,
-        typename dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>::PortalExecution>
+        typename dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>::PortalExecution>
         kernel(input.PrepareForInput(),
                values.PrepareForInput(),
                output.PrepareForOutput(arraySize));
@@ -272,19 +280,24 @@ public:
     DerivedAlgorithm::Schedule(kernel, arraySize);
   }
 
-  template<typename T, class CIn, class CVal, class COut, class Compare>
+  template<typename T, typename IndexType,
+           class CIn, class CVal, class COut, class Compare>
   DAX_CONT_EXPORT static void LowerBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag> &values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &output,
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag> &output,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "LowerBounds", values.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(values)
+                    + values.GetNumberOfValues()*sizeof(IndexType));
     dax::Id arraySize = values.GetNumberOfValues();
 
     LowerBoundsComparisonKernel<
         typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>::PortalConstExecution,
         typename dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>::PortalConstExecution,
-        typename dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>::PortalExecution,
+        typename dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>::PortalExecution,
         Compare>
         kernel(input.PrepareForInput(),
                values.PrepareForInput(),
@@ -294,10 +307,10 @@ public:
     DerivedAlgorithm::Schedule(kernel, arraySize);
   }
 
-  template<class CIn, class COut>
+  template<typename T, class CIn, class COut>
   DAX_CONT_EXPORT static void LowerBounds(
-      const dax::cont::ArrayHandle<dax::Id,CIn,DeviceAdapterTag> &input,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &values_output)
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag> &values_output)
   {
     DeviceAdapterAlgorithmGeneral<
         DerivedAlgorithm,DeviceAdapterTag>::LowerBounds(input,
@@ -336,8 +349,10 @@ public:
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "ScanExclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     typedef dax::cont::ArrayHandle<
-        T,dax::cont::ArrayContainerControlTagBasic,DeviceAdapterTag>
+        T,dax::cont::ArrayContainerControlTagScratch,DeviceAdapterTag>
         TempArrayType;
     typedef dax::cont::ArrayHandle<T,COut,DeviceAdapterTag> OutputArrayType;
 
@@ -414,6 +429,8 @@ public:
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "ScanInclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     typedef typename
         dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>::PortalExecution
             PortalType;
@@ -539,6 +556,8 @@ public:
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTag> &values,
       CompareType compare)
   {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     typedef typename dax::cont::ArrayHandle<T,Container,DeviceAdapterTag>
         ArrayType;
     typedef typename ArrayType::PortalExecution PortalType;
@@ -601,6 +620,9 @@ public:
       dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTag> &keys,
       dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTag> &values)
   {
+    DAX_TRACE_SCOPE("algorithm", "SortByKey", keys.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(keys)
+                    + 2*dax::cont::internal::GetTraceBytes(values));
     //combine the keys and values into a ZipArrayHandle
     //we than need to specify a custom compare function wrapper
     //that only checks for key side of the pair, using a custom compare functor.
@@ -621,6 +643,9 @@ public:
       dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTag> &values,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "SortByKey", keys.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(keys)
+                    + 2*dax::cont::internal::GetTraceBytes(values));
     //combine the keys and values into a ZipArrayHandle
     //we than need to specify a custom compare function wrapper
     //that only checks for key side of the pair, using the custom compare
@@ -714,11 +739,14 @@ public:
       const dax::cont::ArrayHandle<U,CStencil,DeviceAdapterTag>& stencil,
       dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "StreamCompact", stencil.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(stencil));
     DAX_ASSERT_CONT(input.GetNumberOfValues() == stencil.GetNumberOfValues());
     dax::Id arrayLength = stencil.GetNumberOfValues();
 
     typedef dax::cont::ArrayHandle<
-        dax::Id, dax::cont::ArrayContainerControlTagBasic, DeviceAdapterTag>
+        dax::Id, dax::cont::ArrayContainerControlTagScratch, DeviceAdapterTag>
         IndexArrayType;
     IndexArrayType indices;
 
@@ -853,20 +881,22 @@ public:
   DAX_CONT_EXPORT static void Unique(
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTag> &values)
   {
+    DAX_TRACE_SCOPE("algorithm", "Unique", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     dax::cont::ArrayHandle<
-        dax::Id, dax::cont::ArrayContainerControlTagBasic, DeviceAdapterTag>
+        dax::Id, dax::cont::ArrayContainerControlTagScratch, DeviceAdapterTag>
         stencilArray;
     dax::Id inputSize = values.GetNumberOfValues();
 
     ClassifyUniqueKernel<
         typename dax::cont::ArrayHandle<T,Container,DeviceAdapterTag>::PortalConstExecution,
-        typename dax::cont::ArrayHandle<dax::Id,dax::cont::ArrayContainerControlTagBasic,DeviceAdapterTag>::PortalExecution>
+        typename dax::cont::ArrayHandle<dax::Id,dax::cont::ArrayContainerControlTagScratch,DeviceAdapterTag>::PortalExecution>
         classifyKernel(values.PrepareForInput(),
                        stencilArray.PrepareForOutput(inputSize));
     DerivedAlgorithm::Schedule(classifyKernel, inputSize);
 
     dax::cont::ArrayHandle<
-        T, dax::cont::ArrayContainerControlTagBasic, DeviceAdapterTag>
+        T, dax::cont::ArrayContainerControlTagScratch, DeviceAdapterTag>
         outputArray;
 
     DerivedAlgorithm::StreamCompact(values, stencilArray, outputArray);
@@ -879,14 +909,16 @@ public:
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTag> &values,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "Unique", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     dax::cont::ArrayHandle<
-        dax::Id, dax::cont::ArrayContainerControlTagBasic, DeviceAdapterTag>
+        dax::Id, dax::cont::ArrayContainerControlTagScratch, DeviceAdapterTag>
         stencilArray;
     dax::Id inputSize = values.GetNumberOfValues();
 
     ClassifyUniqueComparisonKernel<
         typename dax::cont::ArrayHandle<T,Container,DeviceAdapterTag>::PortalConstExecution,
-        typename dax::cont::ArrayHandle<dax::Id,dax::cont::ArrayContainerControlTagBasic,DeviceAdapterTag>::PortalExecution,
+        typename dax::cont::ArrayHandle<dax::Id,dax::cont::ArrayContainerControlTagScratch,DeviceAdapterTag>::PortalExecution,
         Compare>
         classifyKernel(values.PrepareForInput(),
                        stencilArray.PrepareForOutput(inputSize),
@@ -894,7 +926,7 @@ public:
     DerivedAlgorithm::Schedule(classifyKernel, inputSize);
 
     dax::cont::ArrayHandle<
-        T, dax::cont::ArrayContainerControlTagBasic, DeviceAdapterTag>
+        T, dax::cont::ArrayContainerControlTagScratch, DeviceAdapterTag>
         outputArray;
 
     DerivedAlgorithm::StreamCompact(values, stencilArray, outputArray);
@@ -989,18 +1021,22 @@ private:
   };
 
 public:
-  template<typename T, class CIn, class CVal, class COut>
+  template<typename T, typename IndexType, class CIn, class CVal, class COut>
   DAX_CONT_EXPORT static void UpperBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag> &values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &output)
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag> &output)
   {
+    DAX_TRACE_SCOPE("algorithm", "UpperBounds", values.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(values)
+                    + values.GetNumberOfValues()*sizeof(IndexType));
     dax::Id arraySize = values.GetNumberOfValues();
 
     UpperBoundsKernel<
         typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>::PortalConstExecution,
         typename dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>::PortalConstExecution,
-        typename dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>::PortalExecution>
+        typename dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>::PortalExecution>
         kernel(input.PrepareForInput(),
                values.PrepareForInput(),
                output.PrepareForOutput(arraySize));
@@ -1008,19 +1044,24 @@ public:
     DerivedAlgorithm::Schedule(kernel, arraySize);
   }
 
-  template<typename T, class CIn, class CVal, class COut, class Compare>
+  template<typename T, typename IndexType,
+           class CIn, class CVal, class COut, class Compare>
   DAX_CONT_EXPORT static void UpperBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag> &values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &output,
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag> &output,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "UpperBounds", values.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(values)
+                    + values.GetNumberOfValues()*sizeof(IndexType));
     dax::Id arraySize = values.GetNumberOfValues();
 
     UpperBoundsKernelComparisonKernel<
         typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>::PortalConstExecution,
         typename dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>::PortalConstExecution,
-        typename dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>::PortalExecution,
+        typename dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>::PortalExecution,
         Compare>
         kernel(input.PrepareForInput(),
                values.PrepareForInput(),
@@ -1030,10 +1071,10 @@ public:
     DerivedAlgorithm::Schedule(kernel, arraySize);
   }
 
-  template<class CIn, class COut>
+  template<typename T, class CIn, class COut>
   DAX_CONT_EXPORT static void UpperBounds(
-      const dax::cont::ArrayHandle<dax::Id,CIn,DeviceAdapterTag> &input,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &values_output)
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag> &values_output)
   {
     DeviceAdapterAlgorithmGeneral<DerivedAlgorithm,
       DeviceAdapterTag>::UpperBounds(input, values_output, values_output);
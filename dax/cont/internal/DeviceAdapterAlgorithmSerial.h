@@ -18,11 +18,13 @@
 
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/ErrorExecution.h>
+#include <dax/cont/Tracing.h>
 #include <dax/cont/internal/DeviceAdapterAlgorithm.h>
 #include <dax/cont/internal/DeviceAdapterAlgorithmGeneral.h>
 #include <dax/cont/internal/DeviceAdapterTagSerial.h>
+#include <dax/cont/internal/RadixSort.h>
+#include <dax/cont/internal/ScheduleTiles.h>
 
-#include <dax/exec/internal/IJKIndex.h>
 #include <dax/exec/internal/ErrorMessageBuffer.h>
 
 #include <boost/iterator/counting_iterator.hpp>
@@ -40,6 +42,10 @@ struct DeviceAdapterAlgorithm<dax::cont::DeviceAdapterTagSerial> :
         DeviceAdapterAlgorithm<dax::cont::DeviceAdapterTagSerial>,
         dax::cont::DeviceAdapterTagSerial>
 {
+private:
+  typedef dax::cont::internal::DeviceAdapterAlgorithmGeneral<
+      DeviceAdapterAlgorithm<dax::cont::DeviceAdapterTagSerial>,
+      dax::cont::DeviceAdapterTagSerial> Superclass;
 
 public:
   template<typename T, class CIn, class COut>
@@ -47,6 +53,8 @@ public:
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTagSerial> &input,
       dax::cont::ArrayHandle<T,COut,DeviceAdapterTagSerial>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "ScanInclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     typedef typename dax::cont::ArrayHandle<T,COut,DeviceAdapterTagSerial>
         ::PortalExecution PortalOut;
     typedef typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTagSerial>
@@ -72,6 +80,8 @@ public:
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTagSerial> &input,
       dax::cont::ArrayHandle<T,COut,DeviceAdapterTagSerial>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "ScanExclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     typedef typename dax::cont::ArrayHandle<T,COut,DeviceAdapterTagSerial>
         ::PortalExecution PortalOut;
     typedef typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTagSerial>
@@ -122,6 +132,7 @@ public:
   DAX_CONT_EXPORT static void Schedule(Functor functor,
                                        dax::Id numInstances)
   {
+    DAX_TRACE_SCOPE("algorithm", "Schedule", numInstances, 0);
     const dax::Id MESSAGE_SIZE = 1024;
     char errorString[MESSAGE_SIZE];
     errorString[0] = '\0';
@@ -147,6 +158,8 @@ public:
   DAX_CONT_EXPORT
   static void Schedule(FunctorType functor, dax::Id3 rangeMax)
   {
+    DAX_TRACE_SCOPE("algorithm", "Schedule",
+                    rangeMax[0]*rangeMax[1]*rangeMax[2], 0);
     const dax::Id MESSAGE_SIZE = 1024;
     char errorString[MESSAGE_SIZE];
     errorString[0] = '\0';
@@ -155,35 +168,52 @@ public:
 
     functor.SetErrorMessageBuffer(errorMessage);
 
-    dax::exec::internal::IJKIndex index(rangeMax);
-    for( dax::Id k=0; k!=rangeMax[2]; ++k)
-      {
-      index.SetK(k);
-      for( dax::Id j=0; j!=rangeMax[1]; ++j)
-        {
-        index.SetJ(j);
-        for (dax::Id i=0; i < rangeMax[0]; ++i)
-          {
-          index.SetI(i);
-          functor(index);
-          }
-        }
-      }
+    const dax::cont::internal::ScheduleTiles tiles(
+          rangeMax,
+          dax::cont::internal::ScheduleTilingSettings<
+            dax::cont::DeviceAdapterTagSerial>::Get());
+    tiles.RunTiles(functor, 0, tiles.GetNumberOfTiles());
+
     if (errorMessage.IsErrorRaised())
       {
       throw dax::cont::ErrorExecution(errorString);
       }
   }
 
+private:
+  template<class PortalType>
+  DAX_CONT_EXPORT static void SortPortal(const PortalType &portal,
+                                         boost::true_type)
+  {
+    dax::cont::internal::RadixSort(
+          portal.GetIteratorBegin(),
+          portal.GetIteratorEnd(),
+          dax::cont::internal::RadixSortSerialBlocks());
+  }
+
+  template<class PortalType>
+  DAX_CONT_EXPORT static void SortPortal(const PortalType &portal,
+                                         boost::false_type)
+  {
+    std::sort(portal.GetIteratorBegin(), portal.GetIteratorEnd());
+  }
+
+public:
+  /// Integer and floating point values are sorted with a radix sort, other
+  /// types with std::sort.
+  ///
   template<typename T, class Container>
   DAX_CONT_EXPORT static void Sort(
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTagSerial>& values)
   {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     typedef typename dax::cont::ArrayHandle<T,Container,DeviceAdapterTagSerial>
         ::PortalExecution PortalType;
 
     PortalType arrayPortal = values.PrepareForInPlace();
-    std::sort(arrayPortal.GetIteratorBegin(), arrayPortal.GetIteratorEnd());
+    SortPortal(arrayPortal,
+               typename dax::cont::internal::RadixSortTraits<T>::IsSortable());
   }
 
   template<typename T, class Container, class Compare>
@@ -191,6 +221,8 @@ public:
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTagSerial>& values,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     typedef typename dax::cont::ArrayHandle<T,Container,DeviceAdapterTagSerial>
         ::PortalExecution PortalType;
 
@@ -198,6 +230,57 @@ public:
     std::sort(arrayPortal.GetIteratorBegin(), arrayPortal.GetIteratorEnd(),comp);
   }
 
+private:
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKeyImpl(
+      dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTagSerial> &keys,
+      dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTagSerial> &values,
+      boost::true_type)
+  {
+    typedef typename dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTagSerial>
+        ::PortalExecution KeyPortalType;
+    typedef typename dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTagSerial>
+        ::PortalExecution ValuePortalType;
+
+    DAX_ASSERT_CONT(keys.GetNumberOfValues() == values.GetNumberOfValues());
+    KeyPortalType keyPortal = keys.PrepareForInPlace();
+    ValuePortalType valuePortal = values.PrepareForInPlace();
+    dax::cont::internal::RadixSortByKey(
+          keyPortal.GetIteratorBegin(),
+          keyPortal.GetIteratorEnd(),
+          valuePortal.GetIteratorBegin(),
+          dax::cont::internal::RadixSortSerialBlocks());
+  }
+
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKeyImpl(
+      dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTagSerial> &keys,
+      dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTagSerial> &values,
+      boost::false_type)
+  {
+    Superclass::SortByKey(keys, values);
+  }
+
+public:
+  using Superclass::SortByKey;
+
+  /// Integer and floating point keys are sorted with a radix sort, other
+  /// types with the general comparison sort.
+  ///
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKey(
+      dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTagSerial> &keys,
+      dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTagSerial> &values)
+  {
+    DAX_TRACE_SCOPE("algorithm", "SortByKey", keys.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(keys)
+                    + 2*dax::cont::internal::GetTraceBytes(values));
+    SortByKeyImpl(
+          keys,
+          values,
+          typename dax::cont::internal::RadixSortTraits<T>::IsSortable());
+  }
+
   DAX_CONT_EXPORT static void Synchronize()
   {
     // Nothing to do. This device is serial and has no asynchronous operations.
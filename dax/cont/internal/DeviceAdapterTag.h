@@ -25,6 +25,7 @@
 #define DAX_DEVICE_ADAPTER_CUDA       2
 #define DAX_DEVICE_ADAPTER_OPENMP     3
 #define DAX_DEVICE_ADAPTER_TBB        4
+#define DAX_DEVICE_ADAPTER_STDTHREAD  5
 
 #ifndef DAX_DEVICE_ADAPTER
 #ifdef DAX_CUDA
@@ -61,6 +62,11 @@
 #include <dax/tbb/cont/internal/DeviceAdapterTagTBB.h>
 #define DAX_DEFAULT_DEVICE_ADAPTER_TAG ::dax::tbb::cont::DeviceAdapterTagTBB
 
+#elif DAX_DEVICE_ADAPTER == DAX_DEVICE_ADAPTER_STDTHREAD
+
+#include <dax/stdthread/cont/internal/DeviceAdapterTagStdThread.h>
+#define DAX_DEFAULT_DEVICE_ADAPTER_TAG ::dax::stdthread::cont::DeviceAdapterTagStdThread
+
 #elif DAX_DEVICE_ADAPTER == DAX_DEVICE_ADAPTER_ERROR
 
 #include <dax/cont/internal/DeviceAdapterError.h>
@@ -0,0 +1,77 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_internal_InterpolatedCellsContainer_h
+#define __dax_cont_internal_InterpolatedCellsContainer_h
+
+#include <dax/Types.h>
+
+namespace dax {
+namespace cont {
+namespace internal {
+
+/// \headerfile InterpolatedCellsContainer.h
+/// dax/cont/internal/InterpolatedCellsContainer.h
+/// \brief The output geometry of dax::cont::DispatcherGenerateInterpolatedCells.
+///
+/// The dispatcher passes this in place of the output grid so that the
+/// worklet writes the interpolation edge and ratio of every point of the
+/// generated cells to their own arrays instead of the point coordinates
+/// of the grid.
+///
+template<class GridType, class EdgeHandleType, class RatioHandleType>
+class InterpolatedCellsContainer
+{
+public:
+  DAX_CONT_EXPORT InterpolatedCellsContainer(const GridType &grid,
+                                             const EdgeHandleType &edges,
+                                             const RatioHandleType &ratios):
+    Grid_(grid),
+    Edges_(edges),
+    Ratios_(ratios)
+  {
+  }
+
+  DAX_CONT_EXPORT InterpolatedCellsContainer() {  }
+
+  //should really only be used by the Geometry Concept
+  DAX_CONT_EXPORT const GridType &Grid() const { return Grid_; }
+  DAX_CONT_EXPORT const EdgeHandleType &Edges() const { return Edges_; }
+  DAX_CONT_EXPORT const RatioHandleType &Ratios() const { return Ratios_; }
+
+private:
+  GridType Grid_;
+  EdgeHandleType Edges_;
+  RatioHandleType Ratios_;
+};
+
+
+template<class GridType, class EdgeHandleType, class RatioHandleType>
+DAX_CONT_EXPORT
+dax::cont::internal::InterpolatedCellsContainer<
+    GridType,EdgeHandleType,RatioHandleType>
+make_InterpolatedCells(const GridType &grid,
+                       const EdgeHandleType &edges,
+                       const RatioHandleType &ratios)
+{
+  return dax::cont::internal::InterpolatedCellsContainer<
+      GridType,EdgeHandleType,RatioHandleType>(grid,edges,ratios);
+}
+
+}
+}
+} // namespace dax::cont::internal
+
+#endif //__dax_cont_internal_InterpolatedCellsContainer_h
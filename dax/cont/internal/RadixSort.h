@@ -0,0 +1,492 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_internal_RadixSort_h
+#define __dax_cont_internal_RadixSort_h
+
+#include <dax/Types.h>
+#include <dax/cont/internal/ScratchBuffer.h>
+
+#include <boost/type_traits/integral_constant.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace dax {
+namespace cont {
+namespace internal {
+
+/// \brief Describes how RadixSort orders a key type.
+///
+/// RadixSort works on unsigned integers. The traits of a sortable type map
+/// each value to an unsigned KeyType of the same size whose unsigned order
+/// is the order of the values, and back. \c IsSortable is \c
+/// boost::true_type for the types that have such a mapping, so that device
+/// adapters can pick a radix sort or a comparison sort at compile time.
+///
+template<typename T>
+struct RadixSortTraits
+{
+  typedef boost::false_type IsSortable;
+};
+
+namespace detail {
+
+template<typename UnsignedType>
+struct RadixSortTraitsUnsigned
+{
+  typedef boost::true_type IsSortable;
+  typedef UnsignedType KeyType;
+
+  DAX_CONT_EXPORT static KeyType Encode(UnsignedType value) { return value; }
+  DAX_CONT_EXPORT static UnsignedType Decode(KeyType key) { return key; }
+};
+
+// Flipping the sign bit of a two's complement integer orders the negative
+// numbers before the positive ones.
+template<typename SignedType, typename UnsignedType>
+struct RadixSortTraitsSigned
+{
+  typedef boost::true_type IsSortable;
+  typedef UnsignedType KeyType;
+
+  static const KeyType SIGN_BIT = KeyType(1) << (sizeof(KeyType)*8 - 1);
+
+  DAX_CONT_EXPORT static KeyType Encode(SignedType value)
+  {
+    return static_cast<KeyType>(value) ^ SIGN_BIT;
+  }
+  DAX_CONT_EXPORT static SignedType Decode(KeyType key)
+  {
+    return static_cast<SignedType>(key ^ SIGN_BIT);
+  }
+};
+
+// IEEE floats are sign and magnitude. Setting the sign bit of the positive
+// numbers and inverting all the bits of the negative numbers orders them
+// like the values.
+template<typename FloatType, typename UnsignedType>
+struct RadixSortTraitsFloat
+{
+  typedef boost::true_type IsSortable;
+  typedef UnsignedType KeyType;
+
+  static const KeyType SIGN_BIT = KeyType(1) << (sizeof(KeyType)*8 - 1);
+
+  DAX_CONT_EXPORT static KeyType Encode(FloatType value)
+  {
+    KeyType bits;
+    std::memcpy(&bits, &value, sizeof(KeyType));
+    return (bits & SIGN_BIT) ? ~bits : (bits | SIGN_BIT);
+  }
+  DAX_CONT_EXPORT static FloatType Decode(KeyType key)
+  {
+    const KeyType bits = (key & SIGN_BIT) ? (key & ~SIGN_BIT) : ~key;
+    FloatType value;
+    std::memcpy(&value, &bits, sizeof(KeyType));
+    return value;
+  }
+};
+
+} // namespace detail
+
+template<>
+struct RadixSortTraits<dax::internal::UInt32Type>
+    : detail::RadixSortTraitsUnsigned<dax::internal::UInt32Type> {  };
+template<>
+struct RadixSortTraits<dax::internal::UInt64Type>
+    : detail::RadixSortTraitsUnsigned<dax::internal::UInt64Type> {  };
+template<>
+struct RadixSortTraits<dax::internal::Int32Type>
+    : detail::RadixSortTraitsSigned<dax::internal::Int32Type,
+                                    dax::internal::UInt32Type> {  };
+template<>
+struct RadixSortTraits<dax::internal::Int64Type>
+    : detail::RadixSortTraitsSigned<dax::internal::Int64Type,
+                                    dax::internal::UInt64Type> {  };
+template<>
+struct RadixSortTraits<float>
+    : detail::RadixSortTraitsFloat<float, dax::internal::UInt32Type> {  };
+template<>
+struct RadixSortTraits<double>
+    : detail::RadixSortTraitsFloat<double, dax::internal::UInt64Type> {  };
+
+/// Runs the blocks of a RadixSort one after the other.
+///
+struct RadixSortSerialBlocks
+{
+  DAX_CONT_EXPORT dax::Id GetNumberOfBlocks(dax::Id) const { return 1; }
+
+  template<class KernelType>
+  DAX_CONT_EXPORT void operator()(const KernelType &kernel,
+                                  dax::Id numBlocks) const
+  {
+    for (dax::Id block = 0; block < numBlocks; ++block)
+      {
+      kernel(block);
+      }
+  }
+};
+
+namespace detail {
+
+const int RADIX_DIGIT_BITS = 8;
+const int RADIX_DIGIT_VALUES = 1 << RADIX_DIGIT_BITS;
+
+// The range of values handled by one block.
+struct RadixBlockRange
+{
+  DAX_CONT_EXPORT RadixBlockRange() : NumValues(0), BlockSize(0) {  }
+  DAX_CONT_EXPORT RadixBlockRange(dax::Id numValues, dax::Id numBlocks)
+    : NumValues(numValues),
+      BlockSize((numValues + numBlocks - 1) / numBlocks) {  }
+
+  DAX_CONT_EXPORT dax::Id Begin(dax::Id block) const
+  {
+    return std::min(block * this->BlockSize, this->NumValues);
+  }
+  DAX_CONT_EXPORT dax::Id End(dax::Id block) const
+  {
+    return std::min((block + 1) * this->BlockSize, this->NumValues);
+  }
+
+  dax::Id NumValues;
+  dax::Id BlockSize;
+};
+
+// Encodes the keys, numbers the values, and finds the bits that are the same
+// in every key of the block, so passes over constant digits can be skipped.
+template<class KeyIteratorType>
+struct RadixEncodeKernel
+{
+  typedef typename std::iterator_traits<KeyIteratorType>::value_type
+      ValueType;
+  typedef typename RadixSortTraits<ValueType>::KeyType KeyType;
+
+  DAX_CONT_EXPORT void operator()(dax::Id block) const
+  {
+    KeyType allOnes = ~KeyType(0);
+    KeyType anyOnes = KeyType(0);
+    for (dax::Id index = this->Range.Begin(block);
+         index < this->Range.End(block);
+         ++index)
+      {
+      const KeyType key =
+          RadixSortTraits<ValueType>::Encode(*(this->Input + index));
+      this->Keys[index] = key;
+      allOnes &= key;
+      anyOnes |= key;
+      if (this->Ids) { this->Ids[index] = index; }
+      }
+    this->AllOnes[block] = allOnes;
+    this->AnyOnes[block] = anyOnes;
+  }
+
+  KeyIteratorType Input;
+  KeyType *Keys;
+  dax::Id *Ids;
+  KeyType *AllOnes;
+  KeyType *AnyOnes;
+  RadixBlockRange Range;
+};
+
+template<typename KeyType>
+struct RadixCountKernel
+{
+  DAX_CONT_EXPORT void operator()(dax::Id block) const
+  {
+    dax::Id *counts = this->Counts + block*RADIX_DIGIT_VALUES;
+    std::fill(counts, counts + RADIX_DIGIT_VALUES, dax::Id(0));
+    for (dax::Id index = this->Range.Begin(block);
+         index < this->Range.End(block);
+         ++index)
+      {
+      ++counts[(this->Keys[index] >> this->Shift) & (RADIX_DIGIT_VALUES-1)];
+      }
+  }
+
+  const KeyType *Keys;
+  dax::Id *Counts;
+  int Shift;
+  RadixBlockRange Range;
+};
+
+// Moves each key (and its value number) to the next free slot of its digit.
+// Every block owns a run of slots for each digit, so the sort stays stable.
+template<typename KeyType>
+struct RadixScatterKernel
+{
+  DAX_CONT_EXPORT void operator()(dax::Id block) const
+  {
+    dax::Id offsets[RADIX_DIGIT_VALUES];
+    std::copy(this->Offsets + block*RADIX_DIGIT_VALUES,
+              this->Offsets + (block+1)*RADIX_DIGIT_VALUES,
+              offsets);
+    for (dax::Id index = this->Range.Begin(block);
+         index < this->Range.End(block);
+         ++index)
+      {
+      const KeyType key = this->Keys[index];
+      const dax::Id outIndex =
+          offsets[(key >> this->Shift) & (RADIX_DIGIT_VALUES-1)]++;
+      this->OutKeys[outIndex] = key;
+      if (this->Ids) { this->OutIds[outIndex] = this->Ids[index]; }
+      }
+  }
+
+  const KeyType *Keys;
+  KeyType *OutKeys;
+  const dax::Id *Ids;
+  dax::Id *OutIds;
+  const dax::Id *Offsets;
+  int Shift;
+  RadixBlockRange Range;
+};
+
+template<class KeyIteratorType>
+struct RadixDecodeKernel
+{
+  typedef typename std::iterator_traits<KeyIteratorType>::value_type
+      ValueType;
+  typedef typename RadixSortTraits<ValueType>::KeyType KeyType;
+
+  DAX_CONT_EXPORT void operator()(dax::Id block) const
+  {
+    for (dax::Id index = this->Range.Begin(block);
+         index < this->Range.End(block);
+         ++index)
+      {
+      *(this->Output + index) =
+          RadixSortTraits<ValueType>::Decode(this->Keys[index]);
+      }
+  }
+
+  const KeyType *Keys;
+  KeyIteratorType Output;
+  RadixBlockRange Range;
+};
+
+template<class ValueIteratorType>
+struct RadixCopyKernel
+{
+  typedef typename std::iterator_traits<ValueIteratorType>::value_type
+      ValueType;
+
+  DAX_CONT_EXPORT void operator()(dax::Id block) const
+  {
+    for (dax::Id index = this->Range.Begin(block);
+         index < this->Range.End(block);
+         ++index)
+      {
+      this->Values[index] = *(this->Input + index);
+      }
+  }
+
+  ValueIteratorType Input;
+  ValueType *Values;
+  RadixBlockRange Range;
+};
+
+template<class ValueIteratorType>
+struct RadixGatherKernel
+{
+  typedef typename std::iterator_traits<ValueIteratorType>::value_type
+      ValueType;
+
+  DAX_CONT_EXPORT void operator()(dax::Id block) const
+  {
+    for (dax::Id index = this->Range.Begin(block);
+         index < this->Range.End(block);
+         ++index)
+      {
+      *(this->Output + index) = this->Values[this->Ids[index]];
+      }
+  }
+
+  const ValueType *Values;
+  const dax::Id *Ids;
+  ValueIteratorType Output;
+  RadixBlockRange Range;
+};
+
+// Sorts the keys from [keysBegin, keysBegin+numValues). When ids is not
+// NULL, ids[i] is set to the original position of the i'th sorted key.
+template<class KeyIteratorType, class BlocksType>
+DAX_CONT_EXPORT void RadixSortKeys(KeyIteratorType keysBegin,
+                                   dax::Id numValues,
+                                   ScratchBuffer<dax::Id> *ids,
+                                   const BlocksType &blocks)
+{
+  typedef typename std::iterator_traits<KeyIteratorType>::value_type
+      ValueType;
+  typedef typename RadixSortTraits<ValueType>::KeyType KeyType;
+
+  const dax::Id numBlocks =
+      std::max(dax::Id(1), std::min(blocks.GetNumberOfBlocks(numValues),
+                                    numValues));
+  const RadixBlockRange range(numValues, numBlocks);
+
+  ScratchBuffer<KeyType> keys(numValues);
+  ScratchBuffer<KeyType> outKeys(numValues);
+  ScratchBuffer<dax::Id> outIds;
+  if (ids)
+    {
+    ids->Allocate(numValues);
+    outIds.Allocate(numValues);
+    }
+
+  std::vector<KeyType> allOnes(numBlocks);
+  std::vector<KeyType> anyOnes(numBlocks);
+  RadixEncodeKernel<KeyIteratorType> encode;
+  encode.Input = keysBegin;
+  encode.Keys = keys.GetPointer();
+  encode.Ids = ids ? ids->GetPointer() : NULL;
+  encode.AllOnes = &allOnes[0];
+  encode.AnyOnes = &anyOnes[0];
+  encode.Range = range;
+  blocks(encode, numBlocks);
+
+  KeyType sameBits = ~KeyType(0);
+  KeyType anyBits = KeyType(0);
+  for (dax::Id block = 0; block < numBlocks; ++block)
+    {
+    sameBits &= allOnes[block];
+    anyBits |= anyOnes[block];
+    }
+  //bits that are set in some keys and not in others
+  const KeyType changingBits = anyBits & ~sameBits;
+
+  std::vector<dax::Id> counts(numBlocks*RADIX_DIGIT_VALUES);
+  for (int shift = 0;
+       shift < static_cast<int>(sizeof(KeyType))*8;
+       shift += RADIX_DIGIT_BITS)
+    {
+    if (((changingBits >> shift) & (RADIX_DIGIT_VALUES-1)) == 0)
+      {
+      //every key has the same digit, so this pass would not move anything
+      continue;
+      }
+
+    RadixCountKernel<KeyType> count;
+    count.Keys = keys.GetPointer();
+    count.Counts = &counts[0];
+    count.Shift = shift;
+    count.Range = range;
+    blocks(count, numBlocks);
+
+    //turn the counts into the first slot of each digit of each block,
+    //ordered by digit and then by block
+    dax::Id offset = 0;
+    for (int digit = 0; digit < RADIX_DIGIT_VALUES; ++digit)
+      {
+      for (dax::Id block = 0; block < numBlocks; ++block)
+        {
+        const dax::Id blockCount = counts[block*RADIX_DIGIT_VALUES + digit];
+        counts[block*RADIX_DIGIT_VALUES + digit] = offset;
+        offset += blockCount;
+        }
+      }
+
+    RadixScatterKernel<KeyType> scatter;
+    scatter.Keys = keys.GetPointer();
+    scatter.OutKeys = outKeys.GetPointer();
+    scatter.Ids = ids ? ids->GetPointer() : NULL;
+    scatter.OutIds = ids ? outIds.GetPointer() : NULL;
+    scatter.Offsets = &counts[0];
+    scatter.Shift = shift;
+    scatter.Range = range;
+    blocks(scatter, numBlocks);
+
+    keys.Swap(outKeys);
+    if (ids) { ids->Swap(outIds); }
+    }
+
+  RadixDecodeKernel<KeyIteratorType> decode;
+  decode.Keys = keys.GetPointer();
+  decode.Output = keysBegin;
+  decode.Range = range;
+  blocks(decode, numBlocks);
+}
+
+} // namespace detail
+
+/// \brief Sorts integer or floating point values with an LSD radix sort.
+///
+/// The values are sorted one byte at a time, skipping the bytes that are the
+/// same in every value, so the time is linear in the number of values.
+/// \c BlocksType runs the work of each pass on blocks of the values, which
+/// lets a device adapter run the blocks in parallel (see
+/// RadixSortSerialBlocks). The value type of the iterator must have
+/// RadixSortTraits.
+///
+template<class KeyIteratorType, class BlocksType>
+DAX_CONT_EXPORT void RadixSort(KeyIteratorType begin,
+                               KeyIteratorType end,
+                               const BlocksType &blocks)
+{
+  const dax::Id numValues = static_cast<dax::Id>(std::distance(begin, end));
+  if (numValues < 2) { return; }
+  detail::RadixSortKeys(begin, numValues, NULL, blocks);
+}
+
+/// \brief Sorts values by integer or floating point keys with an LSD radix
+/// sort.
+///
+/// Like RadixSort, but also moves the values at [valuesBegin, valuesBegin +
+/// (keysEnd - keysBegin)) with their keys. The sort is stable.
+///
+template<class KeyIteratorType, class ValueIteratorType, class BlocksType>
+DAX_CONT_EXPORT void RadixSortByKey(KeyIteratorType keysBegin,
+                                    KeyIteratorType keysEnd,
+                                    ValueIteratorType valuesBegin,
+                                    const BlocksType &blocks)
+{
+  typedef typename std::iterator_traits<ValueIteratorType>::value_type
+      ValueType;
+
+  const dax::Id numValues =
+      static_cast<dax::Id>(std::distance(keysBegin, keysEnd));
+  if (numValues < 2) { return; }
+
+  ScratchBuffer<dax::Id> ids;
+  detail::RadixSortKeys(keysBegin, numValues, &ids, blocks);
+
+  const dax::Id numBlocks =
+      std::max(dax::Id(1), std::min(blocks.GetNumberOfBlocks(numValues),
+                                    numValues));
+  const detail::RadixBlockRange range(numValues, numBlocks);
+
+  ScratchBuffer<ValueType> values(numValues);
+  detail::RadixCopyKernel<ValueIteratorType> copy;
+  copy.Input = valuesBegin;
+  copy.Values = values.GetPointer();
+  copy.Range = range;
+  blocks(copy, numBlocks);
+
+  detail::RadixGatherKernel<ValueIteratorType> gather;
+  gather.Values = values.GetPointer();
+  gather.Ids = ids.GetPointer();
+  gather.Output = valuesBegin;
+  gather.Range = range;
+  blocks(gather, numBlocks);
+}
+
+}
+}
+} // namespace dax::cont::internal
+
+#endif //__dax_cont_internal_RadixSort_h
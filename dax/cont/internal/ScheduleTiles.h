@@ -0,0 +1,310 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_internal_ScheduleTiles_h
+#define __dax_cont_internal_ScheduleTiles_h
+
+#include <dax/Types.h>
+#include <dax/exec/internal/IJKIndex.h>
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace dax {
+namespace exec {
+namespace internal {
+template<typename Invocation> class Functor;
+}
+}
+} // namespace dax::exec::internal
+
+namespace dax {
+namespace cont {
+namespace internal {
+
+/// The order in which the tiles of a 3D schedule are visited.
+///
+enum ScheduleTileOrder
+{
+  /// Tiles are visited like the cells of a grid, i fastest.
+  SCHEDULE_TILE_ORDER_ROW_MAJOR,
+  /// Tiles are visited along a Z-order (Morton) curve, which keeps
+  /// consecutive tiles, and so the tiles a thread steals, close in all three
+  /// directions.
+  SCHEDULE_TILE_ORDER_MORTON
+};
+
+/// \brief How a 3D schedule is broken into bricks.
+///
+/// A schedule over a uniform grid visits one brick of \c TileShape indices at
+/// a time, i fastest within the brick. A component of zero or less spans the
+/// whole range, so a shape of (0,0,0) is the plain k/j/i loop. Bricks keep
+/// the points shared by neighboring cells, which a cell gathers from two
+/// rows and two planes, in cache until all the cells using them are done.
+///
+struct ScheduleTiling
+{
+  DAX_CONT_EXPORT ScheduleTiling()
+    : TileShape(0, 0, 0), Order(SCHEDULE_TILE_ORDER_ROW_MAJOR) {  }
+
+  DAX_CONT_EXPORT ScheduleTiling(const dax::Id3 &tileShape,
+                                 ScheduleTileOrder order)
+    : TileShape(tileShape), Order(order) {  }
+
+  dax::Id3 TileShape;
+  ScheduleTileOrder Order;
+};
+
+/// \brief The tiling a device adapter uses when nothing else is set.
+///
+/// Device adapters that schedule through ScheduleTiles specialize this to
+/// the tile shape that works best for them.
+///
+template<class DeviceAdapterTag>
+struct ScheduleTilingDefault
+{
+  DAX_CONT_EXPORT static ScheduleTiling Get() { return ScheduleTiling(); }
+};
+
+/// \brief The tiling used by the 3D schedules of a device adapter.
+///
+/// The tiling can be changed at any time, for example to compare tile shapes
+/// in a benchmark, and applies to the schedules started afterwards.
+///
+template<class DeviceAdapterTag>
+class ScheduleTilingSettings
+{
+public:
+  DAX_CONT_EXPORT static ScheduleTiling Get() { return GetReference(); }
+
+  DAX_CONT_EXPORT static void Set(const ScheduleTiling &tiling)
+  {
+    GetReference() = tiling;
+  }
+
+  DAX_CONT_EXPORT static void Reset()
+  {
+    GetReference() = ScheduleTilingDefault<DeviceAdapterTag>::Get();
+  }
+
+private:
+  DAX_CONT_EXPORT static ScheduleTiling &GetReference()
+  {
+    static ScheduleTiling tiling =
+        ScheduleTilingDefault<DeviceAdapterTag>::Get();
+    return tiling;
+  }
+};
+
+/// \brief The bricks of a 3D schedule in the order they are visited.
+///
+/// Device adapters split the tiles among their threads and call RunTiles
+/// with a functor taking an IJKIndex, like the one given to Schedule.
+///
+class ScheduleTiles
+{
+public:
+  DAX_CONT_EXPORT ScheduleTiles(const dax::Id3 &rangeMax,
+                                const ScheduleTiling &tiling)
+    : RangeMax(rangeMax)
+  {
+    for (int component = 0; component < 3; ++component)
+      {
+      const dax::Id shape = tiling.TileShape[component];
+      this->TileShape[component] =
+          ((shape > 0) && (shape < rangeMax[component]))
+          ? shape : std::max(rangeMax[component], dax::Id(1));
+      this->TileCounts[component] =
+          (rangeMax[component] + this->TileShape[component] - 1)
+          / this->TileShape[component];
+      }
+    if (rangeMax[0] < 1 || rangeMax[1] < 1 || rangeMax[2] < 1)
+      {
+      this->TileCounts = dax::make_Id3(0, 0, 0);
+      }
+
+    if ((tiling.Order == SCHEDULE_TILE_ORDER_MORTON) &&
+        (this->GetNumberOfTiles() > 1))
+      {
+      this->BuildMortonOrder();
+      }
+  }
+
+  DAX_CONT_EXPORT dax::Id GetNumberOfTiles() const
+  {
+    return this->TileCounts[0]*this->TileCounts[1]*this->TileCounts[2];
+  }
+
+  /// The number of indices in a whole tile, for picking grain sizes.
+  DAX_CONT_EXPORT dax::Id GetTileSize() const
+  {
+    return this->TileShape[0]*this->TileShape[1]*this->TileShape[2];
+  }
+
+  DAX_CONT_EXPORT const dax::Id3 &GetTileShape() const
+  {
+    return this->TileShape;
+  }
+
+  /// Calls \p functor on every index of the tiles [\p beginTile, \p endTile).
+  template<class FunctorType>
+  DAX_EXEC_EXPORT void RunTiles(FunctorType &functor,
+                                dax::Id beginTile,
+                                dax::Id endTile) const
+  {
+    dax::exec::internal::IJKIndex index(this->RangeMax);
+    for (dax::Id tile = beginTile; tile < endTile; ++tile)
+      {
+      const dax::Id3 begin = this->GetTileOrigin(tile);
+      const dax::Id3 end =
+          dax::make_Id3(std::min(begin[0] + this->TileShape[0],
+                                 this->RangeMax[0]),
+                        std::min(begin[1] + this->TileShape[1],
+                                 this->RangeMax[1]),
+                        std::min(begin[2] + this->TileShape[2],
+                                 this->RangeMax[2]));
+      for (dax::Id k = begin[2]; k != end[2]; ++k)
+        {
+        index.SetK(k);
+        for (dax::Id j = begin[1]; j != end[1]; ++j)
+          {
+          index.SetJ(j);
+          RunRow(functor, index, begin[0], end[0]);
+          }
+        }
+      }
+  }
+
+private:
+  template<class FunctorType>
+  DAX_EXEC_EXPORT static void RunRow(FunctorType &functor,
+                                     dax::exec::internal::IJKIndex &index,
+                                     dax::Id begin,
+                                     dax::Id end)
+  {
+    for (dax::Id i = begin; i != end; ++i)
+      {
+      index.SetI(i);
+      functor(index);
+      }
+  }
+
+  // Worklet functors invoke a whole row at once, which lets the cells of a
+  // uniform grid reuse the point values they share with the previous cell.
+  template<typename Invocation>
+  DAX_EXEC_EXPORT static void RunRow(
+      const dax::exec::internal::Functor<Invocation> &functor,
+      dax::exec::internal::IJKIndex &index,
+      dax::Id begin,
+      dax::Id end)
+  {
+    index.SetI(begin);
+    functor.InvokeRow(index, end);
+  }
+
+  template<typename Invocation>
+  DAX_EXEC_EXPORT static void RunRow(
+      dax::exec::internal::Functor<Invocation> &functor,
+      dax::exec::internal::IJKIndex &index,
+      dax::Id begin,
+      dax::Id end)
+  {
+    const dax::exec::internal::Functor<Invocation> &constFunctor = functor;
+    RunRow(constFunctor, index, begin, end);
+  }
+
+  DAX_EXEC_EXPORT dax::Id3 GetTileOrigin(dax::Id tile) const
+  {
+    if (!this->MortonTiles.empty())
+      {
+      return this->MortonTiles[tile];
+      }
+    return dax::make_Id3(
+          (tile % this->TileCounts[0])*this->TileShape[0],
+          ((tile / this->TileCounts[0]) % this->TileCounts[1])
+          *this->TileShape[1],
+          (tile / (this->TileCounts[0]*this->TileCounts[1]))
+          *this->TileShape[2]);
+  }
+
+  // Spreads the low 21 bits of value so that two zero bits follow each one.
+  DAX_CONT_EXPORT static boost::uint64_t SpreadBits(boost::uint64_t value)
+  {
+    value &= 0x1fffff;
+    value = (value | (value << 32)) & 0x001f00000000ffffULL;
+    value = (value | (value << 16)) & 0x001f0000ff0000ffULL;
+    value = (value | (value << 8))  & 0x100f00f00f00f00fULL;
+    value = (value | (value << 4))  & 0x10c30c30c30c30c3ULL;
+    value = (value | (value << 2))  & 0x1249249249249249ULL;
+    return value;
+  }
+
+  // Sorting the tiles by their Morton code handles tile counts that are not
+  // powers of two. The origins are stored since there are few tiles.
+  DAX_CONT_EXPORT void BuildMortonOrder()
+  {
+    std::vector<std::pair<boost::uint64_t, dax::Id3> > codes;
+    codes.reserve(static_cast<std::size_t>(this->GetNumberOfTiles()));
+    for (dax::Id k = 0; k < this->TileCounts[2]; ++k)
+      {
+      for (dax::Id j = 0; j < this->TileCounts[1]; ++j)
+        {
+        for (dax::Id i = 0; i < this->TileCounts[0]; ++i)
+          {
+          const boost::uint64_t code =
+              SpreadBits(static_cast<boost::uint64_t>(i))
+              | (SpreadBits(static_cast<boost::uint64_t>(j)) << 1)
+              | (SpreadBits(static_cast<boost::uint64_t>(k)) << 2);
+          codes.push_back(std::make_pair(
+                            code,
+                            dax::make_Id3(i*this->TileShape[0],
+                                          j*this->TileShape[1],
+                                          k*this->TileShape[2])));
+          }
+        }
+      }
+    std::sort(codes.begin(), codes.end(), CompareCodes());
+
+    this->MortonTiles.resize(codes.size());
+    for (std::size_t index = 0; index < codes.size(); ++index)
+      {
+      this->MortonTiles[index] = codes[index].second;
+      }
+  }
+
+  struct CompareCodes
+  {
+    DAX_CONT_EXPORT bool operator()(
+        const std::pair<boost::uint64_t, dax::Id3> &a,
+        const std::pair<boost::uint64_t, dax::Id3> &b) const
+    {
+      return a.first < b.first;
+    }
+  };
+
+  dax::Id3 RangeMax;
+  dax::Id3 TileShape;
+  dax::Id3 TileCounts;
+  std::vector<dax::Id3> MortonTiles;
+};
+
+}
+}
+} // namespace dax::cont::internal
+
+#endif //__dax_cont_internal_ScheduleTiles_h
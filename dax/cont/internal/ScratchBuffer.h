@@ -0,0 +1,120 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_cont_internal_ScratchBuffer_h
+#define __dax_cont_internal_ScratchBuffer_h
+
+#include <dax/Types.h>
+#include <dax/cont/ScratchArena.h>
+
+#include <algorithm>
+
+namespace dax {
+namespace cont {
+namespace internal {
+
+/// \brief A temporary C array drawn from the dax::cont::ScratchArena.
+///
+/// Device adapter algorithms use this in place of \c std::vector for buffers
+/// that live only for one call, such as the ping-pong buffers of a radix
+/// sort. Unlike \c std::vector, the values are not initialized.
+///
+template<typename T>
+class ScratchBuffer
+{
+public:
+  typedef T ValueType;
+
+  DAX_CONT_EXPORT ScratchBuffer()
+    : Array(NULL), NumberOfValues(0), BlockBytes(0) {  }
+
+  DAX_CONT_EXPORT explicit ScratchBuffer(dax::Id numberOfValues)
+    : Array(NULL), NumberOfValues(0), BlockBytes(0)
+  {
+    this->Allocate(numberOfValues);
+  }
+
+  DAX_CONT_EXPORT ~ScratchBuffer()
+  {
+    this->ReleaseResources();
+  }
+
+  /// Replaces the buffer with one of \p numberOfValues uninitialized values.
+  ///
+  DAX_CONT_EXPORT void Allocate(dax::Id numberOfValues)
+  {
+    this->ReleaseResources();
+    if (numberOfValues > 0)
+      {
+      this->Array = static_cast<ValueType*>(
+            dax::cont::ScratchArena::GetInstance().Allocate(
+              static_cast<dax::internal::Int64Type>(numberOfValues)
+              * static_cast<dax::internal::Int64Type>(sizeof(ValueType)),
+              this->BlockBytes));
+      this->NumberOfValues = numberOfValues;
+      }
+  }
+
+  DAX_CONT_EXPORT void ReleaseResources()
+  {
+    if (this->Array != NULL)
+      {
+      dax::cont::ScratchArena::GetInstance().Free(this->Array,
+                                                  this->BlockBytes);
+      this->Array = NULL;
+      this->NumberOfValues = 0;
+      this->BlockBytes = 0;
+      }
+  }
+
+  DAX_CONT_EXPORT void Swap(ScratchBuffer<ValueType> &other)
+  {
+    std::swap(this->Array, other.Array);
+    std::swap(this->NumberOfValues, other.NumberOfValues);
+    std::swap(this->BlockBytes, other.BlockBytes);
+  }
+
+  DAX_CONT_EXPORT dax::Id GetNumberOfValues() const
+  {
+    return this->NumberOfValues;
+  }
+
+  DAX_CONT_EXPORT ValueType *GetPointer() { return this->Array; }
+  DAX_CONT_EXPORT const ValueType *GetPointer() const { return this->Array; }
+
+  DAX_CONT_EXPORT ValueType &operator[](dax::Id index)
+  {
+    return this->Array[index];
+  }
+  DAX_CONT_EXPORT const ValueType &operator[](dax::Id index) const
+  {
+    return this->Array[index];
+  }
+
+private:
+  // Not implemented.
+  ScratchBuffer(const ScratchBuffer<ValueType> &);
+  void operator=(const ScratchBuffer<ValueType> &);
+
+  ValueType *Array;
+  dax::Id NumberOfValues;
+  dax::internal::Int64Type BlockBytes;
+};
+
+}
+}
+} // namespace dax::cont::internal
+
+#endif //__dax_cont_internal_ScratchBuffer_h
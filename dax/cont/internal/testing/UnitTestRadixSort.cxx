@@ -0,0 +1,187 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#include <dax/cont/internal/RadixSort.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const dax::Id ARRAY_SIZE = 10007;
+
+// Splits the work into several uneven blocks, like a parallel device would.
+struct SevenBlocks
+{
+  dax::Id GetNumberOfBlocks(dax::Id) const { return 7; }
+
+  template<class KernelType>
+  void operator()(const KernelType &kernel, dax::Id numBlocks) const
+  {
+    //run the blocks backwards to make sure they do not depend on each other
+    for (dax::Id block = numBlocks-1; block >= 0; --block)
+      {
+      kernel(block);
+      }
+  }
+};
+
+template<typename T>
+T TestValue(dax::Id index);
+
+template<> dax::internal::Int32Type TestValue(dax::Id index)
+{
+  return static_cast<dax::internal::Int32Type>((index * 7919) % 2003) - 1000;
+}
+template<> dax::internal::UInt32Type TestValue(dax::Id index)
+{
+  return static_cast<dax::internal::UInt32Type>(index) * 2654435761u;
+}
+template<> dax::internal::Int64Type TestValue(dax::Id index)
+{
+  return (static_cast<dax::internal::Int64Type>((index * 7919) % 2003) << 40)
+      - index;
+}
+template<> dax::internal::UInt64Type TestValue(dax::Id index)
+{
+  return static_cast<dax::internal::UInt64Type>(index)
+      * 11400714819323198485ull;
+}
+template<> float TestValue(dax::Id index)
+{
+  return static_cast<float>((index * 7919) % 2003 - 1000) * 0.37f;
+}
+template<> double TestValue(dax::Id index)
+{
+  return static_cast<double>((index * 7919) % 2003 - 1000) * 1.0e100;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void TestEncoding()
+{
+  typedef dax::cont::internal::RadixSortTraits<T> Traits;
+  for (dax::Id index = 0; index < 100; ++index)
+    {
+    const T a = TestValue<T>(index);
+    const T b = TestValue<T>(index+1);
+    DAX_TEST_ASSERT(Traits::Decode(Traits::Encode(a)) == a,
+                    "Key does not decode to its value");
+    DAX_TEST_ASSERT((a < b) == (Traits::Encode(a) < Traits::Encode(b)),
+                    "Keys are not ordered like their values");
+    }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, class BlocksType>
+void TestSort(const BlocksType &blocks)
+{
+  std::vector<T> values(ARRAY_SIZE);
+  for (dax::Id index = 0; index < ARRAY_SIZE; ++index)
+    {
+    values[index] = TestValue<T>(index);
+    }
+  std::vector<T> expected(values);
+  std::sort(expected.begin(), expected.end());
+
+  dax::cont::internal::RadixSort(values.begin(), values.end(), blocks);
+  DAX_TEST_ASSERT(values == expected, "Radix sort gave the wrong order");
+
+  //sorting sorted values must not change them
+  dax::cont::internal::RadixSort(values.begin(), values.end(), blocks);
+  DAX_TEST_ASSERT(values == expected, "Radix sort changed sorted values");
+}
+
+//-----------------------------------------------------------------------------
+template<class BlocksType>
+void TestSortByKey(const BlocksType &blocks)
+{
+  //few distinct keys, so there are many ties and stability matters
+  std::vector<dax::Id> keys(ARRAY_SIZE);
+  std::vector<dax::Vector3> values(ARRAY_SIZE);
+  for (dax::Id index = 0; index < ARRAY_SIZE; ++index)
+    {
+    keys[index] = (index * 7919) % 37 - 18;
+    values[index] = dax::make_Vector3(index, keys[index], 0);
+    }
+
+  dax::cont::internal::RadixSortByKey(keys.begin(),
+                                      keys.end(),
+                                      values.begin(),
+                                      blocks);
+
+  for (dax::Id index = 0; index < ARRAY_SIZE; ++index)
+    {
+    DAX_TEST_ASSERT(values[index][1] == keys[index],
+                    "Value was not moved with its key");
+    if (index > 0)
+      {
+      DAX_TEST_ASSERT(keys[index-1] <= keys[index],
+                      "Radix sort by key gave the wrong order");
+      DAX_TEST_ASSERT((keys[index-1] < keys[index]) ||
+                      (values[index-1][0] < values[index][0]),
+                      "Radix sort by key is not stable");
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+template<class BlocksType>
+void TestAllTypes(const BlocksType &blocks)
+{
+  TestSort<dax::internal::Int32Type>(blocks);
+  TestSort<dax::internal::UInt32Type>(blocks);
+  TestSort<dax::internal::Int64Type>(blocks);
+  TestSort<dax::internal::UInt64Type>(blocks);
+  TestSort<float>(blocks);
+  TestSort<double>(blocks);
+  TestSortByKey(blocks);
+}
+
+void TestRadixSort()
+{
+  std::cout << "Checking key encoding" << std::endl;
+  TestEncoding<dax::internal::Int32Type>();
+  TestEncoding<dax::internal::UInt32Type>();
+  TestEncoding<dax::internal::Int64Type>();
+  TestEncoding<dax::internal::UInt64Type>();
+  TestEncoding<float>();
+  TestEncoding<double>();
+
+  std::cout << "Sorting in one block" << std::endl;
+  TestAllTypes(dax::cont::internal::RadixSortSerialBlocks());
+
+  std::cout << "Sorting in several blocks" << std::endl;
+  TestAllTypes(SevenBlocks());
+
+  std::cout << "Sorting tiny arrays" << std::endl;
+  std::vector<dax::Id> one(1, 5);
+  dax::cont::internal::RadixSort(one.begin(), one.end(), SevenBlocks());
+  DAX_TEST_ASSERT(one[0] == 5, "Sorting one value changed it");
+  std::vector<dax::Id> two(2);
+  two[0] = 3; two[1] = -3;
+  dax::cont::internal::RadixSort(two.begin(), two.end(), SevenBlocks());
+  DAX_TEST_ASSERT(two[0] == -3 && two[1] == 3, "Bad sort of two values");
+}
+
+} // anonymous namespace
+
+int UnitTestRadixSort(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestRadixSort);
+}
@@ -0,0 +1,149 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#include <dax/cont/internal/ScheduleTiles.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <vector>
+
+namespace {
+
+// Records the order in which a schedule visits the flat indices.
+struct RecordIndex
+{
+  RecordIndex(std::vector<dax::Id> &visited) : Visited(&visited) {  }
+
+  void operator()(const dax::exec::internal::IJKIndex &index) const
+  {
+    const dax::Id3 ijk = index.GetIJK();
+    DAX_TEST_ASSERT(static_cast<dax::Id>(index) ==
+                    ijk[0] + this->Dims[0]*(ijk[1] + this->Dims[1]*ijk[2]),
+                    "IJK index does not match its flat index.");
+    this->Visited->push_back(index);
+  }
+
+  std::vector<dax::Id> *Visited;
+  dax::Id3 Dims;
+};
+
+std::vector<dax::Id> Visit(const dax::Id3 &rangeMax,
+                           const dax::cont::internal::ScheduleTiling &tiling)
+{
+  std::vector<dax::Id> visited;
+  RecordIndex record(visited);
+  record.Dims = rangeMax;
+  const dax::cont::internal::ScheduleTiles tiles(rangeMax, tiling);
+  // Run the tiles in two calls, like two threads would.
+  const dax::Id half = tiles.GetNumberOfTiles()/2;
+  tiles.RunTiles(record, 0, half);
+  tiles.RunTiles(record, half, tiles.GetNumberOfTiles());
+  return visited;
+}
+
+void CheckCoverage(const dax::Id3 &rangeMax,
+                   const dax::cont::internal::ScheduleTiling &tiling)
+{
+  std::cout << "Range " << rangeMax[0] << "x" << rangeMax[1] << "x"
+            << rangeMax[2] << ", tiles " << tiling.TileShape[0] << "x"
+            << tiling.TileShape[1] << "x" << tiling.TileShape[2]
+            << ((tiling.Order == dax::cont::internal::SCHEDULE_TILE_ORDER_MORTON)
+                ? " Morton" : " row major") << std::endl;
+  const std::vector<dax::Id> visited = Visit(rangeMax, tiling);
+  const dax::Id numIndices = rangeMax[0]*rangeMax[1]*rangeMax[2];
+  DAX_TEST_ASSERT(static_cast<dax::Id>(visited.size()) == numIndices,
+                  "Schedule visited the wrong number of indices.");
+  std::vector<int> counts(static_cast<std::size_t>(numIndices), 0);
+  for (std::size_t index = 0; index < visited.size(); ++index)
+    {
+    DAX_TEST_ASSERT(visited[index] >= 0 && visited[index] < numIndices,
+                    "Schedule visited an index out of range.");
+    DAX_TEST_ASSERT(++counts[visited[index]] == 1,
+                    "Schedule visited an index twice.");
+    }
+}
+
+void TestScheduleTiles()
+{
+  using dax::cont::internal::ScheduleTiling;
+  const dax::cont::internal::ScheduleTileOrder rowMajor =
+      dax::cont::internal::SCHEDULE_TILE_ORDER_ROW_MAJOR;
+  const dax::cont::internal::ScheduleTileOrder morton =
+      dax::cont::internal::SCHEDULE_TILE_ORDER_MORTON;
+
+  std::cout << "Untiled schedules run in k/j/i order" << std::endl;
+  const dax::Id3 range(7, 5, 6);
+  std::vector<dax::Id> visited = Visit(range, ScheduleTiling());
+  DAX_TEST_ASSERT(visited.size() == 7*5*6, "Wrong number of indices.");
+  for (std::size_t index = 0; index < visited.size(); ++index)
+    {
+    DAX_TEST_ASSERT(visited[index] == static_cast<dax::Id>(index),
+                    "Untiled schedule out of order.");
+    }
+
+  std::cout << "Tiles cover the range exactly once" << std::endl;
+  CheckCoverage(range, ScheduleTiling(dax::make_Id3(0, 1, 1), rowMajor));
+  CheckCoverage(range, ScheduleTiling(dax::make_Id3(2, 2, 2), rowMajor));
+  CheckCoverage(range, ScheduleTiling(dax::make_Id3(3, 2, 4), morton));
+  CheckCoverage(range, ScheduleTiling(dax::make_Id3(1, 1, 1), morton));
+  CheckCoverage(range, ScheduleTiling(dax::make_Id3(16, 16, 16), morton));
+  CheckCoverage(dax::make_Id3(1, 1, 1),
+                ScheduleTiling(dax::make_Id3(4, 4, 4), morton));
+
+  std::cout << "Empty ranges have no tiles" << std::endl;
+  const dax::cont::internal::ScheduleTiles empty(
+        dax::make_Id3(5, 0, 5),
+        ScheduleTiling(dax::make_Id3(2, 2, 2), rowMajor));
+  DAX_TEST_ASSERT(empty.GetNumberOfTiles() == 0, "Empty range has tiles.");
+  DAX_TEST_ASSERT(Visit(dax::make_Id3(0, 0, 0), ScheduleTiling()).empty(),
+                  "Empty range visited indices.");
+
+  std::cout << "Tile shape and count" << std::endl;
+  const dax::cont::internal::ScheduleTiles tiles(
+        range, ScheduleTiling(dax::make_Id3(0, 2, 4), rowMajor));
+  DAX_TEST_ASSERT(tiles.GetTileShape() == dax::make_Id3(7, 2, 4),
+                  "Whole rows were not used for a zero tile width.");
+  DAX_TEST_ASSERT(tiles.GetNumberOfTiles() == 1*3*2, "Wrong tile count.");
+  DAX_TEST_ASSERT(tiles.GetTileSize() == 7*2*4, "Wrong tile size.");
+
+  std::cout << "Morton tiles follow the Z curve" << std::endl;
+  // With 1x1x1 tiles on a 2x2x2 range the Z curve is the row major order.
+  visited = Visit(dax::make_Id3(2, 2, 2),
+                  ScheduleTiling(dax::make_Id3(1, 1, 1), morton));
+  for (std::size_t index = 0; index < visited.size(); ++index)
+    {
+    DAX_TEST_ASSERT(visited[index] == static_cast<dax::Id>(index),
+                    "Bad Morton order in a 2x2x2 block.");
+    }
+  // On a 4x4x1 range, the second 2x2 quadrant along i comes before the
+  // second row of the first quadrant is finished.
+  visited = Visit(dax::make_Id3(4, 4, 1),
+                  ScheduleTiling(dax::make_Id3(1, 1, 1), morton));
+  const dax::Id expected[] = { 0, 1, 4, 5, 2, 3, 6, 7,
+                               8, 9, 12, 13, 10, 11, 14, 15 };
+  for (std::size_t index = 0; index < visited.size(); ++index)
+    {
+    DAX_TEST_ASSERT(visited[index] == expected[index],
+                    "Bad Morton order in a 4x4 plane.");
+    }
+}
+
+} // anonymous namespace
+
+int UnitTestScheduleTiles(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestScheduleTiles);
+}
@@ -16,6 +16,7 @@
 #ifndef __dax_cont_testing_TestingDeviceAdapter_h
 #define __dax_cont_testing_TestingDeviceAdapter_h
 
+#include <dax/cont/ArrayContainerControlAligned.h>
 #include <dax/cont/ArrayContainerControlBasic.h>
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/ErrorExecution.h>
@@ -35,10 +36,13 @@
 #include <dax/cont/testing/Testing.h>
 #include <dax/cont/testing/TestingGridGenerator.h>
 
+#include <dax/cont/internal/ScheduleTiles.h>
+
 #include <dax/exec/internal/IJKIndex.h>
 
 #include <dax/math/Compare.h>
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -323,6 +327,39 @@ private:
       }
   }
 
+  // Runs kernels on an aligned array large enough to span many pages, which
+  // the device's ArrayManagerExecution may first touch from its threads.
+  static DAX_CONT_EXPORT void TestArrayContainerControlAligned()
+  {
+    std::cout << "-------------------------------------------" << std::endl;
+    std::cout << "Testing aligned ArrayContainerControl" << std::endl;
+
+    typedef dax::cont::internal::ArrayContainerControl<
+        dax::Id,dax::cont::ArrayContainerControlTagAligned> AlignedContainer;
+    typedef dax::cont::internal::ArrayManagerExecution<
+        dax::Id,dax::cont::ArrayContainerControlTagAligned,DeviceAdapterTag>
+        AlignedManager;
+
+    const dax::Id bigSize = 100*ARRAY_SIZE*ARRAY_SIZE/64;
+    AlignedContainer container;
+    AlignedManager manager;
+    manager.AllocateArrayForOutput(container, bigSize);
+    DAX_TEST_ASSERT(
+          reinterpret_cast<size_t>(
+            container.GetPortalConst().GetIteratorBegin()) % 64 == 0,
+          "Aligned array is not aligned.");
+
+    Algorithm::Schedule(ClearArrayKernel(manager.GetPortal()), bigSize);
+    Algorithm::Schedule(AddArrayKernel(manager.GetPortal()), bigSize);
+    manager.RetrieveOutputData(container);
+
+    for (dax::Id index = 0; index < bigSize; index++)
+      {
+      DAX_TEST_ASSERT(container.GetPortalConst().Get(index) == index + OFFSET,
+                      "Got bad value in aligned array.");
+      }
+  }
+
   static DAX_CONT_EXPORT void TestOutOfMemory()
   {
     // Only test out of memory with 64 bit ids.  If there are 32 bit ids on
@@ -463,6 +500,38 @@ private:
                       "Got bad value for scheduled dax::Id3 kernels.");
       }
     } //release memory
+
+    std::cout << "-------------------------------------------" << std::endl;
+    std::cout << "Testing Schedule with dax::Id3 and partial Morton tiles"
+              << std::endl;
+    {
+    typedef dax::cont::internal::ScheduleTilingSettings<DeviceAdapterTag>
+        TilingSettings;
+    TilingSettings::Set(dax::cont::internal::ScheduleTiling(
+                          dax::make_Id3(3, 2, 5),
+                          dax::cont::internal::SCHEDULE_TILE_ORDER_MORTON));
+
+    IdContainer container;
+    IdArrayManagerExecution manager;
+    dax::Id DIM_SIZE = dax::math::Ceil(dax::math::Cbrt(ARRAY_SIZE));
+    const dax::Id3 maxRange(DIM_SIZE + 2, DIM_SIZE, DIM_SIZE - 1);
+    const dax::Id maxId = maxRange[0] * maxRange[1] * maxRange[2];
+    manager.AllocateArrayForOutput(container, maxId);
+
+    std::cout << "Running clear and add." << std::endl;
+    Algorithm::Schedule(ClearArrayKernel(manager.GetPortal()), maxRange);
+    Algorithm::Schedule(AddArrayKernel(manager.GetPortal()), maxRange);
+    TilingSettings::Reset();
+
+    std::cout << "Checking results." << std::endl;
+    manager.RetrieveOutputData(container);
+    for (dax::Id index = 0; index < maxId; index++)
+      {
+      dax::Id value = container.GetPortalConst().Get(index);
+      DAX_TEST_ASSERT(value == index + OFFSET,
+                      "Got bad value for tiled dax::Id3 kernels.");
+      }
+    } //release memory
   }
 
   static DAX_CONT_EXPORT void TestDispatcher()
@@ -832,6 +901,73 @@ private:
       }
   }
 
+  static DAX_CONT_EXPORT void TestSortNumericKeys()
+  {
+    std::cout << "-------------------------------------------------" << std::endl;
+    std::cout << "Sort negative, floating point and 64 bit keys" << std::endl;
+
+    //scramble the values so that every byte of the keys changes
+    std::vector<dax::Id> ids(ARRAY_SIZE);
+    std::vector<dax::Scalar> scalars(ARRAY_SIZE);
+    std::vector<dax::internal::Int64Type> longs(ARRAY_SIZE);
+    for(dax::Id i=0; i < ARRAY_SIZE; ++i)
+      {
+      const dax::Id scrambled = (i * 7919) % ARRAY_SIZE;
+      ids[i] = (scrambled - ARRAY_SIZE/2) * 1000003;
+      scalars[i] = static_cast<dax::Scalar>(scrambled - ARRAY_SIZE/2) * 0.25f;
+      longs[i] = (static_cast<dax::internal::Int64Type>(scrambled) << 32)
+          - scrambled;
+      }
+
+    IdArrayHandle idHandle;
+    Algorithm::Copy(MakeArrayHandle(ids), idHandle);
+    Algorithm::Sort(idHandle);
+    ScalarArrayHandle scalarHandle;
+    Algorithm::Copy(MakeArrayHandle(scalars), scalarHandle);
+    Algorithm::Sort(scalarHandle);
+    dax::cont::ArrayHandle<dax::internal::Int64Type,
+                           ArrayContainerControlTagBasic,
+                           DeviceAdapterTag> longHandle;
+    Algorithm::Copy(MakeArrayHandle(longs), longHandle);
+    Algorithm::Sort(longHandle);
+
+    std::sort(ids.begin(), ids.end());
+    std::sort(scalars.begin(), scalars.end());
+    std::sort(longs.begin(), longs.end());
+    for(dax::Id i=0; i < ARRAY_SIZE; ++i)
+      {
+      DAX_TEST_ASSERT(idHandle.GetPortalConstControl().Get(i) == ids[i],
+                      "Got bad sorted negative Id");
+      DAX_TEST_ASSERT(scalarHandle.GetPortalConstControl().Get(i) == scalars[i],
+                      "Got bad sorted Scalar");
+      DAX_TEST_ASSERT(longHandle.GetPortalConstControl().Get(i) == longs[i],
+                      "Got bad sorted 64 bit key");
+      }
+
+    //sort Ids by Scalar keys, where the key of each Id is its negative
+    std::vector<dax::Scalar> keys(ARRAY_SIZE);
+    std::vector<dax::Id> values(ARRAY_SIZE);
+    for(dax::Id i=0; i < ARRAY_SIZE; ++i)
+      {
+      values[i] = (i * 7919) % ARRAY_SIZE;
+      keys[i] = -static_cast<dax::Scalar>(values[i]);
+      }
+    ScalarArrayHandle keyHandle;
+    Algorithm::Copy(MakeArrayHandle(keys), keyHandle);
+    IdArrayHandle valueHandle;
+    Algorithm::Copy(MakeArrayHandle(values), valueHandle);
+    Algorithm::SortByKey(keyHandle, valueHandle);
+    for(dax::Id i=0; i < ARRAY_SIZE; ++i)
+      {
+      DAX_TEST_ASSERT(keyHandle.GetPortalConstControl().Get(i) ==
+                      -static_cast<dax::Scalar>(ARRAY_SIZE-1-i),
+                      "Got bad SortByKeys Scalar key");
+      DAX_TEST_ASSERT(valueHandle.GetPortalConstControl().Get(i) ==
+                      ARRAY_SIZE-1-i,
+                      "Got bad SortByKeys value for Scalar key");
+      }
+  }
+
   static DAX_CONT_EXPORT void TestLowerBoundsWithComparisonObject()
   {
     std::cout << "-------------------------------------------------" << std::endl;
@@ -1212,6 +1348,7 @@ private:
     {
       std::cout << "Doing DeviceAdapter tests" << std::endl;
       TestArrayManagerExecution();
+      TestArrayContainerControlAligned();
       TestOutOfMemory();
       TestTimer();
 
@@ -1221,6 +1358,7 @@ private:
       TestScanExclusive();
       TestSortWithComparisonObject();
       TestSortByKey();
+      TestSortNumericKeys();
       TestLowerBoundsWithComparisonObject();
       TestUpperBoundsWithComparisonObject();
       TestUniqueWithComparisonObject();
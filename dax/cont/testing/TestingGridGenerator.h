@@ -60,10 +60,10 @@ private:
   const dax::Id Size;
   GridType Grid;
   template<typename GT> struct GridStorage {};
-  template<typename U, class UCCT, class DAT>
-  struct GridStorage<dax::cont::UnstructuredGrid<U,UCCT,UCCT,DAT> >
+  template<typename U, class UCCT, class DAT, typename CIT>
+  struct GridStorage<dax::cont::UnstructuredGrid<U,UCCT,UCCT,DAT,CIT> >
     {
-    std::vector<dax::Id> topology;
+    std::vector<CIT> topology;
     std::vector<dax::Vector3> points;
     };
   GridStorage<GridType> Info;
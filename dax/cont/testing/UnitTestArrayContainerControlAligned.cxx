@@ -0,0 +1,166 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_ARRAY_CONTAINER_CONTROL DAX_ARRAY_CONTAINER_CONTROL_ERROR
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_ERROR
+
+#include <dax/cont/ArrayContainerControlAligned.h>
+
+#include <dax/cont/DeviceAdapterSerial.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/internal/ArrayContainerControlFirstTouch.h>
+
+#include <dax/cont/testing/Testing.h>
+
+namespace
+{
+
+const dax::Id ARRAY_SIZE = 10;
+
+typedef dax::cont::internal::ArrayContainerControl<
+    dax::Scalar, dax::cont::ArrayContainerControlTagAligned> ContainerType;
+
+bool IsAligned(const ContainerType &container, dax::Id alignment)
+{
+  return (reinterpret_cast<size_t>(
+            container.GetPortalConst().GetIteratorBegin()) % alignment) == 0;
+}
+
+void TestAllocation()
+{
+  std::cout << "Allocating aligned arrays" << std::endl;
+  ContainerType container;
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == 0,
+                  "New array container not zero sized.");
+
+  container.Allocate(ARRAY_SIZE);
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == ARRAY_SIZE,
+                  "Array not properly allocated.");
+  DAX_TEST_ASSERT(IsAligned(container, 64), "Array not aligned to 64.");
+  DAX_TEST_ASSERT(container.GetFirstTouchPending(),
+                  "New array should be waiting for its first touch.");
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    container.GetPortal().Set(index, index);
+    }
+
+  container.SetFirstTouched();
+  container.Allocate(ARRAY_SIZE/2);
+  DAX_TEST_ASSERT(!container.GetFirstTouchPending(),
+                  "Reusing the array should not ask for a first touch.");
+  DAX_TEST_ASSERT(container.GetPortalConst().Get(ARRAY_SIZE/2 - 1)
+                  == ARRAY_SIZE/2 - 1,
+                  "Reusing the array lost values.");
+
+  container.Allocate(ARRAY_SIZE * 2);
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == ARRAY_SIZE * 2,
+                  "Array not reallocated correctly.");
+  DAX_TEST_ASSERT(container.GetFirstTouchPending(),
+                  "Reallocated array should be waiting for its first touch.");
+
+  container.Shrink(ARRAY_SIZE);
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == ARRAY_SIZE,
+                  "Array Shrink failed to resize.");
+  container.Shrink(0);
+  container.ReleaseResources();
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == 0,
+                  "Array not released correctly.");
+
+  try
+    {
+    container.Shrink(ARRAY_SIZE);
+    DAX_TEST_FAIL("Array shrink to a larger size was possible.");
+    }
+  catch (dax::cont::ErrorControlBadValue) {  }
+
+  container.Allocate(ARRAY_SIZE);
+  dax::Scalar *stolenArray = container.StealArray();
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == 0,
+                  "StealArray did not let go of array.");
+  free(stolenArray);
+}
+
+void TestSettings()
+{
+  std::cout << "Changing the alignment" << std::endl;
+  dax::cont::ArrayContainerControlAlignment alignment;
+  alignment.Alignment = 4096;
+  alignment.FirstTouch = false;
+  dax::cont::ArrayContainerControlAlignedSettings::Set(alignment);
+  {
+  ContainerType container;
+  container.Allocate(ARRAY_SIZE);
+  DAX_TEST_ASSERT(IsAligned(container, 4096), "Array not aligned to 4096.");
+  DAX_TEST_ASSERT(!container.GetFirstTouchPending(),
+                  "First touch was turned off.");
+  }
+
+  std::cout << "Asking for huge pages" << std::endl;
+  alignment = dax::cont::ArrayContainerControlAlignment();
+  alignment.HugePageThreshold = 1024*1024;
+  dax::cont::ArrayContainerControlAlignedSettings::Set(alignment);
+  {
+  ContainerType small;
+  small.Allocate(ARRAY_SIZE);
+  DAX_TEST_ASSERT(IsAligned(small, 64), "Small array not aligned.");
+
+  ContainerType big;
+  const dax::Id bigSize = 1024*1024;
+  big.Allocate(bigSize);
+  DAX_TEST_ASSERT(IsAligned(big, alignment.HugePageSize),
+                  "Big array not aligned to a huge page.");
+  for (dax::Id index = 0; index < bigSize; index++)
+    {
+    big.GetPortal().Set(index, 1);
+    }
+
+  std::cout << "First touching the big array" << std::endl;
+  dax::cont::internal::ArrayContainerControlFirstTouch<
+      dax::cont::DeviceAdapterTagSerial>(big);
+  DAX_TEST_ASSERT(!big.GetFirstTouchPending(), "First touch not recorded.");
+  }
+
+  std::cout << "Rejecting bad alignments" << std::endl;
+  alignment = dax::cont::ArrayContainerControlAlignment();
+  alignment.Alignment = 96;
+  try
+    {
+    dax::cont::ArrayContainerControlAlignedSettings::Set(alignment);
+    DAX_TEST_FAIL("Alignment that is not a power of two was accepted.");
+    }
+  catch (dax::cont::ErrorControlBadValue) {  }
+  DAX_TEST_ASSERT(
+        dax::cont::ArrayContainerControlAlignedSettings::Get().Alignment != 96,
+        "Bad alignment was kept.");
+
+  dax::cont::ArrayContainerControlAlignedSettings::Reset();
+  DAX_TEST_ASSERT(
+        dax::cont::ArrayContainerControlAlignedSettings::Get().Alignment == 64,
+        "Reset did not restore the default alignment.");
+}
+
+void TestArrayContainerControlAligned()
+{
+  TestAllocation();
+  TestSettings();
+}
+
+} // Anonymous namespace
+
+int UnitTestArrayContainerControlAligned(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestArrayContainerControlAligned);
+}
@@ -0,0 +1,160 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+//This sets up the ArrayHandle semantics to allocate pointers and share memory
+//between control and execution.
+#define DAX_ARRAY_CONTAINER_CONTROL DAX_ARRAY_CONTAINER_CONTROL_BASIC
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/cont/ArrayHandleInterpolated.h>
+#include <dax/cont/ArrayHandle.h>
+
+#include <dax/exec/internal/InterpolationEdge.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <vector>
+
+namespace {
+
+const dax::Id NUM_FIELD_VALUES = 10;
+const dax::Id ARRAY_SIZE = 9;
+
+typedef dax::cont::ArrayHandle<dax::exec::internal::InterpolationEdgeType>
+    EdgeHandleType;
+typedef dax::cont::ArrayHandle<dax::Scalar> RatioHandleType;
+
+template<typename ValueType>
+ValueType FieldValue(dax::Id index)
+{
+  return ValueType(dax::Scalar(10*index + 1));
+}
+
+// Point index lies a quarter, a half or three quarters of the way along
+// the edge from input point index to input point index + 1.
+template<typename ValueType>
+ValueType ExpectedValue(dax::Id index)
+{
+  const dax::Scalar ratio = dax::Scalar(1 + index%3)/dax::Scalar(4);
+  return FieldValue<ValueType>(index)
+      + ratio*(FieldValue<ValueType>(index+1) - FieldValue<ValueType>(index));
+}
+
+template<typename ValueType>
+struct InterpolatedTests
+{
+  typedef dax::cont::ArrayHandle<ValueType> FieldHandleType;
+  typedef dax::cont::ArrayHandleInterpolated<FieldHandleType,
+                                             EdgeHandleType,
+                                             RatioHandleType>
+      InterpolatedHandleType;
+
+  void operator()() const
+  {
+    std::vector<dax::exec::internal::InterpolationEdgeType> edges;
+    std::vector<dax::Scalar> ratios;
+    for (dax::Id index = 0; index < ARRAY_SIZE; ++index)
+      {
+      // Give the edge ends in both orders, the edge is the same.
+      edges.push_back((index%2 == 0)
+          ? dax::exec::internal::MakeInterpolationEdge(index, index+1)
+          : dax::exec::internal::MakeInterpolationEdge(index+1, index));
+      ratios.push_back(dax::Scalar(1 + index%3)/dax::Scalar(4));
+      }
+    std::vector<ValueType> field;
+    for (dax::Id index = 0; index < NUM_FIELD_VALUES; ++index)
+      {
+      field.push_back(FieldValue<ValueType>(index));
+      }
+
+    EdgeHandleType edgeHandle = dax::cont::make_ArrayHandle(edges);
+    RatioHandleType ratioHandle = dax::cont::make_ArrayHandle(ratios);
+    FieldHandleType fieldHandle;
+
+    InterpolatedHandleType interpolated =
+        dax::cont::make_ArrayHandleInterpolated(edgeHandle,
+                                                ratioHandle,
+                                                fieldHandle);
+
+    //fill the field after making the interpolated handle, so that we check
+    //that the values are interpolated when they are read
+    typename FieldHandleType::PortalExecution fieldPortal =
+        fieldHandle.PrepareForOutput(NUM_FIELD_VALUES);
+    for (dax::Id index = 0; index < NUM_FIELD_VALUES; ++index)
+      {
+      fieldPortal.Set(index, field[index]);
+      }
+
+    std::cout << "Checking the execution portal" << std::endl;
+    typename InterpolatedHandleType::PortalConstExecution execPortal =
+        interpolated.PrepareForInput();
+    DAX_TEST_ASSERT(execPortal.GetNumberOfValues() == ARRAY_SIZE,
+                    "Interpolated array has the wrong size");
+    for (dax::Id index = 0; index < ARRAY_SIZE; ++index)
+      {
+      DAX_TEST_ASSERT(test_equal(execPortal.Get(index),
+                                 ExpectedValue<ValueType>(index)),
+                      "Interpolated array has the wrong value");
+      }
+
+    std::cout << "Checking that the values follow the field" << std::endl;
+    for (dax::Id index = 0; index < NUM_FIELD_VALUES; ++index)
+      {
+      fieldPortal.Set(index, FieldValue<ValueType>(index+1));
+      }
+    execPortal = interpolated.PrepareForInput();
+    for (dax::Id index = 0; index < ARRAY_SIZE; ++index)
+      {
+      // Every field value grew by 10, and so did every interpolated value.
+      DAX_TEST_ASSERT(test_equal(execPortal.Get(index),
+                                 ExpectedValue<ValueType>(index)
+                                 + ValueType(dax::Scalar(10))),
+                      "Interpolated array did not see the new field");
+      }
+
+    std::cout << "Checking that the ratios must match the edges" << std::endl;
+    ratios.pop_back();
+    InterpolatedHandleType mismatched =
+        dax::cont::make_ArrayHandleInterpolated(
+          edgeHandle, dax::cont::make_ArrayHandle(ratios), fieldHandle);
+    bool gotError = false;
+    try
+      {
+      mismatched.PrepareForInput();
+      }
+    catch (dax::cont::ErrorControlBadValue error)
+      {
+      std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+      gotError = true;
+      }
+    DAX_TEST_ASSERT(gotError,
+                    "Interpolated array accepted too few ratios");
+  }
+};
+
+void TestArrayHandleInterpolated()
+{
+  std::cout << "*** dax::Scalar" << std::endl;
+  InterpolatedTests<dax::Scalar>()();
+  std::cout << "*** dax::Vector3" << std::endl;
+  InterpolatedTests<dax::Vector3>()();
+}
+
+} // annonymous namespace
+
+int UnitTestArrayHandleInterpolated(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestArrayHandleInterpolated);
+}
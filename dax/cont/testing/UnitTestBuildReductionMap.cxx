@@ -22,6 +22,7 @@
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/DeviceAdapterSerial.h>
 #include <dax/cont/DispatcherReduceKeysValues.h>
+#include <dax/cont/ErrorExecution.h>
 
 #include <dax/exec/WorkletReduceKeysValues.h>
 
@@ -130,13 +131,25 @@ KeyMapType BuildSerialKeyMap(const ArrayType &inputKeys)
   return keyMap;
 }
 
-void CheckKeyMap(const ArrayType &inputKeys, KeyMapType serialMap)
+ArrayType SortKeys(const ArrayType &inputKeys)
+{
+  ArrayType sortedKeys;
+  dax::cont::DeviceAdapterAlgorithm<DeviceAdapter>::Copy(inputKeys,
+                                                         sortedKeys);
+  dax::cont::DeviceAdapterAlgorithm<DeviceAdapter>::Sort(sortedKeys);
+  return sortedKeys;
+}
+
+void CheckKeyMap(const ArrayType &inputKeys,
+                 KeyMapType serialMap,
+                 dax::Id keyRange = 0)
 {
   std::cout << "Run Dax KeyMap and store counts, offsets, and indices" << std::endl;
 
   TrackReduceWorklet track;
   dax::cont::DispatcherReduceKeysValues< TrackReduceWorklet,
         ArrayType, DeviceAdapter > reduceKeyValues(inputKeys, track);
+  reduceKeyValues.SetKeyRange(keyRange);
 
   //we need to pass the index as the values to bind too
   typedef dax::cont::ArrayHandleCounting<dax::Id, DeviceAdapter> CountingHandle;
@@ -163,6 +176,28 @@ void CheckKeyMap(const ArrayType &inputKeys, KeyMapType serialMap)
     }
 }
 
+void CheckKeyOutOfRange(const ArrayType &inputKeys)
+{
+  std::cout << "Checking that keys outside the key range are reported"
+            << std::endl;
+
+  TrackReduceWorklet track;
+  dax::cont::DispatcherReduceKeysValues< TrackReduceWorklet,
+        ArrayType, DeviceAdapter > reduceKeyValues(inputKeys, track);
+  reduceKeyValues.SetKeyRange(NUM_KEYS/2);
+
+  typedef dax::cont::ArrayHandleCounting<dax::Id, DeviceAdapter> CountingHandle;
+  try
+    {
+    reduceKeyValues.Invoke( CountingHandle(0,inputKeys.GetNumberOfValues()) );
+    }
+  catch (dax::cont::ErrorExecution &)
+    {
+    return;
+    }
+  DAX_TEST_FAIL("Key outside of the key range was not reported.");
+}
+
 void RunBuildReductionMap()
 {
   srandom(time(NULL));
@@ -170,6 +205,24 @@ void RunBuildReductionMap()
   ArrayType randomKeyInput = MakeInputArray();
   KeyMapType serialMap = BuildSerialKeyMap(randomKeyInput);
   CheckKeyMap(randomKeyInput, serialMap);
+
+  std::cout << "Checking keys with a declared key range" << std::endl;
+  CheckKeyMap(randomKeyInput, serialMap, NUM_KEYS);
+  CheckKeyMap(randomKeyInput, serialMap, 3*NUM_KEYS);
+
+  std::cout << "Checking keys that are already sorted" << std::endl;
+  ArrayType sortedKeyInput = SortKeys(randomKeyInput);
+  KeyMapType sortedSerialMap = BuildSerialKeyMap(sortedKeyInput);
+  CheckKeyMap(sortedKeyInput, sortedSerialMap);
+  CheckKeyMap(sortedKeyInput, sortedSerialMap, NUM_KEYS);
+
+  // Place a key at both ends of the range so the out of range check has
+  // something to find whatever the random keys were.
+  std::vector<dax::Id> boundaryData(ARRAY_SIZE, 0);
+  boundaryData[ARRAY_SIZE-1] = NUM_KEYS-1;
+  ArrayType boundaryKeys =
+      dax::cont::make_ArrayHandle(boundaryData,Container(),DeviceAdapter());
+  CheckKeyOutOfRange(boundaryKeys);
 }
 
 } // anonymous namespace
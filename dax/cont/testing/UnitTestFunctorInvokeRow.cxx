@@ -0,0 +1,438 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#define DAX_ARRAY_CONTAINER_CONTROL DAX_ARRAY_CONTAINER_CONTROL_BASIC
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleImplicit.h>
+#include <dax/cont/DeviceAdapterSerial.h>
+#include <dax/cont/DispatcherMapCell.h>
+#include <dax/cont/UniformGrid.h>
+#include <dax/cont/internal/ScheduleTiles.h>
+
+#include <dax/exec/CellField.h>
+#include <dax/exec/WorkletMapCell.h>
+#include <dax/exec/internal/Functor.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <vector>
+
+namespace {
+
+const dax::Id3 CELL_DIMS(7, 4, 3);
+const dax::Scalar UNSET_VALUE = -1;
+
+// The first vertex of the voxel is at ijk, the others are offset by these.
+const dax::Id VERTEX_OFFSETS[8][3] = {
+  {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1} };
+
+// A weighted sum of the values gathered for the cell, so that a value taken
+// from the wrong point or given to the wrong vertex changes the result.
+struct GatherCellPoints : public dax::exec::WorkletMapCell
+{
+  typedef void ControlSignature(Topology, Field(Point), Field(Out));
+  typedef _3 ExecutionSignature(_2);
+
+  template<class CellTag>
+  DAX_EXEC_EXPORT
+  dax::Scalar operator()(
+      const dax::exec::CellField<dax::Scalar,CellTag> &values) const
+  {
+    dax::Scalar result = 0;
+    for (int vertex = 0; vertex < values.NUM_VERTICES; ++vertex)
+      {
+      result += dax::Scalar(vertex+1)*values[vertex];
+      }
+    return result;
+  }
+};
+
+dax::Id PointIndex(dax::Id i, dax::Id j, dax::Id k)
+{
+  return i + (CELL_DIMS[0]+1)*(j + (CELL_DIMS[1]+1)*k);
+}
+
+dax::Scalar PointValue(dax::Id pointIndex)
+{
+  return dax::Scalar(pointIndex);
+}
+
+dax::Scalar ExpectedCellValue(dax::Id cellIndex)
+{
+  const dax::Id i = cellIndex % CELL_DIMS[0];
+  const dax::Id j = (cellIndex / CELL_DIMS[0]) % CELL_DIMS[1];
+  const dax::Id k = cellIndex / (CELL_DIMS[0]*CELL_DIMS[1]);
+  dax::Scalar result = 0;
+  for (int vertex = 0; vertex < 8; ++vertex)
+    {
+    result += dax::Scalar(vertex+1)*PointValue(
+          PointIndex(i + VERTEX_OFFSETS[vertex][0],
+                     j + VERTEX_OFFSETS[vertex][1],
+                     k + VERTEX_OFFSETS[vertex][2]));
+    }
+  return result;
+}
+
+// Computes the values of a point field from the values in a vector, so that
+// an implicit array can stand for a field whose values are computed.
+struct PointValuesFunctor
+{
+  PointValuesFunctor() : Values(NULL) {  }
+  PointValuesFunctor(const std::vector<dax::Scalar> *values)
+    : Values(values) {  }
+
+  DAX_EXEC_CONT_EXPORT
+  dax::Scalar operator()(dax::Id index) const
+  {
+    return (*this->Values)[static_cast<std::size_t>(index)];
+  }
+
+  const std::vector<dax::Scalar> *Values;
+};
+
+typedef dax::cont::UniformGrid<dax::cont::DeviceAdapterTagSerial> GridType;
+typedef dax::cont::ArrayHandle<dax::Scalar> ScalarHandleType;
+typedef dax::cont::ArrayHandleImplicit<dax::Scalar, PointValuesFunctor>
+  ComputedHandleType;
+
+// Binds the worklet to a grid, a point field and a cell field the way a
+// dispatcher does, so that the ways of scheduling a functor can be compared.
+// The point field is either loaded from an array or computed.
+template<typename FieldHandleType>
+struct GatherTest
+{
+  typedef dax::internal::Invocation<
+      GatherCellPoints,
+      dax::internal::ParameterPack<GridType,FieldHandleType,ScalarHandleType> >
+    Invocation;
+  typedef typename dax::cont::internal::Bindings<Invocation>::type
+    BindingsType;
+  typedef dax::exec::internal::Functor<Invocation> FunctorType;
+  typedef typename dax::exec::arg::FindBinding<
+      Invocation, dax::cont::sig::placeholders::_2>::type PointBindingType;
+
+  GatherTest()
+    : PointValues(static_cast<std::size_t>(
+                    (CELL_DIMS[0]+1)*(CELL_DIMS[1]+1)*(CELL_DIMS[2]+1)))
+  {
+    for (std::size_t index = 0; index < this->PointValues.size(); ++index)
+      {
+      this->PointValues[index] = PointValue(static_cast<dax::Id>(index));
+      }
+    this->Grid.SetExtent(dax::make_Id3(0, 0, 0), CELL_DIMS);
+  }
+
+  BindingsType MakeBindings()
+  {
+    BindingsType bindings = dax::cont::internal::BindingsCreate(
+          GatherCellPoints(),
+          dax::internal::make_ParameterPack(
+            this->Grid,
+            this->MakeField(FieldHandleType()),
+            this->CellValues));
+    bindings.ForEachCont(dax::cont::dispatcher::CreateExecutionResources(
+                           this->Grid.GetNumberOfCells()));
+    this->ClearCells();
+    return bindings;
+  }
+
+  ScalarHandleType MakeField(ScalarHandleType)
+  {
+    return dax::cont::make_ArrayHandle(this->PointValues);
+  }
+
+  ComputedHandleType MakeField(ComputedHandleType)
+  {
+    return ComputedHandleType(
+          PointValuesFunctor(&this->PointValues),
+          static_cast<dax::Id>(this->PointValues.size()));
+  }
+
+  // The serial device shares the cell array with the control environment,
+  // so this clears the array the bindings write to.
+  void ClearCells()
+  {
+    typename ScalarHandleType::PortalExecution cells =
+        this->CellValues.PrepareForInPlace();
+    for (dax::Id index = 0; index < cells.GetNumberOfValues(); ++index)
+      {
+      cells.Set(index, UNSET_VALUE);
+      }
+  }
+
+  // Every cell is written exactly once with the value it gathers from its
+  // points, and then cleared for the next schedule.
+  void CheckCells(const char *message)
+  {
+    typename ScalarHandleType::PortalConstControl cells =
+        this->CellValues.GetPortalConstControl();
+    for (dax::Id index = 0; index < cells.GetNumberOfValues(); ++index)
+      {
+      DAX_TEST_ASSERT(cells.Get(index) == ExpectedCellValue(index), message);
+      }
+    this->ClearCells();
+  }
+
+  GridType Grid;
+  std::vector<dax::Scalar> PointValues;
+  ScalarHandleType CellValues;
+};
+
+template<typename FieldHandleType>
+void CheckCellsOneAtATime()
+{
+  std::cout << "Cells invoked one at a time" << std::endl;
+  typedef GatherTest<FieldHandleType> TestType;
+  TestType test;
+  typename TestType::BindingsType bindings = test.MakeBindings();
+  const typename TestType::FunctorType functor(GatherCellPoints(), bindings);
+  dax::exec::internal::IJKIndex index(CELL_DIMS);
+  for (dax::Id k = 0; k < CELL_DIMS[2]; ++k)
+    {
+    index.SetK(k);
+    for (dax::Id j = 0; j < CELL_DIMS[1]; ++j)
+      {
+      index.SetJ(j);
+      // Backwards along i, so that no cell follows its neighbor.
+      for (dax::Id i = CELL_DIMS[0]-1; i >= 0; --i)
+        {
+        index.SetI(i);
+        functor(index);
+        }
+      }
+    }
+  test.CheckCells("Cell invoked on its own gathered the wrong values");
+}
+
+template<typename FieldHandleType>
+void CheckInvokeRow()
+{
+  std::cout << "Rows invoked from their start" << std::endl;
+  typedef GatherTest<FieldHandleType> TestType;
+  TestType test;
+  typename TestType::BindingsType bindings = test.MakeBindings();
+  const typename TestType::FunctorType functor(GatherCellPoints(), bindings);
+  dax::exec::internal::IJKIndex index(CELL_DIMS);
+  for (dax::Id k = 0; k < CELL_DIMS[2]; ++k)
+    {
+    index.SetK(k);
+    for (dax::Id j = 0; j < CELL_DIMS[1]; ++j)
+      {
+      index.SetJ(j);
+      index.SetI(0);
+      functor.InvokeRow(index, CELL_DIMS[0]);
+      }
+    }
+  test.CheckCells("Row of cells gathered the wrong values");
+
+  std::cout << "Rows split into pieces" << std::endl;
+  // Pieces of one and two cells, and pieces starting in the middle of the
+  // row, each start their own gather.
+  const dax::Id pieceEnds[] = { 1, 3, 6, 7 };
+  for (dax::Id k = 0; k < CELL_DIMS[2]; ++k)
+    {
+    index.SetK(k);
+    for (dax::Id j = 0; j < CELL_DIMS[1]; ++j)
+      {
+      index.SetJ(j);
+      dax::Id begin = 0;
+      for (int piece = 0; piece < 4; ++piece)
+        {
+        index.SetI(begin);
+        functor.InvokeRow(index, pieceEnds[piece]);
+        begin = pieceEnds[piece];
+        }
+      }
+    }
+  test.CheckCells("Piece of a row gathered the wrong values");
+
+  std::cout << "Empty rows invoke nothing" << std::endl;
+  index.SetK(0);
+  index.SetJ(0);
+  index.SetI(3);
+  functor.InvokeRow(index, 3);
+  typename ScalarHandleType::PortalConstControl cells =
+      test.CellValues.GetPortalConstControl();
+  for (dax::Id cellIndex = 0;
+       cellIndex < cells.GetNumberOfValues();
+       ++cellIndex)
+    {
+    DAX_TEST_ASSERT(cells.Get(cellIndex) == UNSET_VALUE,
+                    "Empty row invoked a cell");
+    }
+}
+
+template<typename FieldHandleType>
+void CheckTiles(const dax::cont::internal::ScheduleTiling &tiling)
+{
+  std::cout << "Tiles " << tiling.TileShape[0] << "x"
+            << tiling.TileShape[1] << "x" << tiling.TileShape[2]
+            << ((tiling.Order == dax::cont::internal::SCHEDULE_TILE_ORDER_MORTON)
+                ? " Morton" : " row major") << std::endl;
+  typedef GatherTest<FieldHandleType> TestType;
+  TestType test;
+  typename TestType::BindingsType bindings = test.MakeBindings();
+  typename TestType::FunctorType functor(GatherCellPoints(), bindings);
+  const dax::cont::internal::ScheduleTiles tiles(CELL_DIMS, tiling);
+  // Run the tiles in two calls, like two threads would.
+  const dax::Id half = tiles.GetNumberOfTiles()/2;
+  tiles.RunTiles(functor, 0, half);
+  tiles.RunTiles(functor, half, tiles.GetNumberOfTiles());
+  test.CheckCells("Tiled schedule gathered the wrong values");
+}
+
+// The binding keeps the values of the last voxel it gathered. Changing the
+// point field behind its back shows which values were computed again.
+void CheckFaceReuse()
+{
+  std::cout << "Neighbors along i reuse the shared face" << std::endl;
+  typedef GatherTest<ComputedHandleType> TestType;
+  TestType test;
+  TestType::BindingsType bindings = test.MakeBindings();
+  typedef TestType::PointBindingType BindingType;
+  DAX_TEST_ASSERT(BindingType::ReusesFaces::value,
+                  "Computed point field does not reuse faces");
+  BindingType first(bindings);
+  const GatherCellPoints worklet;
+
+  typedef dax::exec::CellField<dax::Scalar,dax::CellTagVoxel> CellValuesType;
+  const CellValuesType firstValues =
+      first(dax::exec::internal::IJKIndex(CELL_DIMS, dax::make_Id3(2,1,1)),
+            worklet);
+
+  // Point (3,1,1) is on the shared face, point (4,1,1) is not.
+  const dax::Scalar offset = 1000;
+  test.PointValues[PointIndex(3,1,1)] += offset;
+  test.PointValues[PointIndex(4,1,1)] += offset;
+
+  BindingType next(bindings);
+  next.ContinueRow(first);
+  const CellValuesType nextValues =
+      next(dax::exec::internal::IJKIndex(CELL_DIMS, dax::make_Id3(3,1,1)),
+           worklet);
+  DAX_TEST_ASSERT(nextValues[0] == firstValues[1],
+                  "Shared face was loaded again");
+  DAX_TEST_ASSERT(nextValues[3] == firstValues[2] &&
+                  nextValues[4] == firstValues[5] &&
+                  nextValues[7] == firstValues[6],
+                  "Shared face was not handed to the next voxel");
+  DAX_TEST_ASSERT(nextValues[1] == PointValue(PointIndex(4,1,1)) + offset,
+                  "Far face was not loaded");
+
+  std::cout << "Voxels that are not the next along i gather every point"
+            << std::endl;
+  const dax::Id3 notNext[] = { dax::make_Id3(3,1,1),   // the same voxel
+                               dax::make_Id3(4,1,1),   // skips one
+                               dax::make_Id3(0,2,1),   // start of next row
+                               dax::make_Id3(3,2,1),   // next along j
+                               dax::make_Id3(3,1,2) }; // next along k
+  for (int trial = 0; trial < 5; ++trial)
+    {
+    BindingType other(bindings);
+    other.ContinueRow(next);
+    const CellValuesType values =
+        other(dax::exec::internal::IJKIndex(CELL_DIMS, notNext[trial]),
+              worklet);
+    for (int vertex = 0; vertex < 8; ++vertex)
+      {
+      DAX_TEST_ASSERT(
+            values[vertex] == test.PointValues[
+              PointIndex(notNext[trial][0] + VERTEX_OFFSETS[vertex][0],
+                         notNext[trial][1] + VERTEX_OFFSETS[vertex][1],
+                         notNext[trial][2] + VERTEX_OFFSETS[vertex][2])],
+            "Values were reused for a voxel that is not the next one");
+      }
+    }
+
+  std::cout << "Bindings that were not continued gather every point"
+            << std::endl;
+  BindingType fresh(bindings);
+  const CellValuesType freshValues =
+      fresh(dax::exec::internal::IJKIndex(CELL_DIMS, dax::make_Id3(3,1,1)),
+            worklet);
+  DAX_TEST_ASSERT(freshValues[0] == PointValue(PointIndex(3,1,1)) + offset,
+                  "Fresh binding reused values it never gathered");
+}
+
+// Values loaded from an array are cheaper to load again than to hand along,
+// so voxels gather every point even when continuing a row.
+void CheckNoReuseOfLoadedValues()
+{
+  std::cout << "Loaded point fields gather every point" << std::endl;
+  typedef GatherTest<ScalarHandleType> TestType;
+  TestType test;
+  TestType::BindingsType bindings = test.MakeBindings();
+  typedef TestType::PointBindingType BindingType;
+  DAX_TEST_ASSERT(!BindingType::ReusesFaces::value,
+                  "Point field loaded from an array reuses faces");
+  BindingType first(bindings);
+  const GatherCellPoints worklet;
+  first(dax::exec::internal::IJKIndex(CELL_DIMS, dax::make_Id3(2,1,1)),
+        worklet);
+
+  const dax::Scalar offset = 1000;
+  test.PointValues[PointIndex(3,1,1)] += offset;
+
+  BindingType next(bindings);
+  next.ContinueRow(first);
+  const dax::exec::CellField<dax::Scalar,dax::CellTagVoxel> nextValues =
+      next(dax::exec::internal::IJKIndex(CELL_DIMS, dax::make_Id3(3,1,1)),
+           worklet);
+  DAX_TEST_ASSERT(nextValues[0] == PointValue(PointIndex(3,1,1)) + offset,
+                  "Loaded values were handed to the next voxel");
+
+  DAX_TEST_ASSERT(
+        dax::cont::internal::ArrayPortalComputesValues<
+          GridType::PointCoordinatesType::PortalConstExecution>::value,
+        "Uniform grid coordinates are not marked as computed");
+}
+
+template<typename FieldHandleType>
+void CheckSchedules()
+{
+  CheckCellsOneAtATime<FieldHandleType>();
+  CheckInvokeRow<FieldHandleType>();
+
+  using dax::cont::internal::ScheduleTiling;
+  const dax::cont::internal::ScheduleTileOrder rowMajor =
+      dax::cont::internal::SCHEDULE_TILE_ORDER_ROW_MAJOR;
+  const dax::cont::internal::ScheduleTileOrder morton =
+      dax::cont::internal::SCHEDULE_TILE_ORDER_MORTON;
+  CheckTiles<FieldHandleType>(ScheduleTiling());
+  CheckTiles<FieldHandleType>(ScheduleTiling(dax::make_Id3(0, 1, 1), rowMajor));
+  CheckTiles<FieldHandleType>(ScheduleTiling(dax::make_Id3(1, 1, 1), rowMajor));
+  CheckTiles<FieldHandleType>(ScheduleTiling(dax::make_Id3(2, 2, 2), rowMajor));
+  CheckTiles<FieldHandleType>(ScheduleTiling(dax::make_Id3(3, 2, 2), morton));
+}
+
+void TestFunctorInvokeRow()
+{
+  std::cout << "*** Point field loaded from an array" << std::endl;
+  CheckSchedules<ScalarHandleType>();
+  std::cout << "*** Point field computed by an implicit array" << std::endl;
+  CheckSchedules<ComputedHandleType>();
+
+  CheckFaceReuse();
+  CheckNoReuseOfLoadedValues();
+}
+
+} // anonymous namespace
+
+int UnitTestFunctorInvokeRow(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestFunctorInvokeRow);
+}
@@ -0,0 +1,570 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/cont/MemoryRegistry.h>
+
+#include <dax/cont/ArrayContainerControlBasic.h>
+#include <dax/cont/ArrayContainerControlScratch.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleTransform.h>
+#include <dax/cont/DeviceAdapterSerial.h>
+#include <dax/cont/DispatcherGenerateInterpolatedCells.h>
+#include <dax/cont/DispatcherMapCell.h>
+#include <dax/cont/ScratchArena.h>
+#include <dax/cont/UniformGrid.h>
+#include <dax/cont/UnstructuredGrid.h>
+#include <dax/cont/internal/ArrayPortalFromIterators.h>
+#include <dax/cont/internal/DeviceAdapterAlgorithmGeneral.h>
+
+#include <dax/worklet/MarchingCubes.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace dax {
+namespace cont {
+namespace testing {
+
+// A device adapter whose execution arrays are copies in a memory space of
+// their own, like a GPU. It schedules with the serial device adapter.
+struct DeviceAdapterTagTestSeparateMemory { };
+
+}
+
+template<>
+struct DeviceAdapterAlgorithm<
+           dax::cont::testing::DeviceAdapterTagTestSeparateMemory> :
+    dax::cont::internal::DeviceAdapterAlgorithmGeneral<
+        DeviceAdapterAlgorithm<
+                   dax::cont::testing::DeviceAdapterTagTestSeparateMemory>,
+        dax::cont::testing::DeviceAdapterTagTestSeparateMemory>
+{
+private:
+  typedef dax::cont::DeviceAdapterAlgorithm<
+      dax::cont::DeviceAdapterTagSerial> Algorithm;
+
+public:
+  template<class Functor>
+  DAX_CONT_EXPORT static void Schedule(Functor functor,
+                                       dax::Id numInstances)
+  {
+    Algorithm::Schedule(functor, numInstances);
+  }
+
+  template<class Functor>
+  DAX_CONT_EXPORT static void Schedule(Functor functor,
+                                       dax::Id3 rangeMax)
+  {
+    Algorithm::Schedule(functor, rangeMax);
+  }
+
+  DAX_CONT_EXPORT static void Synchronize()
+  {
+    Algorithm::Synchronize();
+  }
+};
+
+namespace internal {
+
+template<>
+struct ArrayManagerExecutionMemorySpace<
+    dax::cont::testing::DeviceAdapterTagTestSeparateMemory>
+{
+  static const bool IS_SEPARATE = true;
+  DAX_CONT_EXPORT static const char *GetName() { return "test"; }
+};
+
+template <typename T, class ArrayContainerControlTag>
+class ArrayManagerExecution
+    <T,
+    ArrayContainerControlTag,
+    dax::cont::testing::DeviceAdapterTagTestSeparateMemory>
+{
+public:
+  typedef T ValueType;
+  typedef dax::cont::internal
+      ::ArrayContainerControl<ValueType, ArrayContainerControlTag>
+      ContainerType;
+  typedef dax::cont::internal::ArrayPortalFromIterators<ValueType *>
+      PortalType;
+  typedef dax::cont::internal::ArrayPortalFromIterators<const ValueType *>
+      PortalConstType;
+
+  ArrayManagerExecution() : NumberOfValues(0) {  }
+  ~ArrayManagerExecution() { this->ReleaseResources(); }
+
+  dax::Id GetNumberOfValues() const
+  {
+    return this->NumberOfValues;
+  }
+
+  template<class PortalControl>
+  void LoadDataForInput(PortalControl portal)
+  {
+    this->Resize(portal.GetNumberOfValues());
+    std::copy(portal.GetIteratorBegin(),
+              portal.GetIteratorEnd(),
+              this->GetPortal().GetIteratorBegin());
+  }
+
+  template<class PortalControl>
+  void LoadDataForInPlace(PortalControl portal)
+  {
+    this->LoadDataForInput(portal);
+  }
+
+  void AllocateArrayForOutput(ContainerType &, dax::Id numberOfValues)
+  {
+    this->Resize(numberOfValues);
+  }
+
+  void RetrieveOutputData(ContainerType &controlArray) const
+  {
+    controlArray.Allocate(this->GetNumberOfValues());
+    this->CopyInto(controlArray.GetPortal().GetIteratorBegin());
+  }
+
+  template <class IteratorTypeControl>
+  void CopyInto(IteratorTypeControl dest) const
+  {
+    std::copy(this->GetPortalConst().GetIteratorBegin(),
+              this->GetPortalConst().GetIteratorEnd(),
+              dest);
+  }
+
+  void Shrink(dax::Id numberOfValues)
+  {
+    this->Resize(numberOfValues);
+  }
+
+  PortalType GetPortal()
+  {
+    ValueType *begin = this->Array.empty() ? NULL : &this->Array[0];
+    return PortalType(begin, begin + this->NumberOfValues);
+  }
+
+  PortalConstType GetPortalConst() const
+  {
+    const ValueType *begin = this->Array.empty() ? NULL : &this->Array[0];
+    return PortalConstType(begin, begin + this->NumberOfValues);
+  }
+
+  // The storage is kept until the array grows or is destroyed, filled with
+  // default values, so that a portal used after its array was released reads
+  // wrong values rather than freed memory.
+  void ReleaseResources()
+  {
+    std::fill(this->Array.begin(), this->Array.end(), ValueType());
+    this->Resize(0);
+  }
+
+private:
+  // Not implemented.
+  ArrayManagerExecution(const ArrayManagerExecution &);
+  void operator=(const ArrayManagerExecution &);
+
+  void Resize(dax::Id numberOfValues)
+  {
+    const dax::internal::Int64Type bytesPerValue =
+        static_cast<dax::internal::Int64Type>(sizeof(ValueType));
+    dax::cont::MemoryRegistry::GetInstance().Free(
+          "test", this->NumberOfValues*bytesPerValue);
+    // Like a device vector, the storage is only reallocated to grow.
+    if (static_cast<std::size_t>(numberOfValues) > this->Array.size())
+      {
+      std::vector<ValueType>(static_cast<std::size_t>(numberOfValues))
+          .swap(this->Array);
+      }
+    this->NumberOfValues = numberOfValues;
+    dax::cont::MemoryRegistry::GetInstance().Allocate(
+          "test", numberOfValues*bytesPerValue);
+  }
+
+  std::vector<ValueType> Array;
+  dax::Id NumberOfValues;
+};
+
+}
+}
+} // namespace dax::cont::internal
+
+namespace {
+
+const dax::Id ARRAY_SIZE = 1000;
+const dax::Id ARRAY_BYTES = ARRAY_SIZE*static_cast<dax::Id>(sizeof(dax::Id));
+
+typedef dax::cont::ArrayHandle<dax::Id,
+    dax::cont::ArrayContainerControlTagBasic,
+    dax::cont::testing::DeviceAdapterTagTestSeparateMemory> TestArrayHandle;
+
+dax::cont::MemoryRegistry &GetRegistry()
+{
+  return dax::cont::MemoryRegistry::GetInstance();
+}
+
+dax::internal::Int64Type GetControlBytes()
+{
+  return GetRegistry().GetBytes(
+        dax::cont::MemoryRegistry::GetControlSpaceName());
+}
+
+dax::cont::MemorySpaceUsage GetUsage(const std::string &space)
+{
+  std::vector<dax::cont::MemorySpaceUsage> usage = GetRegistry().GetUsage();
+  for (std::size_t index = 0; index < usage.size(); ++index)
+    {
+    if (usage[index].Name == space) { return usage[index]; }
+    }
+  DAX_TEST_FAIL("Memory space not in the registry.");
+  return dax::cont::MemorySpaceUsage();
+}
+
+void TestControlAccounting()
+{
+  std::cout << "Counting control arrays" << std::endl;
+  const dax::internal::Int64Type startBytes = GetControlBytes();
+  {
+  dax::cont::internal::ArrayContainerControl<
+      dax::Id, dax::cont::ArrayContainerControlTagBasic> container;
+  container.Allocate(ARRAY_SIZE);
+  DAX_TEST_ASSERT(GetControlBytes() - startBytes == ARRAY_BYTES,
+                  "Basic array not counted.");
+  container.Allocate(ARRAY_SIZE/2);
+  DAX_TEST_ASSERT(GetControlBytes() - startBytes == ARRAY_BYTES,
+                  "Reused array counted twice.");
+
+  dax::cont::internal::ArrayContainerControl<
+      dax::Id, dax::cont::ArrayContainerControlTagScratch> scratch;
+  scratch.Allocate(ARRAY_SIZE);
+  DAX_TEST_ASSERT(GetControlBytes() - startBytes
+                  == ARRAY_BYTES + dax::cont::ScratchArena::GetSizeClass(
+                    ARRAY_BYTES),
+                  "Scratch array not counted.");
+  }
+  DAX_TEST_ASSERT(GetControlBytes() == startBytes,
+                  "Released arrays still counted.");
+  DAX_TEST_ASSERT(GetRegistry().GetPeakBytes(
+                    dax::cont::MemoryRegistry::GetControlSpaceName())
+                  >= startBytes + 2*ARRAY_BYTES,
+                  "Bad peak.");
+}
+
+void TestControlBudget()
+{
+  std::cout << "Trimming the scratch cache over budget" << std::endl;
+  const std::string control = dax::cont::MemoryRegistry::GetControlSpaceName();
+  dax::cont::ScratchArena &arena = dax::cont::ScratchArena::GetInstance();
+  dax::cont::ScratchArenaScope scope;
+  {
+  dax::cont::internal::ArrayContainerControl<
+      dax::Id, dax::cont::ArrayContainerControlTagScratch> scratch;
+  scratch.Allocate(ARRAY_SIZE);
+  }
+  DAX_TEST_ASSERT(arena.GetStatistics().BytesCached > 0, "Block not cached.");
+  DAX_TEST_ASSERT(GetControlBytes() >= ARRAY_BYTES,
+                  "Cached block not counted.");
+
+  GetRegistry().SetBudget(control, GetControlBytes() + ARRAY_BYTES/2);
+  {
+  dax::cont::internal::ArrayContainerControl<
+      dax::Id, dax::cont::ArrayContainerControlTagBasic> container;
+  container.Allocate(ARRAY_SIZE);
+  DAX_TEST_ASSERT(arena.GetStatistics().BytesCached == 0,
+                  "Cache not trimmed over budget.");
+  }
+  GetRegistry().SetBudget(control, 0);
+  DAX_TEST_ASSERT(GetRegistry().GetBudget(control) == 0,
+                  "Budget not removed.");
+}
+
+void TestStages()
+{
+  std::cout << "Recording stage peaks" << std::endl;
+  const std::string control = dax::cont::MemoryRegistry::GetControlSpaceName();
+  GetRegistry().ClearStages();
+  const dax::internal::Int64Type startBytes = GetControlBytes();
+
+  GetRegistry().BeginStage("big");
+  {
+  dax::cont::internal::ArrayContainerControl<
+      dax::Id, dax::cont::ArrayContainerControlTagBasic> container;
+  container.Allocate(4*ARRAY_SIZE);
+  }
+  GetRegistry().BeginStage("small");
+  {
+  dax::cont::internal::ArrayContainerControl<
+      dax::Id, dax::cont::ArrayContainerControlTagBasic> container;
+  container.Allocate(ARRAY_SIZE);
+  }
+  GetRegistry().EndStage();
+  GetRegistry().EndStage();
+
+  const std::vector<dax::cont::MemoryStageUsage> &stages =
+      GetRegistry().GetStages();
+  DAX_TEST_ASSERT(stages.size() == 2, "Wrong number of stages.");
+  DAX_TEST_ASSERT(stages[0].Name == "big", "Wrong stage name.");
+  DAX_TEST_ASSERT(stages[1].Name == "small", "Wrong stage name.");
+  DAX_TEST_ASSERT(stages[0].GetTotalPeakBytes() >= startBytes + 4*ARRAY_BYTES,
+                  "Bad peak of first stage.");
+  DAX_TEST_ASSERT(stages[1].GetTotalPeakBytes() < startBytes + 4*ARRAY_BYTES,
+                  "Second stage has the peak of the first.");
+  DAX_TEST_ASSERT(stages[1].GetTotalPeakBytes() >= startBytes + ARRAY_BYTES,
+                  "Bad peak of second stage.");
+  GetRegistry().ClearStages();
+}
+
+void TestLargeCounts()
+{
+  std::cout << "Counting more than 2 GiB" << std::endl;
+  dax::cont::MemoryRegistry &registry = GetRegistry();
+  const dax::internal::Int64Type gibibyte =
+      static_cast<dax::internal::Int64Type>(1) << 30;
+  registry.SetBudget("large", 5*gibibyte);
+  registry.Allocate("large", 3*gibibyte);
+  registry.Allocate("large", 3*gibibyte);
+  DAX_TEST_ASSERT(registry.GetBytes("large") == 6*gibibyte,
+                  "Large allocations not counted.");
+  DAX_TEST_ASSERT(registry.GetBudget("large") == 5*gibibyte,
+                  "Large budget not kept.");
+  registry.EnforceBudgets();
+  DAX_TEST_ASSERT(GetUsage("large").NumberOfOverruns == 1,
+                  "Large allocations not over budget.");
+  registry.Free("large", 3*gibibyte);
+  registry.Free("large", 3*gibibyte);
+  DAX_TEST_ASSERT(registry.GetBytes("large") == 0,
+                  "Large frees not counted.");
+  DAX_TEST_ASSERT(registry.GetPeakBytes("large") == 6*gibibyte,
+                  "Bad large peak.");
+  registry.SetBudget("large", 0);
+}
+
+void CheckValues(const TestArrayHandle &handle, dax::Id offset)
+{
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    DAX_TEST_ASSERT(handle.GetPortalConstControl().Get(index)
+                    == index + offset,
+                    "Bad value in array.");
+    }
+}
+
+void TestExecutionBudget()
+{
+  std::cout << "Releasing and spilling execution arrays" << std::endl;
+  dax::cont::MemoryRegistry &registry = GetRegistry();
+  std::vector<dax::Id> values(ARRAY_SIZE);
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    values[index] = index;
+    }
+
+  {
+  TestArrayHandle input = dax::cont::make_ArrayHandle(
+        values,
+        dax::cont::ArrayContainerControlTagBasic(),
+        dax::cont::testing::DeviceAdapterTagTestSeparateMemory());
+  TestArrayHandle output;
+
+  registry.ResetPeaks();
+  input.PrepareForInput();
+  TestArrayHandle::PortalExecution portal =
+      output.PrepareForOutput(ARRAY_SIZE);
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    portal.Set(index, index + 10);
+    }
+  DAX_TEST_ASSERT(registry.GetBytes("test") == 2*ARRAY_BYTES,
+                  "Execution arrays not counted.");
+
+  std::cout << "  under budget" << std::endl;
+  registry.SetBudget("test", 2*ARRAY_BYTES);
+  registry.EnforceBudgets();
+  DAX_TEST_ASSERT(registry.GetBytes("test") == 2*ARRAY_BYTES,
+                  "Array dropped under budget.");
+
+  std::cout << "  over budget by one array" << std::endl;
+  registry.SetBudget("test", ARRAY_BYTES + ARRAY_BYTES/2);
+  registry.EnforceBudgets();
+  DAX_TEST_ASSERT(registry.GetBytes("test") == ARRAY_BYTES,
+                  "Wrong arrays dropped.");
+  DAX_TEST_ASSERT(GetUsage("test").BytesReleased == ARRAY_BYTES,
+                  "Input array not released first.");
+  DAX_TEST_ASSERT(GetUsage("test").BytesSpilled == 0,
+                  "Output array spilled although a copy could be dropped.");
+
+  std::cout << "  over budget by both arrays" << std::endl;
+  registry.SetBudget("test", ARRAY_BYTES/2);
+  registry.EnforceBudgets();
+  DAX_TEST_ASSERT(registry.GetBytes("test") == 0,
+                  "Output array not spilled.");
+  DAX_TEST_ASSERT(GetUsage("test").BytesSpilled == ARRAY_BYTES,
+                  "Spill not counted.");
+  DAX_TEST_ASSERT(GetUsage("test").NumberOfOverruns == 0,
+                  "Overrun counted although the budget was met.");
+  CheckValues(output, 10);
+
+  std::cout << "  using dropped arrays again" << std::endl;
+  output.PrepareForInput();
+  input.PrepareForInput();
+  DAX_TEST_ASSERT(registry.GetBytes("test") == 2*ARRAY_BYTES,
+                  "Arrays not loaded again.");
+  CheckValues(input, 0);
+  CheckValues(output, 10);
+
+  // The input was used last, so the output copy is dropped first.
+  registry.SetBudget("test", ARRAY_BYTES + ARRAY_BYTES/2);
+  registry.EnforceBudgets();
+  DAX_TEST_ASSERT(input.PrepareForInput().Get(ARRAY_SIZE-1) == ARRAY_SIZE-1,
+                  "Most recently used array dropped.");
+  DAX_TEST_ASSERT(registry.GetBytes("test") == ARRAY_BYTES,
+                  "Least recently used array not dropped.");
+  DAX_TEST_ASSERT(GetUsage("test").PeakBytes == 2*ARRAY_BYTES, "Bad peak.");
+  }
+  DAX_TEST_ASSERT(registry.GetBytes("test") == 0,
+                  "Destroyed arrays still counted.");
+  registry.SetBudget("test", 0);
+}
+
+typedef dax::cont::testing::DeviceAdapterTagTestSeparateMemory
+    SeparateMemoryTag;
+typedef dax::cont::UniformGrid<SeparateMemoryTag> TestUniformGrid;
+typedef dax::cont::UnstructuredGrid<dax::CellTagTriangle,
+                                    dax::cont::ArrayContainerControlTagBasic,
+                                    dax::cont::ArrayContainerControlTagBasic,
+                                    SeparateMemoryTag> TestTriangleGrid;
+typedef dax::cont::ArrayHandle<dax::Scalar,
+                               dax::cont::ArrayContainerControlTagBasic,
+                               SeparateMemoryTag> TestFieldHandle;
+
+// Runs marching cubes from cached cases. The point values are prepared
+// before the generating Invoke, which is the safe point that enforces the
+// budget.
+TestTriangleGrid RunMarchingCubes(const TestUniformGrid &grid,
+                                  const TestFieldHandle &field,
+                                  dax::Scalar isoValue)
+{
+  typedef dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType,
+                                 dax::cont::ArrayContainerControlTagBasic,
+                                 SeparateMemoryTag> CaseHandleType;
+  typedef dax::cont::ArrayHandleTransform<dax::Id, CaseHandleType,
+                dax::worklet::MarchingCubesCaseFaceCount, SeparateMemoryTag>
+      CaseCountHandleType;
+
+  CaseHandleType cases;
+  dax::cont::DispatcherMapCell<dax::worklet::MarchingCubesClassify,
+                               SeparateMemoryTag>
+      classifyDispatcher((dax::worklet::MarchingCubesClassify(isoValue)));
+  classifyDispatcher.Invoke(grid, field, cases);
+
+  CaseCountHandleType caseCount(cases);
+  dax::cont::DispatcherGenerateInterpolatedCells<
+      dax::worklet::MarchingCubesGenerateFromCases,
+      CaseCountHandleType,
+      SeparateMemoryTag> generateDispatcher(
+        caseCount, dax::worklet::MarchingCubesGenerateFromCases(isoValue));
+  generateDispatcher.SetRemoveDuplicatePoints(false);
+
+  TestTriangleGrid outGrid;
+  generateDispatcher.Invoke(grid,
+                            outGrid,
+                            cases,
+                            dax::worklet::make_MarchingCubesPointValues(
+                              field));
+  return outGrid;
+}
+
+void TestPinnedPortals()
+{
+  std::cout << "Keeping arrays whose portals were handed out" << std::endl;
+  dax::cont::MemoryRegistry &registry = GetRegistry();
+  const dax::Id dimension = 9;
+
+  TestUniformGrid grid;
+  grid.SetExtent(dax::make_Id3(0, 0, 0),
+                 dax::make_Id3(dimension-1, dimension-1, dimension-1));
+  std::vector<dax::Scalar> distances;
+  for (dax::Id index = 0; index < grid.GetNumberOfPoints(); ++index)
+    {
+    const dax::Vector3 offset =
+        grid.ComputePointCoordinates(index) - dax::make_Vector3(4, 4, 4);
+    distances.push_back(static_cast<dax::Scalar>(
+                          std::sqrt(dax::dot(offset, offset))));
+    }
+  TestFieldHandle field = dax::cont::make_ArrayHandle(
+        distances,
+        dax::cont::ArrayContainerControlTagBasic(),
+        SeparateMemoryTag());
+
+  const TestTriangleGrid expected = RunMarchingCubes(grid, field, 2.5f);
+  DAX_TEST_ASSERT(expected.GetNumberOfCells() > 0,
+                  "Marching cubes made no triangles.");
+
+  // With a budget of a byte, every array that can be dropped is dropped at
+  // the start of the generating Invoke, except the pinned field.
+  registry.SetBudget("test", 1);
+  registry.ResetPeaks();
+  const TestTriangleGrid outGrid = RunMarchingCubes(grid, field, 2.5f);
+  DAX_TEST_ASSERT(GetUsage("test").BytesReleased
+                  + GetUsage("test").BytesSpilled > 0,
+                  "Budget not enforced by the Invoke.");
+  DAX_TEST_ASSERT(outGrid.GetNumberOfCells() == expected.GetNumberOfCells(),
+                  "Wrong number of triangles under a budget.");
+  DAX_TEST_ASSERT(outGrid.GetNumberOfPoints() == expected.GetNumberOfPoints(),
+                  "Wrong number of points under a budget.");
+  for (dax::Id index = 0; index < outGrid.GetNumberOfPoints(); ++index)
+    {
+    DAX_TEST_ASSERT(test_equal(outGrid.GetPointCoordinates()
+                                 .GetPortalConstControl().Get(index),
+                               expected.GetPointCoordinates()
+                                 .GetPortalConstControl().Get(index)),
+                    "Pinned field dropped while its portal was in use.");
+    }
+
+  std::cout << "  at stages and when enforced explicitly" << std::endl;
+  const dax::internal::Int64Type fieldBytes =
+      grid.GetNumberOfPoints()
+      * static_cast<dax::internal::Int64Type>(sizeof(dax::Scalar));
+  registry.BeginStage("pinned");
+  DAX_TEST_ASSERT(registry.GetBytes("test") == fieldBytes,
+                  "Stage did not keep just the pinned array.");
+  registry.EndStage();
+  registry.ClearStages();
+  registry.EnforceBudgets();
+  DAX_TEST_ASSERT(registry.GetBytes("test") == 0,
+                  "Explicit enforcement kept the pinned array.");
+  registry.SetBudget("test", 0);
+}
+
+void TestMemoryRegistry()
+{
+  TestControlAccounting();
+  TestControlBudget();
+  TestStages();
+  TestLargeCounts();
+  TestExecutionBudget();
+  TestPinnedPortals();
+}
+
+} // Anonymous namespace
+
+int UnitTestMemoryRegistry(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestMemoryRegistry);
+}
@@ -0,0 +1,184 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/cont/MinMaxBrickIndex.h>
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/UniformGrid.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <vector>
+
+namespace {
+
+typedef DAX_DEFAULT_DEVICE_ADAPTER_TAG DeviceAdapter;
+typedef dax::cont::UniformGrid<DeviceAdapter> GridType;
+typedef dax::cont::ArrayHandle<dax::Scalar,
+                               dax::cont::ArrayContainerControlTagBasic,
+                               DeviceAdapter> FieldHandleType;
+typedef dax::cont::MinMaxBrickIndex<DeviceAdapter> BrickIndexType;
+
+const dax::Id BRICK_SIZE = 3;
+
+dax::Scalar FieldValue(dax::Id index)
+{
+  //a bumpy field so that every brick has its own range
+  return static_cast<dax::Scalar>((index * 7919) % 101);
+}
+
+//-----------------------------------------------------------------------------
+void TestRanges(const GridType &grid,
+                const std::vector<dax::Scalar> &field,
+                const BrickIndexType &brickIndex)
+{
+  const dax::Id3 pointDims = dax::extentDimensions(grid.GetExtent());
+  const dax::Id3 cellDims = dax::extentCellDimensions(grid.GetExtent());
+  const dax::Id3 brickDims = brickIndex.GetBrickDimensions();
+
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    DAX_TEST_ASSERT(brickDims[axis] ==
+                    (cellDims[axis] + BRICK_SIZE - 1) / BRICK_SIZE,
+                    "Wrong number of bricks");
+    }
+  DAX_TEST_ASSERT(brickIndex.GetBrickRanges().GetNumberOfValues() ==
+                  brickIndex.GetNumberOfBricks(),
+                  "Wrong number of brick ranges");
+
+  //the brick of a cell covers the points of the cell, so the range of every
+  //brick must contain the values of all the points of its cells
+  std::vector<dax::Vector2> expected(brickIndex.GetNumberOfBricks(),
+                                     dax::make_Vector2(1000, -1000));
+  for (dax::Id k = 0; k < cellDims[2]; ++k)
+    {
+    for (dax::Id j = 0; j < cellDims[1]; ++j)
+      {
+      for (dax::Id i = 0; i < cellDims[0]; ++i)
+        {
+        const dax::Id brick = (i / BRICK_SIZE)
+            + brickDims[0] * ((j / BRICK_SIZE)
+            + brickDims[1] * (k / BRICK_SIZE));
+        for (dax::Id vertex = 0; vertex < 8; ++vertex)
+          {
+          const dax::Id pointIndex = (i + (vertex & 1))
+              + pointDims[0] * ((j + ((vertex >> 1) & 1))
+              + pointDims[1] * (k + ((vertex >> 2) & 1)));
+          const dax::Scalar value = field[pointIndex];
+          if (value < expected[brick][0]) { expected[brick][0] = value; }
+          if (value > expected[brick][1]) { expected[brick][1] = value; }
+          }
+        }
+      }
+    }
+
+  for (dax::Id brick = 0; brick < brickIndex.GetNumberOfBricks(); ++brick)
+    {
+    DAX_TEST_ASSERT(
+          test_equal(brickIndex.GetBrickRanges().GetPortalConstControl()
+                       .Get(brick),
+                     expected[brick]),
+          "Got bad brick range");
+    }
+}
+
+//-----------------------------------------------------------------------------
+void TestMask(BrickIndexType &brickIndex, dax::Scalar isoValue)
+{
+  BrickIndexType::BrickMaskExecution mask =
+      brickIndex.PrepareForIsoValue(isoValue);
+
+  DAX_TEST_ASSERT(brickIndex.GetBrickMask().GetNumberOfValues() ==
+                  brickIndex.GetNumberOfBricks(),
+                  "Wrong number of brick states");
+
+  for (dax::Id brick = 0; brick < brickIndex.GetNumberOfBricks(); ++brick)
+    {
+    const dax::Vector2 range =
+        brickIndex.GetBrickRanges().GetPortalConstControl().Get(brick);
+    dax::exec::BrickState expected = dax::exec::BRICK_ACTIVE;
+    if (range[1] <= isoValue) { expected = dax::exec::BRICK_BELOW; }
+    if (range[0] > isoValue) { expected = dax::exec::BRICK_ABOVE; }
+    DAX_TEST_ASSERT(mask.GetBrickState(brick) == expected,
+                    "Got bad brick state");
+    DAX_TEST_ASSERT(mask.IsBrickActive(brick) ==
+                    (expected == dax::exec::BRICK_ACTIVE),
+                    "Got bad brick flag");
+    }
+
+  //cells map to the brick holding them
+  const dax::Id3 brickDims = brickIndex.GetBrickDimensions();
+  DAX_TEST_ASSERT(mask.GetBrickOfCell(0) == 0, "Bad brick of first cell");
+  DAX_TEST_ASSERT(mask.GetBrickOfCell(BRICK_SIZE) == 1,
+                  "Bad brick of cell in second brick");
+  DAX_TEST_ASSERT(mask.GetBrickOfCell(BRICK_SIZE-1) == 0,
+                  "Bad brick of last cell in first brick");
+  DAX_TEST_ASSERT(brickDims[0] > 1, "Test grid has too few bricks");
+}
+
+//-----------------------------------------------------------------------------
+void TestMinMaxBrickIndex()
+{
+  //an extent that does not start at zero and does not divide into bricks
+  GridType grid;
+  grid.SetExtent(dax::make_Id3(-2, 0, 3), dax::make_Id3(8, 6, 10));
+
+  std::vector<dax::Scalar> field(grid.GetNumberOfPoints());
+  for (dax::Id index = 0; index < grid.GetNumberOfPoints(); ++index)
+    {
+    field[index] = FieldValue(index);
+    }
+  FieldHandleType fieldHandle =
+      dax::cont::make_ArrayHandle(field,
+                                  dax::cont::ArrayContainerControlTagBasic(),
+                                  DeviceAdapter());
+
+  std::cout << "Building index" << std::endl;
+  BrickIndexType brickIndex(grid, fieldHandle, BRICK_SIZE);
+  TestRanges(grid, field, brickIndex);
+
+  std::cout << "Reusing index for several isovalues" << std::endl;
+  TestMask(brickIndex, 10);
+  TestMask(brickIndex, 50);
+  TestMask(brickIndex, 50);
+  TestMask(brickIndex, 95);
+
+  std::cout << "Checking bad input" << std::endl;
+  try
+    {
+    brickIndex.Build(grid, fieldHandle, 0);
+    DAX_TEST_FAIL("Built index with an empty brick");
+    }
+  catch (dax::cont::ErrorControlBadValue) {  }
+
+  try
+    {
+    GridType smallGrid;
+    smallGrid.SetExtent(dax::make_Id3(0, 0, 0), dax::make_Id3(2, 2, 2));
+    brickIndex.Build(smallGrid, fieldHandle, BRICK_SIZE);
+    DAX_TEST_FAIL("Built index with a field of the wrong size");
+    }
+  catch (dax::cont::ErrorControlBadValue) {  }
+}
+
+} // anonymous namespace
+
+int UnitTestMinMaxBrickIndex(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestMinMaxBrickIndex);
+}
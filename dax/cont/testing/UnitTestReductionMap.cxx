@@ -0,0 +1,237 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_ARRAY_CONTAINER_CONTROL DAX_ARRAY_CONTAINER_CONTROL_ERROR
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_ERROR
+
+#include <dax/cont/ReductionMap.h>
+
+#include <dax/cont/ArrayContainerControlBasic.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapterSerial.h>
+#include <dax/cont/DispatcherReduceKeysValues.h>
+#include <dax/cont/ErrorControlBadValue.h>
+
+#include <dax/exec/WorkletReduceKeysValues.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <sstream>
+#include <vector>
+
+namespace {
+
+typedef dax::cont::ArrayContainerControlTagBasic Container;
+typedef dax::cont::DeviceAdapterTagSerial DeviceAdapter;
+
+typedef dax::cont::ArrayHandle<dax::Id,Container,DeviceAdapter> IdArrayType;
+typedef dax::cont::ArrayHandle<dax::Scalar,Container,DeviceAdapter>
+    ScalarArrayType;
+typedef dax::cont::ReductionMap<DeviceAdapter> ReductionMapType;
+
+const dax::Id ARRAY_SIZE = 1000;
+const dax::Id NUM_KEYS = 97;
+
+class SumReduce : public dax::exec::WorkletReduceKeysValues
+{
+public:
+  typedef void ControlSignature(Values(In), Values(Out));
+  typedef _2 ExecutionSignature(KeyGroup(_1));
+
+  template<typename KeyGroupType>
+  DAX_EXEC_EXPORT
+  typename KeyGroupType::ValueType operator()(KeyGroupType inPortal) const
+  {
+    typedef typename KeyGroupType::ValueType VType;
+    VType sum = VType();
+    for(dax::Id iCtr = 0; iCtr < inPortal.GetNumberOfValues(); iCtr++)
+      {
+      sum += inPortal[iCtr];
+      }
+    return sum;
+  }
+};
+
+// Key i*7 % NUM_KEYS for value i, so keys are unsorted but every key occurs.
+dax::Id KeyOf(dax::Id index) { return (index*7) % NUM_KEYS; }
+
+IdArrayType MakeKeys()
+{
+  std::vector<dax::Id> keys(ARRAY_SIZE);
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    keys[index] = KeyOf(index);
+    }
+  IdArrayType keysCopy;
+  dax::cont::DeviceAdapterAlgorithm<DeviceAdapter>::Copy(
+        dax::cont::make_ArrayHandle(keys, Container(), DeviceAdapter()),
+        keysCopy);
+  return keysCopy;
+}
+
+void CheckMap(const ReductionMapType &map)
+{
+  DAX_TEST_ASSERT(map.IsValid(), "Map not valid.");
+  DAX_TEST_ASSERT(map.GetNumberOfKeys() == NUM_KEYS, "Wrong number of keys.");
+  DAX_TEST_ASSERT(map.GetNumberOfValues() == ARRAY_SIZE,
+                  "Wrong number of values.");
+  DAX_TEST_ASSERT(map.GetNumberOfBytes()
+                  == dax::Id(sizeof(dax::Id))*(2*NUM_KEYS + ARRAY_SIZE),
+                  "Wrong memory size.");
+
+  IdArrayType::PortalConstControl counts =
+      map.GetCounts().GetPortalConstControl();
+  IdArrayType::PortalConstControl offsets =
+      map.GetOffsets().GetPortalConstControl();
+  IdArrayType::PortalConstControl indices =
+      map.GetIndices().GetPortalConstControl();
+  dax::Id expectedOffset = 0;
+  for (dax::Id key = 0; key < NUM_KEYS; key++)
+    {
+    DAX_TEST_ASSERT(offsets.Get(key) == expectedOffset, "Bad offset.");
+    for (dax::Id i = 0; i < counts.Get(key); i++)
+      {
+      DAX_TEST_ASSERT(KeyOf(indices.Get(expectedOffset + i)) == key,
+                      "Index grouped under the wrong key.");
+      }
+    expectedOffset += counts.Get(key);
+    }
+  DAX_TEST_ASSERT(expectedOffset == ARRAY_SIZE, "Counts do not add up.");
+}
+
+template<typename T>
+void CheckSums(const dax::cont::ArrayHandle<T,Container,DeviceAdapter> &sums)
+{
+  DAX_TEST_ASSERT(sums.GetNumberOfValues() == NUM_KEYS, "Wrong output size.");
+  std::vector<dax::Id> expected(NUM_KEYS, 0);
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    expected[KeyOf(index)] += index;
+    }
+  for (dax::Id key = 0; key < NUM_KEYS; key++)
+    {
+    DAX_TEST_ASSERT(test_equal(sums.GetPortalConstControl().Get(key),
+                               static_cast<T>(expected[key])),
+                    "Bad reduced value.");
+    }
+}
+
+void TestShareMap()
+{
+  std::cout << "Build a map and reduce two value types with it" << std::endl;
+  ReductionMapType map(MakeKeys());
+  CheckMap(map);
+  CheckMap(ReductionMapType(MakeKeys(), NUM_KEYS));
+
+  std::vector<dax::Id> idValues(ARRAY_SIZE);
+  std::vector<dax::Scalar> scalarValues(ARRAY_SIZE);
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    idValues[index] = index;
+    scalarValues[index] = static_cast<dax::Scalar>(index);
+    }
+
+  IdArrayType idSums;
+  dax::cont::DispatcherReduceKeysValues<SumReduce, IdArrayType, DeviceAdapter>
+      idReduce(map);
+  idReduce.Invoke(dax::cont::make_ArrayHandle(idValues,
+                                              Container(),
+                                              DeviceAdapter()),
+                  idSums);
+  CheckSums(idSums);
+
+  ScalarArrayType scalarSums;
+  dax::cont::DispatcherReduceKeysValues<SumReduce, IdArrayType, DeviceAdapter>
+      scalarReduce(map);
+  scalarReduce.Invoke(dax::cont::make_ArrayHandle(scalarValues,
+                                                  Container(),
+                                                  DeviceAdapter()),
+                      scalarSums);
+  CheckSums(scalarSums);
+
+  std::cout << "Map survives the dispatchers" << std::endl;
+  CheckMap(map);
+
+  std::cout << "Take the map a dispatcher built" << std::endl;
+  dax::cont::DispatcherReduceKeysValues<SumReduce, IdArrayType, DeviceAdapter>
+      keyReduce(MakeKeys());
+  ReductionMapType builtMap = keyReduce.GetReductionMap();
+  CheckMap(builtMap);
+  keyReduce.Invoke(dax::cont::make_ArrayHandle(idValues,
+                                               Container(),
+                                               DeviceAdapter()),
+                   idSums);
+  CheckSums(idSums);
+  CheckMap(builtMap);
+
+  std::cout << "Rebuilding a copy leaves the original alone" << std::endl;
+  ReductionMapType copy = map;
+  copy.Build(IdArrayType());
+  DAX_TEST_ASSERT(copy.GetNumberOfKeys() == 0, "Empty keys gave keys.");
+  CheckMap(map);
+}
+
+void TestSerialize()
+{
+  std::cout << "Write and read a map" << std::endl;
+  ReductionMapType map(MakeKeys());
+
+  std::stringstream stream;
+  map.Write(stream);
+
+  ReductionMapType readMap;
+  DAX_TEST_ASSERT(!readMap.IsValid(), "Empty map claims to be valid.");
+  readMap.Read(stream);
+  CheckMap(readMap);
+
+  std::cout << "Reject a stream that is not a map" << std::endl;
+  std::stringstream badStream("not a reduction map at all");
+  try
+    {
+    readMap.Read(badStream);
+    DAX_TEST_FAIL("Read accepted a bad stream.");
+    }
+  catch (dax::cont::ErrorControlBadValue &error)
+    {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    }
+
+  std::cout << "Reject a truncated map" << std::endl;
+  std::string data = stream.str();
+  std::stringstream truncatedStream(data.substr(0, data.size()/2));
+  try
+    {
+    readMap.Read(truncatedStream);
+    DAX_TEST_FAIL("Read accepted a truncated stream.");
+    }
+  catch (dax::cont::ErrorControlBadValue &error)
+    {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    }
+}
+
+void TestReductionMap()
+{
+  TestShareMap();
+  TestSerialize();
+}
+
+} // anonymous namespace
+
+int UnitTestReductionMap(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestReductionMap);
+}
@@ -0,0 +1,222 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/cont/ScratchArena.h>
+
+#include <dax/cont/ArrayContainerControlScratch.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapterSerial.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/internal/ScratchBuffer.h>
+
+#include <dax/cont/testing/Testing.h>
+
+namespace
+{
+
+const dax::Id ARRAY_SIZE = 1000;
+
+typedef dax::cont::internal::ArrayContainerControl<
+    dax::Id, dax::cont::ArrayContainerControlTagScratch> ContainerType;
+
+dax::cont::ScratchArenaStatistics GetStatistics()
+{
+  return dax::cont::ScratchArena::GetInstance().GetStatistics();
+}
+
+void TestSizeClasses()
+{
+  std::cout << "Checking size classes" << std::endl;
+  typedef dax::cont::ScratchArena Arena;
+  DAX_TEST_ASSERT(Arena::GetSizeClass(1) == 256, "Bad smallest class.");
+  DAX_TEST_ASSERT(Arena::GetSizeClass(256) == 256, "Bad smallest class.");
+  DAX_TEST_ASSERT(Arena::GetSizeClass(257) == 320, "Bad class above 256.");
+  DAX_TEST_ASSERT(Arena::GetSizeClass(1000) == 1024, "Bad class for 1000.");
+  DAX_TEST_ASSERT(Arena::GetSizeClass(1025) == 1280, "Bad class for 1025.");
+  const dax::internal::Int64Type gibibyte =
+      static_cast<dax::internal::Int64Type>(1) << 30;
+  DAX_TEST_ASSERT(Arena::GetSizeClass(3*gibibyte) == 3*gibibyte,
+                  "Bad class for 3 GiB.");
+  DAX_TEST_ASSERT(Arena::GetSizeClass(3*gibibyte + 1)
+                  == 3*gibibyte + gibibyte/2,
+                  "Bad class above 3 GiB.");
+  for (dax::internal::Int64Type size = 1;
+       size < 16*gibibyte;
+       size = size*3 + 1)
+    {
+    const dax::internal::Int64Type sizeClass = Arena::GetSizeClass(size);
+    DAX_TEST_ASSERT(sizeClass >= size, "Size class too small.");
+    DAX_TEST_ASSERT(size <= 256 || sizeClass - size <= size/4,
+                    "Size class wastes too much.");
+    DAX_TEST_ASSERT(Arena::GetSizeClass(sizeClass) == sizeClass,
+                    "Size class is not its own class.");
+    }
+}
+
+void TestContainer()
+{
+  std::cout << "Allocating scratch arrays" << std::endl;
+  const dax::internal::Int64Type startInUse = GetStatistics().BytesInUse;
+  {
+  ContainerType container;
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == 0,
+                  "New array container not zero sized.");
+
+  container.Allocate(ARRAY_SIZE);
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == ARRAY_SIZE,
+                  "Array not properly allocated.");
+  DAX_TEST_ASSERT((reinterpret_cast<size_t>(
+                     container.GetPortalConst().GetIteratorBegin()) % 64) == 0,
+                  "Array not aligned to a cache line.");
+  DAX_TEST_ASSERT(GetStatistics().BytesInUse - startInUse
+                  == dax::cont::ScratchArena::GetSizeClass(
+                    ARRAY_SIZE*static_cast<dax::internal::Int64Type>(
+                      sizeof(dax::Id))),
+                  "Arena does not count the array.");
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    container.GetPortal().Set(index, index);
+    }
+
+  container.Allocate(ARRAY_SIZE/2);
+  DAX_TEST_ASSERT(container.GetPortalConst().Get(ARRAY_SIZE/2 - 1)
+                  == ARRAY_SIZE/2 - 1,
+                  "Reusing the array lost values.");
+
+  container.Shrink(ARRAY_SIZE/4);
+  DAX_TEST_ASSERT(container.GetNumberOfValues() == ARRAY_SIZE/4,
+                  "Array Shrink failed to resize.");
+  try
+    {
+    container.Shrink(ARRAY_SIZE);
+    DAX_TEST_FAIL("Array shrink to a larger size was possible.");
+    }
+  catch (dax::cont::ErrorControlBadValue) {  }
+  }
+  DAX_TEST_ASSERT(GetStatistics().BytesInUse == startInUse,
+                  "Array not given back to the arena.");
+  DAX_TEST_ASSERT(GetStatistics().BytesCached == 0,
+                  "Array cached outside of a scope.");
+}
+
+void TestScope()
+{
+  std::cout << "Reusing arrays in a scope" << std::endl;
+  dax::cont::ScratchArena &arena = dax::cont::ScratchArena::GetInstance();
+  {
+  dax::cont::ScratchArenaScope scope;
+  DAX_TEST_ASSERT(arena.GetCaching(), "Scope did not turn caching on.");
+
+  const dax::Id *firstArray;
+  {
+  ContainerType container;
+  container.Allocate(ARRAY_SIZE);
+  firstArray = container.GetPortalConst().GetIteratorBegin();
+  }
+  DAX_TEST_ASSERT(GetStatistics().BytesCached > 0,
+                  "Array not cached in a scope.");
+
+  arena.ResetHighWaterMark();
+  {
+  dax::cont::ScratchArenaScope nestedScope;
+  ContainerType container;
+  // A slightly different size of the same class gets the same block.
+  container.Allocate(ARRAY_SIZE - 1);
+  DAX_TEST_ASSERT(container.GetPortalConst().GetIteratorBegin() == firstArray,
+                  "Cached block not reused.");
+  DAX_TEST_ASSERT(GetStatistics().NumberOfReuses == 1,
+                  "Reuse not counted.");
+  DAX_TEST_ASSERT(GetStatistics().HighWaterMark ==
+                  dax::cont::ScratchArena::GetSizeClass(
+                    ARRAY_SIZE*static_cast<dax::Id>(sizeof(dax::Id))),
+                  "Bad high-water mark.");
+  }
+  DAX_TEST_ASSERT(GetStatistics().BytesCached > 0,
+                  "Nested scope trimmed the cache.");
+
+  std::cout << "Sorting twice in a scope" << std::endl;
+  typedef dax::cont::ArrayHandle<dax::Scalar,
+      dax::cont::ArrayContainerControlTagBasic,
+      dax::cont::DeviceAdapterTagSerial> ScalarArrayHandleType;
+  typedef dax::cont::DeviceAdapterAlgorithm<dax::cont::DeviceAdapterTagSerial>
+      Algorithm;
+  std::vector<dax::Scalar> values(ARRAY_SIZE);
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    values[index] = static_cast<dax::Scalar>((index*7919) % ARRAY_SIZE);
+    }
+  for (int pass = 0; pass < 2; pass++)
+    {
+    ScalarArrayHandleType handle;
+    Algorithm::Copy(dax::cont::make_ArrayHandle(values), handle);
+    arena.ResetHighWaterMark();
+    Algorithm::Sort(handle);
+    Algorithm::Unique(handle);
+    DAX_TEST_ASSERT(handle.GetNumberOfValues() == ARRAY_SIZE,
+                    "Unique removed values.");
+    DAX_TEST_ASSERT(handle.GetPortalConstControl().Get(ARRAY_SIZE-1)
+                    == ARRAY_SIZE-1,
+                    "Values not sorted.");
+    const dax::cont::ScratchArenaStatistics statistics = GetStatistics();
+    DAX_TEST_ASSERT(statistics.NumberOfRequests > 0,
+                    "Algorithms did not use the arena.");
+    DAX_TEST_ASSERT(statistics.HighWaterMark > 0,
+                    "Algorithms did not use the arena.");
+    if (pass > 0)
+      {
+      DAX_TEST_ASSERT(statistics.NumberOfReuses
+                      == statistics.NumberOfRequests,
+                      "Second run allocated new temporaries.");
+      }
+    }
+  }
+  DAX_TEST_ASSERT(!arena.GetCaching(), "Caching still on after the scope.");
+  DAX_TEST_ASSERT(GetStatistics().BytesCached == 0,
+                  "Cache not trimmed after the scope.");
+}
+
+void TestBuffer()
+{
+  std::cout << "Swapping scratch buffers" << std::endl;
+  dax::cont::internal::ScratchBuffer<dax::Id> first(ARRAY_SIZE);
+  dax::cont::internal::ScratchBuffer<dax::Id> second;
+  for (dax::Id index = 0; index < ARRAY_SIZE; index++)
+    {
+    first[index] = index;
+    }
+  second.Swap(first);
+  DAX_TEST_ASSERT(first.GetNumberOfValues() == 0, "Swap kept values.");
+  DAX_TEST_ASSERT(second.GetNumberOfValues() == ARRAY_SIZE,
+                  "Swap lost values.");
+  DAX_TEST_ASSERT(second[ARRAY_SIZE-1] == ARRAY_SIZE-1, "Swap lost values.");
+}
+
+void TestScratchArena()
+{
+  TestSizeClasses();
+  TestContainer();
+  TestScope();
+  TestBuffer();
+}
+
+} // Anonymous namespace
+
+int UnitTestScratchArena(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestScratchArena);
+}
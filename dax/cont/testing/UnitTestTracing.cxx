@@ -0,0 +1,187 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_ARRAY_CONTAINER_CONTROL DAX_ARRAY_CONTAINER_CONTROL_BASIC
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/cont/Tracing.h>
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapterSerial.h>
+#include <dax/cont/DispatcherMapField.h>
+#include <dax/exec/WorkletMapField.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <sstream>
+#include <vector>
+
+#ifndef DAX_ENABLE_TRACING
+#error This test must be compiled with DAX_ENABLE_TRACING.
+#endif
+
+namespace {
+
+const dax::Id ARRAY_SIZE = 1000;
+
+struct TraceSquare : public dax::exec::WorkletMapField
+{
+  typedef void ControlSignature(Field(In), Field(Out));
+  typedef _2 ExecutionSignature(_1);
+
+  DAX_EXEC_EXPORT dax::Scalar operator()(dax::Scalar value) const
+  {
+    return value*value;
+  }
+};
+
+typedef dax::cont::DeviceAdapterAlgorithm<DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+    Algorithm;
+
+const dax::cont::TraceEvent *FindEvent(const std::string &category,
+                                       const std::string &name)
+{
+  const std::vector<dax::cont::TraceEvent> &events =
+      dax::cont::TraceCollector::GetInstance().GetEvents();
+  for (std::size_t index = 0; index < events.size(); ++index)
+    {
+    if (events[index].Category == category &&
+        events[index].Name.find(name) != std::string::npos)
+      {
+      return &events[index];
+      }
+    }
+  return NULL;
+}
+
+void TestScope()
+{
+  std::cout << "Testing nested scopes." << std::endl;
+  dax::cont::TraceCollector &collector =
+      dax::cont::TraceCollector::GetInstance();
+  collector.Reset();
+
+  {
+    DAX_TRACE_SCOPE("test", "outer", 10, 20);
+    {
+      DAX_TRACE_SCOPE("test", "inner", 1, 0);
+      DAX_TRACE_SCOPE_SET_COUNT(5, 8);
+    }
+  }
+
+  DAX_TEST_ASSERT(collector.GetEvents().size() == 2, "Wrong number of events.");
+  const dax::cont::TraceEvent &inner = collector.GetEvents()[0];
+  const dax::cont::TraceEvent &outer = collector.GetEvents()[1];
+  DAX_TEST_ASSERT(inner.Name == "inner" && outer.Name == "outer",
+                  "Nested events should be recorded first.");
+  DAX_TEST_ASSERT(inner.Depth == 1 && outer.Depth == 0, "Bad depth.");
+  DAX_TEST_ASSERT(inner.Count == 5 && inner.Bytes == 8,
+                  "Count was not changed.");
+  DAX_TEST_ASSERT(outer.Count == 10 && outer.Bytes == 20, "Bad count.");
+  DAX_TEST_ASSERT(inner.StartTime >= outer.StartTime, "Bad start time.");
+  DAX_TEST_ASSERT(outer.Duration >= inner.Duration, "Bad duration.");
+  DAX_TEST_ASSERT(outer.SelfDuration <= outer.Duration - inner.Duration + 1e-9,
+                  "Self duration includes nested event.");
+
+  collector.SetEnabled(false);
+  {
+    DAX_TRACE_SCOPE("test", "disabled", 1, 0);
+  }
+  collector.SetEnabled(true);
+  DAX_TEST_ASSERT(collector.GetEvents().size() == 2,
+                  "Event recorded while disabled.");
+}
+
+void TestInstrumentation()
+{
+  std::cout << "Testing dispatcher, algorithm and transfer events."
+            << std::endl;
+  dax::cont::TraceCollector &collector =
+      dax::cont::TraceCollector::GetInstance();
+  collector.Reset();
+
+  std::vector<dax::Scalar> input(ARRAY_SIZE);
+  for (dax::Id index = 0; index < ARRAY_SIZE; ++index)
+    {
+    input[index] = static_cast<dax::Scalar>(ARRAY_SIZE - index);
+    }
+  dax::cont::ArrayHandle<dax::Scalar> inputHandle =
+      dax::cont::make_ArrayHandle(input);
+  dax::cont::ArrayHandle<dax::Scalar> squared;
+  dax::cont::DispatcherMapField<TraceSquare>().Invoke(inputHandle, squared);
+
+  Algorithm::Sort(squared);
+  dax::cont::ArrayHandle<dax::Scalar> scanned;
+  Algorithm::ScanInclusive(squared, scanned);
+  DAX_TEST_ASSERT(scanned.GetPortalConstControl().Get(0) == 1,
+                  "Bad sort result.");
+
+  const dax::cont::TraceEvent *invoke = FindEvent("dispatcher", "TraceSquare");
+  DAX_TEST_ASSERT(invoke != NULL, "Dispatcher Invoke not traced.");
+  DAX_TEST_ASSERT(invoke->Depth == 0, "Invoke should not be nested.");
+
+  const dax::cont::TraceEvent *worklet = FindEvent("worklet", "TraceSquare");
+  DAX_TEST_ASSERT(worklet != NULL, "Worklet not traced.");
+  DAX_TEST_ASSERT(worklet->Count == ARRAY_SIZE, "Bad worklet count.");
+  DAX_TEST_ASSERT(worklet->Depth == 1, "Worklet not nested in Invoke.");
+
+  const dax::cont::TraceEvent *schedule = FindEvent("algorithm", "Schedule");
+  DAX_TEST_ASSERT(schedule != NULL, "Schedule not traced.");
+  DAX_TEST_ASSERT(schedule->Count == ARRAY_SIZE, "Bad schedule count.");
+
+  const dax::cont::TraceEvent *sort = FindEvent("algorithm", "Sort");
+  DAX_TEST_ASSERT(sort != NULL, "Sort not traced.");
+  DAX_TEST_ASSERT(sort->Depth == 0, "Sort should not be nested.");
+  DAX_TEST_ASSERT(sort->Bytes ==
+                  2*ARRAY_SIZE*static_cast<dax::Id>(sizeof(dax::Scalar)),
+                  "Bad sort bytes.");
+
+  DAX_TEST_ASSERT(FindEvent("algorithm", "ScanInclusive") != NULL,
+                  "Scan not traced.");
+  DAX_TEST_ASSERT(FindEvent("transfer", "PrepareForInput") != NULL,
+                  "Input transfer not traced.");
+  DAX_TEST_ASSERT(FindEvent("transfer", "PrepareForOutput") != NULL,
+                  "Output allocation not traced.");
+  DAX_TEST_ASSERT(FindEvent("transfer", "SyncControlArray") != NULL,
+                  "Transfer back to control not traced.");
+
+  std::stringstream trace;
+  collector.WriteChromeTrace(trace);
+  DAX_TEST_ASSERT(trace.str().find("\"traceEvents\"") != std::string::npos,
+                  "Chrome trace has no events.");
+  DAX_TEST_ASSERT(trace.str().find("\"cat\": \"algorithm\"")
+                  != std::string::npos,
+                  "Chrome trace has no algorithm events.");
+
+  std::stringstream summary;
+  collector.WriteSummary(summary);
+  std::cout << summary.str();
+  DAX_TEST_ASSERT(summary.str().find("algorithm: Sort") != std::string::npos,
+                  "Summary is missing Sort.");
+}
+
+void TestTracing()
+{
+  TestScope();
+  TestInstrumentation();
+}
+
+} // anonymous namespace
+
+int UnitTestTracing(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestTracing);
+}
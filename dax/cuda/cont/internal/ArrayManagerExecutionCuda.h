@@ -30,6 +30,13 @@ namespace dax {
 namespace cont {
 namespace internal {
 
+template<>
+struct ArrayManagerExecutionMemorySpace<dax::cuda::cont::DeviceAdapterTagCuda>
+{
+  static const bool IS_SEPARATE = true;
+  DAX_CONT_EXPORT static const char *GetName() { return "cuda"; }
+};
+
 template <typename T, class ArrayContainerTag>
 class ArrayManagerExecution
     <T, ArrayContainerTag, dax::cuda::cont::DeviceAdapterTagCuda>
@@ -43,6 +50,10 @@ public:
   typedef typename Superclass::PortalType PortalType;
   typedef typename Superclass::PortalConstType PortalConstType;
 
+  DAX_CONT_EXPORT ArrayManagerExecution()
+    : Superclass(ArrayManagerExecutionMemorySpace<
+                   dax::cuda::cont::DeviceAdapterTagCuda>::GetName()) {  }
+
   template<class PortalControl>
   DAX_CONT_EXPORT void LoadDataForInput(PortalControl arrayPortal)
   {
@@ -0,0 +1,111 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#ifndef __dax_exec_BrickMask_h
+#define __dax_exec_BrickMask_h
+
+#include <dax/Types.h>
+#include <dax/exec/ExecutionObjectBase.h>
+
+namespace dax {
+namespace exec {
+
+/// Where the values of a brick lie compared to a threshold such as an
+/// isovalue. Only the bricks that are cut by the threshold are active.
+///
+enum BrickState
+{
+  BRICK_BELOW = 0, ///< every value is at or below the threshold
+  BRICK_ACTIVE = 1, ///< some values are above the threshold and some are not
+  BRICK_ABOVE = 2 ///< every value is above the threshold
+};
+
+/// \brief Tells worklets which cells of a uniform grid lie in active bricks.
+///
+/// A brick is a block of brickSize cells along each axis. BrickMask holds the
+/// dax::exec::BrickState of every brick, so a worklet can skip all of the
+/// work for a cell in an inactive brick. It is created by
+/// dax::cont::MinMaxBrickIndex and is passed to worklets as an ExecObject.
+///
+template<class PortalType>
+class BrickMask : public dax::exec::ExecutionObjectBase
+{
+public:
+  DAX_CONT_EXPORT BrickMask() : CellDimensions(0), BrickDimensions(0),
+                                BrickSize(1) {  }
+
+  DAX_CONT_EXPORT BrickMask(const PortalType &mask,
+                            const dax::Id3 &cellDimensions,
+                            const dax::Id3 &brickDimensions,
+                            dax::Id brickSize)
+    : Mask(mask),
+      CellDimensions(cellDimensions),
+      BrickDimensions(brickDimensions),
+      BrickSize(brickSize) {  }
+
+  /// Returns the brick holding the cell with the given flat index, counting
+  /// from the first cell of the grid extent.
+  ///
+  DAX_EXEC_EXPORT dax::Id GetBrickOfCell(dax::Id cellIndex) const
+  {
+    const dax::Id i = cellIndex % this->CellDimensions[0];
+    const dax::Id jk = cellIndex / this->CellDimensions[0];
+    const dax::Id j = jk % this->CellDimensions[1];
+    const dax::Id k = jk / this->CellDimensions[1];
+    return (i / this->BrickSize)
+        + this->BrickDimensions[0] * ((j / this->BrickSize)
+        + this->BrickDimensions[1] * (k / this->BrickSize));
+  }
+
+  DAX_EXEC_CONT_EXPORT
+  const dax::Id3 &GetCellDimensions() const { return this->CellDimensions; }
+
+  DAX_EXEC_CONT_EXPORT
+  const dax::Id3 &GetBrickDimensions() const { return this->BrickDimensions; }
+
+  DAX_EXEC_CONT_EXPORT dax::Id GetBrickSize() const { return this->BrickSize; }
+
+  DAX_EXEC_EXPORT dax::exec::BrickState GetBrickState(dax::Id brickIndex) const
+  {
+    return static_cast<dax::exec::BrickState>(this->Mask.Get(brickIndex));
+  }
+
+  DAX_EXEC_EXPORT dax::exec::BrickState GetCellState(dax::Id cellIndex) const
+  {
+    return this->GetBrickState(this->GetBrickOfCell(cellIndex));
+  }
+
+  DAX_EXEC_EXPORT bool IsBrickActive(dax::Id brickIndex) const
+  {
+    return this->GetBrickState(brickIndex) == dax::exec::BRICK_ACTIVE;
+  }
+
+  DAX_EXEC_EXPORT bool IsCellActive(dax::Id cellIndex) const
+  {
+    return this->IsBrickActive(this->GetBrickOfCell(cellIndex));
+  }
+
+private:
+  PortalType Mask;
+  dax::Id3 CellDimensions;
+  dax::Id3 BrickDimensions;
+  dax::Id BrickSize;
+};
+
+}
+} // namespace dax::exec
+
+#endif //__dax_exec_BrickMask_h
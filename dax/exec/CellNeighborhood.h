@@ -0,0 +1,70 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_exec_CellNeighborhood_h
+#define __dax_exec_CellNeighborhood_h
+
+#include <dax/Types.h>
+
+namespace dax {
+namespace exec {
+
+/// \brief Holds the field values of the cells that share a point.
+///
+/// Points on the inside of a uniform grid are shared by eight voxels, points
+/// on a face by four, on an edge by two and on a corner by one. The values
+/// are ordered by increasing cell index.
+///
+template<typename FieldType>
+class CellNeighborhood
+{
+public:
+  const static int MAX_NUMBER_OF_VALUES = 8;
+  typedef dax::Tuple<FieldType, MAX_NUMBER_OF_VALUES> TupleType;
+  typedef FieldType ValueType;
+
+  DAX_EXEC_CONT_EXPORT
+  CellNeighborhood() : NumberOfValues(0) {  }
+
+  // Although this copy constructor should be identical to the default copy
+  // constructor, we have noticed that NVCC's default copy constructor can
+  // incur a significant slowdown.
+  DAX_EXEC_CONT_EXPORT
+  CellNeighborhood(const CellNeighborhood &src)
+    : Values(src.Values), NumberOfValues(src.NumberOfValues) {  }
+
+  DAX_EXEC_EXPORT
+  int GetNumberOfValues() const { return this->NumberOfValues; }
+
+  DAX_EXEC_EXPORT
+  const FieldType &operator[](int index) const {
+    return this->Values[index];
+  }
+
+  DAX_EXEC_EXPORT
+  void Append(const FieldType &value)
+  {
+    this->Values[this->NumberOfValues++] = value;
+  }
+
+private:
+  TupleType Values;
+  int NumberOfValues;
+};
+
+}
+} // namespace dax::exec
+
+#endif //__dax_exec_CellNeighborhood_h
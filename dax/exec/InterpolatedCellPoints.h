@@ -16,102 +16,81 @@
 #ifndef __dax_exec_InterpolatedCellPoints_h
 #define __dax_exec_InterpolatedCellPoints_h
 
-#include <dax/exec/CellField.h>
+#include <dax/CellTraits.h>
+#include <dax/Types.h>
+#include <dax/exec/internal/InterpolationEdge.h>
 
 namespace dax {
 namespace exec {
 
-/// \brief Holds the point indices for a cell of a particular type.
+/// \brief Holds the interpolation edge and ratio of each point of a cell
+/// of a particular type.
 ///
-/// This class is really is a convienience wrapper around a dax::Tuple.
+/// Each point of the cell lies at a ratio along the edge between two points
+/// of the input grid. The edges are kept as dax::exec::internal::
+/// InterpolationEdgeType so that the point ids are never converted to
+/// floating point.
 ///
 template<class CellTag>
-class InterpolatedCellPoints : public dax::exec::CellField<dax::Vector3, CellTag>
+class InterpolatedCellPoints
 {
-private:
-  typedef dax::exec::CellField<dax::Vector3, CellTag> Superclass;
 public:
-  const static int NUM_VERTICES = Superclass::NUM_VERTICES;
-  typedef typename Superclass::TupleType TupleType;
+  const static int NUM_VERTICES = dax::CellTraits<CellTag>::NUM_VERTICES;
+  typedef dax::exec::internal::InterpolationEdgeType EdgeType;
+  typedef dax::Tuple<EdgeType,NUM_VERTICES> EdgeTupleType;
+  typedef dax::Tuple<dax::Scalar,NUM_VERTICES> RatioTupleType;
 
   DAX_EXEC_CONT_EXPORT
   InterpolatedCellPoints() {  }
 
   DAX_EXEC_CONT_EXPORT
-  InterpolatedCellPoints(const TupleType &pointIndices) : Superclass(pointIndices) {  }
-
-  DAX_CONT_EXPORT
-  InterpolatedCellPoints(dax::Vector3 value) : Superclass(value) {  }
+  InterpolatedCellPoints(const EdgeTupleType &edges,
+                         const RatioTupleType &ratios)
+    : Edges(edges), Ratios(ratios) {  }
 
   // Although this copy constructor should be identical to the default copy
   // constructor, we have noticed that NVCC's default copy constructor can
   // incur a significant slowdown.
   DAX_EXEC_CONT_EXPORT
-  InterpolatedCellPoints(const InterpolatedCellPoints &src) : Superclass(src) {  }
+  InterpolatedCellPoints(const InterpolatedCellPoints &src)
+    : Edges(src.Edges), Ratios(src.Ratios) {  }
 
-  //Allow easier setting of the interpolation value.
+  //Allow easier setting of the interpolation value. The edge is stored
+  //with the smaller point id first (flipping the weight to match) so that
+  //both cells sharing an edge produce the same entry.
   DAX_EXEC_EXPORT
   void SetInterpolationPoint( dax::Id index, dax::Id pos1, dax::Id pos2,
                               dax::Scalar weight )
     {
-    (*this)[index]=dax::Vector3( pos1, pos2, weight);
+    this->Edges[index] =
+        dax::exec::internal::MakeInterpolationEdge(pos1, pos2);
+    this->Ratios[index] = (pos2 < pos1) ? 1 - weight : weight;
     }
-};
-
-}
-} // namespace dax::exec
-
-namespace dax {
 
-/// Implementation of VectorTraits for a InterpolatedCellPoints so that it can be treated
-/// like a vector.
-///
-template<class CellTag>
-struct VectorTraits<dax::exec::InterpolatedCellPoints<CellTag> >
-{
-  typedef dax::exec::InterpolatedCellPoints<CellTag> InterpolatedCellPointsType;
-  typedef dax::Id ComponentType;
-  static const int NUM_COMPONENTS = InterpolatedCellPointsType::NUM_VERTICES;
-  typedef typename internal::VectorTraitsMultipleComponentChooser<
-      NUM_COMPONENTS>::Type HasMultipleComponents;
+  DAX_EXEC_CONT_EXPORT
+  EdgeType GetInterpolationEdge(int index) const
+    {
+    return this->Edges[index];
+    }
 
-  DAX_EXEC_EXPORT
-  static const ComponentType &GetComponent(const InterpolatedCellPointsType &vector,
-                                           int component) {
-    return vector[component];
-  }
-  DAX_EXEC_EXPORT
-  static ComponentType &GetComponent(InterpolatedCellPointsType &vector, int component) {
-    return vector[component];
-  }
+  DAX_EXEC_CONT_EXPORT
+  dax::Scalar GetInterpolationRatio(int index) const
+    {
+    return this->Ratios[index];
+    }
 
-  DAX_EXEC_EXPORT static void SetComponent(InterpolatedCellPointsType &vector,
-                                           int component,
-                                           ComponentType value) {
-    vector[component] = value;
-  }
+  DAX_EXEC_CONT_EXPORT
+  const EdgeTupleType &GetEdges() const { return this->Edges; }
 
   DAX_EXEC_CONT_EXPORT
-  static dax::Tuple<ComponentType,NUM_COMPONENTS>
-  ToTuple(const InterpolatedCellPointsType &vector)
-  {
-    return vector.GetAsTuple();
-  }
-};
+  const RatioTupleType &GetRatios() const { return this->Ratios; }
 
-/// Implementation of TypeTraits for a CellField.
-///
-template<class CellTag>
-struct TypeTraits<dax::exec::InterpolatedCellPoints<CellTag> > {
-  typedef dax::TypeTraitsIntegerTag NumericTag;
-  typedef dax::TypeTraitsVectorTag DimensionalityTag;
-};
-template<>
-struct TypeTraits<dax::exec::InterpolatedCellPoints<dax::CellTagVertex> > {
-  typedef dax::TypeTraitsIntegerTag NumericTag;
-  typedef dax::TypeTraitsScalarTag DimensionalityTag;
+private:
+  EdgeTupleType Edges;
+  RatioTupleType Ratios;
 };
 
-} // namespace dax
+}
+} // namespace dax::exec
 
 #endif //__dax_exec_InterpolatedCellPoints_h
@@ -23,20 +23,51 @@
 #include <dax/CellTag.h>
 #include <dax/VectorTraits.h>
 
+#include <dax/cont/ArrayPortal.h>
 #include <dax/cont/arg/ConceptMap.h>
 #include <dax/cont/arg/Topology.h>
 
 #include <dax/exec/arg/ArgBase.h>
 #include <dax/exec/arg/BindInfo.h>
+#include <dax/exec/arg/FieldPortal.h>
+#include <dax/exec/arg/TopologyCell.h>
 #include <dax/exec/CellField.h>
 #include <dax/exec/CellVertices.h>
 #include <dax/exec/internal/IJKIndex.h>
+#include <dax/exec/internal/TopologyUniform.h>
 #include <dax/exec/internal/WorkletBase.h>
 
+#include <boost/mpl/and.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/not.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 #include <boost/utility/enable_if.hpp>
 
 namespace dax { namespace exec { namespace arg {
 
+namespace detail {
+// The voxels of a uniform grid next to each other along i share a face, so
+// the values of the face gathered for one voxel are the first face of the
+// next one.
+template<typename TopoExecArgType>
+struct BindCellPointsSharesFacesAlongI : boost::false_type {  };
+
+template<typename Tags>
+struct BindCellPointsSharesFacesAlongI<
+    dax::exec::arg::TopologyCell<Tags, dax::exec::internal::TopologyUniform> >
+    : boost::true_type {  };
+
+// Keeping the values of a face only pays when getting them computes them.
+// Loading them again from memory is cheaper than copying them along.
+template<typename ExecArgType>
+struct BindCellPointsComputesValues : boost::false_type {  };
+
+template<typename T, typename Tags, typename PortalType>
+struct BindCellPointsComputesValues<
+    dax::exec::arg::FieldPortal<T, Tags, PortalType> >
+    : dax::cont::internal::ArrayPortalComputesValues<PortalType> {  };
+}
+
 template <typename Invocation, int N>
 class BindCellPoints
     : public dax::exec::arg::ArgBase<BindCellPoints<Invocation,N> >
@@ -55,11 +86,22 @@ public:
   typedef typename Traits::ReturnType ReturnType;
   typedef typename Traits::SaveType SaveType;
 
+  /// Whether the values gathered for a voxel of a uniform grid are reused
+  /// for the next one along i. Values written back to the points can change
+  /// what the previous voxel gathered, so only input fields reuse them.
+  ///
+  typedef typename boost::mpl::and_<
+      detail::BindCellPointsSharesFacesAlongI<TopoExecArgType>,
+      detail::BindCellPointsComputesValues<ExecArgType>,
+      boost::mpl::not_<typename Traits::HasOutTag> >::type ReusesFaces;
+
   DAX_CONT_EXPORT BindCellPoints(
       typename dax::cont::internal::Bindings<Invocation>::type &bindings):
     TopoExecArg(dax::exec::arg::GetNthExecArg<TopoIndex>(bindings)),
     ExecArg(dax::exec::arg::GetNthExecArg<N>(bindings)),
-    Value(typename dax::VectorTraits<ValueType>::ComponentType()) {}
+    Value(typename dax::VectorTraits<ValueType>::ComponentType()),
+    LastValues(typename dax::VectorTraits<ValueType>::ComponentType()),
+    LastIJK(-1, -1, -1) {}
 
   template<typename IndexType>
   DAX_EXEC_EXPORT ReturnType GetValueForWriting(const IndexType&,
@@ -83,6 +125,22 @@ public:
     return v;
     }
 
+  DAX_EXEC_EXPORT ReturnType GetValueForReading(
+                            const dax::exec::internal::IJKIndex& index,
+                            const dax::exec::internal::WorkletBase& work) const
+    {
+    return this->GatherAlongI(index, work, ReusesFaces());
+    }
+
+  /// Takes the values gathered by \p previous, the copy of this binding
+  /// used for the voxel before this one along i, so that they can be reused.
+  ///
+  DAX_EXEC_EXPORT void ContinueRow(const BindCellPoints &previous)
+    {
+    this->LastValues = previous.LastValues;
+    this->LastIJK = previous.LastIJK;
+    }
+
   DAX_EXEC_EXPORT void SaveValue(int index,
                         const dax::exec::internal::WorkletBase& work) const
     {
@@ -104,9 +162,57 @@ public:
       }
     }
 private:
+  DAX_EXEC_EXPORT ReturnType GatherAlongI(
+                            const dax::exec::internal::IJKIndex& index,
+                            const dax::exec::internal::WorkletBase& work,
+                            boost::mpl::false_) const
+    {
+    return this->template GetValueForReading<
+        dax::exec::internal::IJKIndex>(index, work);
+    }
+
+  DAX_EXEC_EXPORT ReturnType GatherAlongI(
+                            const dax::exec::internal::IJKIndex& index,
+                            const dax::exec::internal::WorkletBase& work,
+                            boost::mpl::true_) const
+    {
+    const dax::Id3 ijk = index.GetIJK();
+    if (ijk[0] != this->LastIJK[0] + 1 ||
+        ijk[1] != this->LastIJK[1] ||
+        ijk[2] != this->LastIJK[2])
+      {
+      this->LastValues = this->template GetValueForReading<
+          dax::exec::internal::IJKIndex>(index, work);
+      this->LastIJK = ijk;
+      return this->LastValues;
+      }
+
+    // The face at i+1 of the last voxel (vertices 1, 2, 5 and 6) is the face
+    // at i of this one (vertices 0, 3, 4 and 7), so only the far face is
+    // loaded.
+    const dax::exec::CellVertices<CellTag>& pointIndices =
+                                            this->TopoExecArg(index, work);
+    ValueType v;
+    v[0] = this->LastValues[1];
+    v[3] = this->LastValues[2];
+    v[4] = this->LastValues[5];
+    v[7] = this->LastValues[6];
+    v[1] = this->ExecArg(pointIndices[1],work);
+    v[2] = this->ExecArg(pointIndices[2],work);
+    v[5] = this->ExecArg(pointIndices[5],work);
+    v[6] = this->ExecArg(pointIndices[6],work);
+    this->LastValues = v;
+    this->LastIJK = ijk;
+    return v;
+    }
+
   TopoExecArgType TopoExecArg;
   ExecArgType ExecArg;
   ValueType Value;
+  // The values gathered for the voxel at LastIJK, kept in the copy of the
+  // binding that invokes a row of voxels.
+  mutable ValueType LastValues;
+  mutable dax::Id3 LastIJK;
 };
 
 
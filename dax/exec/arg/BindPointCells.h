@@ -0,0 +1,151 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_exec_arg_BindPointCells_h
+#define __dax_exec_arg_BindPointCells_h
+#if defined(DAX_DOXYGEN_ONLY)
+
+#else // !defined(DAX_DOXYGEN_ONLY)
+
+#include <dax/Extent.h>
+#include <dax/Types.h>
+
+#include <dax/cont/arg/ConceptMap.h>
+#include <dax/cont/arg/Topology.h>
+
+#include <dax/exec/arg/ArgBase.h>
+#include <dax/exec/arg/BindInfo.h>
+#include <dax/exec/CellNeighborhood.h>
+#include <dax/exec/internal/IJKIndex.h>
+#include <dax/exec/internal/WorkletBase.h>
+
+#include <boost/mpl/if.hpp>
+
+namespace dax { namespace exec { namespace arg {
+
+/// Gathers the values of a cell field for the cells sharing a point of a
+/// uniform grid. The cells are found from the point's i, j, k index, so no
+/// point to cell connectivity has to be built.
+///
+template <typename Invocation, int N>
+class BindPointCells
+    : public dax::exec::arg::ArgBase<BindPointCells<Invocation,N> >
+{
+  typedef dax::exec::arg::ArgBaseTraits<
+      BindPointCells<Invocation, N > > Traits;
+
+  enum{TopoIndex=Traits::TopoIndex};
+  typedef typename Traits::TopoExecArgType TopoExecArgType;
+  typedef typename Traits::ExecArgType ExecArgType;
+
+public:
+
+  typedef typename Traits::ValueType ValueType;
+  typedef typename Traits::ReturnType ReturnType;
+  typedef typename Traits::SaveType SaveType;
+
+  DAX_CONT_EXPORT BindPointCells(
+      typename dax::cont::internal::Bindings<Invocation>::type &bindings):
+    TopoExecArg(dax::exec::arg::GetNthExecArg<TopoIndex>(bindings)),
+    ExecArg(dax::exec::arg::GetNthExecArg<N>(bindings)) {}
+
+  template<typename IndexType>
+  DAX_EXEC_EXPORT ReturnType GetValueForReading(
+                            const IndexType& index,
+                            const dax::exec::internal::WorkletBase& work) const
+    {
+    const dax::Id3 pointDims =
+        dax::extentDimensions(this->TopoExecArg.GetTopology().Extent);
+    const dax::Id3 cellDims = pointDims - dax::make_Id3(1, 1, 1);
+    const dax::Id3 ijk = PointIJK(index, pointDims);
+
+    // The cells sharing point ijk are ijk - 1 through ijk, clamped to the
+    // cells of the grid.
+    const dax::Id3 first(ijk[0] > 0 ? ijk[0] - 1 : 0,
+                         ijk[1] > 0 ? ijk[1] - 1 : 0,
+                         ijk[2] > 0 ? ijk[2] - 1 : 0);
+    const dax::Id3 last(ijk[0] < cellDims[0] ? ijk[0] : cellDims[0] - 1,
+                        ijk[1] < cellDims[1] ? ijk[1] : cellDims[1] - 1,
+                        ijk[2] < cellDims[2] ? ijk[2] : cellDims[2] - 1);
+
+    ValueType cells;
+    for(dax::Id k = first[2]; k <= last[2]; ++k)
+      {
+      for(dax::Id j = first[1]; j <= last[1]; ++j)
+        {
+        for(dax::Id i = first[0]; i <= last[0]; ++i)
+          {
+          const dax::Id cellIndex = i + cellDims[0] * (j + cellDims[1] * k);
+          cells.Append(this->ExecArg(cellIndex, work));
+          }
+        }
+      }
+    return cells;
+    }
+
+private:
+  DAX_EXEC_EXPORT static dax::Id3 PointIJK(
+      const dax::exec::internal::IJKIndex& index, const dax::Id3&)
+    {
+    return index.GetIJK();
+    }
+
+  DAX_EXEC_EXPORT static dax::Id3 PointIJK(dax::Id index,
+                                           const dax::Id3& pointDims)
+    {
+    return dax::Id3(index % pointDims[0],
+                    (index / pointDims[0]) % pointDims[1],
+                    index / (pointDims[0] * pointDims[1]));
+    }
+
+  TopoExecArgType TopoExecArg;
+  ExecArgType ExecArg;
+};
+
+
+
+//the traits for BindPointCells
+template <typename Invocation, int N >
+struct ArgBaseTraits< BindPointCells<Invocation, N> >
+{
+private:
+  typedef dax::exec::arg::FindBindInfo<
+      dax::cont::arg::Topology,Invocation> TopoInfo;
+  typedef dax::exec::arg::BindInfo<N,Invocation> MyInfo;
+  typedef typename MyInfo::Tags Tags;
+public:
+  enum{TopoIndex=TopoInfo::Index};
+
+  typedef typename TopoInfo::ExecArgType TopoExecArgType;
+  typedef typename MyInfo::ExecArgType ExecArgType;
+
+  // The values of the neighborhood are only read; writing to the cells
+  // around a point from more than one point would race.
+  typedef ::boost::false_type HasOutTag;
+
+  typedef typename ::boost::mpl::if_<typename Tags::template Has<dax::cont::sig::In>,
+                                   ::boost::true_type,
+                                   ::boost::false_type>::type HasInTag;
+
+  typedef dax::exec::CellNeighborhood<typename ExecArgType::ValueType>
+      ValueType;
+  typedef ValueType const ReturnType;
+  typedef ValueType SaveType;
+};
+
+}}} // namespace dax::exec::arg
+
+#endif // !defined(DAX_DOXYGEN_ONLY)
+#endif //__dax_exec_arg_BindPointCells_h
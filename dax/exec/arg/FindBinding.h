@@ -33,6 +33,7 @@
 #include <dax/exec/arg/BindCellTag.h>
 #include <dax/exec/arg/BindDirect.h>
 #include <dax/exec/arg/BindPermutedCellField.h>
+#include <dax/exec/arg/BindPointCells.h>
 #include <dax/exec/arg/BindWorkId.h>
 #include <dax/exec/arg/BindKeyGroup.h>
 #include <dax/Types.h>
@@ -107,6 +108,24 @@ public:
 };
 
 
+//specialize on arg to field mapping when visiting points, with Field(Cell)
+//being understood as the cells that share the point
+template<typename Tags,
+         typename Invocation,
+         int N>
+class BindArg<dax::cont::sig::Point,
+              dax::cont::arg::Field(Tags),
+              Invocation,
+              N>
+{
+public:
+  typedef typename boost::mpl::if_<
+    typename Tags::template Has<dax::cont::sig::Cell>,
+    BindPointCells<Invocation, N>,
+    BindDirect<Invocation, N>
+    >::type type;
+};
+
 
 //find binding finds the correct binding for a parameter
 //the main job is to extract out the control signature position and tag
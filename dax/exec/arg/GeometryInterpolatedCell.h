@@ -0,0 +1,108 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_exec_arg_GeometryInterpolatedCell_h
+#define __dax_exec_arg_GeometryInterpolatedCell_h
+#if defined(DAX_DOXYGEN_ONLY)
+
+#else // !defined(DAX_DOXYGEN_ONLY)
+
+#include <dax/Types.h>
+#include <dax/CellTag.h>
+
+#include <dax/exec/arg/ArgBase.h>
+#include <dax/exec/internal/FieldAccess.h>
+#include <dax/exec/internal/WorkletBase.h>
+#include <dax/exec/InterpolatedCellPoints.h>
+
+#include <boost/type_traits/integral_constant.hpp>
+
+namespace dax { namespace exec { namespace arg {
+
+/// Output geometry of a dax::exec::WorkletInterpolatedCell. The edges and
+/// ratios of the points of cell \c index are written to the entries
+/// starting at \c index times the number of vertices of \c CellTag.
+///
+template <typename Tags, typename CellTag_,
+          typename EdgePortalType, typename RatioPortalType>
+class GeometryInterpolatedCell :
+    public dax::exec::arg::ArgBase< GeometryInterpolatedCell<
+        Tags, CellTag_, EdgePortalType, RatioPortalType> >
+{
+public:
+  //needed for cell type binding to be public
+  typedef CellTag_ CellTag;
+
+  typedef dax::exec::arg::ArgBaseTraits< GeometryInterpolatedCell<
+      Tags, CellTag, EdgePortalType, RatioPortalType> > Traits;
+
+  typedef typename Traits::ValueType ValueType;
+  typedef typename Traits::ReturnType ReturnType;
+  typedef typename Traits::SaveType SaveType;
+
+  DAX_CONT_EXPORT GeometryInterpolatedCell(const EdgePortalType& edges,
+                                           const RatioPortalType& ratios):
+    Edges(edges),
+    Ratios(ratios),
+    Cell()
+    {
+    }
+
+  template<typename IndexType>
+  DAX_EXEC_EXPORT ReturnType GetValueForWriting(const IndexType&,
+                            const dax::exec::internal::WorkletBase&)
+    { return this->Cell; }
+
+  DAX_EXEC_EXPORT void SaveValue(dax::Id index,
+                            const dax::exec::internal::WorkletBase& work) const
+    {
+    this->SaveValue(index,this->Cell,work);
+    }
+
+  DAX_EXEC_EXPORT void SaveValue(dax::Id index,
+                            const SaveType& values,
+                            const dax::exec::internal::WorkletBase& work) const
+    {
+    const dax::Id start = index * ValueType::NUM_VERTICES;
+    dax::exec::internal::FieldSetMultiple(this->Edges, start,
+                                          values.GetEdges(), work);
+    dax::exec::internal::FieldSetMultiple(this->Ratios, start,
+                                          values.GetRatios(), work);
+    }
+private:
+  EdgePortalType Edges;
+  RatioPortalType Ratios;
+  ValueType Cell;
+};
+
+//the traits for GeometryInterpolatedCell
+template <typename Tags, typename CellTag,
+          typename EdgePortalType, typename RatioPortalType>
+struct ArgBaseTraits< dax::exec::arg::GeometryInterpolatedCell<
+    Tags, CellTag, EdgePortalType, RatioPortalType > >
+{
+  typedef ::boost::true_type HasOutTag;
+  typedef ::boost::false_type HasInTag;
+
+  typedef dax::exec::InterpolatedCellPoints<CellTag> ValueType;
+  typedef ValueType& ReturnType;
+  typedef ValueType SaveType;
+};
+
+
+}}} // namespace dax::exec::arg
+
+#endif // !defined(DAX_DOXYGEN_ONLY)
+#endif //__dax_exec_arg_GeometryInterpolatedCell_h
@@ -63,6 +63,11 @@ public:
     return this->Topo.GetCellConnections(index);
     }
 
+  //bindings that compute neighborhoods from the structure of the grid
+  //need the topology itself, not just the cell connections
+  DAX_EXEC_EXPORT const TopologyType& GetTopology() const
+    { return this->Topo; }
+
   DAX_EXEC_EXPORT void SaveValue(int index,
                        const dax::exec::internal::WorkletBase& work) const
     { this->SaveValue(index,this->Cell,work); }
@@ -70,10 +75,18 @@ public:
   DAX_EXEC_EXPORT void SaveValue(int index, const SaveType& values,
                        const dax::exec::internal::WorkletBase& work) const
     {
-    dax::exec::internal::FieldSetMultiple(this->Topo.CellConnections,
-                                dax::CellTraits<CellTag>::NUM_VERTICES * index,
-                                values.GetAsTuple(),
-                                work);
+    // The connections may be stored in a narrower type than dax::Id, so
+    // each vertex is converted as it is written.
+    typedef typename TopologyType::CellConnectionsPortalType PortalType;
+    const int NUM_VERTICES = dax::CellTraits<CellTag>::NUM_VERTICES;
+    for (int vertexIndex = 0; vertexIndex < NUM_VERTICES; vertexIndex++)
+      {
+      dax::exec::internal::FieldSet(
+            this->Topo.CellConnections,
+            NUM_VERTICES * index + vertexIndex,
+            static_cast<typename PortalType::ValueType>(values[vertexIndex]),
+            work);
+      }
     }
 
 private:
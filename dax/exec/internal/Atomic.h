@@ -0,0 +1,123 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_exec_internal_Atomic_h
+#define __dax_exec_internal_Atomic_h
+
+#include <dax/Types.h>
+
+namespace dax {
+namespace exec {
+namespace internal {
+
+namespace detail {
+
+#ifdef __CUDA_ARCH__
+template<int Size> struct AtomicCompareAndSwapImpl;
+
+template<> struct AtomicCompareAndSwapImpl<4>
+{
+  template<typename T>
+  __device__ static T Run(T *address, T expected, T desired)
+  {
+    typedef unsigned int WordType;
+    const WordType old = atomicCAS(reinterpret_cast<WordType *>(address),
+                                   *reinterpret_cast<WordType *>(&expected),
+                                   *reinterpret_cast<WordType *>(&desired));
+    return *reinterpret_cast<const T *>(&old);
+  }
+};
+
+template<> struct AtomicCompareAndSwapImpl<8>
+{
+  template<typename T>
+  __device__ static T Run(T *address, T expected, T desired)
+  {
+    typedef unsigned long long WordType;
+    const WordType old = atomicCAS(reinterpret_cast<WordType *>(address),
+                                   *reinterpret_cast<WordType *>(&expected),
+                                   *reinterpret_cast<WordType *>(&desired));
+    return *reinterpret_cast<const T *>(&old);
+  }
+};
+#endif
+
+} // namespace detail
+
+/// Atomically replaces the value at \p address with \p desired if it
+/// currently holds \p expected. Returns the value held before the call, so
+/// the swap happened if and only if the return equals \p expected. \c T
+/// must be a 4 or 8 byte integer.
+///
+/// Worklets scheduled on the parallel device adapters run concurrently, so
+/// any location that more than one invocation writes must be updated with
+/// these functions.
+///
+template<typename T>
+DAX_EXEC_EXPORT
+T AtomicCompareAndSwap(T *address, T expected, T desired)
+{
+#ifdef __CUDA_ARCH__
+  return detail::AtomicCompareAndSwapImpl<sizeof(T)>::Run(address,
+                                                          expected,
+                                                          desired);
+#else
+  return __sync_val_compare_and_swap(address, expected, desired);
+#endif
+}
+
+/// Atomically replaces the value at \p address with \p value if \p value is
+/// smaller. Returns the value held before the call.
+///
+template<typename T>
+DAX_EXEC_EXPORT
+T AtomicMin(T *address, T value)
+{
+  T current = *address;
+  while (value < current)
+    {
+    const T previous = AtomicCompareAndSwap(address, current, value);
+    if (previous == current) { break; }
+    current = previous;
+    }
+  return current;
+}
+
+/// Atomically adds \p value to the value at \p address. Returns the value
+/// held before the call. \c T must be a 4 or 8 byte integer.
+///
+template<typename T>
+DAX_EXEC_EXPORT
+T AtomicAdd(T *address, T value)
+{
+#ifdef __CUDA_ARCH__
+  T current = *address;
+  while (true)
+    {
+    const T previous = AtomicCompareAndSwap(address, current, current + value);
+    if (previous == current) { break; }
+    current = previous;
+    }
+  return current;
+#else
+  return __sync_fetch_and_add(address, value);
+#endif
+}
+
+}
+}
+} // namespace dax::exec::internal
+
+#endif //__dax_exec_internal_Atomic_h
@@ -24,6 +24,9 @@
 # include <dax/internal/GetNthType.h>
 # include <dax/internal/Members.h>
 
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/or.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 #include <boost/type_traits/remove_reference.hpp>
 #include <boost/utility/enable_if.hpp>
 
@@ -59,6 +62,58 @@ struct FunctorExecBindingToWorkletBinding
       FunctorWorkletMemberMap> type;
 };
 
+// Hands what a binding kept from one invocation along a row of a grid to the
+// copy used for the next one. Only the point gathers of uniform grids keep
+// anything, and only of fields whose values are computed.
+template<typename BindingType>
+struct FunctorBindingContinuesRow : boost::false_type {  };
+
+template<typename Invocation, int N>
+struct FunctorBindingContinuesRow<
+    dax::exec::arg::BindCellPoints<Invocation, N> >
+    : dax::exec::arg::BindCellPoints<Invocation, N>::ReusesFaces {  };
+
+template<typename BindingType>
+DAX_EXEC_EXPORT
+void FunctorContinueRow(const BindingType &, BindingType &) {  }
+
+template<typename Invocation, int N>
+DAX_EXEC_EXPORT
+void FunctorContinueRow(
+    const dax::exec::arg::BindCellPoints<Invocation, N> &previous,
+    dax::exec::arg::BindCellPoints<Invocation, N> &next)
+{
+  next.ContinueRow(previous);
+}
+
+template<typename ArgumentsType,
+         int N,
+         bool Done = (N >= ArgumentsType::NUM_MEMBERS)>
+struct FunctorArgumentsContinueRow
+{
+  typedef typename boost::mpl::or_<
+      FunctorBindingContinuesRow<
+        typename ArgumentsType::template GetType<N>::type>,
+      typename FunctorArgumentsContinueRow<ArgumentsType, N+1>::ContinuesRow
+    >::type ContinuesRow;
+
+  DAX_EXEC_EXPORT
+  void operator()(const ArgumentsType &previous, ArgumentsType &next) const
+  {
+    FunctorContinueRow(previous.template Get<N>(), next.template Get<N>());
+    FunctorArgumentsContinueRow<ArgumentsType, N+1>()(previous, next);
+  }
+};
+
+template<typename ArgumentsType, int N>
+struct FunctorArgumentsContinueRow<ArgumentsType, N, true>
+{
+  typedef boost::mpl::false_ ContinuesRow;
+
+  DAX_EXEC_EXPORT
+  void operator()(const ArgumentsType &, ArgumentsType &) const {  }
+};
+
 template<typename IndexType>
 struct FunctorGetArgs
 {
@@ -164,6 +219,18 @@ public:
     this->InvokeWorklet(index);
   }
 
+  /// Invokes the worklet on the cells of a row of a grid, from \p index to
+  /// the cell before \p end along i. When an argument gathers computed
+  /// point values, such as the coordinates of a uniform grid, each
+  /// invocation starts from what the previous one gathered, so the values
+  /// that neighbouring voxels share are computed once.
+  ///
+  DAX_EXEC_EXPORT
+  void InvokeRow(dax::exec::internal::IJKIndex index, dax::Id end) const
+  {
+    this->InvokeRow(index, end, typename RowContinuation::ContinuesRow());
+  }
+
 private:
   WorkletType Worklet;
 
@@ -173,6 +240,42 @@ private:
     > ArgumentsType;
   const ArgumentsType Arguments;
 
+  typedef detail::FunctorArgumentsContinueRow<
+      ArgumentsType, ArgumentsType::FIRST_INDEX> RowContinuation;
+
+  DAX_EXEC_EXPORT
+  void InvokeRow(dax::exec::internal::IJKIndex index,
+                 dax::Id end,
+                 boost::mpl::false_) const
+  {
+    for (dax::Id i = index.GetIJK()[0]; i < end; ++i)
+      {
+      index.SetI(i);
+      this->InvokeWorklet(index);
+      }
+  }
+
+  DAX_EXEC_EXPORT
+  void InvokeRow(dax::exec::internal::IJKIndex index,
+                 dax::Id end,
+                 boost::mpl::true_) const
+  {
+    ArgumentsType row(this->Arguments);
+    for (dax::Id i = index.GetIJK()[0]; i < end; ++i)
+      {
+      index.SetI(i);
+      // Every cell starts from a copy of the arguments, as in InvokeWorklet,
+      // so that nothing a worklet wrote leaks into the next cell. The row
+      // only adds handing the gathered values back to it.
+      ArgumentsType instance(row);
+      this->DoInvokeWorklet<ArgumentsType::FIRST_INDEX>(instance, index);
+      instance.ForEachExec(
+            detail::FunctorSaveArgs<dax::exec::internal::IJKIndex>(
+              index, this->Worklet));
+      RowContinuation()(instance, row);
+      }
+  }
+
   template<typename IndexType>
   DAX_EXEC_EXPORT
   void InvokeWorklet(IndexType index) const
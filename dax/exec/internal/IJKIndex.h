@@ -46,7 +46,7 @@ struct IJKIndex
 
   DAX_EXEC_EXPORT const dax::Id3 GetIJK() const { return this->IJK; }
 
-  DAX_CONT_EXPORT void SetI(dax::Id v) { this->IJK[0]=v; }
+  DAX_EXEC_CONT_EXPORT void SetI(dax::Id v) { this->IJK[0]=v; }
 
   DAX_CONT_EXPORT void SetJ(dax::Id v) { this->IJK[1]=v; this->UpdateCache(); }
 
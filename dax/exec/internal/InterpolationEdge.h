@@ -0,0 +1,71 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_exec_internal_InterpolationEdge_h
+#define __dax_exec_internal_InterpolationEdge_h
+
+#include <dax/Types.h>
+
+namespace dax {
+namespace exec {
+namespace internal {
+
+/// An interpolation edge identifies the pair of input points that an
+/// interpolated point lies between. The smaller point id is packed in the
+/// high 32 bits and the larger one in the low 32 bits, so every edge has
+/// exactly one key and sorting the keys orders the edges by their first and
+/// then second point id. Point ids must be less than 2^31, which the
+/// dispatchers check with InterpolationEdgeCanHold before generating edges.
+///
+typedef dax::internal::Int64Type InterpolationEdgeType;
+
+/// True when every point id of a grid of \p numberOfPoints points can be
+/// packed into an interpolation edge.
+///
+DAX_EXEC_CONT_EXPORT
+bool InterpolationEdgeCanHold(dax::internal::Int64Type numberOfPoints)
+{
+  return numberOfPoints <= (static_cast<dax::internal::Int64Type>(1) << 31);
+}
+
+DAX_EXEC_CONT_EXPORT
+InterpolationEdgeType MakeInterpolationEdge(dax::Id first, dax::Id second)
+{
+  const dax::internal::UInt64Type low = static_cast<dax::internal::UInt32Type>(
+        (first < second) ? first : second);
+  const dax::internal::UInt64Type high = static_cast<dax::internal::UInt32Type>(
+        (first < second) ? second : first);
+  return static_cast<InterpolationEdgeType>((low << 32) | high);
+}
+
+DAX_EXEC_CONT_EXPORT
+dax::Id InterpolationEdgeFirst(InterpolationEdgeType edge)
+{
+  return static_cast<dax::Id>(
+        static_cast<dax::internal::UInt64Type>(edge) >> 32);
+}
+
+DAX_EXEC_CONT_EXPORT
+dax::Id InterpolationEdgeSecond(InterpolationEdgeType edge)
+{
+  return static_cast<dax::Id>(
+        static_cast<dax::internal::UInt64Type>(edge) & 0xffffffffULL);
+}
+
+}
+}
+} // namespace dax::exec::internal
+
+#endif //__dax_exec_internal_InterpolationEdge_h
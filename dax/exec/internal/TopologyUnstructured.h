@@ -95,8 +95,8 @@ struct TopologyUnstructured
     dax::exec::CellVertices<CellTag> vertices;
     for (dax::Id vertexIndex = 0; vertexIndex < NUM_VERTICES; vertexIndex++)
       {
-      vertices[vertexIndex] =
-          this->CellConnections.Get(startConnectionIndex + vertexIndex);
+      vertices[vertexIndex] = static_cast<dax::Id>(
+          this->CellConnections.Get(startConnectionIndex + vertexIndex));
       }
     return vertices;
   }
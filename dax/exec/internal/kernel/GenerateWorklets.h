@@ -18,6 +18,8 @@
 
 #include <dax/Types.h>
 #include <dax/exec/WorkletMapField.h>
+#include <dax/exec/internal/Atomic.h>
+#include <dax/exec/internal/InterpolationEdge.h>
 #include <dax/math/VectorAnalysis.h>
 
 namespace dax {
@@ -60,15 +62,47 @@ struct GetUsedPointsFunctor : public WorkletMapField
   }
 };
 
-template<class InterpolationWeights,
+template<class IndexPortalType,
+         class InRatioPortalType,
+         class OutRatioPortalType>
+struct ScatterInterpolationRatios
+  {
+    DAX_CONT_EXPORT ScatterInterpolationRatios(
+                                        const IndexPortalType &indices,
+                                        const InRatioPortalType &inRatios,
+                                        const OutRatioPortalType &outRatios) :
+    Indices(indices),
+    Input(inRatios),
+    Output(outRatios)
+    {  }
+
+    //every point on an edge carries the same ratio, so it does not matter
+    //which of the duplicates is written last
+    DAX_EXEC_EXPORT void operator()(dax::Id index) const
+    {
+      this->Output.Set(this->Indices.Get(index), this->Input.Get(index));
+    }
+
+    DAX_CONT_EXPORT void SetErrorMessageBuffer(
+        const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+    IndexPortalType Indices;
+    InRatioPortalType Input;
+    OutRatioPortalType Output;
+  };
+
+template<class EdgePortalType,
+         class RatioPortalType,
          class InPortalType,
          class OutPortalType >
 struct InterpolateFieldToField
   {
-    DAX_CONT_EXPORT InterpolateFieldToField(const InterpolationWeights &interp,
+    DAX_CONT_EXPORT InterpolateFieldToField(const EdgePortalType &edges,
+                                            const RatioPortalType &ratios,
                                             const InPortalType &inPortal,
                                             const OutPortalType &outPortal) :
-    Weights(interp),
+    Edges(edges),
+    Ratios(ratios),
     Input(inPortal),
     Output(outPortal)
     {  }
@@ -76,30 +110,186 @@ struct InterpolateFieldToField
 
     DAX_EXEC_EXPORT void operator()(dax::Id index) const
     {
-      const dax::Vector3 interpolationInfo = this->Weights.Get(index);
-      //a vector3 holding the following:
-      // 0 the first id to load from input
-      // 1 the second id to load from input
-      // 2 the weight/ratio to interpolate from the two ids
+      const dax::exec::internal::InterpolationEdgeType edge =
+          this->Edges.Get(index);
 
       typedef typename InPortalType::ValueType InValueType;
       typedef typename OutPortalType::ValueType OutValueType;
 
-      const InValueType first = this->Input.Get(interpolationInfo[0]);
-      const InValueType second = this->Input.Get(interpolationInfo[1]);
+      const InValueType first =
+          this->Input.Get(dax::exec::internal::InterpolationEdgeFirst(edge));
+      const InValueType second =
+          this->Input.Get(dax::exec::internal::InterpolationEdgeSecond(edge));
 
       this->Output.Set(index,
-                       dax::math::Lerp(first,second,interpolationInfo[2]) );
+                       dax::math::Lerp(first,second,this->Ratios.Get(index)) );
     }
 
     DAX_CONT_EXPORT void SetErrorMessageBuffer(
         const dax::exec::internal::ErrorMessageBuffer &) {  }
 
-    InterpolationWeights Weights;
+    EdgePortalType Edges;
+    RatioPortalType Ratios;
     InPortalType Input;
     OutPortalType Output;
   };
 
+//-----------------------------------------------------------------------------
+// Kernels that weld interpolated points with an open addressing hash table
+// keyed on the edge (pair of input point ids) each point was interpolated
+// from. Every point records the slot of its edge, and each slot records the
+// smallest point index that maps to it. Using the smallest index (rather than
+// whichever insert wins) makes the result independent of scheduling order.
+
+namespace detail {
+
+typedef dax::exec::internal::InterpolationEdgeType EdgeHashKeyType;
+
+// Edges pack two non-negative ids, so a negative key is never a real edge.
+DAX_EXEC_EXPORT EdgeHashKeyType EdgeHashEmptyKey() { return -1; }
+
+DAX_EXEC_EXPORT dax::Id EdgeHashSlot(EdgeHashKeyType key, dax::Id mask)
+{
+  // 64-bit finalizer from MurmurHash3.
+  dax::internal::UInt64Type hash =
+      static_cast<dax::internal::UInt64Type>(key);
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return static_cast<dax::Id>(hash & static_cast<dax::internal::UInt64Type>(mask));
+}
+
+} // namespace detail
+
+struct EdgeHashClear
+{
+  DAX_CONT_EXPORT EdgeHashClear(detail::EdgeHashKeyType *keys,
+                                dax::Id *owners,
+                                dax::Id emptyOwner) :
+    Keys(keys),
+    Owners(owners),
+    EmptyOwner(emptyOwner)
+  {  }
+
+  DAX_EXEC_EXPORT void operator()(dax::Id index) const
+  {
+    this->Keys[index] = detail::EdgeHashEmptyKey();
+    this->Owners[index] = this->EmptyOwner;
+  }
+
+  DAX_CONT_EXPORT void SetErrorMessageBuffer(
+      const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+  detail::EdgeHashKeyType *Keys;
+  dax::Id *Owners;
+  dax::Id EmptyOwner;
+};
+
+template<class EdgePortalType, class SlotPortalType>
+struct EdgeHashInsert
+{
+  DAX_CONT_EXPORT EdgeHashInsert(const EdgePortalType &edges,
+                                 const SlotPortalType &slots,
+                                 detail::EdgeHashKeyType *keys,
+                                 dax::Id *owners,
+                                 dax::Id mask) :
+    Edges(edges),
+    Slots(slots),
+    Keys(keys),
+    Owners(owners),
+    Mask(mask)
+  {  }
+
+  DAX_EXEC_EXPORT void operator()(dax::Id index) const
+  {
+    const detail::EdgeHashKeyType key = this->Edges.Get(index);
+    dax::Id slot = detail::EdgeHashSlot(key, this->Mask);
+
+    // The table is at least twice the number of points, so an open slot
+    // is always found.
+    while (true)
+      {
+      const detail::EdgeHashKeyType previous =
+          dax::exec::internal::AtomicCompareAndSwap(
+            this->Keys + slot, detail::EdgeHashEmptyKey(), key);
+      if (previous == detail::EdgeHashEmptyKey() || previous == key)
+        {
+        dax::exec::internal::AtomicMin(this->Owners + slot, index);
+        this->Slots.Set(index, slot);
+        return;
+        }
+      slot = (slot + 1) & this->Mask;
+      }
+  }
+
+  DAX_CONT_EXPORT void SetErrorMessageBuffer(
+      const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+  EdgePortalType Edges;
+  SlotPortalType Slots;
+  detail::EdgeHashKeyType *Keys;
+  dax::Id *Owners;
+  dax::Id Mask;
+};
+
+template<class SlotPortalType, class FlagPortalType>
+struct EdgeHashMarkOwners
+{
+  DAX_CONT_EXPORT EdgeHashMarkOwners(const SlotPortalType &slots,
+                                     const dax::Id *owners,
+                                     const FlagPortalType &flags) :
+    Slots(slots),
+    Owners(owners),
+    Flags(flags)
+  {  }
+
+  DAX_EXEC_EXPORT void operator()(dax::Id index) const
+  {
+    const dax::Id owner = this->Owners[this->Slots.Get(index)];
+    this->Flags.Set(index, (owner == index) ? 1 : 0);
+  }
+
+  DAX_CONT_EXPORT void SetErrorMessageBuffer(
+      const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+  SlotPortalType Slots;
+  const dax::Id *Owners;
+  FlagPortalType Flags;
+};
+
+template<class SlotPortalType, class NewIdPortalType, class ConnectionPortalType>
+struct EdgeHashResolveConnections
+{
+  DAX_CONT_EXPORT EdgeHashResolveConnections(
+      const SlotPortalType &slots,
+      const dax::Id *owners,
+      const NewIdPortalType &newIds,
+      const ConnectionPortalType &connections) :
+    Slots(slots),
+    Owners(owners),
+    NewIds(newIds),
+    Connections(connections)
+  {  }
+
+  DAX_EXEC_EXPORT void operator()(dax::Id index) const
+  {
+    // Before welding, each connection is the index of its interpolated point.
+    const dax::Id point = this->Connections.Get(index);
+    const dax::Id owner = this->Owners[this->Slots.Get(point)];
+    this->Connections.Set(index, this->NewIds.Get(owner));
+  }
+
+  DAX_CONT_EXPORT void SetErrorMessageBuffer(
+      const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+  SlotPortalType Slots;
+  const dax::Id *Owners;
+  NewIdPortalType NewIds;
+  ConnectionPortalType Connections;
+};
+
 template< typename ReductionMapType >
 struct Offset2CountFunctor : dax::exec::internal::WorkletBase
 {
@@ -134,6 +324,100 @@ struct Offset2CountFunctor : dax::exec::internal::WorkletBase
   }
 };
 
+// Sets Unsorted[0] when any key is smaller than its predecessor. Every
+// writer stores the same value, so the race between them is benign.
+template< typename KeysPortalType >
+struct CheckKeysSortedFunctor : dax::exec::internal::WorkletBase
+{
+  KeysPortalType KeysPortal;
+  dax::Id *Unsorted;
+
+  CheckKeysSortedFunctor(KeysPortalType keysPortal, dax::Id *unsorted)
+    : KeysPortal(keysPortal), Unsorted(unsorted) {  }
+
+  DAX_EXEC_EXPORT
+  void operator()(dax::Id index) const {
+    if (this->KeysPortal.Get(index+1) < this->KeysPortal.Get(index))
+      {
+      *this->Unsorted = 1;
+      }
+  }
+};
+
+// Flags the first entry of every run of equal keys in a sorted key array.
+template< typename KeysPortalType, typename FlagsPortalType >
+struct MarkKeyGroupStartsFunctor : dax::exec::internal::WorkletBase
+{
+  KeysPortalType KeysPortal;
+  FlagsPortalType FlagsPortal;
+
+  MarkKeyGroupStartsFunctor(KeysPortalType keysPortal,
+                            FlagsPortalType flagsPortal)
+    : KeysPortal(keysPortal), FlagsPortal(flagsPortal) {  }
+
+  DAX_EXEC_EXPORT
+  void operator()(dax::Id index) const {
+    const bool groupStart = (index == 0) ||
+        !(this->KeysPortal.Get(index) == this->KeysPortal.Get(index-1));
+    this->FlagsPortal.Set(index, groupStart ? 1 : 0);
+  }
+};
+
+// Histograms keys known to lie in [0, KeyRange) into Counts.
+template< typename KeysPortalType >
+struct CountKeysInRangeFunctor : dax::exec::internal::WorkletBase
+{
+  KeysPortalType KeysPortal;
+  dax::Id *Counts;
+  dax::Id KeyRange;
+
+  CountKeysInRangeFunctor(KeysPortalType keysPortal,
+                          dax::Id *counts,
+                          dax::Id keyRange)
+    : KeysPortal(keysPortal), Counts(counts), KeyRange(keyRange) {  }
+
+  DAX_EXEC_EXPORT
+  void operator()(dax::Id index) const {
+    const dax::Id key = static_cast<dax::Id>(this->KeysPortal.Get(index));
+    if (key < 0 || key >= this->KeyRange)
+      {
+      this->RaiseError("Reduction key is outside of the declared key range.");
+      return;
+      }
+    dax::exec::internal::AtomicAdd(this->Counts + key, dax::Id(1));
+  }
+};
+
+// Places every input index in the slot its key owns. Cursors starts as the
+// exclusive scan of the key counts and is advanced atomically, so the order
+// of indices within one key is only deterministic on serial devices. Serial
+// devices should turn UseAtomics off: a locked add stalls on the scattered
+// store before it, which makes the pass an order of magnitude slower.
+template< typename KeysPortalType,
+          typename IndicesPortalType,
+          bool UseAtomics = true >
+struct ScatterKeysInRangeFunctor : dax::exec::internal::WorkletBase
+{
+  KeysPortalType KeysPortal;
+  dax::Id *Cursors;
+  IndicesPortalType IndicesPortal;
+
+  ScatterKeysInRangeFunctor(KeysPortalType keysPortal,
+                            dax::Id *cursors,
+                            IndicesPortalType indicesPortal)
+    : KeysPortal(keysPortal), Cursors(cursors), IndicesPortal(indicesPortal)
+    {  }
+
+  DAX_EXEC_EXPORT
+  void operator()(dax::Id index) const {
+    const dax::Id key = static_cast<dax::Id>(this->KeysPortal.Get(index));
+    const dax::Id slot = UseAtomics ?
+        dax::exec::internal::AtomicAdd(this->Cursors + key, dax::Id(1)) :
+        this->Cursors[key]++;
+    this->IndicesPortal.Set(slot, index);
+  }
+};
+
 }
 }
 }
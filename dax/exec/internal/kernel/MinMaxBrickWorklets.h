@@ -0,0 +1,142 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#ifndef __dax_exec_internal_kernel_MinMaxBrickWorklets_h
+#define __dax_exec_internal_kernel_MinMaxBrickWorklets_h
+
+#include <dax/Types.h>
+#include <dax/exec/BrickMask.h>
+#include <dax/exec/internal/ErrorMessageBuffer.h>
+
+namespace dax {
+namespace exec {
+namespace internal {
+namespace kernel {
+
+// Finds the smallest and largest value of a point field over each brick of
+// cells. A brick holds brickSize cells along each axis (fewer on the upper
+// boundary), so it touches brickSize+1 points along each axis and the points
+// on a brick face are shared with the neighbouring brick.
+template<class FieldPortalType, class RangePortalType>
+struct ComputeBrickRanges
+  {
+    DAX_CONT_EXPORT ComputeBrickRanges(const FieldPortalType &field,
+                                       const RangePortalType &ranges,
+                                       const dax::Id3 &pointDimensions,
+                                       const dax::Id3 &brickDimensions,
+                                       dax::Id brickSize) :
+    Field(field),
+    Ranges(ranges),
+    PointDimensions(pointDimensions),
+    BrickDimensions(brickDimensions),
+    BrickSize(brickSize)
+    {  }
+
+    DAX_EXEC_EXPORT void operator()(dax::Id brickIndex) const
+    {
+      const dax::Id3 brick(
+          brickIndex % this->BrickDimensions[0],
+          (brickIndex / this->BrickDimensions[0]) % this->BrickDimensions[1],
+          brickIndex / (this->BrickDimensions[0] * this->BrickDimensions[1]));
+
+      dax::Id3 first;
+      dax::Id3 last;
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        first[axis] = brick[axis] * this->BrickSize;
+        last[axis] = first[axis] + this->BrickSize;
+        if (last[axis] > this->PointDimensions[axis] - 1)
+          {
+          last[axis] = this->PointDimensions[axis] - 1;
+          }
+        }
+
+      const dax::Id rowSize = this->PointDimensions[0];
+      const dax::Id sliceSize = rowSize * this->PointDimensions[1];
+
+      dax::Scalar value = this->Field.Get(
+          first[0] + rowSize*first[1] + sliceSize*first[2]);
+      dax::Vector2 range(value, value);
+      for (dax::Id k = first[2]; k <= last[2]; ++k)
+        {
+        for (dax::Id j = first[1]; j <= last[1]; ++j)
+          {
+          const dax::Id rowStart = rowSize*j + sliceSize*k;
+          for (dax::Id i = first[0]; i <= last[0]; ++i)
+            {
+            value = this->Field.Get(rowStart + i);
+            range[0] = (value < range[0]) ? value : range[0];
+            range[1] = (value > range[1]) ? value : range[1];
+            }
+          }
+        }
+      this->Ranges.Set(brickIndex, range);
+    }
+
+    DAX_CONT_EXPORT void SetErrorMessageBuffer(
+        const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+    FieldPortalType Field;
+    RangePortalType Ranges;
+    dax::Id3 PointDimensions;
+    dax::Id3 BrickDimensions;
+    dax::Id BrickSize;
+  };
+
+// Saves where the range of each brick lies compared to the isovalue. The
+// test matches the marching cubes classification, where a vertex is inside
+// when its value is above the isovalue, so a brick is only cut when it has a
+// vertex at or below the isovalue and a vertex above it.
+template<class RangePortalType, class MaskPortalType>
+struct MarkActiveBricks
+  {
+    DAX_CONT_EXPORT MarkActiveBricks(const RangePortalType &ranges,
+                                     const MaskPortalType &mask,
+                                     dax::Scalar isoValue) :
+    Ranges(ranges),
+    Mask(mask),
+    IsoValue(isoValue)
+    {  }
+
+    DAX_EXEC_EXPORT void operator()(dax::Id brickIndex) const
+    {
+      const dax::Vector2 range = this->Ranges.Get(brickIndex);
+      dax::exec::BrickState state = dax::exec::BRICK_ACTIVE;
+      if (range[1] <= this->IsoValue)
+        {
+        state = dax::exec::BRICK_BELOW;
+        }
+      else if (range[0] > this->IsoValue)
+        {
+        state = dax::exec::BRICK_ABOVE;
+        }
+      this->Mask.Set(brickIndex, static_cast<unsigned char>(state));
+    }
+
+    DAX_CONT_EXPORT void SetErrorMessageBuffer(
+        const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+    RangePortalType Ranges;
+    MaskPortalType Mask;
+    dax::Scalar IsoValue;
+  };
+
+}
+}
+}
+} //dax::exec::internal::kernel
+
+#endif // __dax_exec_internal_kernel_MinMaxBrickWorklets_h
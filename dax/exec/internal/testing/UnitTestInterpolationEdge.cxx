@@ -0,0 +1,128 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#include <dax/exec/internal/InterpolationEdge.h>
+
+#include <dax/exec/InterpolatedCellPoints.h>
+
+#include <dax/testing/Testing.h>
+
+namespace {
+
+void CheckEdge(dax::Id first, dax::Id second)
+{
+  const dax::Id smaller = (first < second) ? first : second;
+  const dax::Id larger = (first < second) ? second : first;
+
+  const dax::exec::internal::InterpolationEdgeType edge =
+      dax::exec::internal::MakeInterpolationEdge(first, second);
+  DAX_TEST_ASSERT(edge >= 0, "Edge key is negative.");
+  DAX_TEST_ASSERT(edge == dax::exec::internal::MakeInterpolationEdge(second,
+                                                                      first),
+                  "Edge key depends on point order.");
+  DAX_TEST_ASSERT(
+        dax::exec::internal::InterpolationEdgeFirst(edge) == smaller,
+        "Got bad first point of edge.");
+  DAX_TEST_ASSERT(
+        dax::exec::internal::InterpolationEdgeSecond(edge) == larger,
+        "Got bad second point of edge.");
+}
+
+void TestEdgeKeys()
+{
+  std::cout << "Checking edge keys." << std::endl;
+  const dax::Id ids[] = { 0, 1, 2, 1000,
+                          (1 << 24) - 1, (1 << 24), (1 << 24) + 1,
+                          (1 << 30) + 7, 0x7fffffff };
+  const int numIds = sizeof(ids)/sizeof(ids[0]);
+  for (int i = 0; i < numIds; ++i)
+    {
+    for (int j = 0; j < numIds; ++j)
+      {
+      CheckEdge(ids[i], ids[j]);
+      }
+    }
+
+  std::cout << "Checking edge key order." << std::endl;
+  using dax::exec::internal::MakeInterpolationEdge;
+  DAX_TEST_ASSERT(MakeInterpolationEdge(1, 5) < MakeInterpolationEdge(1, 6),
+                  "Edges not ordered by second point.");
+  DAX_TEST_ASSERT(MakeInterpolationEdge(1, 0x7fffffff)
+                  < MakeInterpolationEdge(2, 3),
+                  "Edges not ordered by first point.");
+
+  std::cout << "Checking the packable range." << std::endl;
+  using dax::exec::internal::InterpolationEdgeCanHold;
+  const dax::internal::Int64Type maxPoints =
+      static_cast<dax::internal::Int64Type>(1) << 31;
+  DAX_TEST_ASSERT(InterpolationEdgeCanHold(0), "Empty grid not packable.");
+  DAX_TEST_ASSERT(InterpolationEdgeCanHold(maxPoints),
+                  "Largest id 0x7fffffff not packable.");
+  DAX_TEST_ASSERT(!InterpolationEdgeCanHold(maxPoints + 1),
+                  "Id 2^31 packable.");
+}
+
+void TestInterpolatedCellPoints()
+{
+  std::cout << "Checking interpolated cell points." << std::endl;
+  const dax::Id large = (1 << 24) + 1;
+
+  dax::exec::InterpolatedCellPoints<dax::CellTagLine> points;
+  points.SetInterpolationPoint(0, large, large + 2, 0.25f);
+  points.SetInterpolationPoint(1, large + 2, large, 0.25f);
+
+  for (int vertex = 0; vertex < 2; ++vertex)
+    {
+    const dax::exec::internal::InterpolationEdgeType edge =
+        points.GetInterpolationEdge(vertex);
+    DAX_TEST_ASSERT(edge == points.GetEdges()[vertex],
+                    "Edge tuple does not match edge.");
+    DAX_TEST_ASSERT(dax::exec::internal::InterpolationEdgeFirst(edge) == large,
+                    "Got bad first point id.");
+    DAX_TEST_ASSERT(
+          dax::exec::internal::InterpolationEdgeSecond(edge) == large + 2,
+          "Got bad second point id.");
+    }
+  DAX_TEST_ASSERT(test_equal(points.GetInterpolationRatio(0),
+                             dax::Scalar(0.25)),
+                  "Got bad weight.");
+  DAX_TEST_ASSERT(test_equal(points.GetInterpolationRatio(1),
+                             dax::Scalar(0.75)),
+                  "Weight not flipped with reversed edge.");
+
+  std::cout << "Checking ids past the range of a 32 bit float." << std::endl;
+  const dax::Id largest = 0x7fffffff;
+  points.SetInterpolationPoint(0, largest, largest - 1, 0.5f);
+  DAX_TEST_ASSERT(dax::exec::internal::InterpolationEdgeFirst(
+                    points.GetInterpolationEdge(0)) == largest - 1,
+                  "Got bad first point id.");
+  DAX_TEST_ASSERT(dax::exec::internal::InterpolationEdgeSecond(
+                    points.GetInterpolationEdge(0)) == largest,
+                  "Got bad second point id.");
+}
+
+void TestInterpolationEdge()
+{
+  TestEdgeKeys();
+  TestInterpolatedCellPoints();
+}
+
+} // anonymous namespace
+
+int UnitTestInterpolationEdge(int, char *[])
+{
+  return dax::testing::Testing::Run(TestInterpolationEdge);
+}
@@ -47,6 +47,25 @@
 /// is providing a specialization that does not need that parameter.
 #define daxNotUsed(parameter_name)
 
+/// Placed before a loop whose iterations are independent of each other, as
+/// in a loop along a row of voxels. It tells the compiler that it may
+/// vectorize the loop without proving that the arrays written in it do not
+/// alias the arrays read.
+#if defined(DAX_CUDA)
+#define DAX_SIMD_LOOP
+#elif defined(DAX_OPENMP) && (_OPENMP >= 201307)
+#define DAX_SIMD_LOOP _Pragma("omp simd")
+#elif defined(__INTEL_COMPILER)
+#define DAX_SIMD_LOOP _Pragma("ivdep")
+#elif defined(__clang__)
+#define DAX_SIMD_LOOP _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__) && \
+  ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define DAX_SIMD_LOOP _Pragma("GCC ivdep")
+#else
+#define DAX_SIMD_LOOP
+#endif
+
 
 // Check boost support under CUDA
 #ifdef DAX_CUDA
@@ -0,0 +1,266 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_io_ArrayContainerControlMemoryMapped_h
+#define __dax_io_ArrayContainerControlMemoryMapped_h
+
+#include <dax/Types.h>
+
+#include <dax/cont/ArrayContainerControl.h>
+#include <dax/cont/Assert.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/internal/IteratorFromArrayPortal.h>
+
+#include <dax/io/DataType.h>
+#include <dax/io/ErrorIO.h>
+#include <dax/io/internal/MemoryMappedFile.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace dax {
+namespace io {
+
+/// \brief A tag for read-only arrays whose values live in a memory-mapped
+/// file.
+///
+/// An ArrayHandle with this container tag reads its values directly out of
+/// the pages of a file mapped with \c mmap. Nothing is read from disk until a
+/// value is first accessed, and no copy of the data is ever made in the
+/// control environment. When the values in the file do not match the value
+/// type of the array (or are stored with a foreign byte order), they are
+/// converted as they are read.
+///
+/// Like implicit arrays, the ArrayHandle holds the portal rather than the
+/// container, so the handle must be constructed with an \c
+/// ArrayPortalMemoryMapped (see \c ArrayHandleMemoryMapped). Any operation
+/// that tries to modify the array raises an error. Device adapters that do
+/// not share memory with the control environment copy the values to the
+/// device as they would any other array.
+///
+struct ArrayContainerControlTagMemoryMapped {  };
+
+namespace internal {
+
+/// \brief An array portal that reads values out of a memory-mapped file.
+///
+/// The portal keeps the mapping alive for as long as any copy of it exists.
+///
+template<typename T>
+class ArrayPortalMemoryMapped
+{
+public:
+  typedef T ValueType;
+
+  DAX_CONT_EXPORT
+  ArrayPortalMemoryMapped()
+    : Data(NULL),
+      NumberOfValues(0),
+      Type(DataTypeOf<ValueType>::Type),
+      ValueSize(sizeof(ValueType)),
+      SwapBytes(false),
+      Direct(true)
+  {  }
+
+  /// Creates a portal over \p numberOfValues values of type \p type starting
+  /// \p offset bytes into \p file.
+  ///
+  DAX_CONT_EXPORT
+  ArrayPortalMemoryMapped(
+      boost::shared_ptr<const dax::io::internal::MemoryMappedFile> file,
+      std::size_t offset,
+      dax::Id numberOfValues,
+      dax::io::DataType type = DataTypeOf<T>::Type,
+      dax::io::ByteOrder byteOrder = dax::io::nativeByteOrder())
+    : File(file),
+      Data(NULL),
+      NumberOfValues(numberOfValues),
+      Type(type),
+      ValueSize(dax::io::dataTypeSize(type)),
+      SwapBytes(byteOrder != dax::io::nativeByteOrder() && this->ValueSize > 1),
+      Direct(type == DataTypeOf<ValueType>::Type && !this->SwapBytes)
+  {
+    if (this->ValueSize == 0)
+      {
+      throw dax::io::ErrorIO("Unknown data type for memory-mapped array.");
+      }
+    if (numberOfValues < 0)
+      {
+      throw dax::io::ErrorIO("Invalid size for memory-mapped array.");
+      }
+    const std::size_t requiredSize =
+        offset + static_cast<std::size_t>(numberOfValues) * this->ValueSize;
+    if (!this->File || requiredSize > this->File->GetSize())
+      {
+      std::stringstream message;
+      message << "Memory-mapped array needs " << requiredSize << " bytes but "
+              << (this->File ? this->File->GetFileName() : std::string("file"))
+              << " only has "
+              << (this->File ? this->File->GetSize() : 0) << ".";
+      throw dax::io::ErrorIO(message.str());
+      }
+    this->Data = this->File->GetData() + offset;
+  }
+
+  DAX_CONT_EXPORT
+  dax::Id GetNumberOfValues() const { return this->NumberOfValues; }
+
+  DAX_CONT_EXPORT
+  ValueType Get(dax::Id index) const {
+    DAX_ASSERT_CONT(index >= 0);
+    DAX_ASSERT_CONT(index < this->GetNumberOfValues());
+    const char *location = this->Data + index*this->ValueSize;
+    if (this->Direct)
+      {
+      // The memcpy handles unaligned offsets and compiles to a plain load.
+      ValueType value;
+      std::memcpy(&value, location, sizeof(ValueType));
+      return value;
+      }
+    switch (this->Type)
+      {
+      case DATA_TYPE_INT8:    return this->Convert<signed char>(location);
+      case DATA_TYPE_UINT8:   return this->Convert<unsigned char>(location);
+      case DATA_TYPE_INT16:   return this->Convert<short>(location);
+      case DATA_TYPE_UINT16:  return this->Convert<unsigned short>(location);
+      case DATA_TYPE_INT32:
+        return this->Convert<dax::internal::Int32Type>(location);
+      case DATA_TYPE_UINT32:
+        return this->Convert<dax::internal::UInt32Type>(location);
+      case DATA_TYPE_INT64:
+        return this->Convert<dax::internal::Int64Type>(location);
+      case DATA_TYPE_UINT64:
+        return this->Convert<dax::internal::UInt64Type>(location);
+      case DATA_TYPE_FLOAT32: return this->Convert<float>(location);
+      case DATA_TYPE_FLOAT64: return this->Convert<double>(location);
+      case DATA_TYPE_UNKNOWN:
+      default:                return ValueType();
+      }
+  }
+
+  typedef dax::cont::internal::IteratorFromArrayPortal<
+      ArrayPortalMemoryMapped<T> > IteratorType;
+
+  DAX_CONT_EXPORT
+  IteratorType GetIteratorBegin() const
+  {
+    return IteratorType(*this);
+  }
+
+  DAX_CONT_EXPORT
+  IteratorType GetIteratorEnd() const
+  {
+    return IteratorType(*this, this->NumberOfValues);
+  }
+
+  /// Returns true if values are read straight out of the file without any
+  /// conversion or byte swapping.
+  ///
+  DAX_CONT_EXPORT
+  bool IsDirect() const { return this->Direct; }
+
+  DAX_CONT_EXPORT
+  boost::shared_ptr<const dax::io::internal::MemoryMappedFile> GetFile() const
+  {
+    return this->File;
+  }
+
+private:
+  template<typename FileValueType>
+  DAX_CONT_EXPORT
+  ValueType Convert(const char *location) const
+  {
+    FileValueType value;
+    if (this->SwapBytes)
+      {
+      char bytes[sizeof(FileValueType)];
+      std::reverse_copy(location, location + sizeof(FileValueType), bytes);
+      std::memcpy(&value, bytes, sizeof(FileValueType));
+      }
+    else
+      {
+      std::memcpy(&value, location, sizeof(FileValueType));
+      }
+    return static_cast<ValueType>(value);
+  }
+
+  boost::shared_ptr<const dax::io::internal::MemoryMappedFile> File;
+  const char *Data;
+  dax::Id NumberOfValues;
+  dax::io::DataType Type;
+  std::size_t ValueSize;
+  bool SwapBytes;
+  bool Direct;
+};
+
+}
+}
+} // namespace dax::io::internal
+
+namespace dax {
+namespace cont {
+namespace internal {
+
+template<typename T>
+class ArrayContainerControl<T, dax::io::ArrayContainerControlTagMemoryMapped>
+{
+public:
+  typedef T ValueType;
+  typedef dax::io::internal::ArrayPortalMemoryMapped<ValueType> PortalConstType;
+
+  // This is meant to be invalid. Because memory-mapped arrays are read only,
+  // you should only be able to use the const version.
+  struct PortalType {
+    typedef void *ValueType;
+    typedef void *IteratorType;
+  };
+
+  // All these methods do nothing but raise errors.
+  PortalType GetPortal() {
+    throw dax::cont::ErrorControlBadValue("Memory-mapped arrays are read-only.");
+  }
+  PortalConstType GetPortalConst() const {
+    // This does not work because the ArrayHandle holds the constant
+    // ArrayPortal, not the container.
+    throw dax::cont::ErrorControlBadValue(
+          "Memory-mapped container does not store array portal.  "
+          "Perhaps you did not set the ArrayPortal when "
+          "constructing the ArrayHandle.");
+  }
+  dax::Id GetNumberOfValues() const {
+    throw dax::cont::ErrorControlBadValue(
+          "Memory-mapped container does not store array portal.  "
+          "Perhaps you did not set the ArrayPortal when "
+          "constructing the ArrayHandle.");
+  }
+  void Allocate(dax::Id daxNotUsed(numberOfValues)) {
+    throw dax::cont::ErrorControlBadValue("Memory-mapped arrays are read-only.");
+  }
+  void Shrink(dax::Id daxNotUsed(numberOfValues)) {
+    throw dax::cont::ErrorControlBadValue("Memory-mapped arrays are read-only.");
+  }
+  void ReleaseResources() {
+    throw dax::cont::ErrorControlBadValue("Memory-mapped arrays are read-only.");
+  }
+};
+
+}
+}
+} // namespace dax::cont::internal
+
+#endif //__dax_io_ArrayContainerControlMemoryMapped_h
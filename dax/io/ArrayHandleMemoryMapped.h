@@ -0,0 +1,142 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_io_ArrayHandleMemoryMapped_h
+#define __dax_io_ArrayHandleMemoryMapped_h
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/arg/FieldArrayHandle.h>
+#include <dax/io/ArrayContainerControlMemoryMapped.h>
+
+namespace dax {
+namespace io {
+
+/// ArrayHandleMemoryMapped is a specialization of ArrayHandle that reads its
+/// values directly out of a memory-mapped file. The array is read-only.
+///
+template <typename T,
+          class DeviceAdapterTag = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+class ArrayHandleMemoryMapped
+    : public dax::cont::ArrayHandle<
+          T,
+          dax::io::ArrayContainerControlTagMemoryMapped,
+          DeviceAdapterTag>
+{
+  typedef dax::cont::ArrayHandle<
+          T,
+          dax::io::ArrayContainerControlTagMemoryMapped,
+          DeviceAdapterTag> Superclass;
+public:
+  typedef dax::io::internal::MemoryMappedFile MappedFileType;
+
+  /// Creates an array of \p numberOfValues values of type \p type found \p
+  /// offset bytes into \p file.
+  ///
+  ArrayHandleMemoryMapped(boost::shared_ptr<const MappedFileType> file,
+                          std::size_t offset,
+                          dax::Id numberOfValues,
+                          dax::io::DataType type = DataTypeOf<T>::Type,
+                          dax::io::ByteOrder byteOrder = nativeByteOrder())
+    : Superclass(typename Superclass::PortalConstControl(
+                   file, offset, numberOfValues, type, byteOrder))
+  {  }
+
+  ArrayHandleMemoryMapped() : Superclass() {  }
+};
+
+/// A convenience function that maps \p fileName and creates an
+/// ArrayHandleMemoryMapped over \p numberOfValues values of type \p type
+/// that start \p offset bytes into the file.
+///
+template<typename T, typename DeviceAdapterTag>
+DAX_CONT_EXPORT
+dax::io::ArrayHandleMemoryMapped<T,DeviceAdapterTag>
+make_ArrayHandleMemoryMapped(const std::string &fileName,
+                             std::size_t offset,
+                             dax::Id numberOfValues,
+                             dax::io::DataType type,
+                             dax::io::ByteOrder byteOrder,
+                             DeviceAdapterTag)
+{
+  boost::shared_ptr<const dax::io::internal::MemoryMappedFile> file(
+        new dax::io::internal::MemoryMappedFile(fileName));
+  return dax::io::ArrayHandleMemoryMapped<T,DeviceAdapterTag>(
+        file, offset, numberOfValues, type, byteOrder);
+}
+
+template<typename T>
+DAX_CONT_EXPORT
+dax::io::ArrayHandleMemoryMapped<T,DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+make_ArrayHandleMemoryMapped(const std::string &fileName,
+                             std::size_t offset,
+                             dax::Id numberOfValues,
+                             dax::io::DataType type = DataTypeOf<T>::Type,
+                             dax::io::ByteOrder byteOrder = nativeByteOrder())
+{
+  return make_ArrayHandleMemoryMapped<T>(fileName,
+                                         offset,
+                                         numberOfValues,
+                                         type,
+                                         byteOrder,
+                                         DAX_DEFAULT_DEVICE_ADAPTER_TAG());
+}
+
+}
+} // namespace dax::io
+
+namespace dax { namespace cont { namespace arg {
+
+// The concept maps live with the array handle so that dispatchers can take
+// an ArrayHandleMemoryMapped without dax/cont depending on dax/io.
+
+/// \headerfile ArrayHandleMemoryMapped.h dax/io/ArrayHandleMemoryMapped.h
+/// \brief Map a memory-mapped array to \c Field worklet parameters.
+template <typename Tags, typename T, typename Device>
+class ConceptMap< Field(Tags), dax::io::ArrayHandleMemoryMapped<T, Device> > :
+  public ConceptMap< Field(Tags), dax::cont::ArrayHandle < T,
+                          dax::io::ArrayContainerControlTagMemoryMapped,
+                          Device > >
+{
+  typedef ConceptMap< Field(Tags), dax::cont::ArrayHandle < T,
+                          dax::io::ArrayContainerControlTagMemoryMapped,
+                          Device > > superclass;
+  typedef dax::io::ArrayHandleMemoryMapped<T, Device> HandleType;
+public:
+  ConceptMap(HandleType handle):
+    superclass(handle)
+    {}
+};
+
+/// \headerfile ArrayHandleMemoryMapped.h dax/io/ArrayHandleMemoryMapped.h
+/// \brief Map a memory-mapped array to \c Field worklet parameters.
+template <typename Tags, typename T, typename Device>
+class ConceptMap< Field(Tags), const dax::io::ArrayHandleMemoryMapped<T, Device> > :
+  public ConceptMap< Field(Tags), const dax::cont::ArrayHandle < T,
+                          dax::io::ArrayContainerControlTagMemoryMapped,
+                          Device > >
+{
+  typedef ConceptMap< Field(Tags), const dax::cont::ArrayHandle < T,
+                          dax::io::ArrayContainerControlTagMemoryMapped,
+                          Device > > superclass;
+  typedef dax::io::ArrayHandleMemoryMapped<T, Device> HandleType;
+public:
+  ConceptMap(HandleType handle):
+    superclass(handle)
+    {}
+};
+
+} } } //namespace dax::cont::arg
+
+#endif //__dax_io_ArrayHandleMemoryMapped_h
@@ -0,0 +1,114 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_io_DataType_h
+#define __dax_io_DataType_h
+
+#include <dax/Types.h>
+
+#include <cstddef>
+
+namespace dax {
+namespace io {
+
+/// Identifies the type of the values stored in a file. Readers use this to
+/// convert (or not) the stored values to the value type requested by the
+/// ArrayHandle.
+///
+enum DataType {
+  DATA_TYPE_UNKNOWN,
+  DATA_TYPE_INT8,
+  DATA_TYPE_UINT8,
+  DATA_TYPE_INT16,
+  DATA_TYPE_UINT16,
+  DATA_TYPE_INT32,
+  DATA_TYPE_UINT32,
+  DATA_TYPE_INT64,
+  DATA_TYPE_UINT64,
+  DATA_TYPE_FLOAT32,
+  DATA_TYPE_FLOAT64
+};
+
+/// Identifies the byte order of the values stored in a file.
+///
+enum ByteOrder {
+  BYTE_ORDER_LITTLE_ENDIAN,
+  BYTE_ORDER_BIG_ENDIAN
+};
+
+/// Returns the number of bytes used to store one value of the given type.
+///
+DAX_CONT_EXPORT
+std::size_t dataTypeSize(dax::io::DataType type)
+{
+  switch (type)
+    {
+    case DATA_TYPE_INT8:
+    case DATA_TYPE_UINT8:   return 1;
+    case DATA_TYPE_INT16:
+    case DATA_TYPE_UINT16:  return 2;
+    case DATA_TYPE_INT32:
+    case DATA_TYPE_UINT32:
+    case DATA_TYPE_FLOAT32: return 4;
+    case DATA_TYPE_INT64:
+    case DATA_TYPE_UINT64:
+    case DATA_TYPE_FLOAT64: return 8;
+    case DATA_TYPE_UNKNOWN:
+    default:                return 0;
+    }
+}
+
+/// Returns the byte order of the machine running the control environment.
+///
+DAX_CONT_EXPORT
+dax::io::ByteOrder nativeByteOrder()
+{
+  const dax::internal::UInt32Type probe = 1;
+  return (*reinterpret_cast<const unsigned char *>(&probe) == 1)
+      ? BYTE_ORDER_LITTLE_ENDIAN : BYTE_ORDER_BIG_ENDIAN;
+}
+
+/// Maps a C++ value type to its \c DataType. The default is \c
+/// DATA_TYPE_UNKNOWN, which simply means values of that type are never read
+/// directly out of a file without conversion.
+///
+template<typename T>
+struct DataTypeOf { static const dax::io::DataType Type = DATA_TYPE_UNKNOWN; };
+
+template<> struct DataTypeOf<signed char>
+  { static const dax::io::DataType Type = DATA_TYPE_INT8; };
+template<> struct DataTypeOf<unsigned char>
+  { static const dax::io::DataType Type = DATA_TYPE_UINT8; };
+template<> struct DataTypeOf<short>
+  { static const dax::io::DataType Type = DATA_TYPE_INT16; };
+template<> struct DataTypeOf<unsigned short>
+  { static const dax::io::DataType Type = DATA_TYPE_UINT16; };
+template<> struct DataTypeOf<dax::internal::Int32Type>
+  { static const dax::io::DataType Type = DATA_TYPE_INT32; };
+template<> struct DataTypeOf<dax::internal::UInt32Type>
+  { static const dax::io::DataType Type = DATA_TYPE_UINT32; };
+template<> struct DataTypeOf<dax::internal::Int64Type>
+  { static const dax::io::DataType Type = DATA_TYPE_INT64; };
+template<> struct DataTypeOf<dax::internal::UInt64Type>
+  { static const dax::io::DataType Type = DATA_TYPE_UINT64; };
+template<> struct DataTypeOf<float>
+  { static const dax::io::DataType Type = DATA_TYPE_FLOAT32; };
+template<> struct DataTypeOf<double>
+  { static const dax::io::DataType Type = DATA_TYPE_FLOAT64; };
+
+}
+} // namespace dax::io
+
+#endif //__dax_io_DataType_h
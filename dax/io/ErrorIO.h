@@ -8,35 +8,30 @@
 //  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
 //  PURPOSE.  See the above copyright notice for more information.
 //
-//  Copyright 2012 Sandia Corporation.
+//  Copyright 2013 Sandia Corporation.
 //  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
 //  the U.S. Government retains certain rights in this software.
 //
 //=============================================================================
+#ifndef __dax_io_ErrorIO_h
+#define __dax_io_ErrorIO_h
 
-namespace dax { namespace testing {
+#include <dax/cont/ErrorControl.h>
 
-class ArgumentsParser
+namespace dax {
+namespace io {
+
+/// This class is thrown when a Dax reader or writer fails to open, parse, or
+/// map a file.
+///
+class ErrorIO : public dax::cont::ErrorControl
 {
 public:
-  ArgumentsParser();
-  virtual ~ArgumentsParser();
-
-  bool parseArguments(int argc, char* argv[]);
-
-  unsigned int problemSize() const
-    { return this->ProblemSize; }
-
-  enum PipelineMode
-    {
-    CELL_THRESHOLD = 1
-    };
-  PipelineMode pipeline() const
-    { return this->Pipeline; }
-
-private:
-  unsigned int ProblemSize;
-  PipelineMode Pipeline;
+  ErrorIO(const std::string &message)
+    : ErrorControl(message) { }
 };
 
-}}
+}
+} // namespace dax::io
+
+#endif //__dax_io_ErrorIO_h
@@ -0,0 +1,322 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_io_MarchingCubesOutOfCore_h
+#define __dax_io_MarchingCubesOutOfCore_h
+
+#include <dax/CellTag.h>
+#include <dax/Types.h>
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleTransform.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/DispatcherGenerateInterpolatedCells.h>
+#include <dax/cont/DispatcherMapCell.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/UniformGrid.h>
+#include <dax/cont/UnstructuredGrid.h>
+
+#include <dax/exec/internal/InterpolationEdge.h>
+
+#include <dax/io/ReaderVolume.h>
+#include <dax/io/internal/MemoryMappedFile.h>
+
+#include <dax/worklet/MarchingCubes.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace dax {
+namespace io {
+
+/// \brief Runs marching cubes on a volume one z slab at a time.
+///
+/// The point field of a volume opened with a \c ReaderVolume is memory
+/// mapped. Rather than contour the whole volume at once (which needs
+/// dispatcher temporaries proportional to the whole volume), this class
+/// walks it in slabs of \c SlabDepth cell layers. Neighboring slabs share
+/// one plane of points, so every cell is contoured exactly once. The
+/// triangles of every slab are stitched into one output grid, and points
+/// that lie on the shared plane between two slabs are merged.
+///
+/// While a slab is being contoured, the pages of the next slab are read
+/// ahead in the background (\c MADV_WILLNEED), and once a slab is finished
+/// its pages are dropped from the resident set. Peak memory is therefore
+/// bounded by the slab size plus the output.
+///
+template<class DeviceAdapterTag = DAX_DEFAULT_DEVICE_ADAPTER_TAG>
+class MarchingCubesOutOfCore
+{
+public:
+  typedef dax::cont::UnstructuredGrid<
+      dax::CellTagTriangle,
+      dax::cont::ArrayContainerControlTagBasic,
+      dax::cont::ArrayContainerControlTagBasic,
+      DeviceAdapterTag> OutputGridType;
+
+  DAX_CONT_EXPORT
+  MarchingCubesOutOfCore(const dax::io::ReaderVolume &reader,
+                         dax::Scalar isoValue)
+    : Reader(reader),
+      IsoValue(isoValue),
+      SlabDepth(32),
+      Prefetch(true),
+      NumberOfSlabs(0)
+  {  }
+
+  /// The number of cell layers contoured at once.
+  ///
+  DAX_CONT_EXPORT
+  void SetSlabDepth(dax::Id cellLayers) { this->SlabDepth = cellLayers; }
+  DAX_CONT_EXPORT
+  dax::Id GetSlabDepth() const { return this->SlabDepth; }
+
+  /// When on (the default), the next slab is read ahead while the current
+  /// one is contoured and finished slabs are evicted.
+  ///
+  DAX_CONT_EXPORT
+  void SetPrefetch(bool prefetch) { this->Prefetch = prefetch; }
+  DAX_CONT_EXPORT
+  bool GetPrefetch() const { return this->Prefetch; }
+
+  /// The number of slabs contoured by the last call to \c Run.
+  ///
+  DAX_CONT_EXPORT
+  dax::Id GetNumberOfSlabs() const { return this->NumberOfSlabs; }
+
+  /// Contours the volume into \p outGrid.
+  ///
+  DAX_CONT_EXPORT
+  void Run(OutputGridType &outGrid)
+  {
+    typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag> Algorithm;
+
+    this->NumberOfSlabs = 0;
+    this->Points.clear();
+    this->Connections.clear();
+    this->Seam.clear();
+
+    const dax::Id3 dims = this->Reader.GetDimensions();
+    if (dims[0] > 1 && dims[1] > 1 && dims[2] > 1)
+      {
+      const dax::Id depth = this->GetUsableSlabDepth(dims);
+      boost::shared_ptr<const dax::io::internal::MemoryMappedFile> file =
+          this->Reader.GetMappedFile();
+      const dax::Id lastPlane = dims[2] - 1;
+
+      for (dax::Id zMin = 0; zMin < lastPlane; zMin += depth)
+        {
+        const dax::Id zMax = std::min(zMin + depth, lastPlane);
+        if (this->Prefetch && zMax < lastPlane)
+          {
+          const dax::Id nextZMax = std::min(zMax + depth, lastPlane);
+          file->Advise(dax::io::internal::MemoryMappedFile::ACCESS_WILL_NEED,
+                       this->Reader.GetSlabOffset(zMax),
+                       this->Reader.GetSlabOffset(nextZMax + 1)
+                       - this->Reader.GetSlabOffset(zMax));
+          }
+
+        this->ContourSlab(zMin, zMax, zMax == lastPlane);
+        ++this->NumberOfSlabs;
+
+        if (this->Prefetch)
+          {
+          // Keep plane zMax; it is the first plane of the next slab.
+          file->Advise(dax::io::internal::MemoryMappedFile::ACCESS_DONT_NEED,
+                       this->Reader.GetSlabOffset(zMin),
+                       this->Reader.GetSlabOffset(zMax)
+                       - this->Reader.GetSlabOffset(zMin));
+          }
+        }
+      }
+
+    // Move the stitched output into the grid.
+    if (this->Points.empty())
+      {
+      outGrid = OutputGridType();
+      }
+    else
+      {
+      Algorithm::Copy(dax::cont::make_ArrayHandle(
+                        this->Points,
+                        dax::cont::ArrayContainerControlTagBasic(),
+                        DeviceAdapterTag()),
+                      outGrid.GetPointCoordinates());
+      Algorithm::Copy(dax::cont::make_ArrayHandle(
+                        this->Connections,
+                        dax::cont::ArrayContainerControlTagBasic(),
+                        DeviceAdapterTag()),
+                      outGrid.GetCellConnections());
+      }
+    std::vector<dax::Vector3>().swap(this->Points);
+    std::vector<dax::Id>().swap(this->Connections);
+    this->Seam.clear();
+  }
+
+private:
+  typedef std::pair<dax::Id,dax::Id> EdgeType;
+  typedef std::map<EdgeType,dax::Id> SeamType;
+
+  typedef dax::cont::ArrayHandle<dax::Id,
+      dax::cont::ArrayContainerControlTagBasic,
+      DeviceAdapterTag> CountHandleType;
+  typedef dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType,
+      dax::cont::ArrayContainerControlTagBasic,
+      DeviceAdapterTag> CaseHandleType;
+  typedef dax::cont::ArrayHandleTransform<dax::Id,
+      CaseHandleType,
+      dax::worklet::MarchingCubesCaseFaceCount,
+      DeviceAdapterTag> CaseCountHandleType;
+  typedef dax::cont::DispatcherGenerateInterpolatedCells<
+      dax::worklet::MarchingCubesGenerateFromCases,
+      CaseCountHandleType,
+      DeviceAdapterTag> DispatcherIC;
+  typedef typename DispatcherIC::InterpolationEdgesType
+      InterpolationEdgesType;
+
+  // Interpolation edges pack each point id of a slab into 31 bits (see
+  // dax::exec::internal::InterpolationEdgeCanHold). Keep each slab below
+  // that.
+  DAX_CONT_EXPORT
+  dax::Id GetUsableSlabDepth(const dax::Id3 &dims) const
+  {
+    typedef dax::internal::Int64Type Int64Type;
+    const Int64Type maxId = Int64Type(1) << 31;
+    const Int64Type planeSize = Int64Type(dims[0])*dims[1];
+    if (!dax::exec::internal::InterpolationEdgeCanHold(2*planeSize))
+      {
+      throw dax::cont::ErrorControlBadValue(
+            "Volume planes are too large to contour out of core.");
+      }
+    dax::Id depth = std::max(this->SlabDepth, dax::Id(1));
+    depth = std::min(depth, dims[2] - 1);
+    depth = static_cast<dax::Id>(
+          std::min(Int64Type(depth), maxId / planeSize - 1));
+    return depth;
+  }
+
+  DAX_CONT_EXPORT
+  void ContourSlab(dax::Id zMin, dax::Id zMax, bool lastSlab)
+  {
+    dax::cont::UniformGrid<DeviceAdapterTag> grid =
+        this->Reader.GetSlabGrid(zMin, zMax, DeviceAdapterTag());
+    dax::io::ArrayHandleMemoryMapped<dax::Scalar,DeviceAdapterTag> field =
+        this->Reader.template GetPointFieldSlab<dax::Scalar>(
+          zMin, zMax, DeviceAdapterTag());
+
+    // Classify each cell once. The generate step reads the cached case and
+    // only touches the field values on the cut edges.
+    CaseHandleType cases;
+    dax::cont::DispatcherMapCell<
+        dax::worklet::MarchingCubesClassify,
+        DeviceAdapterTag>(dax::worklet::MarchingCubesClassify(this->IsoValue))
+        .Invoke(grid, field, cases);
+
+    OutputGridType slabGrid;
+    DispatcherIC icDispatcher(
+          CaseCountHandleType(cases),
+          dax::worklet::MarchingCubesGenerateFromCases(this->IsoValue));
+    icDispatcher.SetRemoveDuplicatePoints(true);
+    icDispatcher.Invoke(grid, slabGrid, cases,
+                        dax::worklet::make_MarchingCubesPointValues(field));
+
+    SeamType nextSeam;
+    if (slabGrid.GetNumberOfCells() > 0)
+      {
+      this->StitchSlab(zMin, zMax, lastSlab,
+                       slabGrid, icDispatcher.GetInterpolationEdges(),
+                       nextSeam);
+      }
+    this->Seam.swap(nextSeam);
+  }
+
+  DAX_CONT_EXPORT
+  void StitchSlab(dax::Id zMin,
+                  dax::Id zMax,
+                  bool lastSlab,
+                  OutputGridType &slabGrid,
+                  InterpolationEdgesType edges,
+                  SeamType &nextSeam)
+  {
+    const dax::Id3 dims = this->Reader.GetDimensions();
+    const dax::Id planeSize = dims[0]*dims[1];
+    const dax::Id slabOffset = zMin*planeSize;
+    const dax::Id topPlaneStart = (zMax - zMin)*planeSize;
+
+    typename OutputGridType::PointCoordinatesType::PortalConstControl coords =
+        slabGrid.GetPointCoordinates().GetPortalConstControl();
+    typename OutputGridType::CellConnectionsType::PortalConstControl conns =
+        slabGrid.GetCellConnections().GetPortalConstControl();
+    typename InterpolationEdgesType::PortalConstControl interpolation =
+        edges.GetPortalConstControl();
+
+    const dax::Id numSlabPoints = coords.GetNumberOfValues();
+    std::vector<dax::Id> slabToOutput(numSlabPoints);
+    for (dax::Id index = 0; index < numSlabPoints; ++index)
+      {
+      const dax::exec::internal::InterpolationEdgeType slabEdge =
+          interpolation.Get(index);
+      const dax::Id first =
+          dax::exec::internal::InterpolationEdgeFirst(slabEdge);
+      const dax::Id second =
+          dax::exec::internal::InterpolationEdgeSecond(slabEdge);
+      const EdgeType edge(first + slabOffset, second + slabOffset);
+
+      // Points on the bottom plane were already made by the previous slab.
+      if (first < planeSize && second < planeSize)
+        {
+        typename SeamType::const_iterator shared = this->Seam.find(edge);
+        if (shared != this->Seam.end())
+          {
+          slabToOutput[index] = shared->second;
+          continue;
+          }
+        }
+
+      const dax::Id outputIndex = static_cast<dax::Id>(this->Points.size());
+      this->Points.push_back(coords.Get(index));
+      slabToOutput[index] = outputIndex;
+
+      if (!lastSlab && first >= topPlaneStart && second >= topPlaneStart)
+        {
+        nextSeam.insert(std::make_pair(edge, outputIndex));
+        }
+      }
+
+    const dax::Id numConnections = conns.GetNumberOfValues();
+    this->Connections.reserve(this->Connections.size() + numConnections);
+    for (dax::Id index = 0; index < numConnections; ++index)
+      {
+      this->Connections.push_back(slabToOutput[conns.Get(index)]);
+      }
+  }
+
+  dax::io::ReaderVolume Reader;
+  dax::Scalar IsoValue;
+  dax::Id SlabDepth;
+  bool Prefetch;
+  dax::Id NumberOfSlabs;
+
+  std::vector<dax::Vector3> Points;
+  std::vector<dax::Id> Connections;
+  SeamType Seam;
+};
+
+}
+} // namespace dax::io
+
+#endif //__dax_io_MarchingCubesOutOfCore_h
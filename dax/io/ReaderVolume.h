@@ -0,0 +1,558 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_io_ReaderVolume_h
+#define __dax_io_ReaderVolume_h
+
+#include <dax/Extent.h>
+#include <dax/Types.h>
+
+#include <dax/cont/UniformGrid.h>
+
+#include <dax/io/ArrayHandleMemoryMapped.h>
+#include <dax/io/DataType.h>
+#include <dax/io/ErrorIO.h>
+#include <dax/io/internal/MemoryMappedFile.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace dax {
+namespace io {
+
+/// \brief Reads a single scalar point field on a regular volume.
+///
+/// Two kinds of files are understood:
+///
+/// \li VisIt "brick of values" (BOV) headers, identified by a \c .bov
+/// extension. The header gives the name of the data file (relative to the
+/// header), its dimensions (\c DATA_SIZE), the stored type (\c DATA_FORMAT),
+/// byte order (\c DATA_ENDIAN), an optional \c BYTE_OFFSET, and the physical
+/// placement of the volume (\c BRICK_ORIGIN, \c BRICK_SIZE, \c CENTERING).
+///
+/// \li Headerless raw files. The dimensions are either passed to \c OpenRaw
+/// or encoded at the end of the file name, as in \c counts.400.400.400 or
+/// \c counts.400.400.400.raw. Raw files default to native 32-bit floats.
+///
+/// The values themselves are never read by the reader. \c GetPointField
+/// returns an ArrayHandleMemoryMapped that pages the file in as the values
+/// are used, so no copy of the volume is made in the control environment.
+///
+class ReaderVolume
+{
+public:
+  typedef dax::io::internal::MemoryMappedFile MappedFileType;
+
+  DAX_CONT_EXPORT
+  ReaderVolume() { this->Reset(); }
+
+  /// Opens \p fileName as with \c Open.
+  ///
+  DAX_CONT_EXPORT
+  explicit ReaderVolume(const std::string &fileName)
+  {
+    this->Reset();
+    this->Open(fileName);
+  }
+
+  /// Opens a BOV header if \p fileName ends in \c .bov and otherwise a raw
+  /// file whose dimensions are encoded in its name.
+  ///
+  DAX_CONT_EXPORT
+  void Open(const std::string &fileName)
+  {
+    const std::string extension = ".bov";
+    if (fileName.size() > extension.size() &&
+        ToUpper(fileName.substr(fileName.size() - extension.size()))
+        == ToUpper(extension))
+      {
+      this->OpenBOV(fileName);
+      }
+    else
+      {
+      this->OpenRaw(fileName);
+      }
+  }
+
+  /// Parses the BOV header \p headerFileName.
+  ///
+  DAX_CONT_EXPORT
+  void OpenBOV(const std::string &headerFileName)
+  {
+    std::ifstream header(headerFileName.c_str());
+    if (!header)
+      {
+      throw dax::io::ErrorIO("Could not open " + headerFileName);
+      }
+
+    this->Reset();
+    std::string dataFile;
+    bool haveSize = false;
+    bool zonal = false;
+    dax::Vector3 brickSize(1, 1, 1);
+    bool haveBrickSize = false;
+
+    std::string line;
+    while (std::getline(header, line))
+      {
+      const std::string::size_type colon = line.find(':');
+      if (line.empty() || line[0] == '#' || colon == std::string::npos)
+        {
+        continue;
+        }
+      const std::string key = ToUpper(Trim(line.substr(0, colon)));
+      const std::string value = Trim(line.substr(colon + 1));
+      std::stringstream valueStream(value);
+
+      if (key == "DATA_FILE")
+        {
+        dataFile = value;
+        }
+      else if (key == "DATA_SIZE")
+        {
+        dax::Id3 dimensions;
+        valueStream >> dimensions[0] >> dimensions[1] >> dimensions[2];
+        if (!valueStream || dimensions[0] < 1 || dimensions[1] < 1 ||
+            dimensions[2] < 1)
+          {
+          throw dax::io::ErrorIO("Bad DATA_SIZE in " + headerFileName);
+          }
+        this->SetDimensions(dimensions);
+        haveSize = true;
+        }
+      else if (key == "DATA_FORMAT")
+        {
+        this->Type = ParseDataType(value);
+        if (this->Type == DATA_TYPE_UNKNOWN)
+          {
+          throw dax::io::ErrorIO("Unsupported DATA_FORMAT " + value + " in "
+                                 + headerFileName);
+          }
+        }
+      else if (key == "DATA_ENDIAN")
+        {
+        const std::string endian = ToUpper(value);
+        if (endian == "LITTLE")
+          {
+          this->Order = BYTE_ORDER_LITTLE_ENDIAN;
+          }
+        else if (endian == "BIG")
+          {
+          this->Order = BYTE_ORDER_BIG_ENDIAN;
+          }
+        else
+          {
+          throw dax::io::ErrorIO("Bad DATA_ENDIAN " + value + " in "
+                                 + headerFileName);
+          }
+        }
+      else if (key == "BYTE_OFFSET")
+        {
+        valueStream >> this->Offset;
+        }
+      else if (key == "DATA_COMPONENTS")
+        {
+        int components = 1;
+        valueStream >> components;
+        if (components != 1)
+          {
+          throw dax::io::ErrorIO(
+                "Only single component BOV files are supported: "
+                + headerFileName);
+          }
+        }
+      else if (key == "BRICK_ORIGIN")
+        {
+        valueStream >> this->Origin[0] >> this->Origin[1] >> this->Origin[2];
+        }
+      else if (key == "BRICK_SIZE")
+        {
+        valueStream >> brickSize[0] >> brickSize[1] >> brickSize[2];
+        haveBrickSize = true;
+        }
+      else if (key == "CENTERING")
+        {
+        zonal = (ToUpper(value) == "ZONAL");
+        }
+      else if (key == "VARIABLE")
+        {
+        this->VariableName = value;
+        }
+      }
+
+    if (dataFile.empty() || !haveSize)
+      {
+      throw dax::io::ErrorIO("BOV header is missing DATA_FILE or DATA_SIZE: "
+                             + headerFileName);
+      }
+
+    // The data file is relative to the header.
+    const std::string::size_type slash = headerFileName.find_last_of('/');
+    if (dataFile[0] != '/' && slash != std::string::npos)
+      {
+      dataFile = headerFileName.substr(0, slash + 1) + dataFile;
+      }
+    this->DataFileName = dataFile;
+
+    if (haveBrickSize)
+      {
+      // Nodal values sit on the corners of the brick. Zonal values sit at
+      // the centers of the brick's zones.
+      const dax::Id3 dimensions = this->GetDimensions();
+      for (int component = 0; component < 3; ++component)
+        {
+        const dax::Id divisions = zonal ? dimensions[component]
+                                        : dimensions[component] - 1;
+        this->Spacing[component] =
+            brickSize[component] / static_cast<dax::Scalar>(
+              (divisions > 0) ? divisions : 1);
+        if (zonal)
+          {
+          this->Origin[component] += dax::Scalar(0.5)*this->Spacing[component];
+          }
+        }
+      }
+  }
+
+  /// Opens a headerless raw file whose dimensions are encoded as the last
+  /// three dot-separated numbers of its name.
+  ///
+  DAX_CONT_EXPORT
+  void OpenRaw(const std::string &fileName)
+  {
+    dax::Id3 dimensions;
+    if (!ParseDimensionsFromFileName(fileName, dimensions))
+      {
+      throw dax::io::ErrorIO("Could not determine the dimensions of " +
+                             fileName + ".  Use a BOV header or name the "
+                             "file like volume.X.Y.Z");
+      }
+    this->OpenRaw(fileName, dimensions);
+  }
+
+  /// Opens a headerless raw file with the given layout.
+  ///
+  DAX_CONT_EXPORT
+  void OpenRaw(const std::string &fileName,
+               const dax::Id3 &dimensions,
+               dax::io::DataType type = DATA_TYPE_FLOAT32,
+               dax::io::ByteOrder byteOrder = nativeByteOrder(),
+               std::size_t offset = 0)
+  {
+    this->Reset();
+    this->DataFileName = fileName;
+    this->SetDimensions(dimensions);
+    this->Type = type;
+    this->Order = byteOrder;
+    this->Offset = offset;
+  }
+
+  DAX_CONT_EXPORT
+  const std::string &GetDataFileName() const { return this->DataFileName; }
+
+  DAX_CONT_EXPORT
+  const std::string &GetVariableName() const { return this->VariableName; }
+
+  DAX_CONT_EXPORT
+  const dax::Extent3 &GetExtent() const { return this->Extent; }
+
+  DAX_CONT_EXPORT
+  dax::Id3 GetDimensions() const { return dax::extentDimensions(this->Extent); }
+
+  DAX_CONT_EXPORT
+  dax::Id GetNumberOfValues() const
+  {
+    const dax::Id3 dimensions = this->GetDimensions();
+    return dimensions[0]*dimensions[1]*dimensions[2];
+  }
+
+  DAX_CONT_EXPORT
+  const dax::Vector3 &GetOrigin() const { return this->Origin; }
+
+  DAX_CONT_EXPORT
+  const dax::Vector3 &GetSpacing() const { return this->Spacing; }
+
+  DAX_CONT_EXPORT
+  dax::io::DataType GetDataType() const { return this->Type; }
+
+  DAX_CONT_EXPORT
+  dax::io::ByteOrder GetByteOrder() const { return this->Order; }
+
+  /// The number of bytes in the data file before the first value.
+  ///
+  DAX_CONT_EXPORT
+  std::size_t GetDataOffset() const { return this->Offset; }
+
+  /// Returns a uniform grid with the extent, origin, and spacing of the
+  /// volume.
+  ///
+  template<class DeviceAdapterTag>
+  DAX_CONT_EXPORT
+  dax::cont::UniformGrid<DeviceAdapterTag> GetUniformGrid(
+      DeviceAdapterTag) const
+  {
+    dax::cont::UniformGrid<DeviceAdapterTag> grid;
+    grid.SetExtent(this->Extent);
+    grid.SetOrigin(this->Origin);
+    grid.SetSpacing(this->Spacing);
+    return grid;
+  }
+
+  DAX_CONT_EXPORT
+  dax::cont::UniformGrid<> GetUniformGrid() const
+  {
+    return this->GetUniformGrid(DAX_DEFAULT_DEVICE_ADAPTER_TAG());
+  }
+
+  /// Returns the values of the volume as a read-only array of type \c T.
+  /// The data file is mapped on the first call and the mapping is shared by
+  /// every array returned.
+  ///
+  template<typename T, class DeviceAdapterTag>
+  DAX_CONT_EXPORT
+  dax::io::ArrayHandleMemoryMapped<T,DeviceAdapterTag> GetPointField(
+      DeviceAdapterTag) const
+  {
+    return this->GetPointFieldSlab<T>(this->Extent.Min[2],
+                                      this->Extent.Max[2],
+                                      DeviceAdapterTag());
+  }
+
+  template<typename T>
+  DAX_CONT_EXPORT
+  dax::io::ArrayHandleMemoryMapped<T> GetPointField() const
+  {
+    return this->GetPointField<T>(DAX_DEFAULT_DEVICE_ADAPTER_TAG());
+  }
+
+  /// Returns the values of the z planes \p zMin through \p zMax (inclusive).
+  /// Because x varies fastest in the file, a range of z planes is contiguous
+  /// and the array simply maps that part of the file. Paired with \c
+  /// GetSlabGrid this lets a filter work through a volume one slab at a time.
+  ///
+  template<typename T, class DeviceAdapterTag>
+  DAX_CONT_EXPORT
+  dax::io::ArrayHandleMemoryMapped<T,DeviceAdapterTag> GetPointFieldSlab(
+      dax::Id zMin, dax::Id zMax, DeviceAdapterTag) const
+  {
+    const dax::Id3 dimensions = this->GetDimensions();
+    return dax::io::ArrayHandleMemoryMapped<T,DeviceAdapterTag>(
+          this->GetMappedFile(),
+          this->GetSlabOffset(zMin),
+          dimensions[0]*dimensions[1]*(zMax - zMin + 1),
+          this->Type,
+          this->Order);
+  }
+
+  template<typename T>
+  DAX_CONT_EXPORT
+  dax::io::ArrayHandleMemoryMapped<T> GetPointFieldSlab(dax::Id zMin,
+                                                        dax::Id zMax) const
+  {
+    return this->GetPointFieldSlab<T>(zMin, zMax,
+                                      DAX_DEFAULT_DEVICE_ADAPTER_TAG());
+  }
+
+  /// Returns a uniform grid covering the z planes \p zMin through \p zMax.
+  /// The grid keeps the origin and spacing of the whole volume and only
+  /// narrows the extent, so point coordinates are computed exactly as they
+  /// are for the whole volume.
+  ///
+  template<class DeviceAdapterTag>
+  DAX_CONT_EXPORT
+  dax::cont::UniformGrid<DeviceAdapterTag> GetSlabGrid(
+      dax::Id zMin, dax::Id zMax, DeviceAdapterTag) const
+  {
+    dax::cont::UniformGrid<DeviceAdapterTag> grid =
+        this->GetUniformGrid(DeviceAdapterTag());
+    dax::Extent3 extent = this->Extent;
+    extent.Min[2] = zMin;
+    extent.Max[2] = zMax;
+    grid.SetExtent(extent);
+    return grid;
+  }
+
+  /// Returns the byte offset in the data file of the first value in z plane
+  /// \p z.
+  ///
+  DAX_CONT_EXPORT
+  std::size_t GetSlabOffset(dax::Id z) const
+  {
+    const dax::Id3 dimensions = this->GetDimensions();
+    return this->Offset + static_cast<std::size_t>(z - this->Extent.Min[2])
+        * static_cast<std::size_t>(dimensions[0]*dimensions[1])
+        * dax::io::dataTypeSize(this->Type);
+  }
+
+  /// Returns the mapping of the data file, mapping it if necessary.
+  ///
+  DAX_CONT_EXPORT
+  boost::shared_ptr<const MappedFileType> GetMappedFile() const
+  {
+    if (this->DataFileName.empty())
+      {
+      throw dax::io::ErrorIO("No volume has been opened.");
+      }
+    if (!this->File)
+      {
+      this->File.reset(new MappedFileType(this->DataFileName));
+      }
+    return this->File;
+  }
+
+  /// Converts a BOV \c DATA_FORMAT string (or a sized type name such as \c
+  /// UINT16 or \c FLOAT32) to a \c DataType.
+  ///
+  DAX_CONT_EXPORT
+  static dax::io::DataType ParseDataType(const std::string &name)
+  {
+    const std::string format = ToUpper(name);
+    if (format == "BYTE" || format == "UCHAR" || format == "UINT8")
+      { return DATA_TYPE_UINT8; }
+    if (format == "CHAR" || format == "INT8") { return DATA_TYPE_INT8; }
+    if (format == "SHORT" || format == "INT16") { return DATA_TYPE_INT16; }
+    if (format == "USHORT" || format == "UINT16") { return DATA_TYPE_UINT16; }
+    if (format == "INT" || format == "INT32") { return DATA_TYPE_INT32; }
+    if (format == "UINT" || format == "UINT32") { return DATA_TYPE_UINT32; }
+    if (format == "LONG" || format == "INT64") { return DATA_TYPE_INT64; }
+    if (format == "ULONG" || format == "UINT64") { return DATA_TYPE_UINT64; }
+    if (format == "FLOAT" || format == "FLOAT32") { return DATA_TYPE_FLOAT32; }
+    if (format == "DOUBLE" || format == "FLOAT64") { return DATA_TYPE_FLOAT64; }
+    return DATA_TYPE_UNKNOWN;
+  }
+
+  /// Finds dimensions encoded in a file name like \c name.X.Y.Z (optionally
+  /// followed by an extension). Returns false if there are none.
+  ///
+  DAX_CONT_EXPORT
+  static bool ParseDimensionsFromFileName(const std::string &fileName,
+                                          dax::Id3 &dimensions)
+  {
+    const std::string::size_type slash = fileName.find_last_of('/');
+    const std::string baseName = (slash == std::string::npos)
+        ? fileName : fileName.substr(slash + 1);
+
+    std::vector<std::string> tokens;
+    std::stringstream nameStream(baseName);
+    std::string token;
+    while (std::getline(nameStream, token, '.'))
+      {
+      tokens.push_back(token);
+      }
+    if (!tokens.empty() && !IsNumber(tokens.back()))
+      {
+      tokens.pop_back();
+      }
+    if (tokens.size() < 3)
+      {
+      return false;
+      }
+
+    for (int component = 0; component < 3; ++component)
+      {
+      const std::string &value = tokens[tokens.size() - 3 + component];
+      if (!IsNumber(value))
+        {
+        return false;
+        }
+      std::stringstream valueStream(value);
+      valueStream >> dimensions[component];
+      if (dimensions[component] < 1)
+        {
+        return false;
+        }
+      }
+    return true;
+  }
+
+private:
+  DAX_CONT_EXPORT
+  void Reset()
+  {
+    this->DataFileName.clear();
+    this->VariableName.clear();
+    this->Extent = dax::Extent3();
+    this->Origin = dax::make_Vector3(0, 0, 0);
+    this->Spacing = dax::make_Vector3(1, 1, 1);
+    this->Type = DATA_TYPE_FLOAT32;
+    this->Order = nativeByteOrder();
+    this->Offset = 0;
+    this->File.reset();
+  }
+
+  DAX_CONT_EXPORT
+  void SetDimensions(const dax::Id3 &dimensions)
+  {
+    this->Extent = dax::Extent3(dax::make_Id3(0, 0, 0),
+                                dax::make_Id3(dimensions[0] - 1,
+                                              dimensions[1] - 1,
+                                              dimensions[2] - 1));
+  }
+
+  DAX_CONT_EXPORT
+  static std::string ToUpper(std::string value)
+  {
+    for (std::string::iterator c = value.begin(); c != value.end(); ++c)
+      {
+      *c = static_cast<char>(std::toupper(*c));
+      }
+    return value;
+  }
+
+  DAX_CONT_EXPORT
+  static std::string Trim(const std::string &value)
+  {
+    const char *whitespace = " \t\r\n";
+    const std::string::size_type begin = value.find_first_not_of(whitespace);
+    if (begin == std::string::npos)
+      {
+      return std::string();
+      }
+    const std::string::size_type end = value.find_last_not_of(whitespace);
+    return value.substr(begin, end - begin + 1);
+  }
+
+  DAX_CONT_EXPORT
+  static bool IsNumber(const std::string &value)
+  {
+    if (value.empty()) { return false; }
+    for (std::string::const_iterator c = value.begin(); c != value.end(); ++c)
+      {
+      if (!std::isdigit(*c)) { return false; }
+      }
+    return true;
+  }
+
+  std::string DataFileName;
+  std::string VariableName;
+  dax::Extent3 Extent;
+  dax::Vector3 Origin;
+  dax::Vector3 Spacing;
+  dax::io::DataType Type;
+  dax::io::ByteOrder Order;
+  std::size_t Offset;
+  mutable boost::shared_ptr<const MappedFileType> File;
+};
+
+}
+} // namespace dax::io
+
+#endif //__dax_io_ReaderVolume_h
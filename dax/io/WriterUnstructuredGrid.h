@@ -0,0 +1,372 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_io_WriterUnstructuredGrid_h
+#define __dax_io_WriterUnstructuredGrid_h
+
+#include <dax/CellTag.h>
+#include <dax/CellTraits.h>
+#include <dax/Types.h>
+
+#include <dax/cont/UnstructuredGrid.h>
+
+#include <dax/io/DataType.h>
+#include <dax/io/ErrorIO.h>
+#include <dax/io/internal/FileWriterChunked.h>
+
+#include <cctype>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace dax {
+namespace io {
+
+namespace internal {
+
+/// The VTK cell type identifier of each Dax cell.
+///
+template<class CellTag> struct VTKCellType;
+template<> struct VTKCellType<dax::CellTagVertex>
+  { static const int Id = 1; };
+template<> struct VTKCellType<dax::CellTagLine>
+  { static const int Id = 3; };
+template<> struct VTKCellType<dax::CellTagTriangle>
+  { static const int Id = 5; };
+template<> struct VTKCellType<dax::CellTagQuadrilateral>
+  { static const int Id = 9; };
+template<> struct VTKCellType<dax::CellTagTetrahedron>
+  { static const int Id = 10; };
+template<> struct VTKCellType<dax::CellTagVoxel>
+  { static const int Id = 11; };
+template<> struct VTKCellType<dax::CellTagHexahedron>
+  { static const int Id = 12; };
+template<> struct VTKCellType<dax::CellTagWedge>
+  { static const int Id = 13; };
+
+/// The name VTK XML files use for a \c DataType.
+///
+DAX_CONT_EXPORT
+const char *vtkXMLTypeName(dax::io::DataType type)
+{
+  switch (type)
+    {
+    case DATA_TYPE_INT8:    return "Int8";
+    case DATA_TYPE_UINT8:   return "UInt8";
+    case DATA_TYPE_INT16:   return "Int16";
+    case DATA_TYPE_UINT16:  return "UInt16";
+    case DATA_TYPE_INT32:   return "Int32";
+    case DATA_TYPE_UINT32:  return "UInt32";
+    case DATA_TYPE_INT64:   return "Int64";
+    case DATA_TYPE_UINT64:  return "UInt64";
+    case DATA_TYPE_FLOAT32: return "Float32";
+    case DATA_TYPE_FLOAT64: return "Float64";
+    case DATA_TYPE_UNKNOWN:
+    default:                return "";
+    }
+}
+
+} // namespace internal
+
+/// \brief Writes an UnstructuredGrid to disk in a binary format.
+///
+/// Three formats are supported:
+///
+/// \li Legacy VTK (\c .vtk) with \c BINARY data. The format stores
+/// big-endian values and 32-bit cell indices.
+///
+/// \li VTK XML unstructured grids (\c .vtu) with raw appended data in the
+/// native byte order. Cell indices are stored as \c dax::Id.
+///
+/// \li Headerless raw files: one file of point coordinates (three \c
+/// dax::Scalar per point) and one file of cell connections (\c
+/// NUM_VERTICES \c dax::Id per cell), both in the native byte order.
+///
+/// Values are read from the control portals of the grid arrays and packed
+/// straight into the chunks of a FileWriterChunked, so the grid is never
+/// copied and the disk writes overlap the packing.
+///
+class WriterUnstructuredGrid
+{
+public:
+  DAX_CONT_EXPORT
+  WriterUnstructuredGrid() : ChunkSize(4 << 20) {  }
+
+  /// The size of each of the two write buffers, in bytes.
+  ///
+  DAX_CONT_EXPORT
+  std::size_t GetChunkSize() const { return this->ChunkSize; }
+  DAX_CONT_EXPORT
+  void SetChunkSize(std::size_t chunkSize) { this->ChunkSize = chunkSize; }
+
+  /// Writes legacy VTK if \p fileName ends in \c .vtk and VTK XML if it ends
+  /// in \c .vtu.
+  ///
+  template<class CellTag, class ConnectionsTag, class PointsTag, class Device,
+           typename ConnectionIdType>
+  DAX_CONT_EXPORT
+  void Write(const dax::cont::UnstructuredGrid<
+               CellTag,ConnectionsTag,PointsTag,Device,ConnectionIdType> &grid,
+             const std::string &fileName) const
+  {
+    if (HasExtension(fileName, ".vtk"))
+      {
+      this->WriteVTK(grid, fileName);
+      }
+    else if (HasExtension(fileName, ".vtu"))
+      {
+      this->WriteVTU(grid, fileName);
+      }
+    else
+      {
+      throw dax::io::ErrorIO("Unknown mesh file extension: " + fileName +
+                             ".  Use .vtk, .vtu or WriteRaw.");
+      }
+  }
+
+  /// Writes \p grid as a legacy VTK file with binary data.
+  ///
+  template<class CellTag, class ConnectionsTag, class PointsTag, class Device,
+           typename ConnectionIdType>
+  DAX_CONT_EXPORT
+  void WriteVTK(const dax::cont::UnstructuredGrid<
+                  CellTag,ConnectionsTag,PointsTag,Device,ConnectionIdType> &grid,
+                const std::string &fileName) const
+  {
+    typedef dax::internal::Int32Type LegacyIdType;
+    const int numVertices = dax::CellTraits<CellTag>::NUM_VERTICES;
+    const dax::Id numPoints = grid.GetNumberOfPoints();
+    const dax::Id numCells = grid.GetNumberOfCells();
+
+    // Every index in the CELLS section, counts included, must fit in an int.
+    const double cellsSize = static_cast<double>(numCells)*(numVertices+1);
+    if (cellsSize > std::numeric_limits<LegacyIdType>::max() ||
+        numPoints > std::numeric_limits<LegacyIdType>::max())
+      {
+      throw dax::io::ErrorIO("Grid is too large for the legacy VTK format: " +
+                             fileName + ".  Write a .vtu file instead.");
+      }
+
+    dax::io::internal::FileWriterChunked file(fileName,
+                                              BYTE_ORDER_BIG_ENDIAN,
+                                              this->ChunkSize);
+
+    std::stringstream header;
+    header << "# vtk DataFile Version 3.0\n"
+           << "Dax unstructured grid\n"
+           << "BINARY\n"
+           << "DATASET UNSTRUCTURED_GRID\n"
+           << "POINTS " << numPoints << " "
+           << ((DataTypeOf<dax::Scalar>::Type == DATA_TYPE_FLOAT64)
+               ? "double" : "float")
+           << "\n";
+    file.WriteString(header.str());
+    WritePoints(grid, file);
+
+    std::stringstream cellsHeader;
+    cellsHeader << "\nCELLS " << numCells << " "
+                << numCells*(numVertices+1) << "\n";
+    file.WriteString(cellsHeader.str());
+    typename dax::cont::UnstructuredGrid<
+        CellTag,ConnectionsTag,PointsTag,Device,ConnectionIdType>::CellConnectionsType
+        ::PortalConstControl connections =
+          grid.GetCellConnections().GetPortalConstControl();
+    dax::Id index = 0;
+    for (dax::Id cell = 0; cell < numCells; ++cell)
+      {
+      file.WriteValue(static_cast<LegacyIdType>(numVertices));
+      for (int vertex = 0; vertex < numVertices; ++vertex, ++index)
+        {
+        file.WriteValue(static_cast<LegacyIdType>(connections.Get(index)));
+        }
+      }
+
+    std::stringstream typesHeader;
+    typesHeader << "\nCELL_TYPES " << numCells << "\n";
+    file.WriteString(typesHeader.str());
+    const LegacyIdType cellType = internal::VTKCellType<CellTag>::Id;
+    for (dax::Id cell = 0; cell < numCells; ++cell)
+      {
+      file.WriteValue(cellType);
+      }
+    file.WriteString("\n");
+
+    file.Close();
+  }
+
+  /// Writes \p grid as a VTK XML unstructured grid with raw appended data.
+  ///
+  template<class CellTag, class ConnectionsTag, class PointsTag, class Device,
+           typename ConnectionIdType>
+  DAX_CONT_EXPORT
+  void WriteVTU(const dax::cont::UnstructuredGrid<
+                  CellTag,ConnectionsTag,PointsTag,Device,ConnectionIdType> &grid,
+                const std::string &fileName) const
+  {
+    typedef dax::internal::UInt64Type HeaderType;
+    const int numVertices = dax::CellTraits<CellTag>::NUM_VERTICES;
+    const dax::Id numPoints = grid.GetNumberOfPoints();
+    const dax::Id numCells = grid.GetNumberOfCells();
+    const char *idTypeName =
+        internal::vtkXMLTypeName(DataTypeOf<dax::Id>::Type);
+
+    // Each appended array is its byte count followed by its values.
+    const HeaderType pointsBytes =
+        static_cast<HeaderType>(numPoints)*3*sizeof(dax::Scalar);
+    const HeaderType connectivityBytes =
+        static_cast<HeaderType>(numCells)*numVertices*sizeof(dax::Id);
+    const HeaderType offsetsBytes =
+        static_cast<HeaderType>(numCells)*sizeof(dax::Id);
+    const HeaderType typesBytes = static_cast<HeaderType>(numCells);
+    const HeaderType connectivityOffset = sizeof(HeaderType) + pointsBytes;
+    const HeaderType offsetsOffset =
+        connectivityOffset + sizeof(HeaderType) + connectivityBytes;
+    const HeaderType typesOffset =
+        offsetsOffset + sizeof(HeaderType) + offsetsBytes;
+
+    dax::io::internal::FileWriterChunked file(fileName,
+                                              nativeByteOrder(),
+                                              this->ChunkSize);
+
+    std::stringstream header;
+    header << "<?xml version=\"1.0\"?>\n"
+           << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+           << ((nativeByteOrder() == BYTE_ORDER_LITTLE_ENDIAN)
+               ? "LittleEndian" : "BigEndian")
+           << "\" header_type=\"UInt64\">\n"
+           << "  <UnstructuredGrid>\n"
+           << "    <Piece NumberOfPoints=\"" << numPoints
+           << "\" NumberOfCells=\"" << numCells << "\">\n"
+           << "      <Points>\n"
+           << "        <DataArray type=\""
+           << internal::vtkXMLTypeName(DataTypeOf<dax::Scalar>::Type)
+           << "\" NumberOfComponents=\"3\" format=\"appended\" offset=\"0\"/>\n"
+           << "      </Points>\n"
+           << "      <Cells>\n"
+           << "        <DataArray type=\"" << idTypeName
+           << "\" Name=\"connectivity\" format=\"appended\" offset=\""
+           << connectivityOffset << "\"/>\n"
+           << "        <DataArray type=\"" << idTypeName
+           << "\" Name=\"offsets\" format=\"appended\" offset=\""
+           << offsetsOffset << "\"/>\n"
+           << "        <DataArray type=\"UInt8\" Name=\"types\""
+           << " format=\"appended\" offset=\"" << typesOffset << "\"/>\n"
+           << "      </Cells>\n"
+           << "    </Piece>\n"
+           << "  </UnstructuredGrid>\n"
+           << "  <AppendedData encoding=\"raw\">\n"
+           << "   _";
+    file.WriteString(header.str());
+
+    file.WriteValue(pointsBytes);
+    WritePoints(grid, file);
+
+    file.WriteValue(connectivityBytes);
+    WriteConnections(grid, file);
+
+    file.WriteValue(offsetsBytes);
+    for (dax::Id cell = 1; cell <= numCells; ++cell)
+      {
+      file.WriteValue(static_cast<dax::Id>(cell*numVertices));
+      }
+
+    file.WriteValue(typesBytes);
+    const unsigned char cellType =
+        internal::VTKCellType<CellTag>::Id;
+    for (dax::Id cell = 0; cell < numCells; ++cell)
+      {
+      file.WriteValue(cellType);
+      }
+
+    file.WriteString("\n  </AppendedData>\n</VTKFile>\n");
+    file.Close();
+  }
+
+  /// Writes the point coordinates of \p grid to \p pointsFileName and its
+  /// cell connections to \p connectionsFileName, without headers.
+  ///
+  template<class CellTag, class ConnectionsTag, class PointsTag, class Device,
+           typename ConnectionIdType>
+  DAX_CONT_EXPORT
+  void WriteRaw(const dax::cont::UnstructuredGrid<
+                  CellTag,ConnectionsTag,PointsTag,Device,ConnectionIdType> &grid,
+                const std::string &pointsFileName,
+                const std::string &connectionsFileName) const
+  {
+    dax::io::internal::FileWriterChunked pointsFile(pointsFileName,
+                                                    nativeByteOrder(),
+                                                    this->ChunkSize);
+    WritePoints(grid, pointsFile);
+    pointsFile.Close();
+
+    dax::io::internal::FileWriterChunked connectionsFile(connectionsFileName,
+                                                         nativeByteOrder(),
+                                                         this->ChunkSize);
+    WriteConnections(grid, connectionsFile);
+    connectionsFile.Close();
+  }
+
+private:
+  template<class GridType>
+  DAX_CONT_EXPORT
+  static void WritePoints(const GridType &grid,
+                          dax::io::internal::FileWriterChunked &file)
+  {
+    typename GridType::PointCoordinatesType::PortalConstControl points =
+        grid.GetPointCoordinates().GetPortalConstControl();
+    const dax::Id numPoints = points.GetNumberOfValues();
+    for (dax::Id index = 0; index < numPoints; ++index)
+      {
+      const dax::Vector3 point = points.Get(index);
+      file.WriteValue(point[0]);
+      file.WriteValue(point[1]);
+      file.WriteValue(point[2]);
+      }
+  }
+
+  template<class GridType>
+  DAX_CONT_EXPORT
+  static void WriteConnections(const GridType &grid,
+                               dax::io::internal::FileWriterChunked &file)
+  {
+    typename GridType::CellConnectionsType::PortalConstControl connections =
+        grid.GetCellConnections().GetPortalConstControl();
+    const dax::Id numConnections = connections.GetNumberOfValues();
+    for (dax::Id index = 0; index < numConnections; ++index)
+      {
+      file.WriteValue(connections.Get(index));
+      }
+  }
+
+  DAX_CONT_EXPORT
+  static bool HasExtension(const std::string &fileName,
+                           const std::string &extension)
+  {
+    if (fileName.size() <= extension.size()) { return false; }
+    const std::string end = fileName.substr(fileName.size()-extension.size());
+    for (std::size_t index = 0; index < end.size(); ++index)
+      {
+      if (std::tolower(end[index]) != extension[index]) { return false; }
+      }
+    return true;
+  }
+
+  std::size_t ChunkSize;
+};
+
+}
+} // namespace dax::io
+
+#endif //__dax_io_WriterUnstructuredGrid_h
@@ -0,0 +1,289 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_io_internal_FileWriterChunked_h
+#define __dax_io_internal_FileWriterChunked_h
+
+#include <dax/Types.h>
+#include <dax/io/DataType.h>
+#include <dax/io/ErrorIO.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <aio.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace dax {
+namespace io {
+namespace internal {
+
+/// \brief Writes a file sequentially through two chunk buffers.
+///
+/// Values are packed into one buffer while the other buffer is written to
+/// the file with POSIX asynchronous I/O, so converting the values overlaps
+/// with the disk. A chunk is only reused once its previous write finished.
+/// Values are stored in the byte order given on construction.
+///
+/// Errors are thrown as dax::io::ErrorIO. \c Close must be called to learn
+/// whether the last chunks reached the file; the destructor closes the file
+/// quietly.
+///
+class FileWriterChunked : boost::noncopyable
+{
+public:
+  DAX_CONT_EXPORT
+  FileWriterChunked(const std::string &fileName,
+                    dax::io::ByteOrder byteOrder = nativeByteOrder(),
+                    std::size_t chunkSize = 4 << 20)
+    : FileName(fileName),
+      FileDescriptor(-1),
+      ChunkSize(std::max(chunkSize, std::size_t(64))),
+      ActiveChunk(0),
+      ActiveFill(0),
+      FileOffset(0),
+      SwapBytes(byteOrder != nativeByteOrder())
+  {
+    this->FileDescriptor =
+        open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (this->FileDescriptor < 0)
+      {
+      throw dax::io::ErrorIO("Could not open " + fileName + " for writing: "
+                             + std::strerror(errno));
+      }
+    for (int chunk = 0; chunk < 2; ++chunk)
+      {
+      this->Chunks[chunk].resize(this->ChunkSize);
+      this->Pending[chunk] = false;
+      }
+  }
+
+  DAX_CONT_EXPORT
+  ~FileWriterChunked()
+  {
+    if (this->FileDescriptor >= 0)
+      {
+      try { this->Close(); } catch (...) { }
+      }
+  }
+
+  /// Appends \p numBytes raw bytes. They are never byte swapped.
+  ///
+  DAX_CONT_EXPORT
+  void WriteBytes(const void *data, std::size_t numBytes)
+  {
+    const char *source = static_cast<const char *>(data);
+    while (numBytes > 0)
+      {
+      if (this->ActiveFill == this->ChunkSize) { this->Flush(); }
+      const std::size_t count =
+          std::min(numBytes, this->ChunkSize - this->ActiveFill);
+      std::memcpy(&this->Chunks[this->ActiveChunk][this->ActiveFill],
+                  source,
+                  count);
+      this->ActiveFill += count;
+      source += count;
+      numBytes -= count;
+      }
+  }
+
+  DAX_CONT_EXPORT
+  void WriteString(const std::string &text)
+  {
+    this->WriteBytes(text.data(), text.size());
+  }
+
+  /// Appends one value in the byte order of the file.
+  ///
+  template<typename T>
+  DAX_CONT_EXPORT
+  void WriteValue(T value)
+  {
+    if (this->ActiveFill + sizeof(T) > this->ChunkSize) { this->Flush(); }
+    char *destination = &this->Chunks[this->ActiveChunk][this->ActiveFill];
+    if (this->SwapBytes)
+      {
+      const char *bytes = reinterpret_cast<const char *>(&value);
+      std::reverse_copy(bytes, bytes + sizeof(T), destination);
+      }
+    else
+      {
+      std::memcpy(destination, &value, sizeof(T));
+      }
+    this->ActiveFill += sizeof(T);
+  }
+
+  /// The number of bytes handed to the writer so far.
+  ///
+  DAX_CONT_EXPORT
+  std::size_t GetNumberOfBytesWritten() const
+  {
+    return this->FileOffset + this->ActiveFill;
+  }
+
+  /// Writes out the remaining values, waits for every write to finish and
+  /// closes the file.
+  ///
+  DAX_CONT_EXPORT
+  void Close()
+  {
+    if (this->FileDescriptor < 0) { return; }
+    try
+      {
+      this->Flush();
+      this->Wait(0);
+      this->Wait(1);
+      }
+    catch (...)
+      {
+      this->Abandon();
+      throw;
+      }
+    if (close(this->FileDescriptor) != 0)
+      {
+      this->FileDescriptor = -1;
+      throw dax::io::ErrorIO("Could not close " + this->FileName + ": "
+                             + std::strerror(errno));
+      }
+    this->FileDescriptor = -1;
+  }
+
+private:
+  /// Starts writing the active chunk and switches to the other one.
+  ///
+  DAX_CONT_EXPORT
+  void Flush()
+  {
+    if (this->ActiveFill == 0) { return; }
+
+    const int chunk = this->ActiveChunk;
+    struct aiocb &request = this->Requests[chunk];
+    std::memset(&request, 0, sizeof(request));
+    request.aio_fildes = this->FileDescriptor;
+    request.aio_buf = &this->Chunks[chunk][0];
+    request.aio_nbytes = this->ActiveFill;
+    request.aio_offset = static_cast<off_t>(this->FileOffset);
+    if (aio_write(&request) == 0)
+      {
+      this->Pending[chunk] = true;
+      }
+    else
+      {
+      // Out of asynchronous requests; write this chunk in place.
+      this->WriteSynchronously(&this->Chunks[chunk][0],
+                               this->ActiveFill,
+                               this->FileOffset);
+      }
+
+    this->FileOffset += this->ActiveFill;
+    this->ActiveChunk = 1 - chunk;
+    this->ActiveFill = 0;
+    this->Wait(this->ActiveChunk);
+  }
+
+  /// Blocks until the last write of \p chunk is done.
+  ///
+  DAX_CONT_EXPORT
+  void Wait(int chunk)
+  {
+    if (!this->Pending[chunk]) { return; }
+
+    struct aiocb &request = this->Requests[chunk];
+    const struct aiocb *requestList[1] = { &request };
+    int status;
+    while ((status = aio_error(&request)) == EINPROGRESS)
+      {
+      aio_suspend(requestList, 1, NULL);
+      }
+    this->Pending[chunk] = false;
+
+    const ssize_t written = aio_return(&request);
+    if (status != 0 || written < 0)
+      {
+      throw dax::io::ErrorIO("Could not write " + this->FileName + ": "
+                             + std::strerror(status != 0 ? status : errno));
+      }
+    if (static_cast<std::size_t>(written) < request.aio_nbytes)
+      {
+      // Short write; finish the rest of the chunk directly.
+      this->WriteSynchronously(
+            &this->Chunks[chunk][0] + written,
+            request.aio_nbytes - written,
+            static_cast<std::size_t>(request.aio_offset) + written);
+      }
+  }
+
+  DAX_CONT_EXPORT
+  void WriteSynchronously(const char *data,
+                          std::size_t numBytes,
+                          std::size_t offset)
+  {
+    while (numBytes > 0)
+      {
+      const ssize_t written = pwrite(this->FileDescriptor,
+                                     data,
+                                     numBytes,
+                                     static_cast<off_t>(offset));
+      if (written < 0)
+        {
+        if (errno == EINTR) { continue; }
+        throw dax::io::ErrorIO("Could not write " + this->FileName + ": "
+                               + std::strerror(errno));
+        }
+      data += written;
+      offset += written;
+      numBytes -= written;
+      }
+  }
+
+  /// Waits out any outstanding writes without reporting their errors and
+  /// closes the file.
+  ///
+  DAX_CONT_EXPORT
+  void Abandon()
+  {
+    for (int chunk = 0; chunk < 2; ++chunk)
+      {
+      try { this->Wait(chunk); } catch (...) { }
+      }
+    close(this->FileDescriptor);
+    this->FileDescriptor = -1;
+  }
+
+  std::string FileName;
+  int FileDescriptor;
+  std::size_t ChunkSize;
+  std::vector<char> Chunks[2];
+  struct aiocb Requests[2];
+  bool Pending[2];
+  int ActiveChunk;
+  std::size_t ActiveFill;
+  std::size_t FileOffset;
+  bool SwapBytes;
+};
+
+}
+}
+} // namespace dax::io::internal
+
+#endif //__dax_io_internal_FileWriterChunked_h
@@ -0,0 +1,173 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_io_internal_MemoryMappedFile_h
+#define __dax_io_internal_MemoryMappedFile_h
+
+#include <dax/Types.h>
+#include <dax/io/ErrorIO.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dax {
+namespace io {
+namespace internal {
+
+/// \brief A read-only view of an entire file mapped into memory.
+///
+/// The file is mapped on construction and unmapped on destruction. Pages are
+/// only read from disk when they are first touched, so opening a file that is
+/// much larger than physical memory is cheap. Instances are not copyable;
+/// share them with a \c boost::shared_ptr.
+///
+class MemoryMappedFile : boost::noncopyable
+{
+public:
+  /// Access hints that are passed to the operating system's pager.
+  enum AccessPattern {
+    ACCESS_NORMAL,
+    ACCESS_SEQUENTIAL,
+    ACCESS_RANDOM,
+    ACCESS_WILL_NEED,
+    ACCESS_DONT_NEED
+  };
+
+  DAX_CONT_EXPORT
+  MemoryMappedFile(const std::string &fileName,
+                   AccessPattern access = ACCESS_SEQUENTIAL)
+    : FileName(fileName), Data(NULL), Size(0)
+  {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+      {
+      throw dax::io::ErrorIO("Could not open " + fileName + ": "
+                             + std::strerror(errno));
+      }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+      {
+      const std::string reason = std::strerror(errno);
+      close(fd);
+      throw dax::io::ErrorIO("Could not stat " + fileName + ": " + reason);
+      }
+    this->Size = static_cast<std::size_t>(info.st_size);
+
+    if (this->Size > 0)
+      {
+      void *data = mmap(NULL, this->Size, PROT_READ, MAP_SHARED, fd, 0);
+      if (data == MAP_FAILED)
+        {
+        const std::string reason = std::strerror(errno);
+        close(fd);
+        throw dax::io::ErrorIO("Could not map " + fileName + ": " + reason);
+        }
+      this->Data = static_cast<const char *>(data);
+      this->Advise(access);
+      }
+
+    // The mapping holds its own reference to the file.
+    close(fd);
+  }
+
+  DAX_CONT_EXPORT
+  ~MemoryMappedFile()
+  {
+    if (this->Data != NULL)
+      {
+      munmap(const_cast<char *>(this->Data), this->Size);
+      }
+  }
+
+  /// Passes a hint on how the mapping will be accessed to the pager. The
+  /// hint is advisory, so failures are ignored.
+  ///
+  DAX_CONT_EXPORT
+  void Advise(AccessPattern access) const
+  {
+    this->Advise(access, 0, this->Size);
+  }
+
+  /// Passes a hint for the \p length bytes starting at \p offset. \c
+  /// ACCESS_WILL_NEED starts reading the range in the background and \c
+  /// ACCESS_DONT_NEED drops the range from this process' resident set (the
+  /// data is read again if it is touched later).
+  ///
+  DAX_CONT_EXPORT
+  void Advise(AccessPattern access,
+              std::size_t offset,
+              std::size_t length) const
+  {
+    if (this->Data == NULL || offset >= this->Size || length == 0) { return; }
+
+    // madvise requires a page aligned start. Dropping pages is rounded
+    // inward so that neighboring data still in use stays resident.
+    const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::size_t start = (offset / pageSize) * pageSize;
+    std::size_t end = std::min(offset + length, this->Size);
+    if (access == ACCESS_DONT_NEED)
+      {
+      start = ((offset + pageSize - 1) / pageSize) * pageSize;
+      if (end < this->Size) { end = (end / pageSize) * pageSize; }
+      if (end <= start) { return; }
+      }
+
+    int advice = MADV_NORMAL;
+    switch (access)
+      {
+      case ACCESS_SEQUENTIAL: advice = MADV_SEQUENTIAL; break;
+      case ACCESS_RANDOM:     advice = MADV_RANDOM;     break;
+      case ACCESS_WILL_NEED:  advice = MADV_WILLNEED;   break;
+      case ACCESS_DONT_NEED:  advice = MADV_DONTNEED;   break;
+      case ACCESS_NORMAL:     advice = MADV_NORMAL;     break;
+      }
+    madvise(const_cast<char *>(this->Data) + start, end - start, advice);
+  }
+
+  DAX_CONT_EXPORT
+  const std::string &GetFileName() const { return this->FileName; }
+
+  /// Returns a pointer to the first byte of the file, or \c NULL when the
+  /// file is empty.
+  ///
+  DAX_CONT_EXPORT
+  const char *GetData() const { return this->Data; }
+
+  /// Returns the size of the file in bytes.
+  ///
+  DAX_CONT_EXPORT
+  std::size_t GetSize() const { return this->Size; }
+
+private:
+  std::string FileName;
+  const char *Data;
+  std::size_t Size;
+};
+
+}
+}
+} // namespace dax::io::internal
+
+#endif //__dax_io_internal_MemoryMappedFile_h
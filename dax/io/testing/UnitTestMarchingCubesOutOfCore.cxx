@@ -0,0 +1,198 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/io/MarchingCubesOutOfCore.h>
+
+#include <dax/cont/DispatcherGenerateInterpolatedCells.h>
+#include <dax/cont/DispatcherMapCell.h>
+#include <dax/worklet/MarchingCubes.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const dax::Id3 DIMENSIONS = dax::make_Id3(17, 13, 21);
+const char *FILE_NAME = "UnitTestMarchingCubesOutOfCore.17.13.21";
+const dax::Scalar ISOVALUE = 7.5f;
+
+typedef dax::io::MarchingCubesOutOfCore<> OutOfCoreType;
+typedef OutOfCoreType::OutputGridType GridType;
+
+void WriteVolume()
+{
+  std::ofstream file(FILE_NAME, std::ios::binary);
+  for (dax::Id k = 0; k < DIMENSIONS[2]; k++)
+    {
+    for (dax::Id j = 0; j < DIMENSIONS[1]; j++)
+      {
+      for (dax::Id i = 0; i < DIMENSIONS[0]; i++)
+        {
+        const float x = i - 8.0f, y = j - 6.0f, z = k - 10.0f;
+        const float value = std::sqrt(x*x + y*y + z*z);
+        file.write(reinterpret_cast<const char *>(&value), sizeof(float));
+        }
+      }
+    }
+}
+
+/// A triangle as its three point coordinates in a canonical order, so that
+/// grids can be compared regardless of point numbering.
+struct Triangle
+{
+  dax::Vector3 Points[3];
+
+  bool operator<(const Triangle &other) const
+  {
+    for (int p = 0; p < 3; ++p)
+      {
+      for (int c = 0; c < 3; ++c)
+        {
+        if (this->Points[p][c] < other.Points[p][c]) { return true; }
+        if (other.Points[p][c] < this->Points[p][c]) { return false; }
+        }
+      }
+    return false;
+  }
+};
+
+bool PointLess(const dax::Vector3 &a, const dax::Vector3 &b)
+{
+  for (int c = 0; c < 3; ++c)
+    {
+    if (a[c] < b[c]) { return true; }
+    if (b[c] < a[c]) { return false; }
+    }
+  return false;
+}
+
+std::vector<Triangle> GetTriangles(GridType &grid)
+{
+  GridType::PointCoordinatesType::PortalConstControl coords =
+      grid.GetPointCoordinates().GetPortalConstControl();
+  GridType::CellConnectionsType::PortalConstControl conns =
+      grid.GetCellConnections().GetPortalConstControl();
+  std::vector<Triangle> triangles(grid.GetNumberOfCells());
+  for (dax::Id cell = 0; cell < grid.GetNumberOfCells(); ++cell)
+    {
+    for (int p = 0; p < 3; ++p)
+      {
+      triangles[cell].Points[p] = coords.Get(conns.Get(3*cell + p));
+      }
+    std::sort(triangles[cell].Points, triangles[cell].Points + 3, PointLess);
+    }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+void ContourInCore(const dax::io::ReaderVolume &reader, GridType &outGrid)
+{
+  typedef dax::cont::DispatcherGenerateInterpolatedCells<
+      dax::worklet::MarchingCubesGenerate> DispatcherIC;
+
+  dax::cont::UniformGrid<> grid = reader.GetUniformGrid();
+  dax::io::ArrayHandleMemoryMapped<dax::Scalar> field =
+      reader.GetPointField<dax::Scalar>();
+
+  DispatcherIC::CountHandleType count;
+  dax::cont::DispatcherMapCell<dax::worklet::MarchingCubesCount>(
+        dax::worklet::MarchingCubesCount(ISOVALUE)).Invoke(grid, field, count);
+
+  DispatcherIC icDispatcher(count,
+                            dax::worklet::MarchingCubesGenerate(ISOVALUE));
+  icDispatcher.Invoke(grid, outGrid, field);
+}
+
+void CheckSlabDepth(const dax::io::ReaderVolume &reader,
+                    const std::vector<Triangle> &expected,
+                    dax::Id expectedNumPoints,
+                    dax::Id slabDepth,
+                    dax::Id expectedNumSlabs)
+{
+  std::cout << "Contouring with slab depth " << slabDepth << std::endl;
+  OutOfCoreType outOfCore(reader, ISOVALUE);
+  outOfCore.SetSlabDepth(slabDepth);
+  GridType outGrid;
+  outOfCore.Run(outGrid);
+
+  DAX_TEST_ASSERT(outOfCore.GetNumberOfSlabs() == expectedNumSlabs,
+                  "Wrong number of slabs.");
+  DAX_TEST_ASSERT(outGrid.GetNumberOfCells() ==
+                  static_cast<dax::Id>(expected.size()),
+                  "Out of core contour has wrong number of triangles.");
+  DAX_TEST_ASSERT(outGrid.GetNumberOfPoints() == expectedNumPoints,
+                  "Points on slab seams were not merged.");
+
+  std::vector<Triangle> triangles = GetTriangles(outGrid);
+  for (std::size_t index = 0; index < expected.size(); ++index)
+    {
+    for (int p = 0; p < 3; ++p)
+      {
+      DAX_TEST_ASSERT(test_equal(triangles[index].Points[p],
+                                 expected[index].Points[p]),
+                      "Out of core contour does not match in core contour.");
+      }
+    }
+}
+
+void TestOutOfCore()
+{
+  dax::io::ReaderVolume reader(FILE_NAME);
+
+  GridType inCoreGrid;
+  ContourInCore(reader, inCoreGrid);
+  std::vector<Triangle> expected = GetTriangles(inCoreGrid);
+  std::cout << "In core contour has " << inCoreGrid.GetNumberOfCells()
+            << " triangles and " << inCoreGrid.GetNumberOfPoints()
+            << " points." << std::endl;
+  DAX_TEST_ASSERT(inCoreGrid.GetNumberOfCells() > 0,
+                  "Test volume produced no triangles.");
+
+  // 20 cell layers.
+  CheckSlabDepth(reader, expected, inCoreGrid.GetNumberOfPoints(), 1, 20);
+  CheckSlabDepth(reader, expected, inCoreGrid.GetNumberOfPoints(), 3, 7);
+  CheckSlabDepth(reader, expected, inCoreGrid.GetNumberOfPoints(), 20, 1);
+  CheckSlabDepth(reader, expected, inCoreGrid.GetNumberOfPoints(), 100, 1);
+}
+
+void TestMarchingCubesOutOfCore()
+{
+  WriteVolume();
+  try
+    {
+    TestOutOfCore();
+    }
+  catch (...)
+    {
+    std::remove(FILE_NAME);
+    throw;
+    }
+  std::remove(FILE_NAME);
+}
+
+} // anonymous namespace
+
+int UnitTestMarchingCubesOutOfCore(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestMarchingCubesOutOfCore);
+}
@@ -0,0 +1,233 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/io/ReaderVolume.h>
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DispatcherMapField.h>
+#include <dax/worklet/Square.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const dax::Id3 DIMENSIONS = dax::make_Id3(4, 3, 2);
+const dax::Id NUMBER_OF_VALUES = 4*3*2;
+const std::size_t BYTE_OFFSET = 3;
+
+const char *RAW_FILE_NAME = "UnitTestReaderVolume.4.3.2";
+const char *BOV_DATA_FILE_NAME = "UnitTestReaderVolume.data";
+const char *BOV_HEADER_FILE_NAME = "UnitTestReaderVolume.bov";
+
+dax::Scalar TestValue(dax::Id index)
+{
+  return static_cast<dax::Scalar>(index*3 + 1);
+}
+
+template<typename T>
+void WriteValues(std::ofstream &file, dax::io::ByteOrder byteOrder)
+{
+  for (dax::Id index = 0; index < NUMBER_OF_VALUES; index++)
+    {
+    T value = static_cast<T>(TestValue(index));
+    char bytes[sizeof(T)];
+    std::copy(reinterpret_cast<const char *>(&value),
+              reinterpret_cast<const char *>(&value) + sizeof(T),
+              bytes);
+    if (byteOrder != dax::io::nativeByteOrder())
+      {
+      std::reverse(bytes, bytes + sizeof(T));
+      }
+    file.write(bytes, sizeof(T));
+    }
+}
+
+void WriteFiles()
+{
+  std::ofstream raw(RAW_FILE_NAME, std::ios::binary);
+  WriteValues<float>(raw, dax::io::nativeByteOrder());
+  raw.close();
+
+  // The BOV data is stored as big endian shorts behind a few junk bytes to
+  // force conversion, byte swapping, and an unaligned offset.
+  std::ofstream data(BOV_DATA_FILE_NAME, std::ios::binary);
+  data.write("xyz", BYTE_OFFSET);
+  WriteValues<short>(data, dax::io::BYTE_ORDER_BIG_ENDIAN);
+  data.close();
+
+  std::ofstream header(BOV_HEADER_FILE_NAME);
+  header << "# Test volume" << std::endl
+         << "TIME: 0" << std::endl
+         << "DATA_FILE: " << BOV_DATA_FILE_NAME << std::endl
+         << "DATA_SIZE: 4 3 2" << std::endl
+         << "DATA_FORMAT: SHORT" << std::endl
+         << "VARIABLE: counts" << std::endl
+         << "DATA_ENDIAN: BIG" << std::endl
+         << "CENTERING: nodal" << std::endl
+         << "BRICK_ORIGIN: 1 2 3" << std::endl
+         << "BRICK_SIZE: 6 4 2" << std::endl
+         << "BYTE_OFFSET: " << BYTE_OFFSET << std::endl;
+  header.close();
+}
+
+void RemoveFiles()
+{
+  std::remove(RAW_FILE_NAME);
+  std::remove(BOV_DATA_FILE_NAME);
+  std::remove(BOV_HEADER_FILE_NAME);
+}
+
+template<class ArrayHandleType>
+void CheckValues(const ArrayHandleType &array)
+{
+  DAX_TEST_ASSERT(array.GetNumberOfValues() == NUMBER_OF_VALUES,
+                  "Memory-mapped array has wrong size.");
+
+  std::vector<dax::Scalar> values(NUMBER_OF_VALUES);
+  array.CopyInto(values.begin());
+  for (dax::Id index = 0; index < NUMBER_OF_VALUES; index++)
+    {
+    DAX_TEST_ASSERT(test_equal(values[index], TestValue(index)),
+                    "Got bad value from memory-mapped array.");
+    }
+
+  // Run a worklet directly on the mapped values.
+  dax::cont::ArrayHandle<dax::Scalar> squared;
+  dax::cont::DispatcherMapField<dax::worklet::Square>().Invoke(array, squared);
+  std::vector<dax::Scalar> squaredValues(NUMBER_OF_VALUES);
+  squared.CopyInto(squaredValues.begin());
+  for (dax::Id index = 0; index < NUMBER_OF_VALUES; index++)
+    {
+    DAX_TEST_ASSERT(test_equal(squaredValues[index],
+                               TestValue(index)*TestValue(index)),
+                    "Got bad value from worklet on memory-mapped array.");
+    }
+}
+
+void TestRaw()
+{
+  std::cout << "Reading raw file with dimensions in its name." << std::endl;
+  dax::io::ReaderVolume reader(RAW_FILE_NAME);
+  DAX_TEST_ASSERT(reader.GetDimensions() == DIMENSIONS,
+                  "Bad dimensions parsed from raw file name.");
+  DAX_TEST_ASSERT(reader.GetDataType() == dax::io::DATA_TYPE_FLOAT32,
+                  "Raw files should default to float.");
+
+  dax::io::ArrayHandleMemoryMapped<dax::Scalar> array =
+      reader.GetPointField<dax::Scalar>();
+  DAX_TEST_ASSERT(array.GetPortalConstControl().IsDirect(),
+                  "Native floats should be read without conversion.");
+  CheckValues(array);
+
+  dax::cont::UniformGrid<> grid = reader.GetUniformGrid();
+  DAX_TEST_ASSERT(grid.GetNumberOfPoints() == NUMBER_OF_VALUES,
+                  "Grid does not match the volume.");
+}
+
+void TestBOV()
+{
+  std::cout << "Reading BOV file." << std::endl;
+  dax::io::ReaderVolume reader(BOV_HEADER_FILE_NAME);
+  DAX_TEST_ASSERT(reader.GetDimensions() == DIMENSIONS,
+                  "Bad DATA_SIZE parsed from BOV.");
+  DAX_TEST_ASSERT(reader.GetDataType() == dax::io::DATA_TYPE_INT16,
+                  "Bad DATA_FORMAT parsed from BOV.");
+  DAX_TEST_ASSERT(reader.GetByteOrder() == dax::io::BYTE_ORDER_BIG_ENDIAN,
+                  "Bad DATA_ENDIAN parsed from BOV.");
+  DAX_TEST_ASSERT(reader.GetDataOffset() == BYTE_OFFSET,
+                  "Bad BYTE_OFFSET parsed from BOV.");
+  DAX_TEST_ASSERT(reader.GetVariableName() == "counts",
+                  "Bad VARIABLE parsed from BOV.");
+  DAX_TEST_ASSERT(test_equal(reader.GetOrigin(), dax::make_Vector3(1, 2, 3)),
+                  "Bad BRICK_ORIGIN parsed from BOV.");
+  DAX_TEST_ASSERT(test_equal(reader.GetSpacing(), dax::make_Vector3(2, 2, 2)),
+                  "Bad spacing computed from BRICK_SIZE.");
+
+  dax::io::ArrayHandleMemoryMapped<dax::Scalar> array =
+      reader.GetPointField<dax::Scalar>();
+  DAX_TEST_ASSERT(!array.GetPortalConstControl().IsDirect(),
+                  "Shorts should be converted to scalars.");
+  CheckValues(array);
+}
+
+void TestErrors()
+{
+  std::cout << "Checking errors." << std::endl;
+  try
+    {
+    dax::io::ReaderVolume reader;
+    reader.OpenRaw(RAW_FILE_NAME, dax::make_Id3(5, 5, 5));
+    reader.GetPointField<dax::Scalar>();
+    DAX_TEST_FAIL("Mapping past the end of the file did not throw.");
+    }
+  catch (dax::io::ErrorIO error)
+    {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    }
+
+  try
+    {
+    dax::io::ReaderVolume reader("DoesNotExist.bov");
+    DAX_TEST_FAIL("Opening a missing file did not throw.");
+    }
+  catch (dax::io::ErrorIO error)
+    {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    }
+
+  dax::Id3 dimensions;
+  DAX_TEST_ASSERT(
+        !dax::io::ReaderVolume::ParseDimensionsFromFileName("volume.raw",
+                                                            dimensions),
+        "Found dimensions in a file name without any.");
+  DAX_TEST_ASSERT(
+        dax::io::ReaderVolume::ParseDimensionsFromFileName(
+          "/data/counts.400.300.200.raw", dimensions),
+        "Did not find dimensions in file name.");
+  DAX_TEST_ASSERT(dimensions == dax::make_Id3(400, 300, 200),
+                  "Bad dimensions found in file name.");
+}
+
+void TestReaderVolume()
+{
+  WriteFiles();
+  try
+    {
+    TestRaw();
+    TestBOV();
+    TestErrors();
+    }
+  catch (...)
+    {
+    RemoveFiles();
+    throw;
+    }
+  RemoveFiles();
+}
+
+} // anonymous namespace
+
+int UnitTestReaderVolume(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestReaderVolume);
+}
@@ -0,0 +1,319 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_SERIAL
+
+#include <dax/io/WriterUnstructuredGrid.h>
+
+#include <dax/CellTag.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/UnstructuredGrid.h>
+
+#include <dax/cont/testing/Testing.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const dax::Id NUMBER_OF_CELLS = 97;
+const dax::Id NUMBER_OF_POINTS = NUMBER_OF_CELLS + 2;
+
+// Small enough that every file spans many chunks.
+const std::size_t CHUNK_SIZE = 64;
+
+const char *VTK_FILE_NAME = "UnitTestWriterUnstructuredGrid.vtk";
+const char *VTU_FILE_NAME = "UnitTestWriterUnstructuredGrid.vtu";
+const char *POINTS_FILE_NAME = "UnitTestWriterUnstructuredGrid.points";
+const char *CONNECTIONS_FILE_NAME = "UnitTestWriterUnstructuredGrid.cells";
+
+typedef dax::cont::UnstructuredGrid<dax::CellTagTriangle> GridType;
+
+dax::Vector3 TestPoint(dax::Id index)
+{
+  return dax::make_Vector3(static_cast<dax::Scalar>(index),
+                           static_cast<dax::Scalar>(index % 2),
+                           dax::Scalar(0.5)*index);
+}
+
+// A strip of triangles.
+GridType MakeGrid()
+{
+  std::vector<dax::Vector3> points(NUMBER_OF_POINTS);
+  for (dax::Id index = 0; index < NUMBER_OF_POINTS; index++)
+    {
+    points[index] = TestPoint(index);
+    }
+  std::vector<dax::Id> connections(3*NUMBER_OF_CELLS);
+  for (dax::Id index = 0; index < 3*NUMBER_OF_CELLS; index++)
+    {
+    connections[index] = index/3 + index%3;
+    }
+
+  GridType grid;
+  grid.SetPointCoordinates(dax::cont::make_ArrayHandle(points));
+  grid.SetCellConnections(dax::cont::make_ArrayHandle(connections));
+  // Make the grid own copies so the vectors can go away.
+  GridType::PointCoordinatesType pointsCopy;
+  GridType::CellConnectionsType connectionsCopy;
+  dax::cont::DeviceAdapterAlgorithm<DAX_DEFAULT_DEVICE_ADAPTER_TAG>::Copy(
+        grid.GetPointCoordinates(), pointsCopy);
+  dax::cont::DeviceAdapterAlgorithm<DAX_DEFAULT_DEVICE_ADAPTER_TAG>::Copy(
+        grid.GetCellConnections(), connectionsCopy);
+  return GridType(connectionsCopy, pointsCopy);
+}
+
+std::string ReadFile(const char *fileName)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  DAX_TEST_ASSERT(file.good(), "Could not read back written file.");
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+template<typename T>
+T ReadValue(const std::string &contents,
+            std::size_t &position,
+            dax::io::ByteOrder byteOrder)
+{
+  DAX_TEST_ASSERT(position + sizeof(T) <= contents.size(),
+                  "File ended early.");
+  char bytes[sizeof(T)];
+  std::copy(contents.begin() + position,
+            contents.begin() + position + sizeof(T),
+            bytes);
+  if (byteOrder != dax::io::nativeByteOrder())
+    {
+    std::reverse(bytes, bytes + sizeof(T));
+    }
+  position += sizeof(T);
+  T value;
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+void ExpectText(const std::string &contents,
+                std::size_t &position,
+                const std::string &text)
+{
+  DAX_TEST_ASSERT(contents.compare(position, text.size(), text) == 0,
+                  "Unexpected text in written file.");
+  position += text.size();
+}
+
+void CheckPoints(const std::string &contents,
+                 std::size_t &position,
+                 dax::io::ByteOrder byteOrder)
+{
+  for (dax::Id index = 0; index < NUMBER_OF_POINTS; index++)
+    {
+    dax::Vector3 point;
+    point[0] = ReadValue<dax::Scalar>(contents, position, byteOrder);
+    point[1] = ReadValue<dax::Scalar>(contents, position, byteOrder);
+    point[2] = ReadValue<dax::Scalar>(contents, position, byteOrder);
+    DAX_TEST_ASSERT(test_equal(point, TestPoint(index)),
+                    "Bad point coordinates in written file.");
+    }
+}
+
+void TestWriteVTK(const GridType &grid)
+{
+  std::cout << "Writing legacy VTK" << std::endl;
+  dax::io::WriterUnstructuredGrid writer;
+  writer.SetChunkSize(CHUNK_SIZE);
+  writer.Write(grid, VTK_FILE_NAME);
+
+  const std::string contents = ReadFile(VTK_FILE_NAME);
+  const dax::io::ByteOrder order = dax::io::BYTE_ORDER_BIG_ENDIAN;
+  std::size_t position = 0;
+  std::stringstream pointsHeader;
+  pointsHeader << "# vtk DataFile Version 3.0\nDax unstructured grid\n"
+               << "BINARY\nDATASET UNSTRUCTURED_GRID\nPOINTS "
+               << NUMBER_OF_POINTS << " "
+               << ((sizeof(dax::Scalar) == 8) ? "double" : "float") << "\n";
+  ExpectText(contents, position, pointsHeader.str());
+  CheckPoints(contents, position, order);
+
+  std::stringstream cellsHeader;
+  cellsHeader << "\nCELLS " << NUMBER_OF_CELLS << " " << 4*NUMBER_OF_CELLS
+              << "\n";
+  ExpectText(contents, position, cellsHeader.str());
+  for (dax::Id cell = 0; cell < NUMBER_OF_CELLS; cell++)
+    {
+    DAX_TEST_ASSERT(ReadValue<int>(contents, position, order) == 3,
+                    "Bad cell size in legacy file.");
+    for (dax::Id vertex = 0; vertex < 3; vertex++)
+      {
+      DAX_TEST_ASSERT(ReadValue<int>(contents, position, order)
+                      == cell + vertex,
+                      "Bad cell connection in legacy file.");
+      }
+    }
+
+  std::stringstream typesHeader;
+  typesHeader << "\nCELL_TYPES " << NUMBER_OF_CELLS << "\n";
+  ExpectText(contents, position, typesHeader.str());
+  for (dax::Id cell = 0; cell < NUMBER_OF_CELLS; cell++)
+    {
+    DAX_TEST_ASSERT(ReadValue<int>(contents, position, order) == 5,
+                    "Bad cell type in legacy file.");
+    }
+  ExpectText(contents, position, "\n");
+  DAX_TEST_ASSERT(position == contents.size(), "Legacy file is too long.");
+}
+
+void TestWriteVTU(const GridType &grid)
+{
+  std::cout << "Writing VTK XML" << std::endl;
+  dax::io::WriterUnstructuredGrid writer;
+  writer.SetChunkSize(CHUNK_SIZE);
+  writer.Write(grid, VTU_FILE_NAME);
+
+  typedef dax::internal::UInt64Type HeaderType;
+  const std::string contents = ReadFile(VTU_FILE_NAME);
+  const dax::io::ByteOrder order = dax::io::nativeByteOrder();
+  DAX_TEST_ASSERT(contents.find("NumberOfCells=\"97\"") != std::string::npos,
+                  "Missing cell count in XML file.");
+
+  std::size_t position = contents.find("<AppendedData encoding=\"raw\">");
+  DAX_TEST_ASSERT(position != std::string::npos, "Missing appended data.");
+  position = contents.find('_', position) + 1;
+
+  DAX_TEST_ASSERT(ReadValue<HeaderType>(contents, position, order)
+                  == 3*NUMBER_OF_POINTS*sizeof(dax::Scalar),
+                  "Bad points size in XML file.");
+  CheckPoints(contents, position, order);
+
+  DAX_TEST_ASSERT(ReadValue<HeaderType>(contents, position, order)
+                  == 3*NUMBER_OF_CELLS*sizeof(dax::Id),
+                  "Bad connectivity size in XML file.");
+  for (dax::Id index = 0; index < 3*NUMBER_OF_CELLS; index++)
+    {
+    DAX_TEST_ASSERT(ReadValue<dax::Id>(contents, position, order)
+                    == index/3 + index%3,
+                    "Bad connectivity in XML file.");
+    }
+
+  DAX_TEST_ASSERT(ReadValue<HeaderType>(contents, position, order)
+                  == NUMBER_OF_CELLS*sizeof(dax::Id),
+                  "Bad offsets size in XML file.");
+  for (dax::Id cell = 0; cell < NUMBER_OF_CELLS; cell++)
+    {
+    DAX_TEST_ASSERT(ReadValue<dax::Id>(contents, position, order)
+                    == 3*(cell+1),
+                    "Bad offsets in XML file.");
+    }
+
+  DAX_TEST_ASSERT(ReadValue<HeaderType>(contents, position, order)
+                  == static_cast<HeaderType>(NUMBER_OF_CELLS),
+                  "Bad types size in XML file.");
+  for (dax::Id cell = 0; cell < NUMBER_OF_CELLS; cell++)
+    {
+    DAX_TEST_ASSERT(ReadValue<unsigned char>(contents, position, order) == 5,
+                    "Bad cell type in XML file.");
+    }
+  ExpectText(contents, position, "\n  </AppendedData>\n</VTKFile>\n");
+}
+
+void TestWriteRaw(const GridType &grid)
+{
+  std::cout << "Writing raw files" << std::endl;
+  dax::io::WriterUnstructuredGrid writer;
+  writer.SetChunkSize(CHUNK_SIZE);
+  writer.WriteRaw(grid, POINTS_FILE_NAME, CONNECTIONS_FILE_NAME);
+
+  const dax::io::ByteOrder order = dax::io::nativeByteOrder();
+  const std::string points = ReadFile(POINTS_FILE_NAME);
+  std::size_t position = 0;
+  CheckPoints(points, position, order);
+  DAX_TEST_ASSERT(position == points.size(), "Raw points file is too long.");
+
+  const std::string connections = ReadFile(CONNECTIONS_FILE_NAME);
+  DAX_TEST_ASSERT(connections.size() == 3*NUMBER_OF_CELLS*sizeof(dax::Id),
+                  "Raw connections file has wrong size.");
+  position = 0;
+  for (dax::Id index = 0; index < 3*NUMBER_OF_CELLS; index++)
+    {
+    DAX_TEST_ASSERT(ReadValue<dax::Id>(connections, position, order)
+                    == index/3 + index%3,
+                    "Bad raw connections.");
+    }
+}
+
+void TestErrors(const GridType &grid)
+{
+  std::cout << "Checking errors" << std::endl;
+  dax::io::WriterUnstructuredGrid writer;
+  try
+    {
+    writer.Write(grid, "UnitTestWriterUnstructuredGrid.unknown");
+    DAX_TEST_FAIL("Did not reject an unknown file extension.");
+    }
+  catch (dax::io::ErrorIO error)
+    {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    }
+
+  try
+    {
+    writer.WriteVTK(grid, "no/such/directory/grid.vtk");
+    DAX_TEST_FAIL("Did not report a file that cannot be created.");
+    }
+  catch (dax::io::ErrorIO error)
+    {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    }
+}
+
+void RemoveFiles()
+{
+  std::remove(VTK_FILE_NAME);
+  std::remove(VTU_FILE_NAME);
+  std::remove(POINTS_FILE_NAME);
+  std::remove(CONNECTIONS_FILE_NAME);
+}
+
+void TestWriterUnstructuredGrid()
+{
+  GridType grid = MakeGrid();
+  try
+    {
+    TestWriteVTK(grid);
+    TestWriteVTU(grid);
+    TestWriteRaw(grid);
+    TestErrors(grid);
+    }
+  catch (...)
+    {
+    RemoveFiles();
+    throw;
+    }
+  RemoveFiles();
+}
+
+} // anonymous namespace
+
+int UnitTestWriterUnstructuredGrid(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestWriterUnstructuredGrid);
+}
@@ -20,6 +20,7 @@
 
 #include <dax/openmp/cont/internal/DeviceAdapterTagOpenMP.h>
 
+#include <dax/cont/internal/ArrayContainerControlFirstTouch.h>
 #include <dax/cont/internal/ArrayManagerExecution.h>
 #include <dax/thrust/cont/internal/ArrayManagerExecutionThrustShare.h>
 
@@ -42,6 +43,18 @@ public:
   typedef typename Superclass::ValueType ValueType;
   typedef typename Superclass::PortalType PortalType;
   typedef typename Superclass::PortalConstType PortalConstType;
+  typedef typename Superclass::ContainerType ContainerType;
+
+  /// Allocates in the control array and, for containers that ask for it,
+  /// first touches the new pages from the threads of this device.
+  ///
+  DAX_CONT_EXPORT void AllocateArrayForOutput(ContainerType &controlArray,
+                                              dax::Id numberOfValues)
+  {
+    this->Superclass::AllocateArrayForOutput(controlArray, numberOfValues);
+    dax::cont::internal::ArrayContainerControlFirstTouch<
+        dax::openmp::cont::DeviceAdapterTagOpenMP>(controlArray);
+  }
 };
 
 }
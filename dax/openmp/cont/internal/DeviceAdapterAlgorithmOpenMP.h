@@ -22,6 +22,7 @@
 #include <dax/openmp/cont/internal/ArrayManagerExecutionOpenMP.h>
 
 #include <dax/cont/internal/DeviceAdapterAlgorithm.h>
+#include <dax/cont/internal/ScheduleTiles.h>
 
 // Here are the actual implementation of the algorithms.
 #include <dax/thrust/cont/internal/DeviceAdapterAlgorithmThrust.h>
@@ -31,6 +32,23 @@
 namespace dax {
 namespace cont {
 
+namespace internal {
+
+/// Bricks of whole rows, eight rows by eight planes, give the threads
+/// thousands of tasks on large grids while keeping the inner loop long.
+///
+template<>
+struct ScheduleTilingDefault<dax::openmp::cont::DeviceAdapterTagOpenMP>
+{
+  DAX_CONT_EXPORT static ScheduleTiling Get()
+  {
+    return ScheduleTiling(dax::make_Id3(0, 8, 8),
+                          SCHEDULE_TILE_ORDER_ROW_MAJOR);
+  }
+};
+
+} // namespace internal
+
 template<>
 struct DeviceAdapterAlgorithm<dax::openmp::cont::DeviceAdapterTagOpenMP>
     : public dax::thrust::cont::internal::DeviceAdapterAlgorithmThrust<
@@ -82,6 +100,46 @@ private:
     dax::exec::internal::ErrorMessageBuffer ErrorMessage;
   };
 
+  template<class FunctorType>
+  class ScheduleTilesKernel
+  {
+  public:
+    DAX_CONT_EXPORT ScheduleTilesKernel(
+        const FunctorType &functor,
+        const dax::cont::internal::ScheduleTiles &tiles)
+      : Functor(functor), Tiles(&tiles)
+    {  }
+
+    DAX_CONT_EXPORT void SetErrorMessageBuffer(
+        dax::exec::internal::ErrorMessageBuffer &errorMessage)
+    {
+      this->ErrorMessage = errorMessage;
+      this->Functor.SetErrorMessageBuffer(errorMessage);
+    }
+
+    DAX_EXEC_EXPORT void operator()(dax::Id tile) const {
+      // Errors are caught for the same reason as in ScheduleKernel.
+      try
+        {
+        this->Tiles->RunTiles(this->Functor, tile, tile + 1);
+        }
+      catch (dax::cont::Error error)
+        {
+        this->ErrorMessage.RaiseError(error.GetMessage().c_str());
+        }
+      catch (...)
+        {
+        this->ErrorMessage.RaiseError(
+            "Unexpected error in execution environment.");
+        }
+    }
+
+  private:
+    FunctorType Functor;
+    const dax::cont::internal::ScheduleTiles *Tiles;
+    dax::exec::internal::ErrorMessageBuffer ErrorMessage;
+  };
+
 public:
   // Override the thrust version of Schedule to handle exceptions that can occur
   // because we are running on a CPU.
@@ -94,15 +152,22 @@ public:
            numInstances);
   }
 
+  /// Thrust flattens 3D schedules. Scheduling the bricks given by the
+  /// ScheduleTilingSettings of this device instead keeps the IJK index and
+  /// reuses the points neighboring cells share from cache.
+  ///
   template<class FunctorType>
   DAX_CONT_EXPORT
   static void Schedule(FunctorType functor, dax::Id3 rangeMax)
   {
-    //default behavior for the general algorithm is to defer to the default
-    //schedule implementation.
+    const dax::cont::internal::ScheduleTiles tiles(
+          rangeMax,
+          dax::cont::internal::ScheduleTilingSettings<
+            dax::openmp::cont::DeviceAdapterTagOpenMP>::Get());
     Superclass::Schedule(
-           DeviceAdapterAlgorithm::ScheduleKernel<FunctorType>(functor),
-           rangeMax);
+           DeviceAdapterAlgorithm::ScheduleTilesKernel<FunctorType>(
+             functor, tiles),
+           tiles.GetNumberOfTiles());
   }
 
   DAX_CONT_EXPORT static void Synchronize()
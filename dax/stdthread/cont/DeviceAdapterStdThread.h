@@ -0,0 +1,23 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_stdthread_cont_DeviceAdapterStdThread_h
+#define __dax_stdthread_cont_DeviceAdapterStdThread_h
+
+#include <dax/stdthread/cont/internal/DeviceAdapterTagStdThread.h>
+#include <dax/stdthread/cont/internal/ArrayManagerExecutionStdThread.h>
+#include <dax/stdthread/cont/internal/DeviceAdapterAlgorithmStdThread.h>
+
+#endif //__dax_stdthread_cont_DeviceAdapterStdThread_h
@@ -0,0 +1,60 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_stdthread_cont_internal_ArrayManagerExecutionStdThread_h
+#define __dax_stdthread_cont_internal_ArrayManagerExecutionStdThread_h
+
+#include <dax/stdthread/cont/internal/DeviceAdapterTagStdThread.h>
+
+#include <dax/cont/internal/ArrayManagerExecution.h>
+#include <dax/cont/internal/ArrayContainerControlFirstTouch.h>
+#include <dax/cont/internal/ArrayManagerExecutionShareWithControl.h>
+
+// These must be placed in the dax::cont::internal namespace so that
+// the template can be found.
+
+namespace dax {
+namespace cont {
+namespace internal {
+
+template <typename T, class ArrayContainerTag>
+class ArrayManagerExecution
+    <T, ArrayContainerTag, dax::stdthread::cont::DeviceAdapterTagStdThread>
+    : public dax::cont::internal::ArrayManagerExecutionShareWithControl
+        <T, ArrayContainerTag>
+{
+public:
+  typedef dax::cont::internal::ArrayManagerExecutionShareWithControl
+      <T, ArrayContainerTag> Superclass;
+  typedef typename Superclass::ContainerType ContainerType;
+
+  /// Allocates in the control array and, for containers that ask for it,
+  /// first touches the new pages from the threads of this device.
+  ///
+  DAX_CONT_EXPORT void AllocateArrayForOutput(ContainerType &controlArray,
+                                              dax::Id numberOfValues)
+  {
+    this->Superclass::AllocateArrayForOutput(controlArray, numberOfValues);
+    dax::cont::internal::ArrayContainerControlFirstTouch<
+        dax::stdthread::cont::DeviceAdapterTagStdThread>(controlArray);
+  }
+};
+
+}
+}
+} // namespace dax::cont::internal
+
+
+#endif //__dax_stdthread_cont_internal_ArrayManagerExecutionStdThread_h
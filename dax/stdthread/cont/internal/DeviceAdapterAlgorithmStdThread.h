@@ -0,0 +1,967 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_stdthread_cont_internal_DeviceAdapterAlgorithmStdThread_h
+#define __dax_stdthread_cont_internal_DeviceAdapterAlgorithmStdThread_h
+
+#include <dax/stdthread/cont/internal/DeviceAdapterTagStdThread.h>
+#include <dax/stdthread/cont/internal/ArrayManagerExecutionStdThread.h>
+#include <dax/stdthread/cont/internal/ThreadPool.h>
+
+#include <dax/Functional.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleCounting.h>
+#include <dax/cont/ErrorExecution.h>
+#include <dax/cont/Tracing.h>
+#include <dax/cont/internal/ArrayPortalFromIterators.h>
+#include <dax/cont/internal/DeviceAdapterAlgorithm.h>
+#include <dax/cont/internal/DeviceAdapterAlgorithmGeneral.h>
+#include <dax/cont/internal/RadixSort.h>
+#include <dax/cont/internal/ScheduleTiles.h>
+
+#include <dax/exec/internal/ErrorMessageBuffer.h>
+
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace dax {
+namespace cont {
+
+namespace internal {
+
+/// Bricks of whole rows, eight rows by eight planes, give the threads
+/// thousands of tasks to balance on large grids while keeping the inner loop
+/// long.
+///
+template<>
+struct ScheduleTilingDefault<dax::stdthread::cont::DeviceAdapterTagStdThread>
+{
+  DAX_CONT_EXPORT static ScheduleTiling Get()
+  {
+    return ScheduleTiling(dax::make_Id3(0, 8, 8),
+                          SCHEDULE_TILE_ORDER_ROW_MAJOR);
+  }
+};
+
+} // namespace internal
+
+template<>
+struct DeviceAdapterAlgorithm<dax::stdthread::cont::DeviceAdapterTagStdThread> :
+    dax::cont::internal::DeviceAdapterAlgorithmGeneral<
+        DeviceAdapterAlgorithm<dax::stdthread::cont::DeviceAdapterTagStdThread>,
+        dax::stdthread::cont::DeviceAdapterTagStdThread>
+{
+private:
+  typedef dax::stdthread::cont::DeviceAdapterTagStdThread DeviceAdapterTag;
+  typedef dax::cont::internal::DeviceAdapterAlgorithmGeneral<
+      DeviceAdapterAlgorithm<DeviceAdapterTag>,
+      DeviceAdapterTag> Superclass;
+  typedef dax::stdthread::cont::internal::ThreadPool ThreadPool;
+
+  // Pieces of a schedule are kept small enough that every thread gets
+  // several of them to balance the load, and no larger than this.
+  static const dax::Id MAX_GRAIN_SIZE = 1024;
+
+  // The number of values one scan or stream compact chunk covers.
+  static const dax::Id CHUNK_SIZE = 1 << 14;
+
+  DAX_CONT_EXPORT static dax::Id GetGrainSize(dax::Id numInstances,
+                                              dax::Id maxGrainSize)
+  {
+    const dax::Id numThreads = ThreadPool::GetInstance().GetNumberOfThreads();
+    return std::max(dax::Id(1),
+                    std::min(maxGrainSize, numInstances/(8*numThreads)));
+  }
+
+  DAX_CONT_EXPORT static dax::Id GetNumberOfChunks(dax::Id numValues)
+  {
+    return (numValues + CHUNK_SIZE - 1)/CHUNK_SIZE;
+  }
+
+  //--------------------------------------------------------------------------
+  // Schedule
+  template<class FunctorType>
+  class ScheduleKernel
+  {
+  public:
+    DAX_CONT_EXPORT ScheduleKernel(const FunctorType &functor)
+      : Functor(functor)
+    {  }
+
+    DAX_CONT_EXPORT void SetErrorMessageBuffer(
+        const dax::exec::internal::ErrorMessageBuffer &errorMessage)
+    {
+      this->ErrorMessage = errorMessage;
+      this->Functor.SetErrorMessageBuffer(errorMessage);
+    }
+
+    DAX_EXEC_EXPORT
+    void operator()(dax::Id begin, dax::Id end) const {
+      // The StdThread device adapter causes array classes to be shared
+      // between control and execution environment. This means that it is
+      // possible for an exception to be thrown even though this is typically
+      // not allowed. Throwing an exception from here is bad because there are
+      // several simultaneous threads running. Get around the problem by
+      // catching the error and setting the message buffer as expected.
+      try
+        {
+        for (dax::Id index = begin; index < end; index++)
+          {
+          this->Functor(index);
+          }
+        }
+      catch (dax::cont::Error error)
+        {
+        this->ErrorMessage.RaiseError(error.GetMessage().c_str());
+        }
+      catch (...)
+        {
+        this->ErrorMessage.RaiseError(
+            "Unexpected error in execution environment.");
+        }
+    }
+  private:
+    FunctorType Functor;
+    dax::exec::internal::ErrorMessageBuffer ErrorMessage;
+  };
+
+public:
+  template<class FunctorType>
+  DAX_CONT_EXPORT
+  static void Schedule(FunctorType functor, dax::Id numInstances)
+  {
+    DAX_TRACE_SCOPE("algorithm", "Schedule", numInstances, 0);
+    const dax::Id MESSAGE_SIZE = 1024;
+    char errorString[MESSAGE_SIZE];
+    errorString[0] = '\0';
+    dax::exec::internal::ErrorMessageBuffer
+        errorMessage(errorString, MESSAGE_SIZE);
+
+    ScheduleKernel<FunctorType> kernel(functor);
+    kernel.SetErrorMessageBuffer(errorMessage);
+
+    ThreadPool::GetInstance().ParallelFor(
+          0, numInstances, GetGrainSize(numInstances, MAX_GRAIN_SIZE), kernel);
+
+    if (errorMessage.IsErrorRaised())
+      {
+      throw dax::cont::ErrorExecution(errorString);
+      }
+  }
+
+private:
+  // Runs bricks of the schedule so that the points a cell shares with its
+  // neighbors are reused from cache. A task is a range of tiles.
+  template<class FunctorType>
+  class ScheduleKernelId3
+  {
+  public:
+    DAX_CONT_EXPORT ScheduleKernelId3(
+        const FunctorType &functor,
+        const dax::cont::internal::ScheduleTiles &tiles)
+      : Functor(functor),
+        Tiles(&tiles)
+      {  }
+
+    DAX_CONT_EXPORT void SetErrorMessageBuffer(
+        const dax::exec::internal::ErrorMessageBuffer &errorMessage)
+    {
+      this->ErrorMessage = errorMessage;
+      this->Functor.SetErrorMessageBuffer(errorMessage);
+    }
+
+    DAX_EXEC_EXPORT
+    void operator()(dax::Id beginTile, dax::Id endTile) const {
+      try
+        {
+        this->Tiles->RunTiles(this->Functor, beginTile, endTile);
+        }
+      catch (dax::cont::Error error)
+        {
+        this->ErrorMessage.RaiseError(error.GetMessage().c_str());
+        }
+      catch (...)
+        {
+        this->ErrorMessage.RaiseError(
+            "Unexpected error in execution environment.");
+        }
+    }
+  private:
+    FunctorType Functor;
+    const dax::cont::internal::ScheduleTiles *Tiles;
+    dax::exec::internal::ErrorMessageBuffer ErrorMessage;
+  };
+
+public:
+  /// Schedules the bricks given by the ScheduleTilingSettings of this
+  /// device. Whole tiles run on one thread, so the tile shape also sets the
+  /// granularity of the load balancing.
+  ///
+  template<class FunctorType>
+  DAX_CONT_EXPORT
+  static void Schedule(FunctorType functor,
+                       dax::Id3 rangeMax)
+  {
+    DAX_TRACE_SCOPE("algorithm", "Schedule",
+                    rangeMax[0]*rangeMax[1]*rangeMax[2], 0);
+    const dax::Id MESSAGE_SIZE = 1024;
+    char errorString[MESSAGE_SIZE];
+    errorString[0] = '\0';
+    dax::exec::internal::ErrorMessageBuffer
+        errorMessage(errorString, MESSAGE_SIZE);
+
+    const dax::cont::internal::ScheduleTiles tiles(
+          rangeMax,
+          dax::cont::internal::ScheduleTilingSettings<DeviceAdapterTag>::Get());
+    ScheduleKernelId3<FunctorType> kernel(functor, tiles);
+    kernel.SetErrorMessageBuffer(errorMessage);
+
+    const dax::Id numTiles = tiles.GetNumberOfTiles();
+    if (numTiles > 0)
+      {
+      const dax::Id maxTiles =
+          std::max(dax::Id(1), MAX_GRAIN_SIZE/tiles.GetTileSize());
+      ThreadPool::GetInstance().ParallelFor(
+            0, numTiles, GetGrainSize(numTiles, maxTiles), kernel);
+      }
+
+    if (errorMessage.IsErrorRaised())
+      {
+      throw dax::cont::ErrorExecution(errorString);
+      }
+  }
+
+  //--------------------------------------------------------------------------
+  // Scan
+private:
+  enum ScanChunkState
+  {
+    SCAN_CHUNK_NOT_READY = 0,
+    SCAN_CHUNK_AGGREGATE_READY = 1,
+    SCAN_CHUNK_PREFIX_READY = 2
+  };
+
+  template<typename T>
+  struct ScanChunkStatus
+  {
+    std::atomic<int> State;
+    T Aggregate;
+    T InclusivePrefix;
+  };
+
+  // Single pass scan with decoupled look-back. Each chunk sums its values
+  // and publishes the sum. It then walks back over the chunks before it,
+  // adding published sums, until it finds a chunk that already published
+  // its inclusive prefix. Chunks are handed out in order from a shared
+  // counter, so every chunk waited on is already being worked on and the
+  // look-back cannot deadlock, whatever the order threads run in.
+  template<class InputPortalType, class OutputPortalType>
+  struct ScanBody
+  {
+    typedef typename boost::remove_reference<
+        typename OutputPortalType::ValueType>::type ValueType;
+
+    InputPortalType InputPortal;
+    OutputPortalType OutputPortal;
+    dax::Id NumberOfValues;
+    dax::Id NumberOfChunks;
+    bool Inclusive;
+    ScanChunkStatus<ValueType> *Status;
+    std::atomic<dax::Id> *NextChunk;
+
+    DAX_CONT_EXPORT ScanBody(const InputPortalType &inputPortal,
+                             const OutputPortalType &outputPortal,
+                             dax::Id numberOfValues,
+                             dax::Id numberOfChunks,
+                             bool inclusive,
+                             ScanChunkStatus<ValueType> *status,
+                             std::atomic<dax::Id> *nextChunk)
+      : InputPortal(inputPortal),
+        OutputPortal(outputPortal),
+        NumberOfValues(numberOfValues),
+        NumberOfChunks(numberOfChunks),
+        Inclusive(inclusive),
+        Status(status),
+        NextChunk(nextChunk)
+    {  }
+
+    DAX_CONT_EXPORT void operator()(dax::Id, dax::Id) const
+    {
+      for (dax::Id chunk = this->NextChunk->fetch_add(1);
+           chunk < this->NumberOfChunks;
+           chunk = this->NextChunk->fetch_add(1))
+        {
+        this->ScanChunk(chunk);
+        }
+    }
+
+    DAX_CONT_EXPORT void ScanChunk(dax::Id chunk) const
+    {
+      const dax::Id begin = chunk*CHUNK_SIZE;
+      const dax::Id end = std::min(begin + CHUNK_SIZE, this->NumberOfValues);
+
+      ValueType aggregate = this->InputPortal.Get(begin);
+      for (dax::Id index = begin + 1; index < end; ++index)
+        {
+        aggregate = aggregate + this->InputPortal.Get(index);
+        }
+
+      ScanChunkStatus<ValueType> &status = this->Status[chunk];
+      ValueType exclusive = ValueType(0);
+      if (chunk == 0)
+        {
+        status.InclusivePrefix = aggregate;
+        status.State.store(SCAN_CHUNK_PREFIX_READY, std::memory_order_release);
+        }
+      else
+        {
+        status.Aggregate = aggregate;
+        status.State.store(SCAN_CHUNK_AGGREGATE_READY,
+                           std::memory_order_release);
+
+        dax::Id lookBack = chunk - 1;
+        while (true)
+          {
+          ScanChunkStatus<ValueType> &previous = this->Status[lookBack];
+          const int state = previous.State.load(std::memory_order_acquire);
+          if (state == SCAN_CHUNK_PREFIX_READY)
+            {
+            exclusive = previous.InclusivePrefix + exclusive;
+            break;
+            }
+          else if (state == SCAN_CHUNK_AGGREGATE_READY)
+            {
+            exclusive = previous.Aggregate + exclusive;
+            --lookBack;
+            }
+          else
+            {
+            std::this_thread::yield();
+            }
+          }
+
+        status.InclusivePrefix = exclusive + aggregate;
+        status.State.store(SCAN_CHUNK_PREFIX_READY, std::memory_order_release);
+        }
+
+      // Read each input before writing its output so in place scans work.
+      ValueType running = exclusive;
+      if (this->Inclusive)
+        {
+        for (dax::Id index = begin; index < end; ++index)
+          {
+          running = running + this->InputPortal.Get(index);
+          this->OutputPortal.Set(index, running);
+          }
+        }
+      else
+        {
+        for (dax::Id index = begin; index < end; ++index)
+          {
+          const ValueType value = this->InputPortal.Get(index);
+          this->OutputPortal.Set(index, running);
+          running = running + value;
+          }
+        }
+    }
+  };
+
+  template<class InputPortalType, class OutputPortalType>
+  DAX_CONT_EXPORT static
+  typename ScanBody<InputPortalType,OutputPortalType>::ValueType
+  ScanPortals(const InputPortalType &inputPortal,
+              const OutputPortalType &outputPortal,
+              dax::Id numberOfValues,
+              bool inclusive)
+  {
+    typedef ScanBody<InputPortalType,OutputPortalType> BodyType;
+    typedef typename BodyType::ValueType ValueType;
+
+    const dax::Id numChunks = GetNumberOfChunks(numberOfValues);
+    std::vector<ScanChunkStatus<ValueType> > status(numChunks);
+    for (dax::Id chunk = 0; chunk < numChunks; ++chunk)
+      {
+      status[chunk].State.store(SCAN_CHUNK_NOT_READY);
+      }
+    std::atomic<dax::Id> nextChunk(0);
+
+    BodyType body(inputPortal, outputPortal, numberOfValues, numChunks,
+                  inclusive, &status[0], &nextChunk);
+
+    // One body per thread. Each keeps taking chunks until none are left.
+    const dax::Id numBodies = std::min(
+          numChunks, ThreadPool::GetInstance().GetNumberOfThreads());
+    ThreadPool::GetInstance().ParallelFor(0, numBodies, 1, body);
+
+    return status[numChunks-1].InclusivePrefix;
+  }
+
+public:
+  template<typename T, class CIn, class COut>
+  DAX_CONT_EXPORT static T ScanInclusive(
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& output)
+  {
+    DAX_TRACE_SCOPE("algorithm", "ScanInclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
+    const dax::Id numberOfValues = input.GetNumberOfValues();
+    typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>
+        ::PortalConstExecution inputPortal = input.PrepareForInput();
+    typename dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>
+        ::PortalExecution outputPortal = output.PrepareForOutput(numberOfValues);
+
+    if (numberOfValues <= 0) { return 0; }
+
+    return ScanPortals(inputPortal, outputPortal, numberOfValues, true);
+  }
+
+  template<typename T, class CIn, class COut>
+  DAX_CONT_EXPORT static T ScanExclusive(
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& output)
+  {
+    DAX_TRACE_SCOPE("algorithm", "ScanExclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
+    const dax::Id numberOfValues = input.GetNumberOfValues();
+    typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>
+        ::PortalConstExecution inputPortal = input.PrepareForInput();
+    typename dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>
+        ::PortalExecution outputPortal = output.PrepareForOutput(numberOfValues);
+
+    if (numberOfValues <= 0) { return 0; }
+
+    return ScanPortals(inputPortal, outputPortal, numberOfValues, false);
+  }
+
+  //--------------------------------------------------------------------------
+  // Stream Compact
+private:
+  template<class StencilPortalType>
+  struct CompactCountBody
+  {
+    typedef typename StencilPortalType::ValueType StencilValueType;
+    StencilPortalType StencilPortal;
+    dax::Id NumberOfValues;
+    dax::Id *Counts;
+
+    DAX_CONT_EXPORT CompactCountBody(const StencilPortalType &stencilPortal,
+                                     dax::Id numberOfValues,
+                                     dax::Id *counts)
+      : StencilPortal(stencilPortal),
+        NumberOfValues(numberOfValues),
+        Counts(counts)
+    {  }
+
+    DAX_CONT_EXPORT void operator()(dax::Id beginChunk, dax::Id endChunk) const
+    {
+      for (dax::Id chunk = beginChunk; chunk < endChunk; ++chunk)
+        {
+        const dax::Id end =
+            std::min((chunk+1)*CHUNK_SIZE, this->NumberOfValues);
+        dax::Id count = 0;
+        for (dax::Id index = chunk*CHUNK_SIZE; index < end; ++index)
+          {
+          if (dax::not_default_constructor<StencilValueType>()(
+                this->StencilPortal.Get(index)))
+            {
+            ++count;
+            }
+          }
+        this->Counts[chunk] = count;
+        }
+    }
+  };
+
+  template<class InputPortalType,
+           class StencilPortalType,
+           class OutputPortalType>
+  struct CompactWriteBody
+  {
+    typedef typename StencilPortalType::ValueType StencilValueType;
+    InputPortalType InputPortal;
+    StencilPortalType StencilPortal;
+    OutputPortalType OutputPortal;
+    dax::Id NumberOfValues;
+    const dax::Id *Offsets;
+
+    DAX_CONT_EXPORT CompactWriteBody(const InputPortalType &inputPortal,
+                                     const StencilPortalType &stencilPortal,
+                                     const OutputPortalType &outputPortal,
+                                     dax::Id numberOfValues,
+                                     const dax::Id *offsets)
+      : InputPortal(inputPortal),
+        StencilPortal(stencilPortal),
+        OutputPortal(outputPortal),
+        NumberOfValues(numberOfValues),
+        Offsets(offsets)
+    {  }
+
+    DAX_CONT_EXPORT void operator()(dax::Id beginChunk, dax::Id endChunk) const
+    {
+      for (dax::Id chunk = beginChunk; chunk < endChunk; ++chunk)
+        {
+        const dax::Id end =
+            std::min((chunk+1)*CHUNK_SIZE, this->NumberOfValues);
+        dax::Id outputIndex = this->Offsets[chunk];
+        for (dax::Id index = chunk*CHUNK_SIZE; index < end; ++index)
+          {
+          if (dax::not_default_constructor<StencilValueType>()(
+                this->StencilPortal.Get(index)))
+            {
+            this->OutputPortal.Set(outputIndex++, this->InputPortal.Get(index));
+            }
+          }
+        }
+    }
+  };
+
+public:
+  /// Counts the kept values of each chunk in parallel, scans the counts, then
+  /// writes each chunk in parallel. Unlike the general implementation, no
+  /// array of indices the size of the input is needed.
+  ///
+  template<typename T, typename U, class CIn, class CStencil, class COut>
+  DAX_CONT_EXPORT static void StreamCompact(
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
+      const dax::cont::ArrayHandle<U,CStencil,DeviceAdapterTag>& stencil,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& output)
+  {
+    DAX_TRACE_SCOPE("algorithm", "StreamCompact", stencil.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(stencil));
+    typedef typename dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>
+        ::PortalConstExecution InputPortalType;
+    typedef typename dax::cont::ArrayHandle<U,CStencil,DeviceAdapterTag>
+        ::PortalConstExecution StencilPortalType;
+    typedef typename dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>
+        ::PortalExecution OutputPortalType;
+
+    DAX_ASSERT_CONT(input.GetNumberOfValues() == stencil.GetNumberOfValues());
+    const dax::Id numberOfValues = stencil.GetNumberOfValues();
+    const dax::Id numChunks = GetNumberOfChunks(numberOfValues);
+
+    StencilPortalType stencilPortal = stencil.PrepareForInput();
+    InputPortalType inputPortal = input.PrepareForInput();
+
+    std::vector<dax::Id> offsets(numChunks + 1, 0);
+    if (numChunks > 0)
+      {
+      CompactCountBody<StencilPortalType> countBody(stencilPortal,
+                                                    numberOfValues,
+                                                    &offsets[0]);
+      ThreadPool::GetInstance().ParallelFor(0, numChunks, 1, countBody);
+      }
+
+    dax::Id outputLength = 0;
+    for (dax::Id chunk = 0; chunk < numChunks; ++chunk)
+      {
+      const dax::Id count = offsets[chunk];
+      offsets[chunk] = outputLength;
+      outputLength += count;
+      }
+
+    OutputPortalType outputPortal = output.PrepareForOutput(outputLength);
+
+    if (outputLength > 0)
+      {
+      CompactWriteBody<InputPortalType,StencilPortalType,OutputPortalType>
+          writeBody(inputPortal, stencilPortal, outputPortal,
+                    numberOfValues, &offsets[0]);
+      ThreadPool::GetInstance().ParallelFor(0, numChunks, 1, writeBody);
+      }
+  }
+
+  template<typename T, class CStencil, class COut>
+  DAX_CONT_EXPORT static void StreamCompact(
+      const dax::cont::ArrayHandle<T,CStencil,DeviceAdapterTag> &stencil,
+      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &output)
+  {
+    StreamCompact(dax::cont::make_ArrayHandleCounting(dax::Id(0),
+                                                      stencil.GetNumberOfValues(),
+                                                      DeviceAdapterTag()),
+                  stencil,
+                  output);
+  }
+
+  //--------------------------------------------------------------------------
+  // Sort
+private:
+  template<class KernelType>
+  struct RadixSortBlockBody
+  {
+    DAX_CONT_EXPORT RadixSortBlockBody(const KernelType &kernel)
+      : Kernel(kernel) {  }
+
+    DAX_CONT_EXPORT void operator()(dax::Id begin, dax::Id end) const
+    {
+      for (dax::Id block = begin; block < end; ++block)
+        {
+        this->Kernel(block);
+        }
+    }
+  private:
+    const KernelType &Kernel;
+  };
+
+  // Runs the blocks of a radix sort pass in parallel. Each block needs its
+  // own histogram per pass, so blocks are kept large.
+  struct RadixSortBlocksStdThread
+  {
+    DAX_CONT_EXPORT dax::Id GetNumberOfBlocks(dax::Id numValues) const
+    {
+      const dax::Id MIN_BLOCK_SIZE = 1 << 16;
+      const dax::Id MAX_BLOCKS = 256;
+      return std::min(numValues / MIN_BLOCK_SIZE + 1, MAX_BLOCKS);
+    }
+
+    template<class KernelType>
+    DAX_CONT_EXPORT void operator()(const KernelType &kernel,
+                                    dax::Id numBlocks) const
+    {
+      ThreadPool::GetInstance().ParallelFor(
+            0, numBlocks, 1, RadixSortBlockBody<KernelType>(kernel));
+    }
+  };
+
+  struct LessThanCompare
+  {
+    template<typename T>
+    DAX_EXEC_EXPORT bool operator()(const T &first, const T &second) const
+    {
+      return first < second;
+    }
+  };
+
+  template<class PortalType, class Compare>
+  struct SortRunsBody
+  {
+    PortalType Portal;
+    dax::Id RunSize;
+    Compare Comp;
+
+    DAX_CONT_EXPORT SortRunsBody(const PortalType &portal,
+                                 dax::Id runSize,
+                                 Compare comp)
+      : Portal(portal), RunSize(runSize), Comp(comp)
+    {  }
+
+    DAX_CONT_EXPORT void operator()(dax::Id beginRun, dax::Id endRun) const
+    {
+      const dax::Id numberOfValues = this->Portal.GetNumberOfValues();
+      for (dax::Id run = beginRun; run < endRun; ++run)
+        {
+        const dax::Id begin = std::min(run*this->RunSize, numberOfValues);
+        const dax::Id end = std::min(begin + this->RunSize, numberOfValues);
+        std::sort(this->Portal.GetIteratorBegin() + begin,
+                  this->Portal.GetIteratorBegin() + end,
+                  this->Comp);
+        }
+    }
+  };
+
+  // Merges neighboring sorted runs of Width values from Source into
+  // Destination. A task covers a range of output positions. Where a range
+  // starts inside a merge, the merge path (a binary search along the
+  // diagonal of the two runs) finds how many values of each run come
+  // before it, so every range is merged independently.
+  template<class SourcePortalType, class DestinationPortalType, class Compare>
+  struct MergeRunsBody
+  {
+    SourcePortalType Source;
+    DestinationPortalType Destination;
+    dax::Id Width;
+    dax::Id NumberOfValues;
+    Compare Comp;
+
+    DAX_CONT_EXPORT MergeRunsBody(const SourcePortalType &source,
+                                  const DestinationPortalType &destination,
+                                  dax::Id width,
+                                  Compare comp)
+      : Source(source),
+        Destination(destination),
+        Width(width),
+        NumberOfValues(source.GetNumberOfValues()),
+        Comp(comp)
+    {  }
+
+    // The number of values from [aBegin,aEnd) among the first diagonal
+    // values of the merge with [bBegin,bEnd).
+    DAX_CONT_EXPORT dax::Id MergePath(dax::Id aBegin, dax::Id aEnd,
+                                      dax::Id bBegin, dax::Id bEnd,
+                                      dax::Id diagonal) const
+    {
+      dax::Id low = std::max(dax::Id(0), diagonal - (bEnd - bBegin));
+      dax::Id high = std::min(diagonal, aEnd - aBegin);
+      while (low < high)
+        {
+        const dax::Id middle = low + (high - low)/2;
+        if (this->Comp(this->Source.Get(bBegin + diagonal - middle - 1),
+                       this->Source.Get(aBegin + middle)))
+          {
+          high = middle;
+          }
+        else
+          {
+          low = middle + 1;
+          }
+        }
+      return low;
+    }
+
+    DAX_CONT_EXPORT void operator()(dax::Id begin, dax::Id end) const
+    {
+      dax::Id outputIndex = begin;
+      while (outputIndex < end)
+        {
+        const dax::Id mergeBegin = outputIndex - outputIndex % (2*this->Width);
+        const dax::Id middle =
+            std::min(mergeBegin + this->Width, this->NumberOfValues);
+        const dax::Id mergeEnd =
+            std::min(mergeBegin + 2*this->Width, this->NumberOfValues);
+        const dax::Id segmentEnd = std::min(end, mergeEnd);
+
+        const dax::Id fromA = this->MergePath(mergeBegin, middle,
+                                              middle, mergeEnd,
+                                              outputIndex - mergeBegin);
+        dax::Id aIndex = mergeBegin + fromA;
+        dax::Id bIndex = middle + (outputIndex - mergeBegin - fromA);
+
+        for (; outputIndex < segmentEnd; ++outputIndex)
+          {
+          if ((aIndex < middle) &&
+              ((bIndex >= mergeEnd) ||
+               !this->Comp(this->Source.Get(bIndex), this->Source.Get(aIndex))))
+            {
+            this->Destination.Set(outputIndex, this->Source.Get(aIndex++));
+            }
+          else
+            {
+            this->Destination.Set(outputIndex, this->Source.Get(bIndex++));
+            }
+          }
+        }
+    }
+  };
+
+  template<class SourcePortalType, class DestinationPortalType>
+  struct CopyBody
+  {
+    SourcePortalType Source;
+    DestinationPortalType Destination;
+
+    DAX_CONT_EXPORT CopyBody(const SourcePortalType &source,
+                             const DestinationPortalType &destination)
+      : Source(source), Destination(destination)
+    {  }
+
+    DAX_CONT_EXPORT void operator()(dax::Id begin, dax::Id end) const
+    {
+      for (dax::Id index = begin; index < end; ++index)
+        {
+        this->Destination.Set(index, this->Source.Get(index));
+        }
+    }
+  };
+
+  template<class SourcePortalType, class DestinationPortalType, class Compare>
+  DAX_CONT_EXPORT static void MergeRuns(const SourcePortalType &source,
+                                        const DestinationPortalType &destination,
+                                        dax::Id width,
+                                        Compare comp)
+  {
+    const dax::Id MIN_MERGE_GRAIN = 1 << 12;
+    const dax::Id numberOfValues = source.GetNumberOfValues();
+    const dax::Id numThreads = ThreadPool::GetInstance().GetNumberOfThreads();
+
+    MergeRunsBody<SourcePortalType,DestinationPortalType,Compare>
+        body(source, destination, width, comp);
+    ThreadPool::GetInstance().ParallelFor(
+          0, numberOfValues,
+          std::max(MIN_MERGE_GRAIN, numberOfValues/(4*numThreads)),
+          body);
+  }
+
+  // Parallel merge sort: sort one run per task with std::sort, then merge
+  // pairs of runs, ping-ponging between the array and a buffer. Every merge
+  // round is split over all threads, not only the first few.
+  template<class PortalType, class Compare>
+  DAX_CONT_EXPORT static void MergeSort(const PortalType &portal, Compare comp)
+  {
+    typedef typename PortalType::ValueType ValueType;
+    typedef std::vector<ValueType> BufferType;
+    typedef dax::cont::internal::ArrayPortalFromIterators<
+        typename BufferType::iterator> BufferPortalType;
+
+    const dax::Id MIN_RUN_SIZE = 1 << 12;
+    const dax::Id numberOfValues = portal.GetNumberOfValues();
+    const dax::Id numThreads = ThreadPool::GetInstance().GetNumberOfThreads();
+
+    if ((numThreads < 2) || (numberOfValues < 2*MIN_RUN_SIZE))
+      {
+      std::sort(portal.GetIteratorBegin(), portal.GetIteratorEnd(), comp);
+      return;
+      }
+
+    dax::Id numRuns = 1;
+    while ((numRuns < 2*numThreads) &&
+           (numberOfValues/(2*numRuns) >= MIN_RUN_SIZE))
+      {
+      numRuns *= 2;
+      }
+    const dax::Id runSize = (numberOfValues + numRuns - 1)/numRuns;
+
+    SortRunsBody<PortalType,Compare> sortRuns(portal, runSize, comp);
+    ThreadPool::GetInstance().ParallelFor(0, numRuns, 1, sortRuns);
+
+    BufferType buffer(numberOfValues);
+    BufferPortalType bufferPortal(buffer.begin(), buffer.end());
+
+    bool inBuffer = false;
+    for (dax::Id width = runSize; width < numberOfValues; width *= 2)
+      {
+      if (inBuffer)
+        {
+        MergeRuns(bufferPortal, portal, width, comp);
+        }
+      else
+        {
+        MergeRuns(portal, bufferPortal, width, comp);
+        }
+      inBuffer = !inBuffer;
+      }
+
+    if (inBuffer)
+      {
+      CopyBody<BufferPortalType,PortalType> copy(bufferPortal, portal);
+      ThreadPool::GetInstance().ParallelFor(
+            0, numberOfValues,
+            GetGrainSize(numberOfValues, MIN_RUN_SIZE),
+            copy);
+      }
+  }
+
+  template<class PortalType>
+  DAX_CONT_EXPORT static void SortPortal(const PortalType &portal,
+                                         boost::true_type)
+  {
+    dax::cont::internal::RadixSort(portal.GetIteratorBegin(),
+                                   portal.GetIteratorEnd(),
+                                   RadixSortBlocksStdThread());
+  }
+
+  template<class PortalType>
+  DAX_CONT_EXPORT static void SortPortal(const PortalType &portal,
+                                         boost::false_type)
+  {
+    MergeSort(portal, LessThanCompare());
+  }
+
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKeyImpl(
+      dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTag> &keys,
+      dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTag> &values,
+      boost::true_type)
+  {
+    typedef typename dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTag>
+        ::PortalExecution KeyPortalType;
+    typedef typename dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTag>
+        ::PortalExecution ValuePortalType;
+
+    DAX_ASSERT_CONT(keys.GetNumberOfValues() == values.GetNumberOfValues());
+    KeyPortalType keyPortal = keys.PrepareForInPlace();
+    ValuePortalType valuePortal = values.PrepareForInPlace();
+    dax::cont::internal::RadixSortByKey(keyPortal.GetIteratorBegin(),
+                                        keyPortal.GetIteratorEnd(),
+                                        valuePortal.GetIteratorBegin(),
+                                        RadixSortBlocksStdThread());
+  }
+
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKeyImpl(
+      dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTag> &keys,
+      dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTag> &values,
+      boost::false_type)
+  {
+    Superclass::SortByKey(keys, values);
+  }
+
+public:
+  /// Integer and floating point values are sorted with a parallel radix
+  /// sort, other types with a parallel merge sort.
+  ///
+  template<typename T, class Container>
+  DAX_CONT_EXPORT static void Sort(
+      dax::cont::ArrayHandle<T,Container,DeviceAdapterTag> &values)
+  {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
+    typedef typename dax::cont::ArrayHandle<T,Container,DeviceAdapterTag>
+        ::PortalExecution PortalType;
+
+    PortalType arrayPortal = values.PrepareForInPlace();
+    SortPortal(arrayPortal,
+               typename dax::cont::internal::RadixSortTraits<T>::IsSortable());
+  }
+
+  template<typename T, class Container, class Compare>
+  DAX_CONT_EXPORT static void Sort(
+      dax::cont::ArrayHandle<T,Container,DeviceAdapterTag> &values,
+      Compare comp)
+  {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
+    typedef typename dax::cont::ArrayHandle<T,Container,DeviceAdapterTag>
+        ::PortalExecution PortalType;
+
+    PortalType arrayPortal = values.PrepareForInPlace();
+    MergeSort(arrayPortal, comp);
+  }
+
+  using Superclass::SortByKey;
+
+  /// Integer and floating point keys are sorted with a parallel radix sort,
+  /// other types with the parallel merge sort.
+  ///
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKey(
+      dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTag> &keys,
+      dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTag> &values)
+  {
+    DAX_TRACE_SCOPE("algorithm", "SortByKey", keys.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(keys)
+                    + 2*dax::cont::internal::GetTraceBytes(values));
+    SortByKeyImpl(
+          keys,
+          values,
+          typename dax::cont::internal::RadixSortTraits<T>::IsSortable());
+  }
+
+  DAX_CONT_EXPORT static void Synchronize()
+  {
+    // Nothing to do. Every algorithm returns only after the pool has
+    // finished all of its work.
+  }
+
+};
+
+}
+} // namespace dax::cont
+
+#endif //__dax_stdthread_cont_internal_DeviceAdapterAlgorithmStdThread_h
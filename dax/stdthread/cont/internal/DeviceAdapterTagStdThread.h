@@ -8,40 +8,25 @@
 //  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
 //  PURPOSE.  See the above copyright notice for more information.
 //
-//  Copyright 2012 Sandia Corporation.
+//  Copyright 2013 Sandia Corporation.
 //  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
 //  the U.S. Government retains certain rights in this software.
 //
 //=============================================================================
-#ifndef __argumentsParser_h
-#define __argumentsParser_h
+#ifndef __dax_stdthread_cont_internal_DeviceAdapterTagStdThread_h
+#define __dax_stdthread_cont_internal_DeviceAdapterTagStdThread_h
 
-namespace dax { namespace testing {
+namespace dax {
+namespace stdthread {
+namespace cont {
 
-class ArgumentsParser
-{
-public:
-  ArgumentsParser();
-  virtual ~ArgumentsParser();
+/// A DeviceAdapter that runs algorithms on a work-stealing pool of C++11
+/// std::thread workers. It needs no library beyond the C++ standard library.
+///
+struct DeviceAdapterTagStdThread {  };
 
-  bool parseArguments(int argc, char* argv[]);
+}
+}
+} // namespace dax::stdthread::cont
 
-  unsigned int problemSize() const
-    { return this->ProblemSize; }
-
-  enum PipelineMode
-    {
-    MARCHING_CUBES = 1,
-    MARCHING_CUBES_REMOVE_DUPLICATES = 2
-
-    };
-  PipelineMode pipeline() const
-    { return this->Pipeline; }
-
-private:
-  unsigned int ProblemSize;
-  PipelineMode Pipeline;
-};
-
-}}
-#endif
+#endif //__dax_stdthread_cont_internal_DeviceAdapterTagStdThread_h
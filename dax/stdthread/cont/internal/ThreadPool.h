@@ -0,0 +1,318 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_stdthread_cont_internal_ThreadPool_h
+#define __dax_stdthread_cont_internal_ThreadPool_h
+
+#include <dax/Types.h>
+#include <dax/internal/ExportMacros.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dax {
+namespace stdthread {
+namespace cont {
+namespace internal {
+
+/// \brief A work-stealing pool of std::thread workers.
+///
+/// ParallelFor hands a range to the pool. The thread running a piece of the
+/// range keeps splitting it in half until it is no larger than the grain
+/// size. The upper halves are pushed on the back of the thread's own queue
+/// and the lower half is run right away. Each thread pops work from the back
+/// of its own queue. A thread whose queue is empty steals from the front of
+/// another queue, which holds the largest pieces left. The thread that calls
+/// ParallelFor works on the range too and returns once all of it has run.
+/// ParallelFor may be called from inside a body. Calls from threads outside
+/// the pool run one at a time.
+///
+/// Idle workers sleep on a condition variable, so a pool costs nothing
+/// between algorithms.
+///
+class ThreadPool
+{
+public:
+  /// Returns the pool shared by every StdThread algorithm. It is created
+  /// with one thread per hardware thread on first use.
+  DAX_CONT_EXPORT static ThreadPool &GetInstance()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  DAX_CONT_EXPORT ~ThreadPool() { this->StopWorkers(); }
+
+  /// The number of threads that run work, counting the calling thread.
+  DAX_CONT_EXPORT dax::Id GetNumberOfThreads() const
+    { return this->NumberOfThreads; }
+
+  /// Restarts the pool with \p numThreads threads counting the calling
+  /// thread. A value below 1 picks one thread per hardware thread. Must not
+  /// be called while the pool is running work.
+  DAX_CONT_EXPORT void SetNumberOfThreads(dax::Id numThreads)
+  {
+    this->StopWorkers();
+    this->StartWorkers(numThreads);
+  }
+
+  /// Calls \p body(begin, end) on disjoint subranges that cover
+  /// [\p begin, \p end), each at most \p grainSize long, and returns when
+  /// all calls are done. \p body must not throw.
+  template<class BodyType>
+  DAX_CONT_EXPORT void ParallelFor(dax::Id begin,
+                                   dax::Id end,
+                                   dax::Id grainSize,
+                                   const BodyType &body)
+  {
+    if (end <= begin) { return; }
+    grainSize = std::max(grainSize, dax::Id(1));
+    if ((this->NumberOfThreads < 2) || (end - begin <= grainSize))
+      {
+      body(begin, end);
+      return;
+      }
+
+    int &slot = CurrentSlot();
+    const bool external = (slot < 0);
+    std::unique_lock<std::mutex> submitLock(this->SubmitMutex,
+                                            std::defer_lock);
+    if (external)
+      {
+      submitLock.lock();
+      slot = static_cast<int>(this->NumberOfThreads) - 1;
+      }
+
+    TaskGroup group;
+    group.Invoke = &ThreadPool::InvokeBody<BodyType>;
+    group.Body = &body;
+    group.GrainSize = grainSize;
+    group.Remaining.store(end - begin);
+
+    Task root = { &group, begin, end };
+    this->RunTask(slot, root);
+
+    Task task;
+    while (group.Remaining.load(std::memory_order_acquire) > 0)
+      {
+      if (this->TryGetTask(slot, task))
+        {
+        this->RunTask(slot, task);
+        }
+      else
+        {
+        std::this_thread::yield();
+        }
+      }
+
+    if (external)
+      {
+      slot = -1;
+      }
+  }
+
+private:
+  struct TaskGroup
+  {
+    void (*Invoke)(const void *body, dax::Id begin, dax::Id end);
+    const void *Body;
+    dax::Id GrainSize;
+    std::atomic<dax::Id> Remaining;
+  };
+
+  struct Task
+  {
+    TaskGroup *Group;
+    dax::Id Begin;
+    dax::Id End;
+  };
+
+  struct TaskQueue
+  {
+    std::mutex Mutex;
+    std::deque<Task> Tasks;
+  };
+
+  DAX_CONT_EXPORT ThreadPool()
+    : NumberOfThreads(1), Stop(false), QueuedTasks(0), SleepingWorkers(0)
+  {
+    this->StartWorkers(0);
+  }
+
+  ThreadPool(const ThreadPool &);  // Not implemented.
+  void operator=(const ThreadPool &);  // Not implemented.
+
+  template<class BodyType>
+  DAX_CONT_EXPORT static void InvokeBody(const void *body,
+                                         dax::Id begin,
+                                         dax::Id end)
+  {
+    (*static_cast<const BodyType *>(body))(begin, end);
+  }
+
+  // The queue index of the current thread, or -1 outside of the pool. The
+  // last queue belongs to the thread that submitted the running work.
+  DAX_CONT_EXPORT static int &CurrentSlot()
+  {
+    static thread_local int slot = -1;
+    return slot;
+  }
+
+  DAX_CONT_EXPORT void StartWorkers(dax::Id numThreads)
+  {
+    if (numThreads < 1)
+      {
+      numThreads = static_cast<dax::Id>(std::thread::hardware_concurrency());
+      numThreads = std::max(numThreads, dax::Id(1));
+      }
+    this->NumberOfThreads = numThreads;
+    this->Stop = false;
+
+    this->Queues.clear();
+    for (dax::Id index = 0; index < numThreads; ++index)
+      {
+      this->Queues.push_back(
+            std::unique_ptr<TaskQueue>(new TaskQueue));
+      }
+    for (dax::Id index = 0; index < numThreads - 1; ++index)
+      {
+      this->Workers.push_back(
+            std::thread(&ThreadPool::WorkerLoop, this, static_cast<int>(index)));
+      }
+  }
+
+  DAX_CONT_EXPORT void StopWorkers()
+  {
+    {
+    std::lock_guard<std::mutex> lock(this->SleepMutex);
+    this->Stop = true;
+    }
+    this->WakeUp.notify_all();
+    for (std::size_t index = 0; index < this->Workers.size(); ++index)
+      {
+      this->Workers[index].join();
+      }
+    this->Workers.clear();
+  }
+
+  DAX_CONT_EXPORT void WorkerLoop(int slot)
+  {
+    CurrentSlot() = slot;
+    Task task;
+    while (true)
+      {
+      if (this->TryGetTask(slot, task))
+        {
+        this->RunTask(slot, task);
+        continue;
+        }
+
+      std::unique_lock<std::mutex> lock(this->SleepMutex);
+      ++this->SleepingWorkers;
+      while (!this->Stop && (this->QueuedTasks.load() == 0))
+        {
+        this->WakeUp.wait(lock);
+        }
+      --this->SleepingWorkers;
+      if (this->Stop) { return; }
+      }
+  }
+
+  DAX_CONT_EXPORT void RunTask(int slot, Task task)
+  {
+    TaskGroup *group = task.Group;
+    while (task.End - task.Begin > group->GrainSize)
+      {
+      const dax::Id middle = task.Begin + (task.End - task.Begin)/2;
+      Task upper = { group, middle, task.End };
+      this->PushTask(slot, upper);
+      task.End = middle;
+      }
+    group->Invoke(group->Body, task.Begin, task.End);
+    group->Remaining.fetch_sub(task.End - task.Begin,
+                               std::memory_order_acq_rel);
+  }
+
+  DAX_CONT_EXPORT void PushTask(int slot, const Task &task)
+  {
+    {
+    TaskQueue &queue = *this->Queues[slot];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    queue.Tasks.push_back(task);
+    }
+    ++this->QueuedTasks;
+    // A worker counts itself as sleeping before it checks QueuedTasks, so
+    // either it sees the new task or we see it and wake it.
+    if (this->SleepingWorkers.load() > 0)
+      {
+      std::lock_guard<std::mutex> lock(this->SleepMutex);
+      this->WakeUp.notify_one();
+      }
+  }
+
+  DAX_CONT_EXPORT bool TryGetTask(int slot, Task &task)
+  {
+    {
+    TaskQueue &queue = *this->Queues[slot];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    if (!queue.Tasks.empty())
+      {
+      task = queue.Tasks.back();
+      queue.Tasks.pop_back();
+      --this->QueuedTasks;
+      return true;
+      }
+    }
+
+    const int numQueues = static_cast<int>(this->Queues.size());
+    for (int offset = 1; offset < numQueues; ++offset)
+      {
+      TaskQueue &victim = *this->Queues[(slot + offset) % numQueues];
+      std::lock_guard<std::mutex> lock(victim.Mutex);
+      if (!victim.Tasks.empty())
+        {
+        task = victim.Tasks.front();
+        victim.Tasks.pop_front();
+        --this->QueuedTasks;
+        return true;
+        }
+      }
+    return false;
+  }
+
+  dax::Id NumberOfThreads;
+  std::vector<std::unique_ptr<TaskQueue> > Queues;
+  std::vector<std::thread> Workers;
+  std::mutex SubmitMutex;
+
+  std::mutex SleepMutex;
+  std::condition_variable WakeUp;
+  bool Stop;
+  std::atomic<dax::Id> QueuedTasks;
+  std::atomic<int> SleepingWorkers;
+};
+
+}
+}
+}
+} // namespace dax::stdthread::cont::internal
+
+#endif //__dax_stdthread_cont_internal_ThreadPool_h
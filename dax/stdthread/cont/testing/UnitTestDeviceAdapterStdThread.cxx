@@ -0,0 +1,188 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#define DAX_DEVICE_ADAPTER DAX_DEVICE_ADAPTER_ERROR
+
+#include <dax/stdthread/cont/DeviceAdapterStdThread.h>
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/testing/Testing.h>
+#include <dax/cont/testing/TestingDeviceAdapter.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+typedef dax::stdthread::cont::DeviceAdapterTagStdThread DeviceAdapterTag;
+typedef dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>
+    Algorithm;
+typedef dax::cont::ArrayContainerControlTagBasic ContainerTag;
+typedef dax::cont::ArrayHandle<dax::Id, ContainerTag, DeviceAdapterTag>
+    IdArrayHandle;
+
+// Large enough to span many scan chunks and merge runs.
+const dax::Id ARRAY_SIZE = (1 << 18) + 3;
+
+struct GreaterThan
+{
+  DAX_EXEC_CONT_EXPORT bool operator()(dax::Id a, dax::Id b) const
+  {
+    return a > b;
+  }
+};
+
+dax::Id RandomValue(dax::Id index)
+{
+  // Multiplicative hash; unsigned so the overflow is well defined.
+  return static_cast<dax::Id>(
+        (static_cast<unsigned int>(index) * 2654435761u) >> 16);
+}
+
+void TestLargeScan()
+{
+  std::cout << "Testing scans of " << ARRAY_SIZE << " values" << std::endl;
+  std::vector<dax::Id> input(ARRAY_SIZE);
+  for (dax::Id i = 0; i < ARRAY_SIZE; i++) { input[i] = RandomValue(i) % 5; }
+
+  IdArrayHandle inputHandle =
+      dax::cont::make_ArrayHandle(input, ContainerTag(), DeviceAdapterTag());
+  IdArrayHandle outputHandle;
+
+  dax::Id total = Algorithm::ScanInclusive(inputHandle, outputHandle);
+  std::vector<dax::Id> result(ARRAY_SIZE);
+  outputHandle.CopyInto(result.begin());
+  dax::Id sum = 0;
+  for (dax::Id i = 0; i < ARRAY_SIZE; i++)
+    {
+    sum += input[i];
+    DAX_TEST_ASSERT(result[i] == sum, "Bad inclusive scan value.");
+    }
+  DAX_TEST_ASSERT(total == sum, "Bad inclusive scan total.");
+
+  total = Algorithm::ScanExclusive(inputHandle, outputHandle);
+  outputHandle.CopyInto(result.begin());
+  sum = 0;
+  for (dax::Id i = 0; i < ARRAY_SIZE; i++)
+    {
+    DAX_TEST_ASSERT(result[i] == sum, "Bad exclusive scan value.");
+    sum += input[i];
+    }
+  DAX_TEST_ASSERT(total == sum, "Bad exclusive scan total.");
+
+  // Scan in place.
+  IdArrayHandle inPlaceHandle;
+  Algorithm::Copy(inputHandle, inPlaceHandle);
+  total = Algorithm::ScanInclusive(inPlaceHandle, inPlaceHandle);
+  DAX_TEST_ASSERT(total == sum, "Bad in place scan total.");
+  inPlaceHandle.CopyInto(result.begin());
+  DAX_TEST_ASSERT(result[ARRAY_SIZE-1] == sum, "Bad in place scan value.");
+}
+
+void TestLargeStreamCompact()
+{
+  std::cout << "Testing stream compact of " << ARRAY_SIZE << " values"
+            << std::endl;
+  std::vector<dax::Id> input(ARRAY_SIZE);
+  for (dax::Id i = 0; i < ARRAY_SIZE; i++) { input[i] = RandomValue(i) % 3; }
+
+  IdArrayHandle stencilHandle =
+      dax::cont::make_ArrayHandle(input, ContainerTag(), DeviceAdapterTag());
+  IdArrayHandle resultHandle;
+  Algorithm::StreamCompact(stencilHandle, resultHandle);
+
+  std::vector<dax::Id> expected;
+  for (dax::Id i = 0; i < ARRAY_SIZE; i++)
+    {
+    if (input[i] != 0) { expected.push_back(i); }
+    }
+  DAX_TEST_ASSERT(resultHandle.GetNumberOfValues()
+                  == static_cast<dax::Id>(expected.size()),
+                  "Stream compact has wrong size.");
+  std::vector<dax::Id> result(expected.size());
+  resultHandle.CopyInto(result.begin());
+  DAX_TEST_ASSERT(std::equal(result.begin(), result.end(), expected.begin()),
+                  "Stream compact has wrong values.");
+}
+
+void TestLargeSort()
+{
+  std::cout << "Testing sorts of " << ARRAY_SIZE << " values" << std::endl;
+  std::vector<dax::Id> input(ARRAY_SIZE);
+  for (dax::Id i = 0; i < ARRAY_SIZE; i++) { input[i] = RandomValue(i); }
+  std::vector<dax::Id> expected(input);
+  std::sort(expected.begin(), expected.end(), GreaterThan());
+
+  // Sorting with a comparison object goes through the parallel merge sort.
+  IdArrayHandle sortHandle;
+  Algorithm::Copy(dax::cont::make_ArrayHandle(input,
+                                              ContainerTag(),
+                                              DeviceAdapterTag()),
+                  sortHandle);
+  Algorithm::Sort(sortHandle, GreaterThan());
+  std::vector<dax::Id> result(ARRAY_SIZE);
+  sortHandle.CopyInto(result.begin());
+  DAX_TEST_ASSERT(result == expected, "Merge sort has wrong values.");
+
+  // Keys are a permutation, so each value must still follow its key.
+  std::vector<dax::Id> keys(ARRAY_SIZE);
+  std::vector<dax::Id> values(ARRAY_SIZE);
+  for (dax::Id i = 0; i < ARRAY_SIZE; i++)
+    {
+    keys[i] = (i * 17) % ARRAY_SIZE;
+    values[i] = ARRAY_SIZE - keys[i];
+    }
+  IdArrayHandle keysHandle;
+  IdArrayHandle valuesHandle;
+  Algorithm::Copy(dax::cont::make_ArrayHandle(keys,
+                                              ContainerTag(),
+                                              DeviceAdapterTag()),
+                  keysHandle);
+  Algorithm::Copy(dax::cont::make_ArrayHandle(values,
+                                              ContainerTag(),
+                                              DeviceAdapterTag()),
+                  valuesHandle);
+  Algorithm::SortByKey(keysHandle, valuesHandle, GreaterThan());
+  keysHandle.CopyInto(keys.begin());
+  valuesHandle.CopyInto(values.begin());
+  for (dax::Id i = 0; i < ARRAY_SIZE; i++)
+    {
+    DAX_TEST_ASSERT(keys[i] == ARRAY_SIZE - 1 - i, "Bad sorted key.");
+    DAX_TEST_ASSERT(values[i] == ARRAY_SIZE - keys[i], "Bad sorted value.");
+    }
+}
+
+void TestStdThreadAlgorithms()
+{
+  TestLargeScan();
+  TestLargeStreamCompact();
+  TestLargeSort();
+}
+
+} // anonymous namespace
+
+int UnitTestDeviceAdapterStdThread(int, char *[])
+{
+  // Use several workers even on small machines so that stealing and the
+  // scan lookback are exercised.
+  dax::stdthread::cont::internal::ThreadPool::GetInstance()
+      .SetNumberOfThreads(4);
+
+  int result = dax::cont::testing::Testing::Run(TestStdThreadAlgorithms);
+  if (result != 0) { return result; }
+
+  return dax::cont::testing::TestingDeviceAdapter<DeviceAdapterTag>::Run();
+}
@@ -19,6 +19,7 @@
 #include <dax/tbb/cont/internal/DeviceAdapterTagTBB.h>
 
 #include <dax/cont/internal/ArrayManagerExecution.h>
+#include <dax/cont/internal/ArrayContainerControlFirstTouch.h>
 #include <dax/cont/internal/ArrayManagerExecutionShareWithControl.h>
 
 // These must be placed in the dax::cont::internal namespace so that
@@ -34,6 +35,21 @@ class ArrayManagerExecution
     : public dax::cont::internal::ArrayManagerExecutionShareWithControl
         <T, ArrayContainerTag>
 {
+public:
+  typedef dax::cont::internal::ArrayManagerExecutionShareWithControl
+      <T, ArrayContainerTag> Superclass;
+  typedef typename Superclass::ContainerType ContainerType;
+
+  /// Allocates in the control array and, for containers that ask for it,
+  /// first touches the new pages from the threads of this device.
+  ///
+  DAX_CONT_EXPORT void AllocateArrayForOutput(ContainerType &controlArray,
+                                              dax::Id numberOfValues)
+  {
+    this->Superclass::AllocateArrayForOutput(controlArray, numberOfValues);
+    dax::cont::internal::ArrayContainerControlFirstTouch<
+        dax::tbb::cont::DeviceAdapterTagTBB>(controlArray);
+  }
 };
 
 }
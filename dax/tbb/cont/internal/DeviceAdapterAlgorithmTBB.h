@@ -29,12 +29,14 @@
 #include <dax/cont/arg/Topology.h>
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/ErrorExecution.h>
+#include <dax/cont/Tracing.h>
 #include <dax/cont/internal/DeviceAdapterAlgorithm.h>
 #include <dax/cont/internal/DeviceAdapterAlgorithmGeneral.h>
 #include <dax/cont/internal/FindBinding.h>
 #include <dax/cont/internal/GridTags.h>
+#include <dax/cont/internal/RadixSort.h>
+#include <dax/cont/internal/ScheduleTiles.h>
 
-#include <dax/exec/internal/IJKIndex.h>
 #include <boost/type_traits/remove_reference.hpp>
 
 
@@ -43,7 +45,6 @@
 //and should be included in future version of TBB.
 #include <dax/tbb/cont/internal/parallel_sort.h>
 #include <tbb/blocked_range.h>
-#include <tbb/blocked_range3d.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_scan.h>
 #include <tbb/partitioner.h>
@@ -53,6 +54,23 @@
 namespace dax {
 namespace cont {
 
+namespace internal {
+
+/// Bricks of whole rows, eight rows by eight planes, give TBB thousands of
+/// tasks to balance on large grids while keeping the inner loop long.
+///
+template<>
+struct ScheduleTilingDefault<dax::tbb::cont::DeviceAdapterTagTBB>
+{
+  DAX_CONT_EXPORT static ScheduleTiling Get()
+  {
+    return ScheduleTiling(dax::make_Id3(0, 8, 8),
+                          SCHEDULE_TILE_ORDER_ROW_MAJOR);
+  }
+};
+
+} // namespace internal
+
 template<>
 struct DeviceAdapterAlgorithm<dax::tbb::cont::DeviceAdapterTagTBB> :
     dax::cont::internal::DeviceAdapterAlgorithmGeneral<
@@ -243,6 +261,8 @@ public:
       dax::cont::ArrayHandle<T,COut,dax::tbb::cont::DeviceAdapterTagTBB>
           &output)
   {
+    DAX_TRACE_SCOPE("algorithm", "ScanInclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     return ScanInclusivePortals(
           input.PrepareForInput(),
           output.PrepareForOutput(input.GetNumberOfValues()));
@@ -255,6 +275,8 @@ public:
       dax::cont::ArrayHandle<T,COut,dax::tbb::cont::DeviceAdapterTagTBB>
           &output)
   {
+    DAX_TRACE_SCOPE("algorithm", "ScanExclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     return ScanExclusivePortals(
           input.PrepareForInput(),
           output.PrepareForOutput(input.GetNumberOfValues()));
@@ -311,6 +333,7 @@ public:
   DAX_CONT_EXPORT
   static void Schedule(FunctorType functor, dax::Id numInstances)
   {
+    DAX_TRACE_SCOPE("algorithm", "Schedule", numInstances, 0);
     const dax::Id MESSAGE_SIZE = 1024;
     char errorString[MESSAGE_SIZE];
     errorString[0] = '\0';
@@ -331,14 +354,17 @@ public:
   }
 
 private:
+  // Runs bricks of the schedule so that the points a cell shares with its
+  // neighbors are reused from cache.
   template<class FunctorType>
   class ScheduleKernelId3
   {
   public:
-    DAX_CONT_EXPORT ScheduleKernelId3(const FunctorType &functor,
-                                      const dax::Id3& dims)
+    DAX_CONT_EXPORT ScheduleKernelId3(
+        const FunctorType &functor,
+        const dax::cont::internal::ScheduleTiles &tiles)
       : Functor(functor),
-        Dims(dims)
+        Tiles(&tiles)
       {  }
 
     DAX_CONT_EXPORT void SetErrorMessageBuffer(
@@ -349,23 +375,10 @@ private:
     }
 
     DAX_EXEC_EXPORT
-    void operator()(const ::tbb::blocked_range3d<dax::Id> &range) const {
+    void operator()(const ::tbb::blocked_range<dax::Id> &range) const {
       try
         {
-        dax::exec::internal::IJKIndex index(this->Dims);
-        for( dax::Id k=range.pages().begin(); k!=range.pages().end(); ++k)
-          {
-          index.SetK(k);
-          for( dax::Id j=range.rows().begin(); j!=range.rows().end(); ++j)
-            {
-            index.SetJ(j);
-            for( dax::Id i=range.cols().begin(); i!=range.cols().end(); ++i)
-              {
-              index.SetI(i);
-              this->Functor(index);
-              }
-            }
-          }
+        this->Tiles->RunTiles(this->Functor, range.begin(), range.end());
         }
       catch (dax::cont::Error error)
         {
@@ -379,30 +392,38 @@ private:
     }
   private:
     FunctorType Functor;
-    dax::Id3 Dims;
+    const dax::cont::internal::ScheduleTiles *Tiles;
     dax::exec::internal::ErrorMessageBuffer ErrorMessage;
   };
 
 public:
+  /// Schedules the bricks given by the ScheduleTilingSettings of this
+  /// device. Whole tiles run on one thread, so the tile shape also sets the
+  /// granularity of the load balancing.
+  ///
   template<class FunctorType>
   DAX_CONT_EXPORT
   static void Schedule(FunctorType functor,
                        dax::Id3 rangeMax)
   {
-    //we need to extract from the functor that uniform grid information
+    DAX_TRACE_SCOPE("algorithm", "Schedule",
+                    rangeMax[0]*rangeMax[1]*rangeMax[2], 0);
     const dax::Id MESSAGE_SIZE = 1024;
     char errorString[MESSAGE_SIZE];
     errorString[0] = '\0';
     dax::exec::internal::ErrorMessageBuffer
         errorMessage(errorString, MESSAGE_SIZE);
 
-    //memory is generally setup in a way that iterating the first range
-    //in the tightest loop has the best cache coherence.
-    ::tbb::blocked_range3d<dax::Id> range(0, rangeMax[2],
-                                          0, rangeMax[1],
-                                          0, rangeMax[0]);
+    const dax::cont::internal::ScheduleTiles tiles(
+          rangeMax,
+          dax::cont::internal::ScheduleTilingSettings<
+            dax::tbb::cont::DeviceAdapterTagTBB>::Get());
+    const dax::Id grainSize =
+        std::max(dax::Id(1), TBB_GRAIN_SIZE/tiles.GetTileSize());
+    ::tbb::blocked_range<dax::Id> range(0, tiles.GetNumberOfTiles(),
+                                        grainSize);
 
-    ScheduleKernelId3<FunctorType> kernel(functor,rangeMax);
+    ScheduleKernelId3<FunctorType> kernel(functor, tiles);
     kernel.SetErrorMessageBuffer(errorMessage);
 
     ::tbb::parallel_for(range, kernel);
@@ -413,18 +434,119 @@ public:
       }
   }
 
+private:
+  typedef dax::cont::internal::DeviceAdapterAlgorithmGeneral<
+      DeviceAdapterAlgorithm<dax::tbb::cont::DeviceAdapterTagTBB>,
+      dax::tbb::cont::DeviceAdapterTagTBB> Superclass;
+
+  template<class KernelType>
+  struct RadixSortBlockBody
+  {
+    DAX_CONT_EXPORT RadixSortBlockBody(const KernelType &kernel)
+      : Kernel(kernel) {  }
+
+    DAX_CONT_EXPORT
+    void operator()(const ::tbb::blocked_range<dax::Id> &range) const
+    {
+      for (dax::Id block = range.begin(); block < range.end(); ++block)
+        {
+        this->Kernel(block);
+        }
+    }
+  private:
+    const KernelType &Kernel;
+  };
+
+  // Runs the blocks of a radix sort pass in parallel. Each block needs its
+  // own histogram per pass, so blocks are kept large.
+  struct RadixSortBlocksTBB
+  {
+    DAX_CONT_EXPORT dax::Id GetNumberOfBlocks(dax::Id numValues) const
+    {
+      const dax::Id MIN_BLOCK_SIZE = 1 << 16;
+      const dax::Id MAX_BLOCKS = 256;
+      return std::min(numValues / MIN_BLOCK_SIZE + 1, MAX_BLOCKS);
+    }
+
+    template<class KernelType>
+    DAX_CONT_EXPORT void operator()(const KernelType &kernel,
+                                    dax::Id numBlocks) const
+    {
+      ::tbb::parallel_for(::tbb::blocked_range<dax::Id>(0, numBlocks, 1),
+                          RadixSortBlockBody<KernelType>(kernel));
+    }
+  };
+
+  template<class PortalType>
+  DAX_CONT_EXPORT static void SortPortal(const PortalType &portal,
+                                         boost::true_type)
+  {
+    dax::cont::internal::RadixSort(portal.GetIteratorBegin(),
+                                   portal.GetIteratorEnd(),
+                                   RadixSortBlocksTBB());
+  }
+
+  template<class PortalType>
+  DAX_CONT_EXPORT static void SortPortal(const PortalType &portal,
+                                         boost::false_type)
+  {
+    ::tbb::parallel_sort(portal.GetIteratorBegin(),
+                         portal.GetIteratorEnd());
+  }
+
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKeyImpl(
+      dax::cont::ArrayHandle<T,ContainerT,dax::tbb::cont::DeviceAdapterTagTBB>
+          &keys,
+      dax::cont::ArrayHandle<U,ContainerU,dax::tbb::cont::DeviceAdapterTagTBB>
+          &values,
+      boost::true_type)
+  {
+    typedef typename dax::cont::ArrayHandle<
+        T,ContainerT,dax::tbb::cont::DeviceAdapterTagTBB>::PortalExecution
+        KeyPortalType;
+    typedef typename dax::cont::ArrayHandle<
+        U,ContainerU,dax::tbb::cont::DeviceAdapterTagTBB>::PortalExecution
+        ValuePortalType;
+
+    DAX_ASSERT_CONT(keys.GetNumberOfValues() == values.GetNumberOfValues());
+    KeyPortalType keyPortal = keys.PrepareForInPlace();
+    ValuePortalType valuePortal = values.PrepareForInPlace();
+    dax::cont::internal::RadixSortByKey(keyPortal.GetIteratorBegin(),
+                                        keyPortal.GetIteratorEnd(),
+                                        valuePortal.GetIteratorBegin(),
+                                        RadixSortBlocksTBB());
+  }
+
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKeyImpl(
+      dax::cont::ArrayHandle<T,ContainerT,dax::tbb::cont::DeviceAdapterTagTBB>
+          &keys,
+      dax::cont::ArrayHandle<U,ContainerU,dax::tbb::cont::DeviceAdapterTagTBB>
+          &values,
+      boost::false_type)
+  {
+    Superclass::SortByKey(keys, values);
+  }
+
+public:
+  /// Integer and floating point values are sorted with a parallel radix
+  /// sort, other types with tbb::parallel_sort.
+  ///
   template<typename T, class Container>
   DAX_CONT_EXPORT static void Sort(
       dax::cont::ArrayHandle<T,Container,dax::tbb::cont::DeviceAdapterTagTBB>
           &values)
   {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     typedef typename dax::cont::ArrayHandle<
         T,Container,dax::tbb::cont::DeviceAdapterTagTBB>::PortalExecution
         PortalType;
 
     PortalType arrayPortal = values.PrepareForInPlace();
-    ::tbb::parallel_sort(arrayPortal.GetIteratorBegin(),
-                         arrayPortal.GetIteratorEnd());
+    SortPortal(arrayPortal,
+               typename dax::cont::internal::RadixSortTraits<T>::IsSortable());
   }
 
   template<typename T, class Container, class Compare>
@@ -433,6 +555,8 @@ public:
           &values,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     typedef typename dax::cont::ArrayHandle<
         T,Container,dax::tbb::cont::DeviceAdapterTagTBB>::PortalExecution
         PortalType;
@@ -443,6 +567,26 @@ public:
                          comp);
   }
 
+  using Superclass::SortByKey;
+
+  /// Integer and floating point keys are sorted with a parallel radix sort,
+  /// other types with the general comparison sort.
+  ///
+  template<typename T, typename U, class ContainerT, class ContainerU>
+  DAX_CONT_EXPORT static void SortByKey(
+      dax::cont::ArrayHandle<T,ContainerT,dax::tbb::cont::DeviceAdapterTagTBB>
+          &keys,
+      dax::cont::ArrayHandle<U,ContainerU,dax::tbb::cont::DeviceAdapterTagTBB>
+          &values)
+  {
+    DAX_TRACE_SCOPE("algorithm", "SortByKey", keys.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(keys)
+                    + 2*dax::cont::internal::GetTraceBytes(values));
+    SortByKeyImpl(
+          keys,
+          values,
+          typename dax::cont::internal::RadixSortTraits<T>::IsSortable());
+  }
 
   DAX_CONT_EXPORT static void Synchronize()
   {
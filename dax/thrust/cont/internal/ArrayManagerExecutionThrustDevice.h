@@ -21,6 +21,7 @@
 
 #include <dax/cont/ArrayContainerControl.h>
 #include <dax/cont/ErrorControlOutOfMemory.h>
+#include <dax/cont/MemoryRegistry.h>
 
 #include <dax/exec/internal/ArrayPortalFromIterators.h>
 
@@ -61,6 +62,10 @@ namespace internal {
 /// as an OpenMP or TBB backend), then the device adapter should just use
 /// ArrayManagerExecutionThrustShare.
 ///
+/// The memory held by the device vector is reported to the
+/// dax::cont::MemoryRegistry under the memory space name given to the
+/// constructor.
+///
 
 template<typename T, class ArrayContainerControlTag>
 class ArrayManagerExecutionThrustDevice
@@ -75,7 +80,15 @@ public:
   typedef dax::exec::internal::ArrayPortalFromIterators<const ValueType *>
       PortalConstType;
 
-  DAX_CONT_EXPORT ArrayManagerExecutionThrustDevice() {  }
+  DAX_CONT_EXPORT ArrayManagerExecutionThrustDevice(
+      const char *memorySpaceName = "device")
+    : MemorySpaceName(memorySpaceName), AccountedBytes(0) {  }
+
+  DAX_CONT_EXPORT ~ArrayManagerExecutionThrustDevice()
+  {
+    dax::cont::MemoryRegistry::GetInstance().Free(this->MemorySpaceName,
+                                                  this->AccountedBytes);
+  }
 
   /// Returns the size of the array.
   ///
@@ -96,8 +109,10 @@ public:
       }
     catch (std::bad_alloc error)
       {
+      this->UpdateAccountedBytes();
       throw dax::cont::ErrorControlOutOfMemory(error.what());
       }
+    this->UpdateAccountedBytes();
   }
 
   /// Allocates the appropriate size of the array and copies the given data
@@ -121,8 +136,10 @@ public:
       }
     catch (std::bad_alloc error)
       {
+      this->UpdateAccountedBytes();
       throw dax::cont::ErrorControlOutOfMemory(error.what());
       }
+    this->UpdateAccountedBytes();
   }
 
   /// Copies the data currently in the device array into the given iterators.
@@ -153,6 +170,7 @@ public:
     DAX_ASSERT_CONT(numberOfValues <= static_cast<dax::Id>(this->Array.size()));
 
     this->Array.resize(numberOfValues);
+    this->UpdateAccountedBytes();
   }
 
   DAX_CONT_EXPORT PortalType GetPortal()
@@ -172,6 +190,7 @@ public:
   DAX_CONT_EXPORT void ReleaseResources() {
     this->Array.clear();
     this->Array.shrink_to_fit();
+    this->UpdateAccountedBytes();
   }
 
 private:
@@ -181,8 +200,30 @@ private:
   void operator=(
       ArrayManagerExecutionThrustDevice<T, ArrayContainerControlTag> &);
 
+  // Reports the change in the capacity of the device vector since the last
+  // call to the registry.
+  DAX_CONT_EXPORT void UpdateAccountedBytes()
+  {
+    const dax::internal::Int64Type bytes =
+        static_cast<dax::internal::Int64Type>(this->Array.capacity())
+        * static_cast<dax::internal::Int64Type>(sizeof(ValueType));
+    dax::cont::MemoryRegistry &registry =
+        dax::cont::MemoryRegistry::GetInstance();
+    if (bytes > this->AccountedBytes)
+      {
+      registry.Allocate(this->MemorySpaceName, bytes - this->AccountedBytes);
+      }
+    else if (bytes < this->AccountedBytes)
+      {
+      registry.Free(this->MemorySpaceName, this->AccountedBytes - bytes);
+      }
+    this->AccountedBytes = bytes;
+  }
+
   ::thrust::device_vector<ValueType,
       dax::thrust::cont::internal::UninitializedAllocator<ValueType> > Array;
+  const char *MemorySpaceName;
+  dax::internal::Int64Type AccountedBytes;
 };
 
 }
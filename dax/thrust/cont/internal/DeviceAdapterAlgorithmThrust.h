@@ -21,6 +21,7 @@
 
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/ErrorExecution.h>
+#include <dax/cont/Tracing.h>
 
 #include <dax/Functional.h>
 
@@ -314,30 +315,41 @@ public:
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       dax::cont::ArrayHandle<T,COut,DeviceAdapterTag> &output)
   {
+    DAX_TRACE_SCOPE("algorithm", "Copy", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     dax::Id numberOfValues = input.GetNumberOfValues();
     CopyPortal(input.PrepareForInput(),
                output.PrepareForOutput(numberOfValues));
   }
 
-  template<typename T, class CIn, class CVal, class COut>
+  template<typename T, typename IndexType, class CIn, class CVal, class COut>
   DAX_CONT_EXPORT static void LowerBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>& values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& output)
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "LowerBounds", values.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(values)
+                    + values.GetNumberOfValues()*sizeof(IndexType));
     dax::Id numberOfValues = values.GetNumberOfValues();
     LowerBoundsPortal(input.PrepareForInput(),
                       values.PrepareForInput(),
                       output.PrepareForOutput(numberOfValues));
   }
 
-  template<typename T, class CIn, class CVal, class COut, class Compare>
+  template<typename T, typename IndexType,
+           class CIn, class CVal, class COut, class Compare>
   DAX_CONT_EXPORT static void LowerBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>& values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& output,
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>& output,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "LowerBounds", values.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(values)
+                    + values.GetNumberOfValues()*sizeof(IndexType));
     dax::Id numberOfValues = values.GetNumberOfValues();
     LowerBoundsPortal(input.PrepareForInput(),
                       values.PrepareForInput(),
@@ -345,11 +357,15 @@ public:
                       comp);
   }
 
-  template<class CIn, class COut>
+  template<typename T, class CIn, class COut>
   DAX_CONT_EXPORT static void LowerBounds(
-      const dax::cont::ArrayHandle<dax::Id,CIn,DeviceAdapterTag> &input,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &values_output)
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag> &values_output)
   {
+    DAX_TRACE_SCOPE("algorithm", "LowerBounds",
+                    values_output.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + 2*dax::cont::internal::GetTraceBytes(values_output));
     LowerBoundsPortal(input.PrepareForInput(),
                       values_output.PrepareForInPlace());
   }
@@ -359,6 +375,8 @@ public:
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "ScanExclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     dax::Id numberOfValues = input.GetNumberOfValues();
     if (numberOfValues <= 0)
       {
@@ -374,6 +392,8 @@ public:
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
       dax::cont::ArrayHandle<T,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "ScanInclusive", input.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(input));
     dax::Id numberOfValues = input.GetNumberOfValues();
     if (numberOfValues <= 0)
       {
@@ -409,6 +429,7 @@ public:
   template<class Functor>
   DAX_CONT_EXPORT static void Schedule(Functor functor, dax::Id numInstances)
   {
+    DAX_TRACE_SCOPE("algorithm", "Schedule", numInstances, 0);
     const dax::Id ERROR_ARRAY_SIZE = 1024;
     ::thrust::device_vector<char> errorArray(ERROR_ARRAY_SIZE);
     errorArray[0] = '\0';
@@ -448,6 +469,8 @@ public:
   DAX_CONT_EXPORT static void Sort(
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTag>& values)
   {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     SortPortal(values.PrepareForInPlace());
   }
 
@@ -456,6 +479,8 @@ public:
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTag>& values,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "Sort", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     SortPortal(values.PrepareForInPlace(),comp);
   }
 
@@ -465,6 +490,9 @@ public:
       dax::cont::ArrayHandle<T,ContainerT,DeviceAdapterTag>& keys,
       dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTag>& values)
   {
+    DAX_TRACE_SCOPE("algorithm", "SortByKey", keys.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(keys)
+                    + 2*dax::cont::internal::GetTraceBytes(values));
     SortByKeyPortal(keys.PrepareForInPlace(),
                     values.PrepareForInPlace());
   }
@@ -477,6 +505,9 @@ public:
       dax::cont::ArrayHandle<U,ContainerU,DeviceAdapterTag>& values,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "SortByKey", keys.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(keys)
+                    + 2*dax::cont::internal::GetTraceBytes(values));
     SortByKeyPortal(keys.PrepareForInPlace(),
                     values.PrepareForInPlace(),
                     comp);
@@ -488,6 +519,8 @@ public:
       const dax::cont::ArrayHandle<T,CStencil,DeviceAdapterTag>& stencil,
       dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "StreamCompact", stencil.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(stencil));
     dax::Id stencilSize = stencil.GetNumberOfValues();
 
     RemoveIf(::thrust::make_counting_iterator<dax::Id>(0),
@@ -506,6 +539,9 @@ public:
       const dax::cont::ArrayHandle<T,CStencil,DeviceAdapterTag>& stencil,
       dax::cont::ArrayHandle<U,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "StreamCompact", stencil.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(stencil));
     StreamCompactPortal(input.PrepareForInput(), stencil, output);
   }
 
@@ -513,6 +549,8 @@ public:
   DAX_CONT_EXPORT static void Unique(
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTag> &values)
   {
+    DAX_TRACE_SCOPE("algorithm", "Unique", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     dax::Id newSize = UniquePortal(values.PrepareForInPlace());
 
     values.Shrink(newSize);
@@ -523,30 +561,41 @@ public:
       dax::cont::ArrayHandle<T,Container,DeviceAdapterTag> &values,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "Unique", values.GetNumberOfValues(),
+                    2*dax::cont::internal::GetTraceBytes(values));
     dax::Id newSize = UniquePortal(values.PrepareForInPlace(),comp);
 
     values.Shrink(newSize);
   }
 
-  template<typename T, class CIn, class CVal, class COut>
+  template<typename T, typename IndexType, class CIn, class CVal, class COut>
   DAX_CONT_EXPORT static void UpperBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>& values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& output)
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>& output)
   {
+    DAX_TRACE_SCOPE("algorithm", "UpperBounds", values.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(values)
+                    + values.GetNumberOfValues()*sizeof(IndexType));
     dax::Id numberOfValues = values.GetNumberOfValues();
     UpperBoundsPortal(input.PrepareForInput(),
                       values.PrepareForInput(),
                       output.PrepareForOutput(numberOfValues));
   }
 
-  template<typename T, class CIn, class CVal, class COut, class Compare>
+  template<typename T, typename IndexType,
+           class CIn, class CVal, class COut, class Compare>
   DAX_CONT_EXPORT static void UpperBounds(
       const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag>& input,
       const dax::cont::ArrayHandle<T,CVal,DeviceAdapterTag>& values,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag>& output,
+      dax::cont::ArrayHandle<IndexType,COut,DeviceAdapterTag>& output,
       Compare comp)
   {
+    DAX_TRACE_SCOPE("algorithm", "UpperBounds", values.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + dax::cont::internal::GetTraceBytes(values)
+                    + values.GetNumberOfValues()*sizeof(IndexType));
     dax::Id numberOfValues = values.GetNumberOfValues();
     UpperBoundsPortal(input.PrepareForInput(),
                       values.PrepareForInput(),
@@ -554,11 +603,15 @@ public:
                       comp);
   }
 
-  template<class CIn, class COut>
+  template<typename T, class CIn, class COut>
   DAX_CONT_EXPORT static void UpperBounds(
-      const dax::cont::ArrayHandle<dax::Id,CIn,DeviceAdapterTag> &input,
-      dax::cont::ArrayHandle<dax::Id,COut,DeviceAdapterTag> &values_output)
+      const dax::cont::ArrayHandle<T,CIn,DeviceAdapterTag> &input,
+      dax::cont::ArrayHandle<T,COut,DeviceAdapterTag> &values_output)
   {
+    DAX_TRACE_SCOPE("algorithm", "UpperBounds",
+                    values_output.GetNumberOfValues(),
+                    dax::cont::internal::GetTraceBytes(input)
+                    + 2*dax::cont::internal::GetTraceBytes(values_output));
     UpperBoundsPortal(input.PrepareForInput(),
                       values_output.PrepareForInPlace());
   }
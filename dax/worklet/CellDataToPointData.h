@@ -16,8 +16,10 @@
 #ifndef __CellDataToPointData_h
 #define __CellDataToPointData_h
 
+#include <dax/exec/CellNeighborhood.h>
 #include <dax/exec/CellVertices.h>
 #include <dax/exec/WorkletGenerateKeysValues.h>
+#include <dax/exec/WorkletMapPointNeighborhood.h>
 #include <dax/exec/WorkletReduceKeysValues.h>
 
 namespace dax {
@@ -25,9 +27,9 @@ namespace worklet {
 
 // It might be prudent to change this to create keys and values separately.
 // That way if you have multiple fields to interpolate, you can do them one at
-// atime without continually recreating keys.  It would nice if the dispatcher
-// for generate keys values was able to cache the indexing structures so that
-// they did not have to continually be rebuilt.
+// atime without continually recreating keys.  The reduce side does not need
+// to be rebuilt: build a dax::cont::ReductionMap from the keys once and hand
+// it to the reduce dispatcher of every field.
 
 class CellDataToPointDataGenerateKeys
   : public dax::exec::WorkletGenerateKeysValues
@@ -52,6 +54,8 @@ public:
   }
 };
 
+// The keys are point ids, so the reduce dispatcher can be given the number of
+// points with SetKeyRange to build its reduction map without sorting.
 class CellDataToPointDataReduceKeys
   : public dax::exec::WorkletReduceKeysValues
 {
@@ -73,6 +77,30 @@ public:
   }
 };
 
+// On a uniform grid the cells around a point are known from the point's
+// index, so the point values can be averaged in one pass over the points with
+// DispatcherMapPointNeighborhood instead of generating and reducing keys.
+class CellDataToPointDataGather
+  : public dax::exec::WorkletMapPointNeighborhood
+{
+public:
+  typedef void ControlSignature(Topology, Field(In,Cell), Field(Out));
+  typedef _3 ExecutionSignature(_2);
+
+  template<typename FieldType>
+  DAX_EXEC_EXPORT
+  FieldType operator()(
+      const dax::exec::CellNeighborhood<FieldType> &cellValues) const
+  {
+    FieldType summedValue = cellValues[0];
+    for(int iCtr = 1; iCtr < cellValues.GetNumberOfValues(); iCtr++)
+      {
+      summedValue = summedValue + cellValues[iCtr];
+      }
+    return summedValue * (dax::Scalar(1) / cellValues.GetNumberOfValues());
+  }
+};
+
 
 } } // namespace dax::worklet
 
@@ -0,0 +1,82 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __Fused_worklet_
+#define __Fused_worklet_
+
+#include <dax/exec/WorkletMapField.h>
+
+namespace dax {
+namespace worklet {
+
+/// \brief Runs two map field worklets one after the other in a single pass.
+///
+/// Both worklets must be unary, returning their result from a templated
+/// <tt>T operator()(const T&)</tt> like dax::worklet::Sine. The value
+/// returned by \c FirstWorklet is passed straight to \c SecondWorklet, so
+/// no intermediate array is written. Fused worklets nest, so a chain such
+/// as
+///
+/// \code
+/// typedef dax::worklet::Fused<dax::worklet::Fused<
+///     dax::worklet::Sine, dax::worklet::Square>, dax::worklet::Cosine> Chain;
+/// dax::cont::DispatcherMapField<Chain>().Invoke(input, output);
+/// \endcode
+///
+/// reads \c input once and writes \c output once. Like any such worklet, a
+/// fused worklet can also be the functor of a dax::cont::ArrayHandleTransform
+/// to evaluate the chain lazily inside another dispatcher.
+///
+template<class FirstWorklet, class SecondWorklet>
+class Fused : public dax::exec::WorkletMapField
+{
+public:
+  typedef void ControlSignature(Field(In), Field(Out));
+  typedef _2 ExecutionSignature(_1);
+
+  DAX_EXEC_CONT_EXPORT
+  Fused() {  }
+
+  DAX_CONT_EXPORT
+  Fused(const FirstWorklet &first, const SecondWorklet &second)
+    : First(first), Second(second) {  }
+
+  template<class ValueType>
+  DAX_EXEC_EXPORT
+  ValueType operator()(const ValueType &inValue) const
+  {
+    return this->Second(this->First(inValue));
+  }
+
+  /// Errors raised by either worklet are reported through the buffer the
+  /// dispatcher gives the fused worklet.
+  ///
+  DAX_CONT_EXPORT void SetErrorMessageBuffer(
+      const dax::exec::internal::ErrorMessageBuffer &buffer)
+  {
+    this->dax::exec::WorkletMapField::SetErrorMessageBuffer(buffer);
+    this->First.SetErrorMessageBuffer(buffer);
+    this->Second.SetErrorMessageBuffer(buffer);
+  }
+
+private:
+  FirstWorklet First;
+  SecondWorklet Second;
+};
+
+}
+}
+
+#endif
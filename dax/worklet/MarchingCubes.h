@@ -19,19 +19,37 @@
 
 #include <dax/CellTag.h>
 #include <dax/CellTraits.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/UniformGrid.h>
+#include <dax/exec/BrickMask.h>
 #include <dax/exec/CellField.h>
 #include <dax/exec/CellVertices.h>
+#include <dax/exec/ExecutionObjectBase.h>
 #include <dax/exec/InterpolatedCellPoints.h>
 #include <dax/exec/WorkletInterpolatedCell.h>
 #include <dax/exec/WorkletMapCell.h>
 
+#include <dax/worklet/internal/ClassifyUniformRows.h>
 #include <dax/worklet/internal/MarchingCubesTable.h>
 
 namespace dax {
 namespace worklet {
 
+/// The marching cubes case of a hexahedron: bit i is set when vertex i is
+/// above the isovalue.
+typedef unsigned char MarchingCubesCaseType;
+
 namespace internal{
 namespace marchingcubes{
+// These should probably be available through the voxel class
+DAX_EXEC_CONSTANT_EXPORT const unsigned char VoxelVertEdges[12][2] ={
+    {0,1}, {1,2}, {3,2}, {0,3},
+    {4,5}, {5,6}, {7,6}, {4,7},
+    {0,4}, {1,5}, {2,6}, {3,7},
+  };
+
 // -----------------------------------------------------------------------------
 template<typename T, typename U>
 DAX_EXEC_EXPORT
@@ -46,6 +64,58 @@ int GetHexahedronClassification(const T isoValue, const U& values )
           (values[6] > isoValue) << 6 |
           (values[7] > isoValue) << 7);
 }
+
+// -----------------------------------------------------------------------------
+// Writes the points of one output triangle of a hexahedron. ValuesType only
+// has to support operator[] for the vertices of the cell, so it can be the
+// gathered cell field or a lookup into the whole point field.
+template<class CellTag, typename ValuesType>
+DAX_EXEC_EXPORT void BuildTriangle(
+    const dax::Scalar isoValue,
+    const dax::exec::CellVertices<CellTag>& verts,
+    dax::exec::InterpolatedCellPoints<dax::CellTagTriangle>& outCell,
+    const ValuesType &values,
+    const int voxelClass,
+    dax::Id inputCellVisitIndex)
+{
+  //save the point ids and ratio to interpolate the points of the new cell
+  for (dax::Id outVertIndex = 0;
+       outVertIndex < outCell.NUM_VERTICES;
+       ++outVertIndex)
+    {
+    const unsigned char edge = TriTable[voxelClass][(inputCellVisitIndex*3)+outVertIndex];
+    const int vertA = VoxelVertEdges[edge][0];
+    const int vertB = VoxelVertEdges[edge][1];
+
+    // Find the weight for linear interpolation
+    const dax::Scalar valueA = values[vertA];
+    const dax::Scalar weight = (isoValue - valueA) / (values[vertB]-valueA);
+
+    outCell.SetInterpolationPoint(outVertIndex,
+                                  verts[vertA],
+                                  verts[vertB],
+                                  weight);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Looks up the values of the vertices of a cell only when they are used.
+template<class CellTag, class PortalType>
+struct CellVertexValues
+{
+  DAX_EXEC_EXPORT CellVertexValues(
+      const dax::exec::CellVertices<CellTag> &verts,
+      const PortalType &portal) : Vertices(verts), Portal(portal) {  }
+
+  DAX_EXEC_EXPORT dax::Scalar operator[](int vertexIndex) const
+    {
+    return this->Portal.Get(this->Vertices[vertexIndex]);
+    }
+
+  const dax::exec::CellVertices<CellTag> &Vertices;
+  const PortalType &Portal;
+};
+
 }
 }
 
@@ -126,35 +196,281 @@ private:
       dax::Id inputCellVisitIndex,
       dax::CellTagHexahedron) const
   {
-    using dax::worklet::internal::marchingcubes::TriTable;
-    // These should probably be available through the voxel class
-    const unsigned char voxelVertEdges[12][2] ={
-        {0,1}, {1,2}, {3,2}, {0,3},
-        {4,5}, {5,6}, {7,6}, {4,7},
-        {0,4}, {1,5}, {2,6}, {3,7},
-      };
-
     const int voxelClass =
         internal::marchingcubes::GetHexahedronClassification(IsoValue,values);
 
-    //save the point ids and ratio to interpolate the points of the new cell
-    for (dax::Id outVertIndex = 0;
-         outVertIndex < outCell.NUM_VERTICES;
-         ++outVertIndex)
+    internal::marchingcubes::BuildTriangle(this->IsoValue,
+                                           verts,
+                                           outCell,
+                                           values,
+                                           voxelClass,
+                                           inputCellVisitIndex);
+  }
+};
+
+// -----------------------------------------------------------------------------
+/// Classifies each cell once, saving its marching cubes case. The cases take
+/// one byte per cell. Use MarchingCubesCaseFaceCount to turn them into the
+/// number of triangles of each cell, and MarchingCubesGenerateFromCases to
+/// generate the triangles without classifying every cell again.
+class MarchingCubesClassify : public dax::exec::WorkletMapCell
+{
+public:
+  typedef void ControlSignature(Topology, Field(Point), Field(Out));
+  typedef _3 ExecutionSignature(_2);
+
+  DAX_CONT_EXPORT MarchingCubesClassify(dax::Scalar isoValue)
+    : IsoValue(isoValue) {  }
+
+  template<class CellTag>
+  DAX_EXEC_EXPORT
+  dax::worklet::MarchingCubesCaseType operator()(
+      const dax::exec::CellField<dax::Scalar,CellTag> &values) const
+  {
+    // If you get a compile error on the following line, it means that this
+    // worklet was used with an improper cell type.  Check the cell type for the
+    // input grid given in the control environment.
+    return this->Classify(
+          values,
+          typename dax::CellTraits<CellTag>::CanonicalCellTag());
+  }
+private:
+  dax::Scalar IsoValue;
+
+  template<class CellTag>
+  DAX_EXEC_EXPORT
+  dax::worklet::MarchingCubesCaseType Classify(
+      const dax::exec::CellField<dax::Scalar,CellTag> &values,
+      dax::CellTagHexahedron) const
+  {
+    return static_cast<dax::worklet::MarchingCubesCaseType>(
+          internal::marchingcubes::GetHexahedronClassification(IsoValue,
+                                                                values));
+  }
+};
+
+// -----------------------------------------------------------------------------
+/// Maps a marching cubes case to its number of triangles. Wrap the cases
+/// from MarchingCubesClassify in a dax::cont::ArrayHandleTransform with this
+/// functor to get the count array for DispatcherGenerateInterpolatedCells
+/// without storing it.
+struct MarchingCubesCaseFaceCount
+{
+  DAX_EXEC_EXPORT
+  dax::Id operator()(dax::worklet::MarchingCubesCaseType voxelClass) const
+  {
+    return dax::worklet::internal::marchingcubes::NumFaces[voxelClass];
+  }
+};
+
+// -----------------------------------------------------------------------------
+/// Gives MarchingCubesGenerateFromCases random access to the point field, so
+/// that only the values at the ends of the cut edges are loaded. \c
+/// PortalType is the execution portal of the field.
+template<class PortalType>
+class MarchingCubesPointValues : public dax::exec::ExecutionObjectBase
+{
+public:
+  DAX_CONT_EXPORT MarchingCubesPointValues(const PortalType &portal)
+    : Portal(portal) {  }
+
+  DAX_EXEC_EXPORT
+  const PortalType &GetPortal() const { return this->Portal; }
+
+private:
+  PortalType Portal;
+};
+
+/// Prepares \p field for input and wraps its portal for
+/// MarchingCubesGenerateFromCases.
+template<class ArrayHandleType>
+DAX_CONT_EXPORT
+MarchingCubesPointValues<typename ArrayHandleType::PortalConstExecution>
+make_MarchingCubesPointValues(const ArrayHandleType &field)
+{
+  return MarchingCubesPointValues<
+      typename ArrayHandleType::PortalConstExecution>(field.PrepareForInput());
+}
+
+// -----------------------------------------------------------------------------
+namespace internal{
+namespace marchingcubes{
+// Classifies the cells of one brick of a uniform grid. The cells are visited
+// in nested loops, so no cell index has to be split into i, j, k, and the
+// cells of bricks that the isovalue does not cut get their case without
+// reading the field. dax::cont::MarchingCubesClassifyBricks schedules one
+// per brick.
+template<class FieldPortalType, class MaskPortalType, class CasePortalType>
+struct ClassifyBrick
+{
+  DAX_CONT_EXPORT ClassifyBrick(
+      const FieldPortalType &field,
+      const dax::exec::BrickMask<MaskPortalType> &mask,
+      const CasePortalType &cases,
+      dax::Scalar isoValue) :
+    Field(field),
+    Mask(mask),
+    Cases(cases),
+    IsoValue(isoValue)
+  {  }
+
+  DAX_EXEC_EXPORT void operator()(dax::Id brickIndex) const
+  {
+    const dax::Id3 &cellDims = this->Mask.GetCellDimensions();
+    const dax::Id3 &brickDims = this->Mask.GetBrickDimensions();
+    const dax::Id brickSize = this->Mask.GetBrickSize();
+    const dax::Id3 brick(
+        brickIndex % brickDims[0],
+        (brickIndex / brickDims[0]) % brickDims[1],
+        brickIndex / (brickDims[0] * brickDims[1]));
+
+    dax::Id3 first;
+    dax::Id3 end;
+    for (int axis = 0; axis < 3; ++axis)
       {
-      const unsigned char edge = TriTable[voxelClass][(inputCellVisitIndex*3)+outVertIndex];
-      const int vertA = voxelVertEdges[edge][0];
-      const int vertB = voxelVertEdges[edge][1];
-
-      // Find the weight for linear interpolation
-      const dax::Scalar weight = (IsoValue - values[vertA]) /
-                                (values[vertB]-values[vertA]);
-
-      outCell.SetInterpolationPoint(outVertIndex,
-                                    verts[vertA],
-                                    verts[vertB],
-                                    weight);
+      first[axis] = brick[axis] * brickSize;
+      end[axis] = first[axis] + brickSize;
+      end[axis] = (end[axis] < cellDims[axis]) ? end[axis] : cellDims[axis];
       }
+
+    const dax::exec::BrickState state = this->Mask.GetBrickState(brickIndex);
+    const dax::Id pointRow = cellDims[0] + 1;
+    const dax::Id pointSlice = pointRow * (cellDims[1] + 1);
+    for (dax::Id k = first[2]; k < end[2]; ++k)
+      {
+      for (dax::Id j = first[1]; j < end[1]; ++j)
+        {
+        const dax::Id cellRowStart = cellDims[0] * (j + cellDims[1] * k);
+        if (state != dax::exec::BRICK_ACTIVE)
+          {
+          const dax::worklet::MarchingCubesCaseType voxelClass =
+              (state == dax::exec::BRICK_ABOVE) ? 255 : 0;
+          for (dax::Id i = first[0]; i < end[0]; ++i)
+            {
+            this->Cases.Set(cellRowStart + i, voxelClass);
+            }
+          continue;
+          }
+
+        const dax::Id pointRowStart = pointRow * j + pointSlice * k;
+        for (dax::Id i = first[0]; i < end[0]; ++i)
+          {
+          //same vertex order as the cells of dax::cont::UniformGrid
+          const dax::Id point = pointRowStart + i;
+          dax::Tuple<dax::Scalar,8> values;
+          values[0] = this->Field.Get(point);
+          values[1] = this->Field.Get(point + 1);
+          values[2] = this->Field.Get(point + pointRow + 1);
+          values[3] = this->Field.Get(point + pointRow);
+          values[4] = this->Field.Get(point + pointSlice);
+          values[5] = this->Field.Get(point + pointSlice + 1);
+          values[6] = this->Field.Get(point + pointSlice + pointRow + 1);
+          values[7] = this->Field.Get(point + pointSlice + pointRow);
+          this->Cases.Set(cellRowStart + i,
+                          static_cast<dax::worklet::MarchingCubesCaseType>(
+                            GetHexahedronClassification(this->IsoValue,
+                                                        values)));
+          }
+        }
+      }
+  }
+
+  DAX_CONT_EXPORT void SetErrorMessageBuffer(
+      const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+  FieldPortalType Field;
+  dax::exec::BrickMask<MaskPortalType> Mask;
+  CasePortalType Cases;
+  dax::Scalar IsoValue;
+};
+}
+}
+
+/// Computes the same cases as MarchingCubesClassify for a uniform grid, a
+/// row of cells at a time. Whole x rows of \p field are compared against
+/// \p isoValue, and the cases of each row of cells are assembled from the
+/// results of the four point rows around it, so every value is loaded about
+/// twice instead of once for each of the eight cells that share it.
+template<class DeviceAdapterTag, class FieldContainer, class CaseContainer>
+DAX_CONT_EXPORT void MarchingCubesClassifyRows(
+    const dax::cont::UniformGrid<DeviceAdapterTag> &grid,
+    const dax::cont::ArrayHandle<dax::Scalar,FieldContainer,DeviceAdapterTag>
+        &field,
+    dax::Scalar isoValue,
+    dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType,
+                           CaseContainer,DeviceAdapterTag> &cases)
+{
+  typedef dax::cont::ArrayHandle<dax::Scalar,FieldContainer,DeviceAdapterTag>
+      FieldHandleType;
+  typedef internal::ClassifyPointsAbove<
+      typename FieldHandleType::PortalConstExecution,
+      dax::Scalar> ClassifierType;
+
+  if (field.GetNumberOfValues() != grid.GetNumberOfPoints())
+    {
+    throw dax::cont::ErrorControlBadValue(
+          "The field does not match the points of the grid.");
+    }
+
+  internal::ScheduleClassifyUniformRows(
+        grid, ClassifierType(field.PrepareForInput(), isoValue), cases);
+}
+// -----------------------------------------------------------------------------
+/// Generates triangles from the cases saved by MarchingCubesClassify. The
+/// case of each cell is read from the cache instead of gathering all eight
+/// vertex values and classifying again, and only the two values of each cut
+/// edge are loaded.
+class MarchingCubesGenerateFromCases : public dax::exec::WorkletInterpolatedCell
+{
+public:
+
+  typedef void ControlSignature(Topology, Geometry(Out), Field(Cell,In),
+                                ExecObject());
+  typedef void ExecutionSignature(Vertices(_1), _2, _3, _4, VisitIndex);
+
+  DAX_CONT_EXPORT MarchingCubesGenerateFromCases(dax::Scalar isoValue)
+    : IsoValue(isoValue){ }
+
+  template<class CellTag, class PortalType>
+  DAX_EXEC_EXPORT void operator()(
+      const dax::exec::CellVertices<CellTag>& verts,
+      dax::exec::InterpolatedCellPoints<dax::CellTagTriangle>& outCell,
+      dax::worklet::MarchingCubesCaseType voxelClass,
+      const MarchingCubesPointValues<PortalType> &field,
+      dax::Id inputCellVisitIndex) const
+  {
+    // If you get a compile error on the following line, it means that this
+    // worklet was used with an improper cell type.  Check the cell type for the
+    // input grid given in the control environment.
+    this->BuildTriangle(
+          verts,
+          outCell,
+          voxelClass,
+          field.GetPortal(),
+          inputCellVisitIndex,
+          typename dax::CellTraits<CellTag>::CanonicalCellTag());
+  }
+
+private:
+  dax::Scalar IsoValue;
+
+  template<class CellTag, class PortalType>
+  DAX_EXEC_EXPORT void BuildTriangle(
+      const dax::exec::CellVertices<CellTag>& verts,
+      dax::exec::InterpolatedCellPoints<dax::CellTagTriangle>& outCell,
+      dax::worklet::MarchingCubesCaseType voxelClass,
+      const PortalType &portal,
+      dax::Id inputCellVisitIndex,
+      dax::CellTagHexahedron) const
+  {
+    internal::marchingcubes::BuildTriangle(
+          this->IsoValue,
+          verts,
+          outCell,
+          internal::marchingcubes::CellVertexValues<CellTag,PortalType>(
+            verts, portal),
+          voxelClass,
+          inputCellVisitIndex);
   }
 };
 }
@@ -75,6 +75,79 @@ private:
   }
 };
 
+// -----------------------------------------------------------------------------
+namespace internal {
+// Tests the points of a uniform grid against the plane of a slice. The
+// coordinates and the distance are computed in the same order as the point
+// coordinates of dax::cont::UniformGrid and SliceCount, so points that lie
+// almost on the plane fall on the same side.
+struct ClassifyPointsAbovePlane
+{
+  template<class DeviceAdapterTag>
+  DAX_CONT_EXPORT ClassifyPointsAbovePlane(
+      const dax::cont::UniformGrid<DeviceAdapterTag> &grid,
+      const dax::Vector3 &origin,
+      const dax::Vector3 &normal)
+    : GridOrigin(grid.GetOrigin()),
+      Spacing(grid.GetSpacing()),
+      Minimum(grid.GetExtent().Min),
+      Origin(origin),
+      Normal(normal),
+      IsoValue(dax::dot(normal, origin))
+  {  }
+
+  DAX_EXEC_EXPORT void operator()(const dax::Id3 &firstPoint,
+                                  dax::Id,
+                                  dax::Id numberOfPoints,
+                                  unsigned char *flags) const
+  {
+    const dax::Scalar y =
+        this->GridOrigin[1] + this->Spacing[1]*(firstPoint[1]+this->Minimum[1]);
+    const dax::Scalar z =
+        this->GridOrigin[2] + this->Spacing[2]*(firstPoint[2]+this->Minimum[2]);
+    const dax::Scalar yDistance = this->Normal[1] * (y - this->Origin[1]);
+    const dax::Scalar zDistance = this->Normal[2] * (z - this->Origin[2]);
+    const dax::Id firstI = firstPoint[0] + this->Minimum[0];
+
+    DAX_SIMD_LOOP
+    for (dax::Id n = 0; n < numberOfPoints; ++n)
+      {
+      const dax::Scalar x =
+          this->GridOrigin[0] + this->Spacing[0]*(firstI + n);
+      const dax::Scalar distance =
+          this->Normal[0] * (x - this->Origin[0]) + yDistance + zDistance;
+      flags[n] = (distance > this->IsoValue);
+      }
+  }
+
+  dax::Vector3 GridOrigin;
+  dax::Vector3 Spacing;
+  dax::Id3 Minimum;
+  dax::Vector3 Origin;
+  dax::Vector3 Normal;
+  dax::Scalar IsoValue;
+};
+}
+
+/// Computes the marching cubes case of every cell of a uniform grid for a
+/// slice, giving the same number of triangles as SliceCount through
+/// dax::worklet::MarchingCubesCaseFaceCount. The points are tested against
+/// the plane a row at a time from the grid geometry, without gathering the
+/// coordinates of each cell.
+template<class DeviceAdapterTag, class CaseContainer>
+DAX_CONT_EXPORT void SliceClassifyRows(
+    const dax::cont::UniformGrid<DeviceAdapterTag> &grid,
+    const dax::Vector3 &origin,
+    const dax::Vector3 &normal,
+    dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType,
+                           CaseContainer,DeviceAdapterTag> &cases)
+{
+  internal::ScheduleClassifyUniformRows(
+        grid,
+        internal::ClassifyPointsAbovePlane(grid, origin, normal),
+        cases);
+}
+
 // -----------------------------------------------------------------------------
 //In the future we could extend this to be more general so we can accept
 //any implicit function, that would help reduce the duplicate code between
@@ -17,6 +17,9 @@
 #ifndef __Threshold_worklet_
 #define __Threshold_worklet_
 
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ErrorControlBadValue.h>
+#include <dax/cont/UniformGrid.h>
 #include <dax/exec/CellField.h>
 #include <dax/exec/CellVertices.h>
 #include <dax/exec/VectorOperations.h>
@@ -24,6 +27,8 @@
 #include <dax/exec/WorkletGenerateTopology.h>
 #include <dax/VectorTraits.h>
 
+#include <dax/worklet/internal/ClassifyUniformRows.h>
+
 namespace dax {
 namespace worklet {
 
@@ -95,6 +100,88 @@ private:
   ValueType ThresholdMax;
 };
 
+namespace internal {
+// Flags the points of a field whose value passes the threshold.
+template<class PortalType, typename ValueType>
+struct ClassifyPointsInRange
+{
+  DAX_CONT_EXPORT ClassifyPointsInRange(const PortalType &portal,
+                                        const ValueType &thresholdMin,
+                                        const ValueType &thresholdMax)
+    : Portal(portal), ThresholdMin(thresholdMin), ThresholdMax(thresholdMax)
+  {  }
+
+  DAX_EXEC_EXPORT void operator()(const dax::Id3 &,
+                                  dax::Id pointIndex,
+                                  dax::Id numberOfPoints,
+                                  unsigned char *flags) const
+  {
+    typedef typename dax::TypeTraits<ValueType>::DimensionalityTag
+        Dimensionality;
+    DAX_SIMD_LOOP
+    for (dax::Id n = 0; n < numberOfPoints; ++n)
+      {
+      ThresholdFunction<ValueType,Dimensionality> threshold(
+            this->ThresholdMin, this->ThresholdMax);
+      threshold(this->Portal.Get(pointIndex + n));
+      flags[n] = static_cast<unsigned char>(threshold.valid);
+      }
+  }
+
+  PortalType Portal;
+  ValueType ThresholdMin;
+  ValueType ThresholdMax;
+};
+}
+
+/// Computes the vertex case of every cell of a uniform grid for a
+/// threshold: bit \c v of the case of a cell is set when the value of its
+/// vertex \c v is in range. The points are tested a row at a time instead
+/// of gathering the eight values of every cell. Wrap the cases in a
+/// dax::cont::ArrayHandleTransform with ThresholdCaseCount to get the same
+/// counts as ThresholdCount.
+template<class DeviceAdapterTag,
+         typename ValueType,
+         class FieldContainer,
+         class CaseContainer>
+DAX_CONT_EXPORT void ThresholdClassifyRows(
+    const dax::cont::UniformGrid<DeviceAdapterTag> &grid,
+    const dax::cont::ArrayHandle<ValueType,FieldContainer,DeviceAdapterTag>
+        &field,
+    const ValueType &thresholdMin,
+    const ValueType &thresholdMax,
+    dax::cont::ArrayHandle<unsigned char,CaseContainer,DeviceAdapterTag>
+        &cases)
+{
+  typedef dax::cont::ArrayHandle<ValueType,FieldContainer,DeviceAdapterTag>
+      FieldHandleType;
+  typedef internal::ClassifyPointsInRange<
+      typename FieldHandleType::PortalConstExecution,
+      ValueType> ClassifierType;
+
+  if (field.GetNumberOfValues() != grid.GetNumberOfPoints())
+    {
+    throw dax::cont::ErrorControlBadValue(
+          "The field does not match the points of the grid.");
+    }
+
+  internal::ScheduleClassifyUniformRows(
+        grid,
+        ClassifierType(field.PrepareForInput(), thresholdMin, thresholdMax),
+        cases);
+}
+
+/// Maps a case from ThresholdClassifyRows to the number of cells that pass
+/// the threshold, which is 1 when all of its vertices are in range.
+struct ThresholdCaseCount
+{
+  DAX_EXEC_EXPORT
+  dax::Id operator()(unsigned char voxelClass) const
+  {
+    return (voxelClass == 255) ? 1 : 0;
+  }
+};
+
 class ThresholdTopology : public dax::exec::WorkletGenerateTopology
 {
 public:
@@ -0,0 +1,207 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+#ifndef __dax_worklet_internal_ClassifyUniformRows_h
+#define __dax_worklet_internal_ClassifyUniformRows_h
+
+#include <dax/Extent.h>
+#include <dax/Types.h>
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/UniformGrid.h>
+#include <dax/exec/internal/ErrorMessageBuffer.h>
+
+namespace dax {
+namespace worklet {
+namespace internal {
+
+/// \brief Computes the vertex cases of the cells of a uniform grid a row at
+/// a time.
+///
+/// The case of a hexahedron has bit \c v set when vertex \c v passes the
+/// test of \c PointClassifierType, with the vertex order of the cells of
+/// dax::cont::UniformGrid, so it is the marching cubes case when the test is
+/// "above the isovalue". Instead of testing the eight vertices of every cell,
+/// the points of a whole x row are tested together into one flag per point,
+/// and the case of each cell is assembled from the flags of the four point
+/// rows around its cell row. Neighbouring cells share those flags, and the
+/// two upper rows of a cell row are the two lower rows of the next one, so
+/// every point is tested about twice instead of eight times. Both the tests
+/// and the assembly are straight loops over contiguous rows that compilers
+/// vectorize.
+///
+/// Each instance handles one slab of cells in k over a span of at most
+/// ROW_WIDTH cells in i, walking up j. \c PointClassifierType needs
+///
+/// \code
+/// void operator()(const dax::Id3 &firstPoint, dax::Id pointIndex,
+///                 dax::Id numberOfPoints, unsigned char *flags) const;
+/// \endcode
+///
+/// which sets \c flags[n] to 0 or 1 for the \c numberOfPoints points along
+/// i starting at \c firstPoint (an ijk position relative to the minimum of
+/// the extent) whose flat index is \c pointIndex.
+///
+template<class PointClassifierType, class CasePortalType>
+class ClassifyUniformRows
+{
+public:
+  enum { ROW_WIDTH = 64 };
+
+  DAX_CONT_EXPORT ClassifyUniformRows(const PointClassifierType &classifier,
+                                      const CasePortalType &cases,
+                                      const dax::Id3 &cellDimensions)
+    : Classifier(classifier),
+      Cases(cases),
+      CellDimensions(cellDimensions)
+  {  }
+
+  DAX_CONT_EXPORT dax::Id GetNumberOfInstances() const
+  {
+    return this->GetNumberOfSpans() * this->CellDimensions[2];
+  }
+
+  DAX_EXEC_EXPORT void operator()(dax::Id instance) const
+  {
+    typedef typename CasePortalType::ValueType CaseType;
+
+    const dax::Id numSpans = this->GetNumberOfSpans();
+    const dax::Id k = instance / numSpans;
+    const dax::Id firstCell = (instance % numSpans) * ROW_WIDTH;
+    const dax::Id remaining = this->CellDimensions[0] - firstCell;
+    const dax::Id numCells = (remaining < ROW_WIDTH) ? remaining : ROW_WIDTH;
+    const dax::Id numPoints = numCells + 1;
+
+    const dax::Id pointRow = this->CellDimensions[0] + 1;
+    const dax::Id pointSlice = pointRow * (this->CellDimensions[1] + 1);
+
+    // Flags of the point rows at j and j + 1 in the slices k and k + 1.
+    unsigned char buffers[4][ROW_WIDTH + 1];
+    unsigned char *lowFront = buffers[0];
+    unsigned char *lowBack = buffers[1];
+    unsigned char *highFront = buffers[2];
+    unsigned char *highBack = buffers[3];
+
+    dax::Id pointIndex = firstCell + pointSlice * k;
+    this->Classifier(dax::make_Id3(firstCell, 0, k), pointIndex, numPoints,
+                     lowFront);
+    this->Classifier(dax::make_Id3(firstCell, 0, k + 1),
+                     pointIndex + pointSlice, numPoints, highFront);
+
+    dax::Id cellIndex =
+        firstCell + this->CellDimensions[0] * this->CellDimensions[1] * k;
+    for (dax::Id j = 0; j < this->CellDimensions[1]; ++j)
+      {
+      pointIndex += pointRow;
+      this->Classifier(dax::make_Id3(firstCell, j + 1, k), pointIndex,
+                       numPoints, lowBack);
+      this->Classifier(dax::make_Id3(firstCell, j + 1, k + 1),
+                       pointIndex + pointSlice, numPoints, highBack);
+
+      DAX_SIMD_LOOP
+      for (dax::Id i = 0; i < numCells; ++i)
+        {
+        const unsigned char voxelClass = static_cast<unsigned char>(
+              lowFront[i] | (lowFront[i+1] << 1) |
+              (lowBack[i+1] << 2) | (lowBack[i] << 3) |
+              (highFront[i] << 4) | (highFront[i+1] << 5) |
+              (highBack[i+1] << 6) | (highBack[i] << 7));
+        this->Cases.Set(cellIndex + i, static_cast<CaseType>(voxelClass));
+        }
+      cellIndex += this->CellDimensions[0];
+
+      // The back rows of this cell row are the front rows of the next.
+      unsigned char *swap = lowFront;
+      lowFront = lowBack;
+      lowBack = swap;
+      swap = highFront;
+      highFront = highBack;
+      highBack = swap;
+      }
+  }
+
+  DAX_CONT_EXPORT void SetErrorMessageBuffer(
+      const dax::exec::internal::ErrorMessageBuffer &) {  }
+
+private:
+  DAX_EXEC_CONT_EXPORT dax::Id GetNumberOfSpans() const
+  {
+    return (this->CellDimensions[0] + ROW_WIDTH - 1) / ROW_WIDTH;
+  }
+
+  PointClassifierType Classifier;
+  CasePortalType Cases;
+  dax::Id3 CellDimensions;
+};
+
+/// Tests the points of a scalar field against an isovalue, setting the flag
+/// of every point above it.
+///
+template<class PortalType, typename ValueType>
+struct ClassifyPointsAbove
+{
+  DAX_CONT_EXPORT ClassifyPointsAbove(const PortalType &portal,
+                                      ValueType isoValue)
+    : Portal(portal), IsoValue(isoValue) {  }
+
+  DAX_EXEC_EXPORT void operator()(const dax::Id3 &,
+                                  dax::Id pointIndex,
+                                  dax::Id numberOfPoints,
+                                  unsigned char *flags) const
+  {
+    DAX_SIMD_LOOP
+    for (dax::Id n = 0; n < numberOfPoints; ++n)
+      {
+      flags[n] = (this->Portal.Get(pointIndex + n) > this->IsoValue);
+      }
+  }
+
+  PortalType Portal;
+  ValueType IsoValue;
+};
+
+/// Fills \p cases with the vertex case of every cell of \p grid, the flag of
+/// each point coming from \p classifier. See ClassifyUniformRows.
+///
+template<class PointClassifierType,
+         typename CaseType,
+         class CaseContainer,
+         class DeviceAdapterTag>
+DAX_CONT_EXPORT void ScheduleClassifyUniformRows(
+    const dax::cont::UniformGrid<DeviceAdapterTag> &grid,
+    const PointClassifierType &classifier,
+    dax::cont::ArrayHandle<CaseType,CaseContainer,DeviceAdapterTag> &cases)
+{
+  typedef dax::cont::ArrayHandle<CaseType,CaseContainer,DeviceAdapterTag>
+      CaseHandleType;
+  typedef ClassifyUniformRows<PointClassifierType,
+                              typename CaseHandleType::PortalExecution>
+      ClassifyType;
+
+  ClassifyType classify(classifier,
+                        cases.PrepareForOutput(grid.GetNumberOfCells()),
+                        dax::extentCellDimensions(grid.GetExtent()));
+  if (grid.GetNumberOfCells() > 0)
+    {
+    dax::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>::Schedule(
+          classify, classify.GetNumberOfInstances());
+    }
+}
+
+}
+}
+} // namespace dax::worklet::internal
+
+#endif //__dax_worklet_internal_ClassifyUniformRows_h
@@ -26,7 +26,9 @@
 #include <dax/cont/ArrayHandle.h>
 #include <dax/cont/ArrayHandleConstant.h>
 #include <dax/cont/DeviceAdapterSerial.h>
+#include <dax/cont/UniformGrid.h>
 #include <dax/cont/DispatcherGenerateKeysValues.h>
+#include <dax/cont/DispatcherMapPointNeighborhood.h>
 #include <dax/cont/DispatcherReduceKeysValues.h>
 
 #include <iostream>
@@ -122,6 +124,7 @@ struct TestCellDataToPointDataWorklet
     dax::cont::DispatcherReduceKeysValues<
       dax::worklet::CellDataToPointDataReduceKeys> reduceKeys(keyHandle);
 
+    reduceKeys.SetReleaseKeys(false);
     reduceKeys.Invoke(valueHandle, resultHandle);
 
     std::cout << "Checking result" << std::endl;
@@ -129,14 +132,110 @@ struct TestCellDataToPointDataWorklet
     resultHandle.CopyInto(pointData.begin());
 
     verifyPointData(grid, field, pointData);
+
+    std::cout << "Running CellDataToPointDataReduceKeys with a key range"
+              << std::endl;
+    reduceKeys.SetKeyRange(grid->GetNumberOfPoints());
+    reduceKeys.Invoke(valueHandle, resultHandle);
+
+    std::cout << "Checking result" << std::endl;
+    DAX_TEST_ASSERT(resultHandle.GetNumberOfValues()
+                    == dax::Id(pointData.size()),
+                    "Wrong number of point values");
+    resultHandle.CopyInto(pointData.begin());
+
+    verifyPointData(grid, field, pointData);
   }
 };
 
+//-----------------------------------------------------------------------------
+void TestCellDataToPointDataGather()
+{
+  typedef dax::cont::UniformGrid<> GridType;
+  dax::cont::testing::TestGrid<GridType> grid(DIM);
+
+  std::vector<dax::Scalar> field(grid->GetNumberOfCells());
+  for (dax::Id cellIndex = 0;
+       cellIndex < grid->GetNumberOfCells();
+       cellIndex++)
+    {
+    field[cellIndex] = cellIndex;
+    }
+  dax::cont::ArrayHandle<dax::Scalar> fieldHandle =
+      dax::cont::make_ArrayHandle(field);
+  dax::cont::ArrayHandle<dax::Scalar> resultHandle;
+
+  std::cout << "Running CellDataToPointDataGather worklet" << std::endl;
+  dax::cont::DispatcherMapPointNeighborhood<
+      dax::worklet::CellDataToPointDataGather>().Invoke(
+        grid.GetRealGrid(), fieldHandle, resultHandle);
+
+  std::cout << "Checking result" << std::endl;
+  DAX_TEST_ASSERT(resultHandle.GetNumberOfValues()
+                  == grid->GetNumberOfPoints(),
+                  "Wrong number of point values");
+  std::vector<dax::Scalar> pointData(resultHandle.GetNumberOfValues());
+  resultHandle.CopyInto(pointData.begin());
+  verifyPointData(grid, field, pointData);
+
+  std::cout << "Running CellDataToPointDataGather on an offset extent"
+            << std::endl;
+  // A grid that is not cubic and does not start at the origin, checked
+  // against the averages of the keys and values worklets.
+  GridType offsetGrid;
+  offsetGrid.SetExtent(dax::make_Id3(-2, 3, 0), dax::make_Id3(3, 5, 4));
+  std::vector<dax::Scalar> offsetField(offsetGrid.GetNumberOfCells());
+  for (dax::Id cellIndex = 0;
+       cellIndex < offsetGrid.GetNumberOfCells();
+       cellIndex++)
+    {
+    offsetField[cellIndex] = dax::Scalar(cellIndex * cellIndex);
+    }
+  dax::cont::ArrayHandle<dax::Scalar> offsetHandle =
+      dax::cont::make_ArrayHandle(offsetField);
+  dax::cont::ArrayHandle<dax::Scalar> gatherHandle;
+  dax::cont::DispatcherMapPointNeighborhood<
+      dax::worklet::CellDataToPointDataGather>().Invoke(
+        offsetGrid, offsetHandle, gatherHandle);
+
+  dax::cont::ArrayHandleConstant<dax::Id> keyGenCounts =
+    dax::cont::make_ArrayHandleConstant<dax::Id>(
+          dax::CellTraits<GridType::CellTag>::NUM_VERTICES,
+          offsetGrid.GetNumberOfCells());
+  dax::cont::ArrayHandle<dax::Id> keyHandle;
+  dax::cont::ArrayHandle<dax::Scalar> valueHandle;
+  dax::cont::ArrayHandle<dax::Scalar> reduceHandle;
+  dax::cont::DispatcherGenerateKeysValues<
+      dax::worklet::CellDataToPointDataGenerateKeys,
+      dax::cont::ArrayHandleConstant<dax::Id> >(keyGenCounts).Invoke(
+        offsetGrid, offsetHandle, keyHandle, valueHandle);
+  dax::cont::DispatcherReduceKeysValues<
+      dax::worklet::CellDataToPointDataReduceKeys> reduceKeys(keyHandle);
+  reduceKeys.SetKeyRange(offsetGrid.GetNumberOfPoints());
+  reduceKeys.Invoke(valueHandle, reduceHandle);
+
+  DAX_TEST_ASSERT(gatherHandle.GetNumberOfValues()
+                  == offsetGrid.GetNumberOfPoints(),
+                  "Wrong number of point values");
+  std::vector<dax::Scalar> gathered(gatherHandle.GetNumberOfValues());
+  std::vector<dax::Scalar> reduced(reduceHandle.GetNumberOfValues());
+  gatherHandle.CopyInto(gathered.begin());
+  reduceHandle.CopyInto(reduced.begin());
+  for (dax::Id pointIndex = 0;
+       pointIndex < dax::Id(gathered.size());
+       pointIndex++)
+    {
+    DAX_TEST_ASSERT(test_equal(gathered[pointIndex], reduced[pointIndex]),
+                    "Gather and reduce by key disagree");
+    }
+}
+
 //-----------------------------------------------------------------------------
 void TestCellDataToPointData()
   {
   dax::cont::testing::GridTesting::TryAllGridTypes(
                                            TestCellDataToPointDataWorklet());
+  TestCellDataToPointDataGather();
   }
 
 
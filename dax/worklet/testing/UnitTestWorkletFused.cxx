@@ -0,0 +1,119 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2013 Sandia Corporation.
+//  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+//  the U.S. Government retains certain rights in this software.
+//
+//=============================================================================
+
+#include <dax/worklet/Fused.h>
+
+#include <dax/worklet/Cosine.h>
+#include <dax/worklet/Sine.h>
+#include <dax/worklet/Square.h>
+
+#include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleTransform.h>
+#include <dax/cont/DeviceAdapter.h>
+#include <dax/cont/DispatcherMapField.h>
+#include <dax/cont/UniformGrid.h>
+
+#include <dax/cont/testing/TestingGridGenerator.h>
+#include <dax/cont/testing/Testing.h>
+
+#include <vector>
+
+namespace {
+
+const dax::Id DIM = 8;
+
+typedef dax::worklet::Fused<
+    dax::worklet::Fused<dax::worklet::Sine, dax::worklet::Square>,
+    dax::worklet::Cosine> ChainType;
+
+//-----------------------------------------------------------------------------
+struct TestFusedWorklet
+{
+  //----------------------------------------------------------------------------
+  template<typename GridType>
+  DAX_CONT_EXPORT
+  void operator()(const GridType&) const
+  {
+  dax::cont::testing::TestGrid<GridType> grid(DIM);
+
+  std::vector<dax::Vector3> field(grid->GetNumberOfPoints());
+  for (dax::Id pointIndex = 0;
+       pointIndex < grid->GetNumberOfPoints();
+       pointIndex++)
+    {
+    field[pointIndex] = grid->ComputePointCoordinates(pointIndex);
+    }
+  dax::cont::ArrayHandle<dax::Vector3> fieldHandle =
+      dax::cont::make_ArrayHandle(field);
+
+  std::cout << "Running Sine, Square and Cosine one at a time" << std::endl;
+  dax::cont::ArrayHandle<dax::Vector3> sineHandle;
+  dax::cont::ArrayHandle<dax::Vector3> squareHandle;
+  dax::cont::ArrayHandle<dax::Vector3> expectedHandle;
+  dax::cont::DispatcherMapField< dax::worklet::Sine >().Invoke(fieldHandle,
+                                                               sineHandle);
+  dax::cont::DispatcherMapField< dax::worklet::Square >().Invoke(sineHandle,
+                                                                 squareHandle);
+  dax::cont::DispatcherMapField< dax::worklet::Cosine >().Invoke(
+        squareHandle, expectedHandle);
+
+  std::cout << "Running the fused chain" << std::endl;
+  dax::cont::ArrayHandle<dax::Vector3> fusedHandle;
+  dax::cont::DispatcherMapField< ChainType >().Invoke(fieldHandle,
+                                                      fusedHandle);
+  CheckSame(expectedHandle, fusedHandle);
+
+  std::cout << "Running the fused chain inside a transform" << std::endl;
+  dax::cont::ArrayHandleTransform<dax::Vector3,
+      dax::cont::ArrayHandle<dax::Vector3>,
+      dax::worklet::Fused<dax::worklet::Sine, dax::worklet::Square> >
+      lazySquareHandle(fieldHandle);
+  dax::cont::ArrayHandle<dax::Vector3> lazyHandle;
+  dax::cont::DispatcherMapField< dax::worklet::Cosine >().Invoke(
+        lazySquareHandle, lazyHandle);
+  CheckSame(expectedHandle, lazyHandle);
+  }
+
+  //----------------------------------------------------------------------------
+  DAX_CONT_EXPORT
+  void CheckSame(const dax::cont::ArrayHandle<dax::Vector3> &expected,
+                 const dax::cont::ArrayHandle<dax::Vector3> &result) const
+  {
+  std::cout << "Checking result" << std::endl;
+  DAX_TEST_ASSERT(result.GetNumberOfValues() == expected.GetNumberOfValues(),
+                  "Fused chain has the wrong number of values.");
+  for (dax::Id index = 0; index < expected.GetNumberOfValues(); index++)
+    {
+    DAX_TEST_ASSERT(test_equal(result.GetPortalConstControl().Get(index),
+                               expected.GetPortalConstControl().Get(index)),
+                    "Fused chain differs from running each worklet.");
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+void TestFused()
+  {
+  dax::cont::testing::GridTesting::TryAllGridTypes(TestFusedWorklet());
+  }
+
+} // Anonymous namespace
+
+//-----------------------------------------------------------------------------
+int UnitTestWorkletFused(int, char *[])
+{
+  return dax::cont::testing::Testing::Run(TestFused);
+}
@@ -26,12 +26,16 @@
 #include <dax/TypeTraits.h>
 
 #include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleTransform.h>
+#include <dax/cont/ClassifyUniformGrid.h>
 #include <dax/cont/DispatcherGenerateInterpolatedCells.h>
 #include <dax/cont/DispatcherMapCell.h>
+#include <dax/cont/MinMaxBrickIndex.h>
 #include <dax/cont/UniformGrid.h>
 #include <dax/cont/UnstructuredGrid.h>
 
 #include <dax/cont/testing/Testing.h>
+#include <cmath>
 #include <vector>
 
 
@@ -51,6 +55,277 @@ struct TestMarchingCubesWorklet
       CellType,ArrayContainer,ArrayContainer,DeviceAdapter>
       UnstructuredGridType;
 
+  //----------------------------------------------------------------------------
+  // The hash strategy numbers points by first use rather than by sorted
+  // weight, so compare the point each connection refers to, and check that
+  // the numbering is in order of first use (which makes it independent of
+  // the device adapter's scheduling).
+  DAX_CONT_EXPORT
+  void VerifyWeldedTopology(const UnstructuredGridType &sortedGrid,
+                            const UnstructuredGridType &weldedGrid) const
+    {
+    typedef UnstructuredGridType::CellConnectionsType::PortalConstControl
+        ConnectionPortal;
+    typedef UnstructuredGridType::PointCoordinatesType::PortalConstControl
+        PointPortal;
+    ConnectionPortal sortedConn =
+        sortedGrid.GetCellConnections().GetPortalConstControl();
+    ConnectionPortal weldedConn =
+        weldedGrid.GetCellConnections().GetPortalConstControl();
+    PointPortal sortedPoints =
+        sortedGrid.GetPointCoordinates().GetPortalConstControl();
+    PointPortal weldedPoints =
+        weldedGrid.GetPointCoordinates().GetPortalConstControl();
+
+    dax::Id nextNewPoint = 0;
+    for (dax::Id index = 0; index < weldedConn.GetNumberOfValues(); ++index)
+      {
+      const dax::Id weldedId = weldedConn.Get(index);
+      DAX_TEST_ASSERT(weldedId <= nextNewPoint,
+                      "Hash welded points are not numbered by first use");
+      if (weldedId == nextNewPoint) { ++nextNewPoint; }
+
+      DAX_TEST_ASSERT(test_equal(sortedPoints.Get(sortedConn.Get(index)),
+                                 weldedPoints.Get(weldedId)),
+                      "Hash welding produced different geometry");
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  DAX_CONT_EXPORT
+  void VerifySameGrid(const UnstructuredGridType &expectedGrid,
+                      const UnstructuredGridType &grid) const
+    {
+    DAX_TEST_ASSERT(
+          expectedGrid.GetNumberOfCells() == grid.GetNumberOfCells(),
+          "Cached cases produced a different number of cells");
+    DAX_TEST_ASSERT(
+          expectedGrid.GetNumberOfPoints() == grid.GetNumberOfPoints(),
+          "Cached cases produced a different number of points");
+
+    for (dax::Id index = 0; index < grid.GetNumberOfPoints(); ++index)
+      {
+      DAX_TEST_ASSERT(
+            test_equal(expectedGrid.GetPointCoordinates()
+                         .GetPortalConstControl().Get(index),
+                       grid.GetPointCoordinates()
+                         .GetPortalConstControl().Get(index)),
+            "Cached cases produced different points");
+      }
+    for (dax::Id index = 0;
+         index < grid.GetCellConnections().GetNumberOfValues();
+         ++index)
+      {
+      DAX_TEST_ASSERT(
+            expectedGrid.GetCellConnections().GetPortalConstControl()
+              .Get(index) ==
+            grid.GetCellConnections().GetPortalConstControl().Get(index),
+            "Cached cases produced different connections");
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  // Without materialized coordinates the output grid has only its topology,
+  // and the points come from the implicit arrays of the dispatcher. The
+  // scalar field used for contouring interpolates to the isovalue.
+  template<class DispatcherType, class CoordinatesHandleType,
+           class FieldHandleType>
+  DAX_CONT_EXPORT
+  void VerifyImplicitPoints(const UnstructuredGridType &expectedGrid,
+                            const UnstructuredGridType &grid,
+                            DispatcherType &dispatcher,
+                            const CoordinatesHandleType &inputCoordinates,
+                            const FieldHandleType &inputField,
+                            dax::Scalar isoValue) const
+    {
+    // The grid has no coordinates, so it reports no points. This is a
+    // documented limitation, the dispatcher gives the number of points.
+    DAX_TEST_ASSERT(grid.GetNumberOfPoints() == 0,
+                    "Coordinates were materialized when asked not to");
+    DAX_TEST_ASSERT(
+          expectedGrid.GetNumberOfCells() == grid.GetNumberOfCells(),
+          "Implicit coordinates changed the number of cells");
+
+    const dax::Id numPoints = expectedGrid.GetNumberOfPoints();
+    DAX_TEST_ASSERT(dispatcher.GetNumberOfPoints() == numPoints,
+                    "Implicit coordinates have the wrong number of points");
+    DAX_TEST_ASSERT(
+          dispatcher.GetInterpolationEdges().GetNumberOfValues() == numPoints,
+          "Implicit coordinates have the wrong number of edges");
+    typename DispatcherType::template InterpolatedPointFieldType<
+        CoordinatesHandleType>::type::PortalConstExecution coordinates =
+          dispatcher.GetInterpolatedPointField(inputCoordinates)
+            .PrepareForInput();
+    typename DispatcherType::template InterpolatedPointFieldType<
+        FieldHandleType>::type::PortalConstExecution field =
+          dispatcher.GetInterpolatedPointField(inputField).PrepareForInput();
+
+    for (dax::Id index = 0; index < numPoints; ++index)
+      {
+      DAX_TEST_ASSERT(
+            test_equal(expectedGrid.GetPointCoordinates()
+                         .GetPortalConstControl().Get(index),
+                       coordinates.Get(index)),
+            "Implicit coordinates differ from materialized ones");
+      DAX_TEST_ASSERT(test_equal(field.Get(index), isoValue),
+                      "Interpolated field is not at the isovalue");
+      }
+    for (dax::Id index = 0;
+         index < grid.GetCellConnections().GetNumberOfValues();
+         ++index)
+      {
+      DAX_TEST_ASSERT(
+            expectedGrid.GetCellConnections().GetPortalConstControl()
+              .Get(index) ==
+            grid.GetCellConnections().GetPortalConstControl().Get(index),
+            "Implicit coordinates changed the connections");
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  // An interpolated point field taken after one Invoke keeps the points of
+  // that Invoke after the dispatcher is invoked again.
+  template<class CoordinatesHandleType>
+  DAX_CONT_EXPORT
+  void VerifyKeptPoints(const UnstructuredGridType &expectedGrid,
+                        const CoordinatesHandleType &coordinates) const
+    {
+    const dax::Id numPoints = expectedGrid.GetNumberOfPoints();
+    DAX_TEST_ASSERT(coordinates.GetNumberOfValues() == numPoints,
+                    "Invoke changed the points of an earlier Invoke");
+    typename CoordinatesHandleType::PortalConstExecution portal =
+        coordinates.PrepareForInput();
+    for (dax::Id index = 0; index < numPoints; ++index)
+      {
+      DAX_TEST_ASSERT(
+            test_equal(expectedGrid.GetPointCoordinates()
+                         .GetPortalConstControl().Get(index),
+                       portal.Get(index)),
+            "Invoke changed the points of an earlier Invoke");
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  // The brick index only supports uniform grids, so there is nothing to
+  // check for the other grid types.
+  template<class GridType, class FieldHandleType, class CaseHandleType>
+  DAX_CONT_EXPORT
+  void VerifyBrickClassify(const GridType &,
+                           dax::Scalar,
+                           const FieldHandleType &,
+                           const CaseHandleType &) const
+    {  }
+
+  template<class FieldHandleType, class CaseHandleType>
+  DAX_CONT_EXPORT
+  void VerifyBrickClassify(const dax::cont::UniformGrid<DeviceAdapter> &grid,
+                           dax::Scalar isoValue,
+                           const FieldHandleType &fieldHandle,
+                           const CaseHandleType &expectedCases) const
+    {
+    //try a brick size that does not divide the grid evenly
+    const dax::Id brickSizes[2] = { 4, 7 };
+    for (int sizeIndex = 0; sizeIndex < 2; ++sizeIndex)
+      {
+      dax::cont::MinMaxBrickIndex<DeviceAdapter> brickIndex(
+            grid, fieldHandle, brickSizes[sizeIndex]);
+
+      CaseHandleType cases;
+      dax::cont::MarchingCubesClassifyBricks(brickIndex,
+                                             fieldHandle,
+                                             isoValue,
+                                             cases);
+
+      DAX_TEST_ASSERT(cases.GetNumberOfValues() ==
+                      expectedCases.GetNumberOfValues(),
+                      "Brick classify produced the wrong number of cases");
+      for (dax::Id index = 0; index < cases.GetNumberOfValues(); ++index)
+        {
+        DAX_TEST_ASSERT(cases.GetPortalConstControl().Get(index) ==
+                        expectedCases.GetPortalConstControl().Get(index),
+                        "Brick classify produced a different case");
+        }
+
+      //the plane cuts the grid diagonally, so some bricks must be skipped
+      dax::Id numActive = 0;
+      for (dax::Id index = 0; index < brickIndex.GetNumberOfBricks(); ++index)
+        {
+        if (brickIndex.GetBrickMask().GetPortalConstControl().Get(index) ==
+            dax::exec::BRICK_ACTIVE)
+          {
+          ++numActive;
+          }
+        }
+      DAX_TEST_ASSERT(numActive > 0 &&
+                      numActive < brickIndex.GetNumberOfBricks(),
+                      "Brick index did not skip any bricks");
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  // Row classification only supports uniform grids.
+  template<class GridType, class FieldHandleType, class CaseHandleType>
+  DAX_CONT_EXPORT
+  void VerifyRowClassify(const GridType &,
+                         dax::Scalar,
+                         const FieldHandleType &,
+                         const CaseHandleType &) const
+    {  }
+
+  template<class FieldHandleType, class CaseHandleType>
+  DAX_CONT_EXPORT
+  void VerifyRowClassify(const dax::cont::UniformGrid<DeviceAdapter> &grid,
+                         dax::Scalar isoValue,
+                         const FieldHandleType &fieldHandle,
+                         const CaseHandleType &expectedCases) const
+    {
+    CaseHandleType cases;
+    dax::worklet::MarchingCubesClassifyRows(grid, fieldHandle, isoValue, cases);
+    this->VerifySameCases(expectedCases, cases);
+
+    //rows longer than one span of the classifier that do not divide evenly,
+    //on an extent that does not start at 0
+    dax::cont::UniformGrid<DeviceAdapter> wideGrid;
+    wideGrid.SetExtent(dax::make_Id3(-3, 2, 1), dax::make_Id3(131, 6, 4));
+    wideGrid.SetSpacing(dax::make_Vector3(0.25, 1.0, 0.5));
+
+    std::vector<dax::Scalar> wideField(wideGrid.GetNumberOfPoints());
+    for (dax::Id index = 0; index < wideGrid.GetNumberOfPoints(); ++index)
+      {
+      const dax::Vector3 coords = wideGrid.ComputePointCoordinates(index);
+      wideField[index] = isoValue + dax::Scalar(
+            std::sin(coords[0]) + std::cos(coords[1]) + coords[2] - 1.25);
+      }
+    FieldHandleType wideFieldHandle = dax::cont::make_ArrayHandle(
+          wideField, ArrayContainer(), DeviceAdapter());
+
+    CaseHandleType wideExpectedCases;
+    dax::cont::DispatcherMapCell<dax::worklet::MarchingCubesClassify>(
+          dax::worklet::MarchingCubesClassify(isoValue))
+        .Invoke(wideGrid, wideFieldHandle, wideExpectedCases);
+
+    CaseHandleType wideCases;
+    dax::worklet::MarchingCubesClassifyRows(wideGrid, wideFieldHandle,
+                                            isoValue, wideCases);
+    this->VerifySameCases(wideExpectedCases, wideCases);
+    }
+
+  template<class CaseHandleType>
+  DAX_CONT_EXPORT
+  void VerifySameCases(const CaseHandleType &expectedCases,
+                       const CaseHandleType &cases) const
+    {
+    DAX_TEST_ASSERT(cases.GetNumberOfValues() ==
+                    expectedCases.GetNumberOfValues(),
+                    "Row classify produced the wrong number of cases");
+    for (dax::Id index = 0; index < cases.GetNumberOfValues(); ++index)
+      {
+      DAX_TEST_ASSERT(cases.GetPortalConstControl().Get(index) ==
+                      expectedCases.GetPortalConstControl().Get(index),
+                      "Row classify produced a different case");
+      }
+    }
+
   //----------------------------------------------------------------------------
   //----------------------------------------------------------------------------
   template<class InputGridType>
@@ -127,6 +402,104 @@ struct TestMarchingCubesWorklet
       DAX_TEST_ASSERT(NumberOfUniquePoints == secondOutGrid.GetNumberOfPoints() &&
                       NumberOfUniquePoints != valid_num_points,
           "We didn't merge to the correct number of points");
+
+      //run the second step again leaving the coordinates implicit
+      interpDispatcher.SetMaterializePointCoordinates(false);
+      UnstructuredGridType implicitOutGrid;
+      interpDispatcher.Invoke(inGrid.GetRealGrid(),
+                              implicitOutGrid,
+                              fieldHandle);
+      interpDispatcher.SetMaterializePointCoordinates(true);
+      this->VerifyImplicitPoints(secondOutGrid,
+                                 implicitOutGrid,
+                                 interpDispatcher,
+                                 inGrid.GetRealGrid().GetPointCoordinates(),
+                                 fieldHandle,
+                                 isoValue);
+
+      //keep the implicit coordinates of this Invoke to check that the next
+      //one does not change them
+      typedef typename InterpolatedDispatcher::template
+          InterpolatedPointFieldType<typename InputGridType::PointCoordinatesType>
+          ::type ImplicitCoordinatesType;
+      ImplicitCoordinatesType implicitCoordinates =
+          interpDispatcher.GetInterpolatedPointField(
+            inGrid.GetRealGrid().GetPointCoordinates());
+
+      //run the second step again welding points with the hash table
+      interpDispatcher.SetDuplicatePointStrategy(
+                                        dax::cont::DUPLICATE_POINTS_HASH);
+      UnstructuredGridType thirdOutGrid;
+      interpDispatcher.Invoke(inGrid.GetRealGrid(),
+                              thirdOutGrid,
+                              fieldHandle);
+      this->VerifyKeptPoints(secondOutGrid, implicitCoordinates);
+
+      DAX_TEST_ASSERT(NumberOfUniquePoints == thirdOutGrid.GetNumberOfPoints(),
+          "Hash welding didn't merge to the correct number of points");
+      DAX_TEST_ASSERT(
+          secondOutGrid.GetNumberOfCells() == thirdOutGrid.GetNumberOfCells(),
+          "Hash welding changed the number of cells");
+      this->VerifyWeldedTopology(secondOutGrid, thirdOutGrid);
+
+      //run marching cubes again, classifying each cell once and generating
+      //the triangles from the cached cases
+      typedef dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType,
+                                     ArrayContainer, DeviceAdapter>
+                    CaseHandleType;
+      typedef dax::cont::ArrayHandleTransform<dax::Id, CaseHandleType,
+                    dax::worklet::MarchingCubesCaseFaceCount, DeviceAdapter>
+                    CaseCountHandleType;
+      typedef  dax::cont::DispatcherMapCell<
+                          dax::worklet::MarchingCubesClassify > ClassifyDispatcher;
+      typedef  dax::cont::DispatcherGenerateInterpolatedCells<
+                  dax::worklet::MarchingCubesGenerateFromCases,
+                  CaseCountHandleType > CaseInterpolatedDispatcher;
+
+      CaseHandleType cases;
+      ClassifyDispatcher classifyDispatcher(
+                              (dax::worklet::MarchingCubesClassify(isoValue)) );
+      classifyDispatcher.Invoke( inGrid.GetRealGrid(),
+                                 fieldHandle,
+                                 cases);
+      DAX_TEST_ASSERT(cases.GetNumberOfValues() ==
+                      inGrid->GetNumberOfCells(),
+                      "Wrong number of cached cases");
+
+      CaseCountHandleType caseCount(cases);
+      CaseInterpolatedDispatcher caseDispatcher( caseCount,
+                    dax::worklet::MarchingCubesGenerateFromCases(isoValue) );
+      caseDispatcher.SetRemoveDuplicatePoints(false);
+      caseDispatcher.SetReleaseCount(false);
+
+      UnstructuredGridType caseOutGrid;
+      caseDispatcher.Invoke(inGrid.GetRealGrid(),
+                            caseOutGrid,
+                            cases,
+                            dax::worklet::make_MarchingCubesPointValues(
+                              fieldHandle));
+      this->VerifySameGrid(outGrid, caseOutGrid);
+
+      //classify again, skipping the bricks that the isovalue does not cross
+      this->VerifyBrickClassify(inGrid.GetRealGrid(),
+                                isoValue,
+                                fieldHandle,
+                                cases);
+
+      //classify again a row of cells at a time
+      this->VerifyRowClassify(inGrid.GetRealGrid(),
+                              isoValue,
+                              fieldHandle,
+                              cases);
+
+      caseDispatcher.SetRemoveDuplicatePoints(true);
+      UnstructuredGridType caseMergedOutGrid;
+      caseDispatcher.Invoke(inGrid.GetRealGrid(),
+                            caseMergedOutGrid,
+                            cases,
+                            dax::worklet::make_MarchingCubesPointValues(
+                              fieldHandle));
+      this->VerifySameGrid(secondOutGrid, caseMergedOutGrid);
       }
     catch (dax::cont::ErrorControl error)
       {
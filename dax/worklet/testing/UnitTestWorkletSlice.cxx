@@ -51,6 +51,63 @@ struct TestSliceWorklet
       CellType,ArrayContainer,ArrayContainer,DeviceAdapter>
       UnstructuredGridType;
 
+  //----------------------------------------------------------------------------
+  // Row classification only supports uniform grids.
+  template<class GridType, class CountHandleType>
+  DAX_CONT_EXPORT
+  void VerifyRowClassify(const GridType &, const CountHandleType &) const
+    {  }
+
+  template<class CountHandleType>
+  DAX_CONT_EXPORT
+  void VerifyRowClassify(const dax::cont::UniformGrid<DeviceAdapter> &grid,
+                         const CountHandleType &expectedCount) const
+    {
+    this->VerifyRowClassify(grid, ORIGIN, NORMAL, expectedCount);
+
+    //an oblique plane across rows longer than one span of the classifier,
+    //on an extent that does not start at 0
+    dax::cont::UniformGrid<DeviceAdapter> wideGrid;
+    wideGrid.SetExtent(dax::make_Id3(-3, 2, 1), dax::make_Id3(131, 6, 4));
+    wideGrid.SetOrigin(dax::make_Vector3(-1.0, 0.5, 0.0));
+    wideGrid.SetSpacing(dax::make_Vector3(0.25, 1.0, 0.5));
+    const dax::Vector3 origin(10.0, 4.0, 1.5);
+    const dax::Vector3 normal(0.2, 1.0, -0.5);
+
+    CountHandleType wideExpectedCount;
+    dax::cont::DispatcherMapCell<dax::worklet::SliceCount>(
+          dax::worklet::SliceCount(origin, normal))
+        .Invoke(wideGrid, wideGrid.GetPointCoordinates(), wideExpectedCount);
+    this->VerifyRowClassify(wideGrid, origin, normal, wideExpectedCount);
+    }
+
+  template<class CountHandleType>
+  DAX_CONT_EXPORT
+  void VerifyRowClassify(const dax::cont::UniformGrid<DeviceAdapter> &grid,
+                         const dax::Vector3 &origin,
+                         const dax::Vector3 &normal,
+                         const CountHandleType &expectedCount) const
+    {
+    dax::cont::ArrayHandle<dax::worklet::MarchingCubesCaseType,
+                           ArrayContainer,DeviceAdapter> cases;
+    dax::worklet::SliceClassifyRows(grid, origin, normal, cases);
+
+    DAX_TEST_ASSERT(cases.GetNumberOfValues() ==
+                    expectedCount.GetNumberOfValues(),
+                    "Row classify produced the wrong number of cases");
+    dax::worklet::MarchingCubesCaseFaceCount faceCount;
+    dax::Id numberOfFaces = 0;
+    for (dax::Id index = 0; index < cases.GetNumberOfValues(); ++index)
+      {
+      const dax::Id count =
+          faceCount(cases.GetPortalConstControl().Get(index));
+      DAX_TEST_ASSERT(count == expectedCount.GetPortalConstControl().Get(index),
+                      "Row classify produced a different number of faces");
+      numberOfFaces += count;
+      }
+    DAX_TEST_ASSERT(numberOfFaces > 0, "Slice does not cross the grid");
+    }
+
   //----------------------------------------------------------------------------
   //----------------------------------------------------------------------------
   template<class InputGridType>
@@ -81,6 +138,9 @@ struct TestSliceWorklet
                             inGrid->GetPointCoordinates(),
                             classification);
 
+      //classify again a row of cells at a time
+      this->VerifyRowClassify(inGrid.GetRealGrid(), classification);
+
       InterpolatedDispatcher interpDispatcher(classification,
                                 dax::worklet::SliceGenerate(ORIGIN,NORMAL));
       interpDispatcher.SetRemoveDuplicatePoints(false);
@@ -25,6 +25,7 @@
 #include <dax/TypeTraits.h>
 
 #include <dax/cont/ArrayHandle.h>
+#include <dax/cont/ArrayHandleTransform.h>
 #include <dax/cont/UniformGrid.h>
 #include <dax/cont/DispatcherGenerateTopology.h>
 #include <dax/cont/DispatcherMapCell.h>
@@ -148,7 +149,7 @@ struct TestThresholdWorklet
     dax::cont::testing::TestGrid<GridType> in(DIM);
     GridType out;
 
-    this->GridThreshold(in,out);
+    this->GridThreshold(in,out,dax::Id());
     }
 
   //----------------------------------------------------------------------------
@@ -158,16 +159,127 @@ struct TestThresholdWorklet
     dax::cont::testing::TestGrid<dax::cont::UniformGrid<> > in(DIM);
     dax::cont::UnstructuredGrid<dax::CellTagHexahedron> out;
 
-    this->GridThreshold(in,out);
+    this->GridThreshold(in,out,dax::Id());
+    }
+
+  //----------------------------------------------------------------------------
+  template<typename T1, class C1, typename T2, class C2, class Device>
+  DAX_CONT_EXPORT
+  void CheckSameConnections(
+      const dax::cont::ArrayHandle<T1,C1,Device> &expected,
+      const dax::cont::ArrayHandle<T2,C2,Device> &connections) const
+    {
+    DAX_TEST_ASSERT(expected.GetNumberOfValues() ==
+                    connections.GetNumberOfValues(),
+                    "Wrong number of connections.");
+    for (dax::Id index = 0; index < expected.GetNumberOfValues(); index++)
+      {
+      DAX_TEST_ASSERT(static_cast<dax::Id>(
+                        connections.GetPortalConstControl().Get(index)) ==
+                      static_cast<dax::Id>(
+                        expected.GetPortalConstControl().Get(index)),
+                      "Connections depend on the index type.");
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  DAX_CONT_EXPORT
+  void CheckIndexTypes() const
+    {
+    dax::cont::testing::TestGrid<dax::cont::UniformGrid<> > in(DIM);
+    dax::cont::UnstructuredGrid<dax::CellTagHexahedron> out;
+    this->GridThreshold(in,out,dax::Id());
+
+    std::cout << "Storing connections as 32-bit indices" << std::endl;
+    dax::cont::UnstructuredGrid<dax::CellTagHexahedron,
+        DAX_DEFAULT_ARRAY_CONTAINER_CONTROL_TAG,
+        DAX_DEFAULT_ARRAY_CONTAINER_CONTROL_TAG,
+        DAX_DEFAULT_DEVICE_ADAPTER_TAG,
+        dax::internal::Int32Type> out32;
+    this->GridThreshold(in,out32,dax::internal::Int32Type());
+    CheckSameConnections(out.GetCellConnections(),
+                         out32.GetCellConnections());
+
+    std::cout << "Storing connections as 64-bit indices" << std::endl;
+    dax::cont::UnstructuredGrid<dax::CellTagHexahedron,
+        DAX_DEFAULT_ARRAY_CONTAINER_CONTROL_TAG,
+        DAX_DEFAULT_ARRAY_CONTAINER_CONTROL_TAG,
+        DAX_DEFAULT_DEVICE_ADAPTER_TAG,
+        dax::internal::Int64Type> out64;
+    this->GridThreshold(in,out64,dax::internal::Int64Type());
+    CheckSameConnections(out.GetCellConnections(),
+                         out64.GetCellConnections());
+    }
+
+  //----------------------------------------------------------------------------
+  DAX_CONT_EXPORT
+  void CheckClassifyRows() const
+    {
+    //rows longer than one span of the classifier that do not divide evenly,
+    //on an extent that does not start at 0
+    dax::cont::UniformGrid<> grid;
+    grid.SetExtent(dax::make_Id3(-3, 2, 1), dax::make_Id3(131, 6, 4));
+    std::vector<dax::Scalar> field(grid.GetNumberOfPoints());
+    for (dax::Id pointIndex = 0;
+         pointIndex < grid.GetNumberOfPoints();
+         pointIndex++)
+      {
+      const dax::Id3 ijk = grid.ComputePointLocation(pointIndex);
+      field[pointIndex] = static_cast<dax::Scalar>(
+            MIN_THRESHOLD + (ijk[0] * 7 + ijk[1] * 3 + ijk[2]) % 14);
+      }
+    dax::cont::ArrayHandle<dax::Scalar> fieldHandle =
+        dax::cont::make_ArrayHandle(field);
+    const dax::Scalar min = MIN_THRESHOLD;
+    const dax::Scalar max = MAX_THRESHOLD;
+
+    std::cout << "Running Threshold one cell at a time" << std::endl;
+    typedef dax::worklet::ThresholdCount<dax::Scalar> CountWorklet;
+    dax::cont::ArrayHandle<dax::Id> count;
+    dax::cont::DispatcherMapCell<CountWorklet>(CountWorklet(min,max))
+        .Invoke(grid, fieldHandle, count);
+    dax::cont::DispatcherGenerateTopology<dax::worklet::ThresholdTopology>
+        dispatcher(count);
+    dispatcher.SetReleaseCount(false);
+    dax::cont::UnstructuredGrid<dax::CellTagHexahedron> expectedGrid;
+    dispatcher.Invoke(grid, expectedGrid);
+
+    std::cout << "Running Threshold a row of cells at a time" << std::endl;
+    typedef dax::cont::ArrayHandle<unsigned char> CaseHandleType;
+    typedef dax::cont::ArrayHandleTransform<dax::Id, CaseHandleType,
+        dax::worklet::ThresholdCaseCount> CaseCountHandleType;
+    CaseHandleType cases;
+    dax::worklet::ThresholdClassifyRows(grid, fieldHandle, min, max, cases);
+    DAX_TEST_ASSERT(cases.GetNumberOfValues() == count.GetNumberOfValues(),
+                    "Row classify produced the wrong number of cases.");
+    dax::worklet::ThresholdCaseCount caseCount;
+    for (dax::Id index = 0; index < count.GetNumberOfValues(); index++)
+      {
+      DAX_TEST_ASSERT(caseCount(cases.GetPortalConstControl().Get(index)) ==
+                      count.GetPortalConstControl().Get(index),
+                      "Row classify produced a different count.");
+      }
+
+    dax::cont::DispatcherGenerateTopology<dax::worklet::ThresholdTopology,
+        CaseCountHandleType> caseDispatcher((CaseCountHandleType(cases)));
+    dax::cont::UnstructuredGrid<dax::CellTagHexahedron> grid2;
+    caseDispatcher.Invoke(grid, grid2);
+    DAX_TEST_ASSERT(grid2.GetNumberOfCells() > 0 &&
+                    grid2.GetNumberOfCells() < grid.GetNumberOfCells(),
+                    "Threshold should keep some of the cells.");
+    CheckSameConnections(expectedGrid.GetCellConnections(),
+                         grid2.GetCellConnections());
     }
 
   //----------------------------------------------------------------------------
   template <typename InGridType,
-            typename OutGridType>
+            typename OutGridType,
+            typename IndexType>
   DAX_CONT_EXPORT
   void GridThreshold(
       const dax::cont::testing::TestGrid<InGridType> &inGridGenerator,
-      OutGridType& outGrid) const
+      OutGridType& outGrid,
+      IndexType) const
     {
     const InGridType inGrid = inGridGenerator.GetRealGrid();
 
@@ -197,7 +309,10 @@ struct TestThresholdWorklet
     try
       {
       typedef dax::cont::DispatcherGenerateTopology<
-            dax::worklet::testing::VerifyThresholdTopology > DispatcherGT;
+            dax::worklet::testing::VerifyThresholdTopology,
+            dax::cont::ArrayHandle< dax::Id >,
+            DAX_DEFAULT_DEVICE_ADAPTER_TAG,
+            IndexType > DispatcherGT;
       typedef typename DispatcherGT::CountHandleType  CountHandleType;
 
 
@@ -245,6 +360,8 @@ struct TestThresholdWorklet
 static void TestThreshold()
   {
   dax::cont::testing::GridTesting::TryAllGridTypes(TestThresholdWorklet());
+  TestThresholdWorklet().CheckIndexTypes();
+  TestThresholdWorklet().CheckClassifyRows();
   }
 } // Anonymous namespace
 